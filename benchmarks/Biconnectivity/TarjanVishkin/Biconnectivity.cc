@@ -32,6 +32,12 @@
 //     -of : the output file to write the biconnectivity labels
 //     -if : the file storing bicc labels, specify if you want to compute the
 //           number of biconnected components.
+//     -euler : build the spanning forest and its preorder numbers and
+//              (low, high) labels with an Euler tour, in polylog depth,
+//              instead of with BFS (suited to high-diameter graphs)
+//     -structure : compute the articulation points, bridges,
+//                  2-edge-connected components and block-cut tree, and
+//                  print their sizes
 //
 // ex computing #biccs:
 // > numactl -i all ./Biconnectivity -of orkut_bcs.out -s -m
@@ -39,6 +45,7 @@
 // -s -m com-orkut.ungraph.txt_SJ
 
 #include "Biconnectivity.h"
+#include "BiconnectivityStructure.h"
 #include "gbbs/pbbslib/sparse_additive_map.h"
 #include "pbbslib/strings/string_basics.h"
 
@@ -59,6 +66,16 @@ void BiconnectivityStats(symmetric_graph<vertex, W>& GA, char* s,
   auto bits = sequence<uintE>(n, (uintE)0);
   auto flags = sequence<bool>(n, false);
 
+  // Both forests are rooted at the smallest vertex of each component, so
+  // rebuilding the rooted forest from the parents recovers the same
+  // ancestors. A non-tree edge takes the label of its lower endpoint, which
+  // only differs from the other endpoint for non-BFS (-euler) forests.
+  auto parents = sequence<parent>(n, [&] (size_t i) {
+    return std::get<0>(labels[i]);
+  });
+  auto forest_edges = spanning_forest::parents_to_edges(parents);
+  auto F = spanning_forest::RootedForest(n, forest_edges);
+
   auto bicc_label = [&](const uintE& u, const uintE& v) {
     auto lab_u = labels[u];
     auto lab_v = labels[v];
@@ -68,8 +85,9 @@ void BiconnectivityStats(symmetric_graph<vertex, W>& GA, char* s,
       return std::get<1>(lab_u);
     } else if (u == p_v) {
       return std::get<1>(lab_v);
+    } else if (F.is_ancestor(u, v)) {
+      return std::get<1>(lab_v);
     } else {
-      assert(std::get<1>(lab_u) == std::get<1>(lab_v));
       return std::get<1>(lab_u);
     }
     exit(0);
@@ -141,12 +159,32 @@ double Biconnectivity_runner(symmetric_graph<vertex, W>& GA, commandLine P) {
 
   auto in_f = P.getOptionValue("-if");
   auto out_f = P.getOptionValue("-of");
+  bool euler_tour = P.getOptionValue("-euler");
   assert(P.getOptionValue("-s"));
   if (in_f) {
     BiconnectivityStats(GA, in_f);
+  } else if (P.getOptionValue("-structure")) {
+    timer t; t.start();
+    auto S = BiconnectivityStructure(GA, euler_tour);
+    double tt = t.stop();
+    std::cout << "### Running Time: " << tt << std::endl;
+    auto count = [&](auto f) {
+      return pbbslib::reduce_add(pbbs::delayed_seq<size_t>(GA.n, f));
+    };
+    std::cout << "num biconnected components = " << S.num_biccs << "\n";
+    std::cout << "num articulation points = "
+              << count([&](size_t v) { return (size_t)S.articulation[v]; })
+              << "\n";
+    std::cout << "num bridges = "
+              << count([&](size_t v) { return (size_t)S.bridge[v]; }) << "\n";
+    std::cout << "num 2-edge-connected components, including isolated "
+                 "vertices = "
+              << count([&](size_t v) { return (size_t)(S.two_edge_cc[v] == v); })
+              << "\n";
+    std::cout << "num block-cut tree edges = " << S.block_cut.size() << "\n";
   } else {
     timer t; t.start();
-    Biconnectivity(GA, out_f);
+    Biconnectivity(GA, out_f, euler_tour);
     double tt = t.stop();
     std::cout << "### Running Time: " << tt << std::endl;
   }
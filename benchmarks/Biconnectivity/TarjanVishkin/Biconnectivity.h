@@ -24,6 +24,8 @@
 #pragma once
 
 #include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
+#include "benchmarks/SpanningForest/SDB14/SpanningForest.h"
+#include "benchmarks/SpanningForest/rooted_forest.h"
 
 #include "gbbs/gbbs.h"
 #include "gbbs/pbbslib/dyn_arr.h"
@@ -318,6 +320,77 @@ inline std::tuple<labels*, uintE*, uintE*> preorder_number(symmetric_graph<verte
   return std::make_tuple(MM.to_array(), PN.to_array(), aug_sizes.to_array());
 }
 
+// Polylog-depth alternative to multi_bfs + preorder_number. The spanning
+// forest comes from LDD-based contraction and is rooted by an Euler tour with
+// list ranking, so no step takes O(diameter) rounds. The (low, high) labels
+// are aggregated over the preorder range of each subtree instead of by a
+// leaffix. Returns the parents, the (min, max) for each subtree, the preorder
+// numbers and the subtree sizes.
+template <template <typename W> class vertex, class W>
+inline std::tuple<uintE*, labels*, uintE*, uintE*> euler_tour_preorder_number(
+    symmetric_graph<vertex, W>& GA) {
+  size_t n = GA.n;
+
+  timer sf_t;
+  sf_t.start();
+  auto forest_edges = workefficient_sf::SpanningForest(GA);
+  sf_t.stop();
+  debug(sf_t.reportTotal("spanning forest time"););
+
+  timer et_t;
+  et_t.start();
+  auto F = spanning_forest::RootedForest(n, forest_edges);
+  forest_edges.clear();
+  et_t.stop();
+  debug(et_t.reportTotal("euler tour time"););
+
+  auto& PN = F.preorder;
+  auto& Parents = F.parents;
+
+  timer map_e;
+  map_e.start();
+  // The (min, max) over the non-tree neighbors of each vertex, and itself.
+  auto MM = sequence<labels>(n, [&](size_t i) {
+    return std::make_tuple(PN[i], PN[i]);
+  });
+  auto map_f = [&](const uintE& u, const uintE& v, const W& wgh) {
+    if (u == Parents[v] || v == Parents[u]) {
+      return;
+    }
+    uintE p_v = PN[v];
+    if (p_v < std::get<0>(MM[u])) {
+      pbbslib::write_min(&std::get<0>(MM[u]), p_v);
+    } else if (p_v > std::get<1>(MM[u])) {
+      pbbslib::write_max(&std::get<1>(MM[u]), p_v);
+    }
+  };
+  par_for(0, n, 1, [&] (size_t i) { GA.get_vertex(i).mapOutNgh(i, map_f); });
+  map_e.stop();
+  debug(map_e.reportTotal("map edges time"););
+
+  timer agg_t;
+  agg_t.start();
+  // Aggregate over subtrees, which are the preorder ranges.
+  auto low = sequence<uintE>::no_init(n);
+  auto high = sequence<uintE>::no_init(n);
+  par_for(0, n, [&] (size_t i) {
+    low[PN[i]] = std::get<0>(MM[i]);
+    high[PN[i]] = std::get<1>(MM[i]);
+  });
+  auto sub_low = spanning_forest::subtree_aggregate(
+      F, low, [](uintE a, uintE b) { return std::min(a, b); });
+  auto sub_high = spanning_forest::subtree_aggregate(
+      F, high, [](uintE a, uintE b) { return std::max(a, b); });
+  par_for(0, n, [&] (size_t i) {
+    MM[i] = std::make_tuple(sub_low[i], sub_high[i]);
+  });
+  agg_t.stop();
+  debug(agg_t.reportTotal("subtree aggregate time"););
+
+  return std::make_tuple(Parents.to_array(), MM.to_array(), PN.to_array(),
+                         F.subtree_size.to_array());
+}
+
 // Deterministic version
 struct BC_BFS_F {
   uintE* Parents;
@@ -456,6 +529,14 @@ inline std::tuple<uintE*, uintE*> critical_connectivity(
     }
   });
 
+  auto is_ancestor = [&](const uintE& u, const uintE& v) {
+    return PN[u] <= PN[v] && PN[v] < PN[u] + aug_sizes[u];
+  };
+
+  // A non-tree edge from a vertex to its ancestor a is in the bicc of the
+  // tree edge from a to its child c on the path, and the vertex is already
+  // connected to c by non-critical tree edges, so the edge is dropped rather
+  // than uniting it with a. Only non-BFS forests have such edges.
   auto not_critical_edge = [&](const uintE& u, const uintE& v) {
     uintE e = Parents[u];
     uintE p_u = (e & bc::VAL_MASK);
@@ -467,7 +548,7 @@ inline std::tuple<uintE*, uintE*> critical_connectivity(
     if (p_v == u) {
       return !(e & bc::TOP_BIT);
     }
-    return true;
+    return !is_ancestor(u, v) && !is_ancestor(v, u);
   };
 
   timer ccpred;
@@ -537,11 +618,24 @@ inline std::tuple<uintE*, uintE*> critical_connectivity(
 
 // CC -> BFS from one source from each component = set of BFS trees in a single
 // array
+//
+// With euler_tour set, the forest and its labels are instead computed in
+// polylog depth by euler_tour_preorder_number. Returns the parents, the
+// (min, max) for each subtree, the preorder numbers and the subtree sizes.
 template <template <class W> class vertex, class W>
-inline std::tuple<uintE*, uintE*> Biconnectivity(symmetric_graph<vertex, W>& GA,
-                                                 char* out_f = 0) {
+inline std::tuple<uintE*, labels*, uintE*, uintE*> forest_labels(
+    symmetric_graph<vertex, W>& GA, bool euler_tour = false) {
   size_t n = GA.n;
 
+  if (euler_tour) {
+    timer et;
+    et.start();
+    auto ret = euler_tour_preorder_number(GA);
+    et.stop();
+    debug(et.reportTotal("euler tour preorder time"););
+    return ret;
+  }
+
   timer fcc;
   fcc.start();
   sequence<uintE> Components = workefficient_cc::CC(GA, 0.2, false);
@@ -573,6 +667,19 @@ inline std::tuple<uintE*, uintE*> Biconnectivity(symmetric_graph<vertex, W>& GA,
   pn.stop();
   debug(pn.reportTotal("preorder time"););
 
+  return std::make_tuple(Parents, min_max, preorder_num, aug_sizes);
+}
+
+template <template <class W> class vertex, class W>
+inline std::tuple<uintE*, uintE*> Biconnectivity(symmetric_graph<vertex, W>& GA,
+                                                 char* out_f = 0,
+                                                 bool euler_tour = false) {
+  uintE* Parents;
+  labels* min_max;
+  uintE* preorder_num;
+  uintE* aug_sizes;
+  std::tie(Parents, min_max, preorder_num, aug_sizes) =
+      forest_labels(GA, euler_tour);
   return critical_connectivity(GA, Parents, min_max, preorder_num, aug_sizes,
                                out_f);
 }
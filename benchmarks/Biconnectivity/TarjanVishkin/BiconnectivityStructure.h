@@ -0,0 +1,227 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+
+#include "Biconnectivity.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/sample_sort.h"
+
+namespace gbbs {
+
+// The biconnected structure of a graph: its biconnected components (biccs),
+// articulation points, bridges, 2-edge-connected components and block-cut
+// tree. Everything is stored per vertex of the spanning forest used by
+// Biconnectivity: the tree edge (parents[v], v) is in bicc label[v], and a
+// non-tree edge is in the bicc of the tree edge above its lower endpoint.
+// Edges are named by their endpoints, and queries take O(1) time.
+struct bicc_structure {
+  sequence<uintE> parents;       // parent in the forest (v itself for roots)
+  sequence<uintE> preorder;      // preorder number within v's tree
+  sequence<uintE> subtree_size;  // number of vertices in v's subtree
+  size_t num_biccs;
+  sequence<uintE> label;     // bicc of (parents[v], v) in [0, num_biccs);
+                             // UINT_E_MAX for roots
+  sequence<bool> articulation;
+  sequence<bool> bridge;     // whether (parents[v], v) is a bridge
+  // The 2-edge-connected component of v, named by its topmost vertex in the
+  // forest. Isolated vertices are their own components.
+  sequence<uintE> two_edge_cc;
+  // The block-cut forest, as the biccs adjacent to each articulation point v:
+  // block_cut[block_offsets[v], block_offsets[v + 1]), in increasing order.
+  // The range is empty for other vertices.
+  sequence<size_t> block_offsets;
+  sequence<uintE> block_cut;
+
+  bool is_ancestor(uintE u, uintE v) const {
+    return preorder[u] <= preorder[v] &&
+           preorder[v] < preorder[u] + subtree_size[u];
+  }
+
+  // Returns the bicc of the edge (u, v).
+  uintE bicc(uintE u, uintE v) const {
+    if (parents[v] == u) return label[v];
+    if (parents[u] == v) return label[u];
+    return is_ancestor(u, v) ? label[v] : label[u];
+  }
+
+  bool same_bcc(const edge& e1, const edge& e2) const {
+    return bicc(e1.first, e1.second) == bicc(e2.first, e2.second);
+  }
+
+  bool is_articulation(uintE v) const { return articulation[v]; }
+
+  bool is_bridge(uintE u, uintE v) const {
+    return (parents[v] == u && bridge[v]) || (parents[u] == v && bridge[u]);
+  }
+
+  bool same_2ecc(uintE u, uintE v) const {
+    return two_edge_cc[u] == two_edge_cc[v];
+  }
+
+  size_t num_blocks(uintE v) const {
+    return block_offsets[v + 1] - block_offsets[v];
+  }
+
+  uintE block(uintE v, size_t i) const {
+    return block_cut[block_offsets[v] + i];
+  }
+};
+
+// Computes the biconnected structure from the forest and labels used by
+// Biconnectivity, without another pass over the graph: the bridges come from
+// the (low, high) labels, and the rest from the bicc labels of the tree
+// edges. Like Biconnectivity, this mutates GA.
+template <template <class W> class vertex, class W>
+inline bicc_structure BiconnectivityStructure(symmetric_graph<vertex, W>& GA,
+                                              bool euler_tour = false) {
+  size_t n = GA.n;
+  uintE* Parents_A;
+  labels* MM;
+  uintE* PN;
+  uintE* aug_sizes;
+  std::tie(Parents_A, MM, PN, aug_sizes) = forest_labels(GA, euler_tour);
+
+  bicc_structure S;
+  S.preorder = sequence<uintE>(n, [&](size_t i) { return PN[i]; });
+  S.subtree_size = sequence<uintE>(n, [&](size_t i) { return aug_sizes[i]; });
+  // A tree edge is a bridge iff no other edge leaves the subtree below it.
+  S.bridge = sequence<bool>(n, [&](size_t v) {
+    uintE low = std::get<0>(MM[v]), high = std::get<1>(MM[v]);
+    return Parents_A[v] != v && PN[v] <= low && high < PN[v] + aug_sizes[v];
+  });
+
+  uintE* Parents;
+  uintE* cc;
+  std::tie(Parents, cc) =
+      critical_connectivity(GA, Parents_A, MM, PN, aug_sizes, nullptr);
+  S.parents = sequence<uintE>(n, [&](size_t i) {
+    return Parents[i] & bc::VAL_MASK;
+  });
+  pbbslib::free_array(Parents);
+  auto& P = S.parents;
+
+  timer lt;
+  lt.start();
+  // Number the biccs densely.
+  auto ids = sequence<uintE>(n, (uintE)0);
+  par_for(0, n, [&] (size_t v) {
+    if (P[v] != v && !ids[cc[v]]) {
+      ids[cc[v]] = 1;
+    }
+  });
+  S.num_biccs = pbbslib::scan_add_inplace(ids);
+  S.label = sequence<uintE>(n, [&](size_t v) {
+    return (P[v] == v) ? UINT_E_MAX : ids[cc[v]];
+  });
+  pbbslib::free_array(cc);
+  ids.clear();
+  auto& label = S.label;
+
+  // Every bicc containing u contains a tree edge at u, so u is an
+  // articulation point iff the tree edges at u are in two or more biccs. rep[u]
+  // is one of them: that of u's parent edge, or the smallest child edge's for a
+  // root.
+  auto rep = sequence<uintE>(n, [&](size_t v) { return label[v]; });
+  par_for(0, n, [&] (size_t v) {
+    uintE u = P[v];
+    if (u != v && P[u] == u && label[v] < rep[u]) {
+      pbbslib::write_min(&rep[u], label[v]);
+    }
+  });
+  S.articulation = sequence<bool>(n, false);
+  par_for(0, n, [&] (size_t v) {
+    uintE u = P[v];
+    if (u != v && label[v] != rep[u] && !S.articulation[u]) {
+      S.articulation[u] = true;
+    }
+  });
+  lt.stop();
+  debug(lt.reportTotal("articulation time"););
+
+  timer bt;
+  bt.start();
+  // The block-cut edges, from the tree edges at each articulation point.
+  auto all_blocks = pbbs::delayed_seq<edge>(2 * n, [&](size_t i) {
+    uintE v = i / 2;
+    uintE u = (i % 2 == 0) ? P[v] : v;
+    if (P[v] == v || !S.articulation[u]) return empty_edge;
+    return std::make_pair(u, label[v]);
+  });
+  auto blocks = pbbslib::filter(all_blocks, [&](const edge& e) {
+    return e != empty_edge;
+  });
+  pbbslib::sample_sort_inplace(blocks.slice(), std::less<edge>());
+  auto distinct = pbbslib::filter(
+      pbbs::delayed_seq<size_t>(blocks.size(), [](size_t i) { return i; }),
+      [&](size_t i) { return i == 0 || blocks[i] != blocks[i - 1]; });
+  S.block_cut = sequence<uintE>(distinct.size(), [&](size_t i) {
+    return blocks[distinct[i]].second;
+  });
+  S.block_offsets = sequence<size_t>(n + 1, (size_t)0);
+  par_for(0, distinct.size(), [&] (size_t i) {
+    uintE u = blocks[distinct[i]].first;
+    if (i == distinct.size() - 1 || blocks[distinct[i + 1]].first != u) {
+      S.block_offsets[u] = i + 1;
+    }
+  });
+  par_for(0, distinct.size(), [&] (size_t i) {
+    uintE u = blocks[distinct[i]].first;
+    if (i == 0 || blocks[distinct[i - 1]].first != u) {
+      S.block_offsets[u] = S.block_offsets[u] - i;
+    }
+  });
+  pbbslib::scan_add_inplace(S.block_offsets);
+  bt.stop();
+  debug(bt.reportTotal("block-cut tree time"););
+
+  timer tt;
+  tt.start();
+  // Removing the bridges splits the forest into the 2-edge-connected
+  // components; each vertex finds the top of its piece by pointer jumping.
+  S.two_edge_cc = sequence<uintE>(n, [&](size_t v) {
+    return (P[v] == v || S.bridge[v]) ? (uintE)v : P[v];
+  });
+  auto& T = S.two_edge_cc;
+  std::atomic<bool> changed = true;
+  while (changed.load()) {
+    changed.store(false);
+    par_for(0, n, [&] (size_t v) {
+      uintE w = T[v];
+      uintE ww = T[w];
+      if (w != ww) {
+        T[v] = ww;
+        if (!changed.load(std::memory_order_relaxed)) {
+          changed.store(true, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  tt.stop();
+  debug(tt.reportTotal("2-edge-connected components time"););
+  return S;
+}
+
+}  // namespace gbbs
@@ -0,0 +1,181 @@
+#include "benchmarks/Biconnectivity/TarjanVishkin/BiconnectivityStructure.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Checks S against a sequential Hopcroft-Tarjan DFS over the edge list.
+void CheckStructure(size_t n, const std::unordered_set<UndirectedEdge>& edges,
+                    const bicc_structure& S) {
+  std::vector<std::vector<uintE>> adj(n);
+  for (const auto& e : edges) {
+    adj[e.endpoints().first].push_back(e.endpoints().second);
+    adj[e.endpoints().second].push_back(e.endpoints().first);
+  }
+  std::vector<uintE> disc(n, UINT_E_MAX), low(n);
+  std::map<edge, size_t> component;  // edge (min, max) -> bicc
+  std::vector<bool> articulation(n, false);
+  std::set<edge> bridges;
+  std::vector<edge> stack;
+  size_t num_biccs = 0;
+  uintE time = 0;
+  auto key = [](uintE u, uintE v) {
+    return std::make_pair(std::min(u, v), std::max(u, v));
+  };
+  std::function<void(uintE, uintE)> dfs = [&](uintE v, uintE p) {
+    disc[v] = low[v] = time++;
+    size_t children = 0;
+    for (uintE u : adj[v]) {
+      if (u == p) continue;
+      if (disc[u] == UINT_E_MAX) {
+        children++;
+        stack.push_back(key(v, u));
+        dfs(u, v);
+        low[v] = std::min(low[v], low[u]);
+        if (low[u] >= disc[v]) {
+          if (p != UINT_E_MAX || children > 1) articulation[v] = true;
+          edge e;
+          do {
+            e = stack.back();
+            stack.pop_back();
+            component[e] = num_biccs;
+          } while (e != key(v, u));
+          num_biccs++;
+        }
+        if (low[u] > disc[v]) bridges.insert(key(v, u));
+      } else if (disc[u] < disc[v]) {
+        stack.push_back(key(v, u));
+        low[v] = std::min(low[v], disc[u]);
+      }
+    }
+  };
+  for (size_t v = 0; v < n; v++) {
+    if (disc[v] == UINT_E_MAX) dfs(v, UINT_E_MAX);
+  }
+
+  // 2-edge-connected components: components without the bridges.
+  std::vector<uintE> two_edge(n, UINT_E_MAX);
+  for (size_t s = 0; s < n; s++) {
+    if (two_edge[s] != UINT_E_MAX) continue;
+    std::vector<uintE> todo = {(uintE)s};
+    two_edge[s] = s;
+    while (!todo.empty()) {
+      uintE v = todo.back(); todo.pop_back();
+      for (uintE u : adj[v]) {
+        if (two_edge[u] == UINT_E_MAX && !bridges.count(key(u, v))) {
+          two_edge[u] = s;
+          todo.push_back(u);
+        }
+      }
+    }
+  }
+
+  EXPECT_EQ(S.num_biccs, num_biccs);
+  for (const auto& [e1, c1] : component) {
+    EXPECT_LT(S.bicc(e1.first, e1.second), S.num_biccs);
+    EXPECT_EQ(S.bicc(e1.first, e1.second), S.bicc(e1.second, e1.first));
+    EXPECT_EQ(S.is_bridge(e1.first, e1.second), bridges.count(e1) > 0);
+    for (const auto& [e2, c2] : component) {
+      EXPECT_EQ(S.same_bcc(e1, e2), c1 == c2);
+    }
+  }
+  for (size_t v = 0; v < n; v++) {
+    EXPECT_EQ(S.is_articulation(v), articulation[v]) << "v = " << v;
+    for (size_t u = 0; u < v; u++) {
+      EXPECT_EQ(S.same_2ecc(u, v), two_edge[u] == two_edge[v]);
+    }
+    std::set<uintE> blocks;
+    for (uintE u : adj[v]) blocks.insert(S.bicc(v, u));
+    if (articulation[v]) {
+      std::vector<uintE> expected(blocks.begin(), blocks.end());
+      ASSERT_EQ(S.num_blocks(v), expected.size());
+      for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(S.block(v, i), expected[i]);
+      }
+    } else {
+      EXPECT_EQ(S.num_blocks(v), 0);
+    }
+  }
+}
+
+void CheckBothForests(size_t n,
+                      const std::unordered_set<UndirectedEdge>& edges) {
+  for (bool euler_tour : {false, true}) {
+    // BiconnectivityStructure mutates the graph.
+    auto graph{graph_test::MakeUnweightedSymmetricGraph(n, edges)};
+    // The blocked edgeMap used by both forests allocates from this pool.
+    alloc_init(graph);
+    auto S = BiconnectivityStructure(graph, euler_tour);
+    CheckStructure(n, edges, S);
+  }
+}
+
+}  // namespace
+
+TEST(BiconnectivityStructure, SmallGraph) {
+  // Graph diagram:
+  //   0 - 1     4 - 5 - 6        9
+  //    \ /      |   |
+  //     2 - 3   7 - 8
+  constexpr uintE kNumVertices{10};
+  const std::unordered_set<UndirectedEdge> kEdges{
+    {0, 1}, {0, 2}, {1, 2}, {2, 3},
+    {4, 5}, {4, 7}, {5, 8}, {7, 8}, {5, 6},
+  };
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, kEdges)};
+  auto S = BiconnectivityStructure(graph);
+
+  EXPECT_EQ(S.num_biccs, 4);
+  EXPECT_TRUE(S.is_articulation(2));
+  EXPECT_TRUE(S.is_articulation(5));
+  EXPECT_FALSE(S.is_articulation(4));
+  EXPECT_FALSE(S.is_articulation(9));
+  EXPECT_TRUE(S.is_bridge(2, 3));
+  EXPECT_TRUE(S.is_bridge(6, 5));
+  EXPECT_FALSE(S.is_bridge(4, 5));
+  EXPECT_TRUE(S.same_bcc({0, 1}, {2, 1}));
+  EXPECT_FALSE(S.same_bcc({0, 1}, {2, 3}));
+  EXPECT_TRUE(S.same_bcc({4, 7}, {8, 5}));
+  EXPECT_TRUE(S.same_2ecc(4, 8));
+  EXPECT_FALSE(S.same_2ecc(5, 6));
+  EXPECT_EQ(S.num_blocks(5), 2);
+  CheckStructure(kNumVertices, kEdges, S);
+}
+
+TEST(BiconnectivityStructure, SmallGraphEulerTour) {
+  constexpr uintE kNumVertices{10};
+  const std::unordered_set<UndirectedEdge> kEdges{
+    {0, 1}, {0, 2}, {1, 2}, {2, 3},
+    {4, 5}, {4, 7}, {5, 8}, {7, 8}, {5, 6},
+  };
+  CheckBothForests(kNumVertices, kEdges);
+}
+
+TEST(BiconnectivityStructure, PseudorandomGraph) {
+  // A long cycle with chords and pendant trees, so that the forests have
+  // non-tree edges between ancestors and descendants.
+  constexpr uintE kNumVertices{200};
+  std::unordered_set<UndirectedEdge> edges;
+  graph_test::PseudorandomGenerator generator{1};
+  for (uintE v = 0; v + 1 < 120; v++) edges.insert({v, v + 1});
+  for (size_t i = 0; i < 30; i++) {
+    uintE u = generator.Next() % 120, v = generator.Next() % 120;
+    if (u != v) edges.insert({u, v});
+  }
+  for (uintE v = 120; v < kNumVertices - 5; v++) {
+    edges.insert({v, (uintE)(generator.Next() % v)});
+  }
+  CheckBothForests(kNumVertices, edges);
+}
+
+}  // namespace gbbs
@@ -32,8 +32,14 @@
 //     -rounds : the number of times to run the algorithm
 //     -fa : run the fetch-and-add implementation of k-core
 //     -nb : the number of buckets to use in the bucketing implementation
+//     --sparse --colors c : count on a colorful sparsification with c colors
+//     --trials t : average t independent colorings and report a 95%
+//                  confidence interval
+//     --err e, --budget s : add colorings until the interval is within a
+//                           fraction e of the estimate, or s seconds pass
 
 #include "Clique.h"
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/ApproxTriangle.h"
 #include <math.h>
 #include <fstream>
 
@@ -70,6 +76,12 @@ double AppKCore_runner(Graph& GA, commandLine P) {
 
   bool sparsify = P.getOptionValue("--sparse"); // if set, use colorful sparsification for approx counting
   long sparsify_denom = P.getOptionLongValue("--colors", 0); // number of colors for colorful sparsification
+  // Independent colorings to average, reporting a confidence interval. More
+  // colorings are added until the 95% interval is within --err of the
+  // estimate or --budget seconds are spent, if either is set.
+  long sparsify_trials = P.getOptionLongValue("--trials", 1);
+  double sparsify_err = P.getOptionDoubleValue("--err", 0.0);
+  double sparsify_budget = P.getOptionDoubleValue("--budget", 0.0);
 
   bool approx_peel = P.getOptionValue("--approxpeel"); // if set, use approximate vertex peeling
   double approx_eps = P.getOptionDoubleValue("--approxeps", 0.1); // epsilon for approximate vertex peeling
@@ -103,7 +115,26 @@ double AppKCore_runner(Graph& GA, commandLine P) {
   timer t; t.start();
 
   size_t count = 0;
-  if (sparsify) {
+  if (sparsify && (sparsify_trials > 1 || sparsify_err > 0 || sparsify_budget > 0)) {
+    sampling_params params;
+    params.min_samples = std::max(sparsify_trials, 2L);
+    params.max_samples = (sparsify_err > 0 || sparsify_budget > 0) ?
+        params.max_samples : params.min_samples;
+    params.relative_error = sparsify_err;
+    params.time_budget = sparsify_budget;
+    // Each trial counts on a sparsified copy, so GA is left intact.
+    auto draw = [&](size_t first, size_t num, double* out) {
+      for (size_t i = 0; i < num; i++) {
+        auto GA_sparse = clr_sparsify_graph_copy(GA, sparsify_denom, 7398234 + 7919 * (first + i));
+        out[i] = Clique(GA_sparse, k, order, epsilon, space, label, filter, use_base,
+                        recursive_level, approx_peel, approx_eps);
+        GA_sparse.del();
+      }
+    };
+    auto e = approx_triangle::estimate_mean(draw, pow(sparsify_denom, k-1), params);
+    std::cout << "### Estimated " << k << " cliques = " << e << std::endl;
+    count = std::llround(e.estimate);
+  } else if (sparsify) {
     // Sparsify graph, with random seed
     auto GA_sparse = clr_sparsify_graph(GA, sparsify_denom, 7398234);
 
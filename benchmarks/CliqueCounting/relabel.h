@@ -19,7 +19,7 @@ inline auto relabel_graph(asymmetric_graph<vertex, W>& G, uintE* rank, P& pred)
 template <
     template <class W> class vertex, class W, typename P,
     typename std::enable_if<
-        std::is_same<vertex<W>, cav_bytepd_amortized<W>>::value, int>::type = 0>
+        is_compressed_asymmetric_vertex<vertex<W>>::value, int>::type = 0>
 inline auto relabel_graph(asymmetric_graph<vertex, W>& G,uintE* rank, P& pred) -> decltype(G) {
   std::cout << "Filter graph not implemented for directed graphs" << std::endl;
   assert(false);  // Not implemented for directed graphs
@@ -29,24 +29,17 @@ inline auto relabel_graph(asymmetric_graph<vertex, W>& G,uintE* rank, P& pred) -
 
 template <template <class W> class vertex, class W, typename P,
           typename std::enable_if<
-              std::is_same<vertex<W>, csv_bytepd_amortized<W>>::value,
+              is_compressed_symmetric_vertex<vertex<W>>::value,
               int>::type = 0>
-inline symmetric_graph<csv_byte, W> relabel_graph(symmetric_graph<vertex, W>& GA, uintE* rank, P& pred) { // -> decltype(GA)
+inline symmetric_graph<vertex, W> relabel_graph(symmetric_graph<vertex, W>& GA, uintE* rank, P& pred) { // -> decltype(GA)
+  using C = typename vertex<W>::decoder;
   size_t n = GA.n;
   using edge = std::tuple<uintE, W>;
 
-  // 1. Calculate total size
-  auto degrees = sequence<uintE>(n);
-  auto byte_offsets = sequence<uintT>(n + 1);
-  parallel_for(0, n, [&] (size_t i) {
-    size_t total_bytes = 0;
-    uintE last_ngh = 0;
+  // Writes the relabeled out-neighbors of i satisfying pred to tmp_edges, in
+  // sorted order, and returns their number.
+  auto relabel_edges = [&] (size_t i, sequence<edge>& tmp_edges) {
     size_t deg = 0;
-    uchar tmp[16];
-
-    size_t prev_deg = GA.get_vertex(i).getOutDegree();
-    // here write out all of G's outneighbors to an uncompressed array, and then relabel and sort
-    auto tmp_edges = sequence<edge>(prev_deg);
     auto f = [&](uintE u, uintE v, W w) {
       if (pred(u, v, w)) {
         tmp_edges[deg] = std::make_tuple(rank[v], w);
@@ -55,29 +48,25 @@ inline symmetric_graph<csv_byte, W> relabel_graph(symmetric_graph<vertex, W>& GA
       return false;
     };
     GA.get_vertex(i).mapOutNgh(i, f, false);
-    // need to sort tmp_edges
     tmp_edges.shrink(deg);
     pbbslib::sample_sort (tmp_edges, [&](const edge u, const edge v) {
       return std::get<0>(u) < std::get<0>(v);
     }, true);
+    return deg;
+  };
 
-    // now need to compute total_bytes (TODO: this could be parallelized, b/c we know what last_ngh is)
-    for (size_t j=0; j < deg; j++) {
-      size_t bytes = 0;
-      auto v = std::get<0>(tmp_edges[j]);
-      auto wgh = std::get<1>(tmp_edges[j]);
-      if (j == 0) {
-        bytes = byte::compressFirstEdge(tmp, bytes, rank[i], v);
-        bytes = byte::compressWeight<W>(tmp, bytes, wgh);
-      } else {
-        bytes = byte::compressEdge(tmp, bytes, v - last_ngh);
-        bytes = byte::compressWeight<W>(tmp, bytes, wgh);
-      }
-      last_ngh = v;
-      total_bytes += bytes;
+  // 1. Calculate total size
+  auto degrees = sequence<uintE>(n);
+  auto byte_offsets = sequence<uintT>(n + 1);
+  parallel_for(0, n, [&] (size_t i) {
+    // here write out all of G's outneighbors to an uncompressed array, and then relabel and sort
+    auto tmp_edges = sequence<edge>(GA.get_vertex(i).getOutDegree());
+    size_t deg = relabel_edges(i, tmp_edges);
+    size_t total_bytes = 0;
+    if (deg > 0) {
+      auto iter = vertex_ops::get_iter(tmp_edges.begin(), deg);
+      total_bytes = C::template compressed_size<W>(deg, rank[i], iter);
     }
-    tmp_edges.clear();
-
     byte_offsets[rank[i]] = total_bytes;
     degrees[i] = deg;
   }, 1);
@@ -91,24 +80,10 @@ inline symmetric_graph<csv_byte, W> relabel_graph(symmetric_graph<vertex, W>& GA
   parallel_for(0, n, [&] (size_t i) {
     uintE deg = degrees[i];
     if (deg > 0) {
-      // here write out all of G's outneighbors to an uncompressed array, and then relabel and sort
-      auto tmp_edges = sequence<edge>(deg);
-      size_t j = 0;
-      auto f = [&](uintE u, uintE v, W w) {
-        if (pred(u, v, w)) {
-          tmp_edges[j] = std::make_tuple(rank[v], w);
-          j++;
-        }
-        return false;
-      };
-      GA.get_vertex(i).mapOutNgh(i, f, false);
-      // need to sort tmp_edges
-      pbbslib::sample_sort (tmp_edges, [&](const edge u, const edge v) {
-        return std::get<0>(u) < std::get<0>(v);
-      }, true);
-
+      auto tmp_edges = sequence<edge>(GA.get_vertex(i).getOutDegree());
+      relabel_edges(i, tmp_edges);
       auto iter = vertex_ops::get_iter(tmp_edges.begin(), deg);
-      byte::sequentialCompressEdgeSet<W>(
+      C::template sequentialCompressEdgeSet<W>(
           edges.begin() + byte_offsets[rank[i]], 0, deg, rank[i], iter);
     }
   }, 1);
@@ -125,7 +100,7 @@ inline symmetric_graph<csv_byte, W> relabel_graph(symmetric_graph<vertex, W>& GA
   uintT total_deg = pbbslib::reduce_add(deg_map);
   auto edge_arr = edges.to_array();
   std::cout << "# Filtered, total_deg = " << total_deg << "\n";
-  return symmetric_graph<csv_byte, W>(out_vdata, GA.n, total_deg,
+  return symmetric_graph<vertex, W>(out_vdata, GA.n, total_deg,
                             [=]() {pbbslib::free_arrays(out_vdata, edge_arr); },
                             edge_arr, edge_arr);
 }
@@ -213,4 +188,18 @@ auto clr_sparsify_graph(Graph& GA, size_t denom, long seed) {
   return GA; //sym_graph_from_edges(edges_seq, edges_seq.size());
 }
 
+// Same as clr_sparsify_graph (keeps the monochromatic edges), but returns the
+// sparsified graph as a copy and leaves GA unchanged, so that independent
+// colorings can be drawn.
+template <class Graph>
+auto clr_sparsify_graph_copy(Graph& GA, size_t denom, long seed) {
+  using W = typename Graph::weight_type;
+  uintE numColors = std::max((size_t) 1,denom);
+  sequence<uintE> colors = sequence<uintE>(GA.n, [&](size_t i){ return pbbs::hash64_2((uintE) seed+i) % numColors; });
+  auto pack_predicate = [&](const uintE& u, const uintE& v, const W& wgh) {
+    return colors[u] == colors[v];
+  };
+  return filterGraph(GA, pack_predicate);
+}
+
 }  // namespace gbbs
@@ -0,0 +1,97 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Usage:
+// numactl -i all ./runtime -s -sampling sample_kout -finish uf
+//     -unite unite_rem_cas -find find_naive -splice split_atomic_one <graph>
+// numactl -i all ./runtime -s -auto <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -auto : select the variant from graph statistics (timed with the run)
+//     -sampling, -finish, -unite, -find, -splice, -jayanti_find, -connect,
+//     -update, -shortcut : select the variant (see Framework/runtime.h)
+//     -sample_rounds : the number of k-out sampling rounds
+//     -r : the number of times to run the algorithm
+//     -check : check the output against WorkEfficientSDB14
+
+#include "benchmarks/Connectivity/Framework/runtime.h"
+#include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
+#include "benchmarks/Connectivity/BFSCC/Connectivity.h"
+#include "benchmarks/Connectivity/common.h"
+
+#include "bench_utils.h"
+
+namespace gbbs {
+
+template <class Graph>
+double Benchmark_runner(Graph& G, commandLine P) {
+  int rounds = P.getOptionIntValue("-r", 5);
+
+  auto correct = pbbs::sequence<parent>();
+  if (P.getOptionValue("-check")) {
+    correct = workefficient_cc::CC(G, 0.2, false, true);
+    RelabelDet(correct);
+  }
+
+  if (P.getOptionValue("-auto")) {
+    // Selection is part of every run, as the finish reuses its sample.
+    uint32_t sample_rounds = P.getOptionLongValue("-sample_rounds", 2);
+    auto test = [&] (Graph& graph, commandLine params, pbbs::sequence<parent>& correct_cc) {
+      connectit::graph_statistics stats;
+      connectit::connectit_options opts;
+      timer tt; tt.start();
+      auto CC = connectit::auto_CC(graph, sample_rounds, &stats, &opts);
+      double t = tt.stop();
+      std::cout << "# avg_degree = " << stats.avg_degree
+                << " max_degree = " << stats.max_degree
+                << " giant_fraction = " << stats.giant_fraction << std::endl;
+      std::cout << "# selected: " << connectit::options_to_string(opts) << std::endl;
+      if (params.getOptionValue("-check")) {
+        cc_check(correct_cc, CC);
+      }
+      return t;
+    };
+    run_multiple(G, rounds, correct, "auto", P, test);
+    return 1.0;
+  }
+
+  auto opts = connectit::options_from_command_line(P);
+  std::cout << "# selected: " << connectit::options_to_string(opts) << std::endl;
+
+  auto test = [&] (Graph& graph, commandLine params, pbbs::sequence<parent>& correct_cc) {
+    timer tt; tt.start();
+    auto CC = connectit::CC(graph, opts);
+    double t = tt.stop();
+    if (params.getOptionValue("-check")) {
+      cc_check(correct_cc, CC);
+    }
+    return t;
+  };
+  run_multiple(G, rounds, correct, connectit::options_to_string(opts), P, test);
+  return 1.0;
+}
+}  // namespace gbbs
+
+generate_symmetric_once_main(gbbs::Benchmark_runner, false);
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include "framework.h"
+#include "pbbslib/assert.h"
+
+/* ************************* Runtime-selected ConnectIt ************************
+ * Dispatches to the precompiled (sampling x finish) variants of the framework
+ * based on a runtime options struct, so that variants can be switched without
+ * rebuilding. */
+
+namespace gbbs {
+namespace connectit {
+
+  struct connectit_options {
+    SamplingOption sampling_option = sample_kout;
+    AlgorithmType algorithm_type = union_find_type;
+
+    /* union_find_type */
+    bool jayanti = false;  // use the Jayanti-Tarjan union-find instead
+    UniteOption unite_option = unite_rem_cas;
+    FindOption find_option = find_naive;
+    SpliceOption splice_option = split_atomic_one;  // rem_cas and rem_lock
+    JayantiFindOption jayanti_find_option = find_twotrysplit;
+
+    /* liu_tarjan_type */
+    LiuTarjanConnectOption connect_option = parent_connect;
+    LiuTarjanUpdateOption update_option = root_update;
+    LiuTarjanShortcutOption shortcut_option = full_shortcut;
+
+    /* sample_kout */
+    uint32_t sample_rounds = 2;
+  };
+
+  inline std::string options_to_string(const connectit_options& opts) {
+    switch (opts.algorithm_type) {
+      case union_find_type:
+        if (opts.jayanti) {
+          return jayanti_options_to_string(opts.sampling_option,
+                                           opts.jayanti_find_option);
+        } else if (opts.unite_option == unite_rem_cas ||
+                   opts.unite_option == unite_rem_lock) {
+          return uf_options_to_string(opts.sampling_option, opts.find_option,
+                                      opts.unite_option, opts.splice_option);
+        }
+        return uf_options_to_string(opts.sampling_option, opts.find_option,
+                                    opts.unite_option);
+      case liu_tarjan_type:
+        return liu_tarjan_options_to_string(
+            opts.sampling_option, opts.connect_option, opts.update_option,
+            opts.shortcut_option, no_alter);
+      case shiloach_vishkin_type:
+        return "shiloach_vishkin; sample=" +
+               sampling_to_string(opts.sampling_option);
+      case label_prop_type:
+        return "label_prop; sample=" + sampling_to_string(opts.sampling_option);
+    }
+    ABORT_INVALID_ENUM(AlgorithmType, opts.algorithm_type);
+  }
+
+  /* Reads the options from the same flags as the names of the enums, e.g.
+   *   -sampling sample_ldd -finish uf -unite unite_rem_cas -find find_naive
+   *   -splice split_atomic_one
+   *   -finish jayanti -jayanti_find find_simple
+   *   -finish liu_tarjan -connect parent_connect -update root_update
+   *   -shortcut full_shortcut
+   *   -finish sv | lp
+   * Unset flags keep the defaults of connectit_options. */
+  inline connectit_options options_from_command_line(commandLine& P) {
+    connectit_options opts;
+    opts.sampling_option = sampling_from_string(
+        P.getOptionValue("-sampling", sampling_to_string(opts.sampling_option)));
+    auto finish = P.getOptionValue("-finish", "uf");
+    if (finish == "uf" || finish == "jayanti") {
+      opts.algorithm_type = union_find_type;
+      opts.jayanti = (finish == "jayanti");
+    } else if (finish == "liu_tarjan") {
+      opts.algorithm_type = liu_tarjan_type;
+    } else if (finish == "sv") {
+      opts.algorithm_type = shiloach_vishkin_type;
+    } else if (finish == "lp") {
+      opts.algorithm_type = label_prop_type;
+    } else {
+      ABORT("Unexpected -finish: " << finish);
+    }
+    opts.unite_option = unite_from_string(
+        P.getOptionValue("-unite", unite_to_string(opts.unite_option)));
+    opts.find_option = find_from_string(
+        P.getOptionValue("-find", find_to_string(opts.find_option)));
+    opts.splice_option = splice_from_string(
+        P.getOptionValue("-splice", splice_to_string(opts.splice_option)));
+    opts.jayanti_find_option = jayanti_find_from_string(P.getOptionValue(
+        "-jayanti_find", jayanti_find_to_string(opts.jayanti_find_option)));
+    opts.connect_option = connect_from_string(
+        P.getOptionValue("-connect", connect_to_string(opts.connect_option)));
+    opts.update_option = update_from_string(
+        P.getOptionValue("-update", update_to_string(opts.update_option)));
+    opts.shortcut_option = shortcut_from_string(
+        P.getOptionValue("-shortcut", shortcut_to_string(opts.shortcut_option)));
+    opts.sample_rounds = P.getOptionLongValue("-sample_rounds", opts.sample_rounds);
+    return opts;
+  }
+
+  namespace runtime {
+
+  /* The samplers read their parameters from a commandLine; this builds one
+   * holding the options that they read. */
+  struct sampler_params {
+    std::string rounds;
+    char* argv[3];
+    commandLine P;
+    sampler_params(const connectit_options& opts) :
+      rounds(std::to_string(opts.sample_rounds)),
+      argv{const_cast<char*>("connectit"),
+           const_cast<char*>("-sample_rounds"),
+           const_cast<char*>(rounds.c_str())},
+      P(3, argv) {}
+  };
+
+  template <
+    class Graph,
+    SamplingOption sampling_option,
+    UniteOption unite_option,
+    FindOption find_option>
+  pbbs::sequence<parent> dispatch_splice(
+      Graph& G,
+      const connectit_options& opts,
+      commandLine& P) {
+    if constexpr (unite_option == unite_rem_cas || unite_option == unite_rem_lock) {
+      switch (opts.splice_option) {
+        case split_atomic_one:
+          return run_uf_alg<Graph, sampling_option, find_option, unite_option, split_atomic_one>(G, P);
+        case halve_atomic_one:
+          return run_uf_alg<Graph, sampling_option, find_option, unite_option, halve_atomic_one>(G, P);
+        case splice_atomic:
+          return run_uf_alg<Graph, sampling_option, find_option, unite_option, splice_atomic>(G, P);
+        default:
+          ABORT("Unsupported splice option: " << splice_to_string(opts.splice_option));
+      }
+    } else {
+      return run_uf_alg<Graph, sampling_option, find_option, unite_option>(G, P);
+    }
+  }
+
+  template <
+    class Graph,
+    SamplingOption sampling_option,
+    UniteOption unite_option>
+  pbbs::sequence<parent> dispatch_find(
+      Graph& G,
+      const connectit_options& opts,
+      commandLine& P) {
+    switch (opts.find_option) {
+      case find_naive:
+        return dispatch_splice<Graph, sampling_option, unite_option, find_naive>(G, opts, P);
+      case find_compress:
+        return dispatch_splice<Graph, sampling_option, unite_option, find_compress>(G, opts, P);
+      case find_atomic_split:
+        return dispatch_splice<Graph, sampling_option, unite_option, find_atomic_split>(G, opts, P);
+      case find_atomic_halve:
+        return dispatch_splice<Graph, sampling_option, unite_option, find_atomic_halve>(G, opts, P);
+      default:
+        ABORT("Unsupported find option: " << find_to_string(opts.find_option));
+    }
+  }
+
+  template <class Graph, SamplingOption sampling_option>
+  pbbs::sequence<parent> dispatch_union_find(
+      Graph& G,
+      const connectit_options& opts,
+      commandLine& P) {
+    if (opts.jayanti) {
+      if (opts.jayanti_find_option == find_twotrysplit) {
+        return run_jayanti_alg<Graph, sampling_option, find_twotrysplit>(G, P);
+      }
+      return run_jayanti_alg<Graph, sampling_option, find_simple>(G, P);
+    }
+    switch (opts.unite_option) {
+      case unite:
+        return dispatch_find<Graph, sampling_option, unite>(G, opts, P);
+      case unite_early:
+        return dispatch_find<Graph, sampling_option, unite_early>(G, opts, P);
+      case unite_nd:
+        return dispatch_find<Graph, sampling_option, unite_nd>(G, opts, P);
+      case unite_rem_lock:
+        return dispatch_find<Graph, sampling_option, unite_rem_lock>(G, opts, P);
+      case unite_rem_cas:
+        return dispatch_find<Graph, sampling_option, unite_rem_cas>(G, opts, P);
+    }
+    ABORT_INVALID_ENUM(UniteOption, opts.unite_option);
+  }
+
+  /* Only the Liu-Tarjan variants without alter that the framework benchmarks
+   * (mains/liutarjan_*.cc) run on the CPU are precompiled. */
+  template <class Graph, SamplingOption sampling_option>
+  pbbs::sequence<parent> dispatch_liu_tarjan(
+      Graph& G,
+      const connectit_options& opts,
+      commandLine& P) {
+    auto c = opts.connect_option;
+    auto u = opts.update_option;
+    auto s = opts.shortcut_option;
+    if (c == parent_connect && u == simple_update && s == shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, parent_connect, simple_update, shortcut, no_alter>(G, P);
+    } else if (c == parent_connect && u == simple_update && s == full_shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, parent_connect, simple_update, full_shortcut, no_alter>(G, P);
+    } else if (c == parent_connect && u == root_update && s == shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, parent_connect, root_update, shortcut, no_alter>(G, P);
+    } else if (c == parent_connect && u == root_update && s == full_shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, parent_connect, root_update, full_shortcut, no_alter>(G, P);
+    } else if (c == extended_connect && u == simple_update && s == shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, extended_connect, simple_update, shortcut, no_alter>(G, P);
+    } else if (c == extended_connect && u == simple_update && s == full_shortcut) {
+      return run_liu_tarjan_alg<Graph, sampling_option, extended_connect, simple_update, full_shortcut, no_alter>(G, P);
+    }
+    ABORT("Unsupported Liu-Tarjan variant: " << liu_tarjan_options_to_string(
+        sampling_option, c, u, s, no_alter));
+  }
+
+  template <class Graph, SamplingOption sampling_option>
+  pbbs::sequence<parent> dispatch_finish(
+      Graph& G,
+      const connectit_options& opts,
+      commandLine& P) {
+    switch (opts.algorithm_type) {
+      case union_find_type:
+        return dispatch_union_find<Graph, sampling_option>(G, opts, P);
+      case liu_tarjan_type:
+        return dispatch_liu_tarjan<Graph, sampling_option>(G, opts, P);
+      case shiloach_vishkin_type:
+        return run_sample_only_alg<Graph, sampling_option,
+               shiloachvishkin_cc::SVAlgorithm, shiloach_vishkin_type>(G, P);
+      case label_prop_type:
+        return run_sample_only_alg<Graph, sampling_option,
+               labelprop_cc::LPAlgorithm, label_prop_type>(G, P);
+    }
+    ABORT_INVALID_ENUM(AlgorithmType, opts.algorithm_type);
+  }
+
+  }  // namespace runtime
+
+  /* Returns the connected components of G, as a parents array in which
+   * vertices in the same component have the same label, using the variant
+   * described by opts. */
+  template <class Graph>
+  pbbs::sequence<parent> CC(Graph& G, const connectit_options& opts) {
+    auto params = runtime::sampler_params(opts);
+    auto& P = params.P;
+    switch (opts.sampling_option) {
+      case sample_kout:
+        return runtime::dispatch_finish<Graph, sample_kout>(G, opts, P);
+      case sample_bfs:
+        return runtime::dispatch_finish<Graph, sample_bfs>(G, opts, P);
+      case sample_ldd:
+        return runtime::dispatch_finish<Graph, sample_ldd>(G, opts, P);
+      case no_sampling:
+        return runtime::dispatch_finish<Graph, no_sampling>(G, opts, P);
+    }
+    ABORT_INVALID_ENUM(SamplingOption, opts.sampling_option);
+  }
+
+  /* ******************************* Auto mode ****************************** */
+
+  struct graph_statistics {
+    size_t n = 0;
+    size_t m = 0;
+    double avg_degree = 0;
+    uintE max_degree = 0;
+    double isolated_fraction = 0;  // fraction of degree-0 vertices
+    double giant_fraction = 0;     // k-out estimate of the largest component
+  };
+
+  /* Collects the statistics that select_options uses. The giant component
+   * fraction is estimated by a k-out sampling pass, which costs a small
+   * constant number of edges per vertex. If sample is non-null, the k-out
+   * labeling is returned in it so that the finish can reuse it (see
+   * auto_CC). */
+  template <class Graph>
+  graph_statistics compute_statistics(Graph& G, uint32_t sample_rounds = 2,
+                                      pbbs::sequence<parent>* sample = nullptr) {
+    graph_statistics stats;
+    size_t n = G.n;
+    stats.n = n;
+    stats.m = G.m;
+    if (n == 0) return stats;
+    stats.avg_degree = static_cast<double>(G.m) / n;
+    auto degrees = pbbs::delayed_seq<uintE>(n, [&] (size_t i) {
+      return G.get_vertex(i).getOutDegree();
+    });
+    stats.max_degree = pbbslib::reduce_max(degrees);
+    auto isolated = pbbs::delayed_seq<size_t>(n, [&] (size_t i) {
+      return static_cast<size_t>(degrees[i] == 0);
+    });
+    stats.isolated_fraction =
+        static_cast<double>(pbbslib::reduce_add(isolated)) / n;
+
+    auto params = runtime::sampler_params(connectit_options());
+    auto sampler = KOutSamplingTemplate<Graph>(G, params.P, sample_rounds);
+    auto parents = sampler.initial_components();
+    stats.giant_fraction = sample_frequent_element(parents).second;
+    if (sample) *sample = std::move(parents);
+    return stats;
+  }
+
+  /* Picks a variant from the graph statistics, following the ConnectIt
+   * evaluation: k-out sampling with Rem-CAS is the fastest whenever the
+   * sample finds a giant component. Otherwise sparse graphs are likely to
+   * have a high diameter, where LDD shrinks the graph the most, graphs with
+   * very skewed degrees have a low diameter, where a BFS from a random vertex
+   * covers most of a giant component, and the remaining dense graphs with no
+   * giant component are finished directly with Liu-Tarjan, which needs few
+   * rounds over the edges in this case. */
+  inline connectit_options select_options(const graph_statistics& stats,
+                                          uint32_t sample_rounds = 2) {
+    connectit_options opts;
+    opts.sample_rounds = sample_rounds;
+    opts.algorithm_type = union_find_type;
+    opts.unite_option = unite_rem_cas;
+    opts.splice_option = split_atomic_one;
+    double non_isolated = 1.0 - stats.isolated_fraction;
+    if (stats.giant_fraction >= 0.1 * non_isolated) {
+      opts.sampling_option = sample_kout;
+      opts.find_option = find_naive;
+    } else if (stats.avg_degree <= 4.0) {
+      opts.sampling_option = sample_ldd;
+      opts.find_option = find_atomic_split;
+    } else if (stats.max_degree >= std::sqrt(static_cast<double>(stats.n))) {
+      opts.sampling_option = sample_bfs;
+      opts.find_option = find_naive;
+    } else {
+      opts.sampling_option = no_sampling;
+      opts.algorithm_type = liu_tarjan_type;
+      opts.connect_option = parent_connect;
+      opts.update_option = root_update;
+      opts.shortcut_option = full_shortcut;
+    }
+    return opts;
+  }
+
+  template <class Graph>
+  connectit_options auto_options(Graph& G, uint32_t sample_rounds = 2) {
+    return select_options(compute_statistics(G, sample_rounds), sample_rounds);
+  }
+
+  namespace runtime {
+
+  /* A sampler that hands out a labeling that was already computed. */
+  struct precomputed_sampling {
+    pbbs::sequence<parent>& parents;
+    pbbs::sequence<parent> initial_components() { return std::move(parents); }
+  };
+
+  }  // namespace runtime
+
+  /* Selects the variant as auto_options does and returns the connected
+   * components of G. When k-out sampling is selected, the finish starts from
+   * the k-out sample drawn for the statistics instead of sampling again. The
+   * statistics and the selected variant are returned in stats and selected
+   * if they are non-null. */
+  template <class Graph>
+  pbbs::sequence<parent> auto_CC(Graph& G, uint32_t sample_rounds = 2,
+                                 graph_statistics* stats = nullptr,
+                                 connectit_options* selected = nullptr) {
+    auto sample = pbbs::sequence<parent>();
+    auto st = compute_statistics(G, sample_rounds, &sample);
+    auto opts = select_options(st, sample_rounds);
+    if (stats) *stats = st;
+    if (selected) *selected = opts;
+    if (opts.sampling_option != sample_kout) {
+      return CC(G, opts);
+    }
+    /* The k-out variant that select_options picks. */
+    assert(opts.algorithm_type == union_find_type && !opts.jayanti &&
+           opts.unite_option == unite_rem_cas &&
+           opts.find_option == find_naive &&
+           opts.splice_option == split_atomic_one);
+    auto find = get_find_function<find_naive>();
+    auto splice = get_splice_function<split_atomic_one>();
+    auto unite = get_unite_function<unite_rem_cas, decltype(find),
+         decltype(splice), find_naive>(G.n, find, splice);
+    using UF = union_find::UFAlgorithm<decltype(find), decltype(unite), Graph>;
+    auto alg = UF(G, unite, find);
+    auto sampler = runtime::precomputed_sampling{sample};
+    auto connectivity = SamplingAlgorithmTemplate<Graph, decltype(sampler), UF,
+         union_find_type, sample_kout>(G, sampler, alg);
+    return connectivity.components();
+  }
+
+}  // namespace connectit
+}  // namespace gbbs
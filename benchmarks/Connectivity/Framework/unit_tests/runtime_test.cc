@@ -0,0 +1,96 @@
+#include "benchmarks/Connectivity/Framework/runtime.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Checks that labels induces the same partition as a sequential union-find
+// over the edges.
+void CheckComponents(uintE n, const std::unordered_set<UndirectedEdge>& edges,
+                     const pbbs::sequence<parent>& labels) {
+  graph_test::SequentialUnionFind components{n};
+  for (const auto& e : edges) {
+    components.Unite(e.endpoints().first, e.endpoints().second);
+  }
+  ASSERT_EQ(labels.size(), n);
+  std::unordered_map<uintE, parent> root_to_label;
+  std::unordered_map<parent, uintE> label_to_root;
+  for (uintE u = 0; u < n; u++) {
+    auto r = components.Find(u);
+    auto l = labels[u];
+    EXPECT_EQ(root_to_label.emplace(r, l).first->second, l) << "vertex " << u;
+    EXPECT_EQ(label_to_root.emplace(l, r).first->second, r) << "vertex " << u;
+  }
+}
+
+}  // namespace
+
+TEST(SelectOptions, PicksKOutWithAGiantComponent) {
+  connectit::graph_statistics stats;
+  stats.n = 1000;
+  stats.avg_degree = 2;
+  stats.giant_fraction = 0.5;
+  auto opts = connectit::select_options(stats);
+  EXPECT_EQ(opts.sampling_option, sample_kout);
+  EXPECT_EQ(opts.algorithm_type, union_find_type);
+  EXPECT_EQ(opts.unite_option, unite_rem_cas);
+}
+
+TEST(SelectOptions, PicksByDegreesWithoutAGiantComponent) {
+  connectit::graph_statistics stats;
+  stats.n = 10000;
+  stats.giant_fraction = 0.001;
+
+  stats.avg_degree = 2;
+  stats.max_degree = 10;
+  EXPECT_EQ(connectit::select_options(stats).sampling_option, sample_ldd);
+
+  stats.avg_degree = 20;
+  stats.max_degree = 1000;
+  EXPECT_EQ(connectit::select_options(stats).sampling_option, sample_bfs);
+
+  stats.max_degree = 50;
+  auto opts = connectit::select_options(stats);
+  EXPECT_EQ(opts.sampling_option, no_sampling);
+  EXPECT_EQ(opts.algorithm_type, liu_tarjan_type);
+}
+
+TEST(AutoCC, ReusesTheKOutSampleOnAGiantComponent) {
+  constexpr uintE kNumVertices{2000};
+  auto edges = graph_test::PseudorandomEdges(kNumVertices, 6000, 1);
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  alloc_init(graph);
+
+  connectit::graph_statistics stats;
+  connectit::connectit_options opts;
+  auto labels = connectit::auto_CC(graph, 2, &stats, &opts);
+  EXPECT_GT(stats.giant_fraction, 0.1);
+  EXPECT_EQ(opts.sampling_option, sample_kout);
+  CheckComponents(kNumVertices, edges, labels);
+}
+
+TEST(AutoCC, FinishesSmallComponents) {
+  constexpr uintE kNumVertices{2000};
+  std::unordered_set<UndirectedEdge> edges;
+  for (uintE i = 0; i + 2 < kNumVertices; i += 4) {
+    edges.insert({i, i + 1});
+    edges.insert({i + 1, i + 2});
+  }
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  alloc_init(graph);
+
+  connectit::connectit_options opts;
+  auto labels = connectit::auto_CC(graph, 2, nullptr, &opts);
+  EXPECT_EQ(opts.sampling_option, sample_ldd);
+  CheckComponents(kNumVertices, edges, labels);
+}
+
+}  // namespace gbbs
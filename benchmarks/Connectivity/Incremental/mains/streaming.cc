@@ -0,0 +1,195 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Mixed read/write benchmark for StreamingConnectivity: the main thread
+// inserts the sampled edges in batches while query threads issue random
+// connected(u, v) queries, and the query latency percentiles are reported.
+//
+// Usage:
+// numactl -i all ./streaming -s -batch_size 100000 -query_threads 4 <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -update_pct : fraction of edges to insert (default 1)
+//     -batch_size : number of edges per batch
+//     -query_threads : number of threads issuing queries concurrently
+//     -find : find_twotrysplit (default) or find_simple
+//     -r : the number of times to run the benchmark
+//     -check : check the final components against a sequential union-find
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/Connectivity/Incremental/streaming.h"
+#include "benchmarks/Connectivity/Framework/mains/check.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace connectit {
+
+template <class SC, class Seq>
+void run_streaming(SC& sc, Seq& updates, size_t batch_size,
+    size_t query_threads, size_t round, commandLine& P) {
+  size_t n = sc.n;
+  size_t m = updates.size();
+  size_t n_batches = (m + batch_size - 1) / batch_size;
+
+  std::atomic<bool> done(false);
+  std::vector<std::vector<double>> latencies(query_threads);
+  std::vector<size_t> num_connected(query_threads, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < query_threads; t++) {
+    threads.emplace_back([&, t] () {
+      auto rr = pbbs::random(round).fork(t);
+      size_t i = 0;
+      auto& lat = latencies[t];
+      while (!done.load(std::memory_order_relaxed)) {
+        uintE u = rr.ith_rand(2 * i) % n;
+        uintE v = rr.ith_rand(2 * i + 1) % n;
+        auto st = std::chrono::steady_clock::now();
+        bool c = sc.connected(u, v);
+        auto et = std::chrono::steady_clock::now();
+        lat.push_back(std::chrono::duration<double, std::micro>(et - st).count());
+        num_connected[t] += c;
+        i++;
+      }
+    });
+  }
+
+  timer tt; tt.start();
+  std::vector<double> batch_times;
+  for (size_t i = 0; i < n_batches; i++) {
+    auto batch = updates.slice(i * batch_size, std::min((i + 1) * batch_size, m));
+    timer bt; bt.start();
+    sc.insert_batch(batch);
+    batch_times.push_back(bt.stop());
+  }
+  double t = tt.stop();
+  done = true;
+  for (auto& th : threads) th.join();
+
+  std::vector<double> all;
+  size_t connected = 0;
+  for (size_t i = 0; i < query_threads; i++) {
+    all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+    connected += num_connected[i];
+  }
+  std::sort(all.begin(), all.end());
+  auto pct = [&] (double p) {
+    if (all.empty()) return 0.0;
+    return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+  };
+  std::sort(batch_times.begin(), batch_times.end());
+
+  std::cout << "{" << std::endl;
+  std::cout << "  \"test_type\": \"streaming_connectivity_result\"," << std::endl;
+  std::cout << "  \"graph\" : \"" << P.getArgument(0) << "\"," << std::endl;
+  std::cout << "  \"batch_size\" : " << batch_size << "," << std::endl;
+  std::cout << "  \"num_batches\" : " << n_batches << "," << std::endl;
+  std::cout << "  \"query_threads\" : " << query_threads << "," << std::endl;
+  std::cout << "  \"update_time\" : " << t << "," << std::endl;
+  std::cout << "  \"update_throughput\" : " << (m / t) << "," << std::endl;
+  std::cout << "  \"med_batch_time\" : "
+            << (batch_times.empty() ? 0.0 : batch_times[batch_times.size() / 2]) << "," << std::endl;
+  std::cout << "  \"num_queries\" : " << all.size() << "," << std::endl;
+  std::cout << "  \"query_throughput\" : " << (all.size() / t) << "," << std::endl;
+  std::cout << "  \"connected_fraction\" : "
+            << (all.empty() ? 0.0 : static_cast<double>(connected) / all.size()) << "," << std::endl;
+  std::cout << "  \"query_latency_us_p50\" : " << pct(0.5) << "," << std::endl;
+  std::cout << "  \"query_latency_us_p90\" : " << pct(0.9) << "," << std::endl;
+  std::cout << "  \"query_latency_us_p99\" : " << pct(0.99) << "," << std::endl;
+  std::cout << "  \"query_latency_us_p999\" : " << pct(0.999) << "," << std::endl;
+  std::cout << "  \"query_latency_us_max\" : " << (all.empty() ? 0.0 : all.back()) << std::endl;
+  std::cout << "}" << std::endl;
+}
+
+template <class Seq>
+void check_streaming(pbbs::sequence<parent>& labels, Seq& updates, size_t n) {
+  auto correct = pbbs::sequence<parent>(n, [&] (size_t i) { return i; });
+  auto find = [&] (parent x) {
+    while (correct[x] != x) {
+      correct[x] = correct[correct[x]];
+      x = correct[x];
+    }
+    return x;
+  };
+  for (size_t i = 0; i < updates.size(); i++) {
+    parent u = find(std::get<0>(updates[i]));
+    parent v = find(std::get<1>(updates[i]));
+    if (u != v) correct[std::max(u, v)] = std::min(u, v);
+  }
+  for (size_t i = 0; i < n; i++) correct[i] = find(i);
+  RelabelDet(correct);
+  cc_check(correct, labels);
+}
+
+template <JayantiFindOption find_option, class Seq>
+void run_streaming_rounds(size_t n, Seq& updates, commandLine& P) {
+  int rounds = P.getOptionIntValue("-r", 3);
+  size_t batch_size = P.getOptionLongValue("-batch_size", 100000);
+  size_t query_threads = P.getOptionLongValue("-query_threads", 1);
+  std::cout << "# " << jayanti_options_to_string(no_sampling, find_option) << std::endl;
+  for (int i = 0; i < rounds; i++) {
+    auto sc = make_streaming_connectivity<find_option>(n);
+    run_streaming(sc, updates, batch_size, query_threads, i, P);
+    if (P.getOptionValue("-check")) {
+      auto labels = sc.components();
+      check_streaming(labels, updates, n);
+    }
+  }
+}
+
+}  // namespace connectit
+
+template <class Graph>
+double Streaming_runner(Graph& G, commandLine P) {
+  using W = typename Graph::weight_type;
+  double update_pct = P.getOptionDoubleValue("-update_pct", 1.0);
+  auto hash_to_double = [&] (const uintE& u, const uintE& v) -> double {
+    size_t hashed_v = pbbs::hash64((static_cast<size_t>(u) << 32UL) + static_cast<size_t>(v));
+    return static_cast<double>(hashed_v) / static_cast<double>(std::numeric_limits<size_t>::max());
+  };
+  auto update_pred = [&] (const uintE& u, const uintE& v, const W& wgh) {
+    return u < v && hash_to_double(u, v) < update_pct;
+  };
+  auto updates_arr = sampleEdges(G, update_pred);
+  auto updates = pbbs::sequence<std::tuple<uintE, uintE>>(updates_arr.m, [&] (size_t i) {
+    return std::make_tuple(std::get<0>(updates_arr.E[i]), std::get<1>(updates_arr.E[i]));
+  });
+  updates_arr.del();
+  updates = pbbs::random_shuffle(updates);
+  std::cout << "# inserting " << updates.size() << " edges" << std::endl;
+
+  if (P.getOptionValue("-find", "find_twotrysplit") == "find_simple") {
+    connectit::run_streaming_rounds<find_simple>(G.n, updates, P);
+  } else {
+    connectit::run_streaming_rounds<find_twotrysplit>(G.n, updates, P);
+  }
+  return 1.0;
+}
+}  // namespace gbbs
+
+generate_symmetric_once_main(gbbs::Streaming_runner, false);
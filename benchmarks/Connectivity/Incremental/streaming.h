@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+
+#include "benchmarks/Connectivity/UnionFind/jayanti.h"
+#include "benchmarks/Connectivity/common.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace connectit {
+
+  /* Incremental connectivity that answers queries concurrently with batched
+   * edge insertions, based on the randomized linking-by-rank union-find of
+   * Jayanti, Tarjan, and Boix-Adserà (UnionFind/jayanti.h).
+   *
+   * insert_batch processes a batch of edges with the parallel scheduler and
+   * must be called by one thread at a time. connected and component may be
+   * called at any time from any number of threads, including threads that are
+   * not scheduler workers; they only read and shortcut the forest (the finds
+   * are wait-free reads plus CASs), so they never block an update. Both are
+   * linearizable: connected(u, v) returns the answer at some point during the
+   * call, and component(v) returns the representative of v's component at
+   * some point during the call. Representatives change as components merge,
+   * so component ids are only comparable between calls made while no batch
+   * is running. */
+  template <class Find>
+  struct StreamingConnectivity {
+    size_t n;
+    Find find;
+    pbbs::sequence<jayanti_rank::vdata> vdatas;
+    pbbs::random r;
+    std::atomic<size_t> num_batches;
+    std::atomic<size_t> num_inserted;
+
+    StreamingConnectivity(size_t n, Find find) :
+      n(n), find(find), num_batches(0), num_inserted(0) {
+      vdatas = pbbs::sequence<jayanti_rank::vdata>(n);
+      parallel_for(0, n, [&] (size_t i) {
+        vdatas[i] = jayanti_rank::vdata(/* parent */ i, /* rank */ 1, /* is_root */ true);
+      });
+    }
+
+    /* Inserts the edges (u, v) of batch, a sequence of std::tuple<uintE,
+     * uintE> (or any type with std::get<0> and std::get<1>). */
+    template <class Seq>
+    void insert_batch(Seq& batch) {
+      auto batch_r = r;
+      parallel_for(0, batch.size(), [&] (size_t i) {
+        uintE u = std::get<0>(batch[i]);
+        uintE v = std::get<1>(batch[i]);
+        jayanti_rank::unite(u, v, vdatas, batch_r.fork(i), find);
+      }, 512);
+      r = r.next();
+      num_inserted += batch.size();
+      num_batches++;
+    }
+
+    /* The roots found for u and v were roots at the times that the finds
+     * returned. If u is still a root after v's root was found, the two were
+     * distinct roots at that time, so u and v were disconnected; otherwise u
+     * was linked in the meantime and we retry. */
+    bool connected(uintE u, uintE v) {
+      while (true) {
+        u = find(u, vdatas);
+        v = find(v, vdatas);
+        if (u == v) return true;
+        if (vdatas[u].is_root()) return false;
+      }
+    }
+
+    uintE component(uintE v) {
+      return find(v, vdatas);
+    }
+
+    /* Returns the component labels of all vertices. Only meaningful while no
+     * batch is running. */
+    pbbs::sequence<parent> components() {
+      return pbbs::sequence<parent>(n, [&] (size_t i) { return find(i, vdatas); });
+    }
+
+    /* Number of components; only meaningful while no batch is running. */
+    size_t num_components() {
+      auto roots = pbbs::delayed_seq<size_t>(n, [&] (size_t i) {
+        return static_cast<size_t>(vdatas[i].is_root());
+      });
+      return pbbslib::reduce_add(roots);
+    }
+  };
+
+  template <JayantiFindOption find_option = find_twotrysplit>
+  auto make_streaming_connectivity(size_t n) {
+    if constexpr (find_option == find_twotrysplit) {
+      auto find = jayanti_rank::find_twotry_splitting;
+      return StreamingConnectivity<decltype(find)>(n, find);
+    } else {
+      auto find = jayanti_rank::find;
+      return StreamingConnectivity<decltype(find)>(n, find);
+    }
+  }
+
+}  // namespace connectit
+}  // namespace gbbs
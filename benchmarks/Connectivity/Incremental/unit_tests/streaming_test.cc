@@ -0,0 +1,101 @@
+#include "benchmarks/Connectivity/Incremental/streaming.h"
+
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using graph_test::PseudorandomGenerator;
+using graph_test::SequentialUnionFind;
+using edge = std::tuple<uintE, uintE>;
+
+pbbs::sequence<edge> RandomBatch(PseudorandomGenerator& rng, uintE n,
+                                 size_t size) {
+  auto batch = pbbs::sequence<edge>(size);
+  for (size_t i = 0; i < size; i++) {
+    uintE u = rng.Next() % n;
+    uintE v = rng.Next() % n;
+    batch[i] = edge(u, v);
+  }
+  return batch;
+}
+
+}  // namespace
+
+TEST(StreamingConnectivity, InterleavedInsertsAndQueriesMatchUnionFind) {
+  constexpr uintE kNumVertices{5000};
+  auto sc = connectit::make_streaming_connectivity(kNumVertices);
+  SequentialUnionFind expected(kNumVertices);
+  PseudorandomGenerator rng{7};
+  for (size_t b = 0; b < 40; b++) {
+    auto batch = RandomBatch(rng, kNumVertices, (b % 3 == 0) ? 1 : 100);
+    sc.insert_batch(batch);
+    for (const auto& [u, v] : batch) expected.Unite(u, v);
+
+    for (size_t q = 0; q < 500; q++) {
+      uintE u = rng.Next() % kNumVertices, v = rng.Next() % kNumVertices;
+      ASSERT_EQ(sc.connected(u, v), expected.Connected(u, v))
+          << "batch " << b << " query (" << u << ", " << v << ")";
+    }
+    size_t num_components = 0;
+    for (uintE u = 0; u < kNumVertices; u++) {
+      num_components += (expected.Find(u) == u);
+    }
+    ASSERT_EQ(sc.num_components(), num_components) << "batch " << b;
+  }
+
+  auto labels = sc.components();
+  for (uintE u = 0; u < kNumVertices; u++) {
+    EXPECT_EQ(labels[u], labels[expected.Find(u)]);
+  }
+  EXPECT_EQ(sc.num_batches, 40);
+}
+
+// Queries that overlap a batch must return an answer that held at some point
+// during the batch: connected before it implies true, disconnected after it
+// implies false.
+TEST(StreamingConnectivity, ConcurrentQueriesAreBetweenBatches) {
+  constexpr uintE kNumVertices{2000};
+  constexpr size_t kNumBatches{30};
+  auto sc = connectit::make_streaming_connectivity(kNumVertices);
+  std::vector<SequentialUnionFind> after(kNumBatches + 1,
+                                         SequentialUnionFind(kNumVertices));
+  std::vector<pbbs::sequence<edge>> batches;
+  PseudorandomGenerator rng{11};
+  for (size_t b = 0; b < kNumBatches; b++) {
+    batches.push_back(RandomBatch(rng, kNumVertices, 60));
+    after[b + 1] = after[b];
+    for (const auto& [u, v] : batches[b]) after[b + 1].Unite(u, v);
+  }
+
+  std::atomic<size_t> completed{0};
+  std::atomic<bool> done{false};
+  std::atomic<size_t> violations{0};
+  std::thread query_thread([&] {
+    PseudorandomGenerator qrng{13};
+    while (!done.load()) {
+      uintE u = qrng.Next() % kNumVertices, v = qrng.Next() % kNumVertices;
+      size_t before = completed.load();
+      bool answer = sc.connected(u, v);
+      size_t end = std::min(completed.load() + 1, kNumBatches);
+      if (answer && !after[end].Connected(u, v)) violations++;
+      if (!answer && after[before].Connected(u, v)) violations++;
+    }
+  });
+  for (size_t b = 0; b < kNumBatches; b++) {
+    sc.insert_batch(batches[b]);
+    completed++;
+  }
+  done = true;
+  query_thread.join();
+  EXPECT_EQ(violations, 0);
+}
+
+}  // namespace gbbs
@@ -35,7 +35,17 @@ double CC_runner(Graph& G, commandLine P) {
 
   timer t;
   t.start();
-  if (P.getOptionValue("-permute")) {
+  if (P.getOptionValue("-tiled")) {
+    // Run label propagation over a tiled edge array (COO) built from G.
+    using W = typename Graph::weight_type;
+    size_t tile_bits = P.getOptionLongValue("-tile_bits",
+        tile_bits_for_cache(sizeof(parent)));
+    auto order = P.getOptionValue("-grid") ? grid_order : hilbert_order;
+    auto TG = to_tiled_edge_array<W>(G, tile_bits, order);
+    t.stop(); t.reportTotal("tiling time");
+    t.start();
+    auto components = labelprop_cc::CC</*use_permutation=*/false>(TG);
+  } else if (P.getOptionValue("-permute")) {
     auto components = labelprop_cc::CC</*use_permutation=*/true>(G);
   } else {
     auto components = labelprop_cc::CC</*use_permutation=*/false>(G);
@@ -31,6 +31,10 @@
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
 //     -stats : print the #ccs, and the #vertices in the largest cc
+//     -tiled : run over a tiled edge array (COO) built from the graph
+//     -tile_bits : the log of the tile side length used by -tiled (by
+//                  default, the tiles are sized for the L2 cache)
+//     -grid : lay out the tiles in row-major order instead of Hilbert order
 
 #include "Connectivity.h"
 
@@ -47,7 +51,19 @@ double CC_runner(Graph& G, commandLine P) {
 
   timer t;
   t.start();
-  auto components = gbbs::simple_union_find::SimpleUnionAsync(G);
+  sequence<parent> components;
+  if (P.getOptionValue("-tiled")) {
+    using W = typename Graph::weight_type;
+    size_t tile_bits = P.getOptionLongValue("-tile_bits",
+        tile_bits_for_cache(sizeof(parent)));
+    auto order = P.getOptionValue("-grid") ? grid_order : hilbert_order;
+    auto TG = to_tiled_edge_array<W>(G, tile_bits, order);
+    t.stop(); t.reportTotal("tiling time");
+    t.start();
+    components = gbbs::simple_union_find::SimpleUnionAsync(TG);
+  } else {
+    components = gbbs::simple_union_find::SimpleUnionAsync(G);
+  }
   double tt = t.stop();
   std::cout << "### Running Time: " << tt << std::endl;
 
@@ -97,6 +97,18 @@ inline sequence<parent> SimpleUnionAsync(Graph& G) {
   return uf.finish();
 }
 
+// The same algorithm over a tiled edge array (COO), uniting the endpoints of
+// every edge while processing the tiles in tile order.
+template <class W>
+inline sequence<parent> SimpleUnionAsync(tiled_edge_array<W>& G) {
+  size_t n = G.n;
+  auto uf = SimpleUnionAsyncStruct(n);
+  G.map_edges([&] (const uintE& u, const uintE& v, const W& wgh) {
+    uf.unite(u, v);
+  });
+  return uf.finish();
+}
+
 
 template <class Seq>
 inline size_t num_cc(Seq& labels) {
@@ -31,6 +31,7 @@
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
 //     -stats : print the #ccs, and the #vertices in the largest cc
+//     -coarsen : use the multi-level coarsening pipeline (CC_coarsen)
 
 #include "Connectivity.h"
 
@@ -44,7 +45,7 @@ double CC_runner(Graph& G, commandLine P) {
   std::cout << "### Threads: " << num_workers() << std::endl;
   std::cout << "### n: " << G.n << std::endl;
   std::cout << "### m: " << G.m << std::endl;
-  std::cout << "### Params: -beta = " << beta << " -permute = " << P.getOption("-permute") << std::endl;
+  std::cout << "### Params: -beta = " << beta << " -permute = " << P.getOption("-permute") << " -coarsen = " << P.getOption("-coarsen") << std::endl;
   std::cout << "### ------------------------------------" << std::endl;
 
   auto pack = P.getOption("-pack");
@@ -52,7 +53,9 @@ double CC_runner(Graph& G, commandLine P) {
   assert(!pack); // discouraged for now. Using the optimized contraction method is faster.
   timer t;
   t.start();
-  auto components = workefficient_cc::CC(G, beta, pack, P.getOption("-permute"));
+  auto components = P.getOption("-coarsen")
+      ? workefficient_cc::CC_coarsen(G, beta, P.getOption("-permute"))
+      : workefficient_cc::CC(G, beta, pack, P.getOption("-permute"));
   double tt = t.stop();
   std::cout << "### Running Time: " << tt << std::endl;
 
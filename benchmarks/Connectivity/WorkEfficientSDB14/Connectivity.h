@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "benchmarks/LowDiameterDecomposition/MPX13/Coarsening.h"
 #include "benchmarks/LowDiameterDecomposition/MPX13/LowDiameterDecomposition.h"
 #include "gbbs/gbbs.h"
 #include "gbbs/contract.h"
@@ -116,5 +117,21 @@ inline sequence<parent> CC(Graph& G, double beta = 0.2, bool pack = false, bool
   return CC_impl(G, beta, 0, pack, permute);
 }
 
+// Computes the connected components like CC, using the multi-level coarsening
+// pipeline (coarsening::Coarsen), which builds every level in two reused
+// buffers instead of allocating a contracted graph per level. Each component
+// is named by its smallest vertex.
+template <class Graph>
+inline sequence<parent> CC_coarsen(Graph& G, double beta = 0.2,
+                                   bool permute = false) {
+  coarsening::coarsening_params params;
+  params.beta = beta;
+  params.permute = permute;
+  auto H = coarsening::Coarsen(G, params, coarsening::no_weight());
+  auto labels = H.parts();
+  H.del();
+  return labels;
+}
+
 }  // namespace workefficient_cc
 }  // namespace gbbs
@@ -96,6 +96,70 @@ std::string alter_to_string(const LiuTarjanAlterOption alter_option) {
   ABORT_INVALID_ENUM(LiuTarjanAlterOption, alter_option);
 }
 
+// Returns `case_label` if `str` is its name.
+#define RETURN_IF_LABEL(str, case_label) \
+  if (str == #case_label) return case_label;
+
+FindOption find_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, find_compress);
+  RETURN_IF_LABEL(str, find_naive);
+  RETURN_IF_LABEL(str, find_split);
+  RETURN_IF_LABEL(str, find_halve);
+  RETURN_IF_LABEL(str, find_atomic_split);
+  RETURN_IF_LABEL(str, find_atomic_halve);
+  ABORT("Unexpected FindOption: " << str);
+}
+
+SpliceOption splice_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, split_atomic_one);
+  RETURN_IF_LABEL(str, halve_atomic_one);
+  RETURN_IF_LABEL(str, splice_simple);
+  RETURN_IF_LABEL(str, splice_atomic);
+  ABORT("Unexpected SpliceOption: " << str);
+}
+
+UniteOption unite_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, unite);
+  RETURN_IF_LABEL(str, unite_early);
+  RETURN_IF_LABEL(str, unite_nd);
+  RETURN_IF_LABEL(str, unite_rem_lock);
+  RETURN_IF_LABEL(str, unite_rem_cas);
+  ABORT("Unexpected UniteOption: " << str);
+}
+
+SamplingOption sampling_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, sample_kout);
+  RETURN_IF_LABEL(str, sample_bfs);
+  RETURN_IF_LABEL(str, sample_ldd);
+  RETURN_IF_LABEL(str, no_sampling);
+  ABORT("Unexpected SamplingOption: " << str);
+}
+
+JayantiFindOption jayanti_find_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, find_twotrysplit);
+  RETURN_IF_LABEL(str, find_simple);
+  ABORT("Unexpected JayantiFindOption: " << str);
+}
+
+LiuTarjanConnectOption connect_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, simple_connect);
+  RETURN_IF_LABEL(str, parent_connect);
+  RETURN_IF_LABEL(str, extended_connect);
+  ABORT("Unexpected LiuTarjanConnectOption: " << str);
+}
+
+LiuTarjanUpdateOption update_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, simple_update);
+  RETURN_IF_LABEL(str, root_update);
+  ABORT("Unexpected LiuTarjanUpdateOption: " << str);
+}
+
+LiuTarjanShortcutOption shortcut_from_string(const std::string& str) {
+  RETURN_IF_LABEL(str, shortcut);
+  RETURN_IF_LABEL(str, full_shortcut);
+  ABORT("Unexpected LiuTarjanShortcutOption: " << str);
+}
+
 std::string uf_options_to_string(
     const SamplingOption sampling_option,
     const FindOption find_option,
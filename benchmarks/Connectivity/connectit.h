@@ -72,6 +72,17 @@ namespace connectit {
   std::string shortcut_to_string(LiuTarjanShortcutOption);
   std::string alter_to_string(LiuTarjanAlterOption);
 
+  // Converts string to enum; the inverse of the functions above. Aborts on an
+  // unknown name.
+  FindOption find_from_string(const std::string&);
+  SpliceOption splice_from_string(const std::string&);
+  UniteOption unite_from_string(const std::string&);
+  SamplingOption sampling_from_string(const std::string&);
+  JayantiFindOption jayanti_find_from_string(const std::string&);
+  LiuTarjanConnectOption connect_from_string(const std::string&);
+  LiuTarjanUpdateOption update_from_string(const std::string&);
+  LiuTarjanShortcutOption shortcut_from_string(const std::string&);
+
   std::string uf_options_to_string(SamplingOption, FindOption, UniteOption);
   std::string uf_options_to_string(
       SamplingOption, FindOption, UniteOption, SpliceOption);
@@ -32,20 +32,30 @@
 //     -rounds : the number of times to run the algorithm
 //     -fa : run the fetch-and-add implementation of k-core
 //     -nb : the number of buckets to use in the bucketing implementation
+//     -approx : compute approximate coreness values using geometric buckets
+//     -eps : the approximation parameter used by -approx (default: 0.2)
+//     -check : with -approx, also run the exact algorithm and report the
+//              maximum and mean ratio between approximate and exact coreness
+//     -hierarchy : also build the k-core hierarchy (the forest of connected
+//                  components of every k-core) from the exact coreness;
+//                  its time is reported separately from the running time
 
 #include "KCore.h"
+#include "KCoreHierarchy.h"
 
 namespace gbbs {
 template <class Graph>
 double KCore_runner(Graph& G, commandLine P) {
   size_t num_buckets = P.getOptionLongValue("-nb", 16);
   bool fa = P.getOption("-fa");
+  bool approx = P.getOption("-approx");
+  double eps = P.getOptionDoubleValue("-eps", 0.2);
   std::cout << "### Application: KCore" << std::endl;
   std::cout << "### Graph: " << P.getArgument(0) << std::endl;
   std::cout << "### Threads: " << num_workers() << std::endl;
   std::cout << "### n: " << G.n << std::endl;
   std::cout << "### m: " << G.m << std::endl;
-  std::cout << "### Params: -nb (num_buckets) = " << num_buckets << " -fa (use fetch_and_add) = " << fa << std::endl;
+  std::cout << "### Params: -nb (num_buckets) = " << num_buckets << " -fa (use fetch_and_add) = " << fa << " -approx = " << approx << " -eps = " << eps << std::endl;
   std::cout << "### ------------------------------------" << std::endl;
   if (num_buckets != static_cast<size_t>((1 << pbbslib::log2_up(num_buckets)))) {
     std::cout << "Number of buckets must be a power of two."
@@ -54,6 +64,29 @@ double KCore_runner(Graph& G, commandLine P) {
   }
   assert(P.getOption("-s"));
 
+  if (approx) {
+    timer t; t.start();
+    auto cores = ApproxKCore(G, eps, num_buckets);
+    double tt = t.stop();
+    std::cout << "### Running Time: " << tt << std::endl;
+
+    if (P.getOption("-check")) {
+      timer et; et.start();
+      auto exact = KCore(G, num_buckets);
+      std::cout << "### Exact Running Time: " << et.stop() << std::endl;
+      auto ratio = pbbs::delayed_seq<double>(G.n, [&] (size_t i) {
+        if (exact[i] == 0) return (cores[i] == 0) ? 1.0 : (double)UINT_E_MAX;
+        double r = (double)cores[i] / exact[i];
+        return std::max(r, 1.0 / r);
+      });
+      double max_err = pbbslib::reduce_max(ratio);
+      double mean_err = pbbslib::reduce_add(ratio) / G.n;
+      std::cout << "### Max ratio error = " << max_err
+                << " mean ratio error = " << mean_err << std::endl;
+    }
+    return tt;
+  }
+
   // runs the fetch-and-add based implementation if set.
   timer t; t.start();
   auto cores = (fa) ? KCore_FA(G, num_buckets) : KCore(G, num_buckets);
@@ -61,6 +94,13 @@ double KCore_runner(Graph& G, commandLine P) {
 
   std::cout << "### Running Time: " << tt << std::endl;
 
+  if (P.getOption("-hierarchy")) {
+    timer ht; ht.start();
+    auto H = KCoreHierarchy(G, std::move(cores));
+    std::cout << "### Hierarchy Time: " << ht.stop() << std::endl;
+    std::cout << "### hierarchy nodes = " << H.num_nodes() << std::endl;
+  }
+
   return tt;
 }
 }  // namespace gbbs
@@ -83,6 +83,109 @@ inline sequence<uintE> KCore(Graph& G, size_t num_buckets = 16) {
   return D;
 }
 
+// Approximate coreness. Vertices are bucketed by a geometric group of their
+// induced degree: group i holds degrees in (T[i-1], T[i]], where T[0] = 0 and
+// T[i] = max(T[i-1] + 1, floor((1 + eps) * T[i-1])), so small degrees are
+// bucketed exactly. Each round peels the whole lowest group, i.e. every
+// remaining vertex whose induced degree is within a (1+eps) factor of the
+// current threshold, and assigns it the estimate T[i].
+//
+// If a group is drained completely, every vertex peeled in it has coreness in
+// (T[i-1], T[i]], so the estimate is within a (1+eps) factor. A group is
+// forcibly closed after rounds_per_group rounds (default: log_{1+eps} n + 1),
+// after which the remaining vertices of the group are peeled as part of the
+// next group. Since repeatedly peeling vertices of degree at most (2+eps)k
+// removes all vertices of coreness at most k within O(log_{1+eps} n) rounds,
+// this bounds the number of rounds by O(log^2 n) for constant eps while
+// keeping the estimates within a (2+eps)(1+eps) factor.
+template <class Graph>
+inline sequence<uintE> ApproxKCore(Graph& G, double eps = 0.2,
+                                   size_t num_buckets = 16,
+                                   size_t rounds_per_group = 0) {
+  const size_t n = G.n;
+  auto D =
+      sequence<uintE>(n, [&](size_t i) { return G.get_vertex(i).getOutDegree(); });
+  uintE max_deg = pbbslib::reduce_max(D);
+  if (rounds_per_group == 0) {
+    rounds_per_group = (size_t)(log((double)std::max(n, (size_t)2)) / log(1.0 + eps)) + 1;
+  }
+
+  std::vector<uintE> T = {0};
+  while (T.back() < max_deg) {
+    uintE t = T.back();
+    T.push_back(std::max(t + 1, (uintE)std::min((double)UINT_E_MAX - 1,
+                                                (1.0 + eps) * t)));
+  }
+  auto group = [&](uintE deg) -> uintE {
+    return std::lower_bound(T.begin(), T.end(), deg) - T.begin();
+  };
+
+  // Bkt holds the group of each remaining vertex; Cores holds the estimate of
+  // each peeled vertex and UINT_E_MAX for remaining vertices.
+  auto Bkt = sequence<uintE>(n, [&](size_t i) { return group(D[i]); });
+  auto Cores = sequence<uintE>(n, [&](size_t i) { return UINT_E_MAX; });
+
+  auto em = hist_table<uintE, uintE>(std::make_tuple(UINT_E_MAX, 0), (size_t)G.m / 50);
+  auto b = make_vertex_buckets(n, Bkt, increasing, num_buckets);
+
+  size_t finished = 0, rho = 0, num_groups = 0, forced = 0;
+  uintE cur_group = 0, rounds_in_group = 0;
+  bool first = true;
+  while (finished != n) {
+    auto bkt = b.next_bucket();
+    auto active = vertexSubset(n, bkt.identifiers);
+    if (first || bkt.id > cur_group) {
+      cur_group = std::max(cur_group, (uintE)bkt.id);
+      rounds_in_group = 0;
+      num_groups++;
+      first = false;
+    } else if (rounds_in_group == rounds_per_group) {
+      cur_group++;
+      rounds_in_group = 0;
+      num_groups++;
+      forced++;
+    }
+    rounds_in_group++;
+    finished += active.size();
+
+    uintE estimate = T[std::min((size_t)cur_group, T.size() - 1)];
+    vertexMap(active, [&](const uintE& v) {
+      Cores[v] = std::min(estimate, G.get_vertex(v).getOutDegree());
+    });
+
+    auto apply_f = [&](const std::tuple<uintE, uintE>& p)
+        -> const std::optional<std::tuple<uintE, uintE> > {
+      uintE v = std::get<0>(p), edgesRemoved = std::get<1>(p);
+      if (Cores[v] == UINT_E_MAX) {
+        uintE new_deg = D[v] - edgesRemoved;
+        D[v] = new_deg;
+        uintE prev_bkt = Bkt[v];
+        uintE new_bkt = std::max(group(new_deg), cur_group);
+        if (new_bkt < prev_bkt) {
+          Bkt[v] = new_bkt;
+          return wrap(v, b.get_bucket(prev_bkt, new_bkt));
+        }
+      }
+      return std::nullopt;
+    };
+
+    auto cond_f = [] (const uintE& u) { return true; };
+    vertexSubsetData<uintE> moved = nghCount(G, active, cond_f, apply_f, em, no_dense);
+    if (moved.dense()) {
+      b.update_buckets(moved.get_fn_repr(), n);
+    } else {
+      b.update_buckets(moved.get_fn_repr(), moved.size());
+    }
+    moved.del();
+    active.del();
+    rho++;
+  }
+  std::cout << "### rho = " << rho << " groups = " << num_groups
+            << " forced = " << forced << "\n";
+  b.del();
+  return Cores;
+}
+
 template <class W>
 struct kcore_fetch_add {
   uintE* er;
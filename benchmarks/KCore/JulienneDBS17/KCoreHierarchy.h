@@ -0,0 +1,175 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "KCore.h"
+#include "benchmarks/Connectivity/SimpleUnionAsync/Connectivity.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+
+// The k-core hierarchy (k-core forest) of a graph. Each node is a connected
+// component of the level(x)-core, and its parent is the component of a
+// lower core containing it. Chains of nodes representing the same vertex set
+// are compressed: a node is only created at level k if its component contains
+// a vertex of coreness k, so parent(x) is the component of the
+// (level(x)-1)-core containing x if level(parent(x)) = level(x) - 1, and
+// otherwise x is also the component of every k-core with
+// level(parent(x)) < k <= level(x).
+struct core_hierarchy {
+  sequence<uintE> coreness;  // coreness of each vertex
+  sequence<uintE> parent;    // parent of each node (UINT_E_MAX for roots)
+  sequence<uintE> level;     // the largest k such that the node is a k-core component
+  sequence<size_t> size;     // number of vertices in each node's component
+  // Vertex v's component in the k-core, for 0 <= k <= coreness[v], is stored
+  // at components[offsets[v] + k].
+  sequence<size_t> offsets;
+  sequence<uintE> components;
+
+  size_t num_nodes() const { return parent.size(); }
+
+  // Returns the node for the component of the k-core containing v, or
+  // UINT_E_MAX if v is not in the k-core.
+  uintE component(uintE v, uintE k) const {
+    return (k <= coreness[v]) ? components[offsets[v] + k] : UINT_E_MAX;
+  }
+};
+
+// Builds the k-core hierarchy given the coreness of every vertex. Vertices are
+// added in decreasing order of coreness: at level k, the vertices of coreness k
+// are united (using a concurrent union-find) with their neighbors of coreness
+// at least k. Every component touched at level k gets a new node, which
+// becomes the parent of the nodes of the components it absorbed.
+// The work is O(m + sum_v coreness(v)).
+template <class Graph>
+inline core_hierarchy KCoreHierarchy(Graph& G, sequence<uintE> coreness) {
+  using W = typename Graph::weight_type;
+  const size_t n = G.n;
+  uintE k_max = pbbslib::reduce_max(coreness);
+
+  // Vertices sorted by decreasing coreness; level k holds the vertices
+  // vtxs[starts[k_max - k], starts[k_max - k + 1]).
+  auto [vtxs, counts] = pbbs::integer_sort_with_counts<size_t>(
+      pbbs::delayed_seq<uintE>(n, [&] (size_t i) { return (uintE)i; }),
+      [&] (uintE v) { return k_max - coreness[v]; }, (size_t)k_max + 1);
+  auto starts = sequence<size_t>(k_max + 2, [&] (size_t i) {
+    return (i <= k_max) ? counts[i] : 0; });
+  pbbslib::scan_add_inplace(starts);
+
+  auto parents = sequence<parent>(n, [&] (size_t i) { return (parent)i; });
+  auto root_node = sequence<uintE>(n, [&] (size_t i) { return UINT_E_MAX; });
+  auto leaf_node = sequence<uintE>(n);
+  auto flags = sequence<bool>(n, false);
+  auto buffer = sequence<uintE>::no_init(n);
+
+  std::vector<uintE> node_parent, node_level;
+  for (long k = k_max; k >= 0; k--) {
+    size_t lo = starts[k_max - k], hi = starts[k_max - k + 1];
+    if (lo == hi) continue;
+    auto L = vtxs.slice(lo, hi);
+
+    // 1. Collect the existing components adjacent to the new vertices.
+    size_t num_touched = 0;
+    parallel_for(0, L.size(), [&] (size_t i) {
+      uintE v = L[i];
+      auto map_f = [&] (const uintE& u, const uintE& ngh, const W& wgh) {
+        if (coreness[ngh] > k) {
+          uintE r = simple_union_find::find_compress(ngh, parents);
+          if (!flags[r] && pbbslib::atomic_compare_and_swap(&flags[r], false, true)) {
+            buffer[pbbslib::fetch_and_add(&num_touched, (size_t)1)] = r;
+          }
+        }
+      };
+      G.get_vertex(v).mapOutNgh(v, map_f);
+    }, 1);
+    auto touched = buffer.slice(0, num_touched);
+    parallel_for(0, num_touched, [&] (size_t i) { flags[touched[i]] = false; });
+
+    // 2. Union the new vertices with their neighbors in the k-core.
+    parallel_for(0, L.size(), [&] (size_t i) {
+      uintE v = L[i];
+      auto map_f = [&] (const uintE& u, const uintE& ngh, const W& wgh) {
+        if (coreness[ngh] >= k) {
+          simple_union_find::unite_impl(v, ngh, parents);
+        }
+      };
+      G.get_vertex(v).mapOutNgh(v, map_f);
+    }, 1);
+
+    // 3. Create a node for each component containing a new vertex.
+    auto old_nodes = sequence<uintE>(num_touched, [&] (size_t i) {
+      return root_node[touched[i]]; });
+    auto new_roots = sequence<uintE>::no_init(L.size());
+    size_t num_new = 0;
+    parallel_for(0, L.size(), [&] (size_t i) {
+      uintE r = simple_union_find::find_compress(L[i], parents);
+      if (!flags[r] && pbbslib::atomic_compare_and_swap(&flags[r], false, true)) {
+        new_roots[pbbslib::fetch_and_add(&num_new, (size_t)1)] = r;
+      }
+    });
+    uintE first_node = node_parent.size();
+    node_parent.resize(first_node + num_new, UINT_E_MAX);
+    node_level.resize(first_node + num_new, (uintE)k);
+    parallel_for(0, num_new, [&] (size_t i) {
+      root_node[new_roots[i]] = first_node + i;
+      flags[new_roots[i]] = false;
+    });
+    parallel_for(0, num_touched, [&] (size_t i) {
+      uintE r = simple_union_find::find_compress(touched[i], parents);
+      node_parent[old_nodes[i]] = root_node[r];
+    });
+    parallel_for(0, L.size(), [&] (size_t i) {
+      uintE r = simple_union_find::find_compress(L[i], parents);
+      leaf_node[L[i]] = root_node[r];
+    });
+  }
+
+  core_hierarchy H;
+  size_t num_nodes = node_parent.size();
+  H.parent = sequence<uintE>(num_nodes, [&] (size_t i) { return node_parent[i]; });
+  H.level = sequence<uintE>(num_nodes, [&] (size_t i) { return node_level[i]; });
+
+  // Walk from each vertex's leaf node to its root, filling in its component
+  // at every level.
+  H.offsets = sequence<size_t>(n + 1, [&] (size_t i) {
+    return (i < n) ? (size_t)coreness[i] + 1 : 0; });
+  size_t total = pbbslib::scan_add_inplace(H.offsets);
+  H.components = sequence<uintE>::no_init(total);
+  H.size = sequence<size_t>(num_nodes, (size_t)0);
+  parallel_for(0, n, [&] (size_t v) {
+    uintE x = leaf_node[v];
+    size_t off = H.offsets[v];
+    for (long k = coreness[v]; k >= 0; k--) {
+      while (H.parent[x] != UINT_E_MAX && H.level[H.parent[x]] >= k) {
+        x = H.parent[x];
+      }
+      H.components[off + k] = x;
+      if (H.level[x] == k) pbbslib::write_add(&H.size[x], (size_t)1);
+    }
+  }, 1);
+  H.coreness = std::move(coreness);
+  return H;
+}
+
+}  // namespace gbbs
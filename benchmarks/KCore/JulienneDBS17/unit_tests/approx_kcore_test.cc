@@ -0,0 +1,92 @@
+#include "benchmarks/KCore/JulienneDBS17/KCore.h"
+
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Checks that the approximate coreness of every vertex is at least its
+// coreness and at most `factor` times its coreness.
+template <class Graph>
+void CheckApproximation(Graph& graph, double eps, size_t rounds_per_group,
+                        double factor) {
+  auto cores = KCore(graph);
+  auto approx = ApproxKCore(graph, eps, 16, rounds_per_group);
+  ASSERT_EQ(approx.size(), graph.n);
+  for (size_t v = 0; v < graph.n; v++) {
+    EXPECT_GE(approx[v], cores[v]) << "v = " << v;
+    EXPECT_LE(approx[v], factor * cores[v]) << "v = " << v;
+  }
+}
+
+// Checks the (1+eps) approximation when every group is drained, and the
+// (2+eps)(1+eps) approximation when groups are closed after the default
+// number of rounds.
+void CheckAllEps(uintE n, const std::unordered_set<UndirectedEdge>& edges) {
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(n, edges)};
+  for (double eps : {0.1, 0.5, 1.0}) {
+    SCOPED_TRACE(testing::Message() << "eps = " << eps);
+    CheckApproximation(graph, eps, n + 1, 1 + eps);
+    CheckApproximation(graph, eps, 0, (2 + eps) * (1 + eps));
+  }
+}
+
+}  // namespace
+
+TEST(ApproxKCore, SmallGraph) {
+  // Graph diagram:
+  //   0 - 1     4 - 5 - 6        9
+  //    \ /      | X |
+  //     2 - 3   7 - 8
+  constexpr uintE kNumVertices{10};
+  const std::unordered_set<UndirectedEdge> kEdges{
+    {0, 1}, {0, 2}, {1, 2}, {2, 3},
+    {4, 5}, {4, 7}, {4, 8}, {5, 7}, {5, 8}, {7, 8}, {5, 6},
+  };
+  CheckAllEps(kNumVertices, kEdges);
+}
+
+TEST(ApproxKCore, PseudorandomGraphs) {
+  CheckAllEps(500, graph_test::PseudorandomEdges(500, 3000, 1));
+  CheckAllEps(200, graph_test::PseudorandomEdges(200, 8000, 2));
+
+  // Edges skewed towards low ids, so that coreness values span a wide range
+  // and fall in many groups.
+  constexpr uintE kNumVertices{2000};
+  std::unordered_set<UndirectedEdge> edges;
+  graph_test::PseudorandomGenerator generator{3};
+  for (size_t i = 0; i < 40000; i++) {
+    uintE u = generator.Next() % kNumVertices;
+    uintE v = (generator.Next() % kNumVertices) * u / kNumVertices;
+    if (u != v) edges.insert({u, v});
+  }
+  CheckAllEps(kNumVertices, edges);
+}
+
+TEST(ApproxKCore, LongPaths) {
+  // Peeling a path takes a round per pair of endpoints, so groups are closed
+  // after the default number of rounds before they are drained. A clique
+  // hangs off the middle of the first path.
+  constexpr uintE kPathLength{1000};
+  constexpr uintE kCliqueSize{12};
+  std::unordered_set<UndirectedEdge> edges;
+  for (uintE v = 0; v + 1 < kPathLength; v++) {
+    edges.insert({v, v + 1});
+    edges.insert({kPathLength + v, kPathLength + v + 1});
+    edges.insert({kPathLength + v, kPathLength + v + 2});
+  }
+  for (uintE u = 0; u < kCliqueSize; u++) {
+    for (uintE v = u + 1; v < kCliqueSize; v++) {
+      edges.insert({2 * kPathLength + 2 + u, 2 * kPathLength + 2 + v});
+    }
+  }
+  edges.insert({kPathLength / 2, 2 * kPathLength + 2});
+  CheckAllEps(2 * kPathLength + 2 + kCliqueSize, edges);
+}
+
+}  // namespace gbbs
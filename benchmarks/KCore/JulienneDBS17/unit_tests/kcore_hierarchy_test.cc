@@ -0,0 +1,106 @@
+#include "benchmarks/KCore/JulienneDBS17/KCoreHierarchy.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Checks H against the connected components of each k-core, computed by a
+// sequential DFS over the edge list.
+void CheckHierarchy(size_t n, const std::unordered_set<UndirectedEdge>& edges,
+                    const core_hierarchy& H) {
+  std::vector<std::vector<uintE>> adj(n);
+  for (const auto& e : edges) {
+    adj[e.endpoints().first].push_back(e.endpoints().second);
+    adj[e.endpoints().second].push_back(e.endpoints().first);
+  }
+  uintE k_max = 0;
+  for (size_t v = 0; v < n; v++) k_max = std::max(k_max, H.coreness[v]);
+  for (uintE k = 0; k <= k_max; k++) {
+    std::vector<uintE> label(n, UINT_E_MAX);
+    std::vector<size_t> sizes;
+    for (size_t s = 0; s < n; s++) {
+      if (H.coreness[s] < k || label[s] != UINT_E_MAX) continue;
+      std::vector<uintE> stack = {(uintE)s};
+      label[s] = sizes.size();
+      size_t size = 0;
+      while (!stack.empty()) {
+        uintE v = stack.back(); stack.pop_back();
+        size++;
+        for (uintE u : adj[v]) {
+          if (H.coreness[u] >= k && label[u] == UINT_E_MAX) {
+            label[u] = sizes.size();
+            stack.push_back(u);
+          }
+        }
+      }
+      sizes.push_back(size);
+    }
+    for (size_t v = 0; v < n; v++) {
+      if (label[v] == UINT_E_MAX) {
+        EXPECT_EQ(H.component(v, k), UINT_E_MAX);
+        continue;
+      }
+      uintE x = H.component(v, k);
+      ASSERT_NE(x, UINT_E_MAX);
+      EXPECT_LE(k, H.level[x]);
+      EXPECT_EQ(H.size[x], sizes[label[v]]);
+      for (size_t u = 0; u < v; u++) {
+        if (label[u] == UINT_E_MAX) continue;
+        EXPECT_EQ(label[u] == label[v], H.component(u, k) == x);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(KCoreHierarchy, SmallGraph) {
+  // Graph diagram:
+  //   0 - 1     4 - 5 - 6        9
+  //    \ /      | X |
+  //     2 - 3   7 - 8
+  constexpr uintE kNumVertices{10};
+  const std::unordered_set<UndirectedEdge> kEdges{
+    {0, 1}, {0, 2}, {1, 2}, {2, 3},
+    {4, 5}, {4, 7}, {4, 8}, {5, 7}, {5, 8}, {7, 8}, {5, 6},
+  };
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, kEdges)};
+  auto H = KCoreHierarchy(graph, KCore(graph));
+
+  EXPECT_EQ(H.coreness[2], 2);
+  EXPECT_EQ(H.coreness[4], 3);
+  EXPECT_EQ(H.coreness[9], 0);
+  // The 3-core is {4, 5, 7, 8}, whose parent is the component containing 6.
+  uintE x = H.component(4, 3);
+  EXPECT_EQ(H.size[x], 4);
+  EXPECT_EQ(H.component(6, 1), H.parent[x]);
+  EXPECT_EQ(H.component(4, 2), x);
+  EXPECT_NE(H.component(0, 1), H.component(4, 1));
+  EXPECT_EQ(H.component(0, 0), H.component(3, 0));
+  CheckHierarchy(kNumVertices, kEdges, H);
+}
+
+TEST(KCoreHierarchy, PseudorandomGraph) {
+  constexpr uintE kNumVertices{300};
+  std::unordered_set<UndirectedEdge> edges;
+  graph_test::PseudorandomGenerator generator{1};
+  for (size_t i = 0; i < 2000; i++) {
+    uint64_t state = generator.NextState();
+    uintE u = (state >> 33) % kNumVertices;
+    // Skews edges towards low ids to get a range of coreness values.
+    uintE v = ((state >> 13) % kNumVertices) * u / kNumVertices;
+    if (u != v) edges.insert({u, v});
+  }
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  auto H = KCoreHierarchy(graph, KCore(graph));
+  CheckHierarchy(kNumVertices, edges, H);
+}
+
+}  // namespace gbbs
@@ -30,6 +30,8 @@
 //     -no_buckets : run an implementation that does not use bucketing
 //                   (using bucketing is default)
 //     -nb : the number of buckets to use in the bucketing implementation
+//     -ht : use the hash-table based implementation (default for compressed
+//           graphs). Otherwise, edges are indexed by their CSR positions.
 
 #include "KTruss.h"
 
@@ -39,6 +41,7 @@ template <class Graph>
 double KTruss_runner(Graph& G, commandLine P) {
   size_t num_buckets = P.getOptionLongValue("-nb", 16);
   bool no_buckets = P.getOption("-no_buckets");
+  bool ht = P.getOption("-ht");
   std::cout << "### Application: KTruss" << std::endl;
   std::cout << "### Graph: " << P.getArgument(0) << std::endl;
   std::cout << "### Threads: " << num_workers() << std::endl;
@@ -56,7 +59,17 @@ double KTruss_runner(Graph& G, commandLine P) {
   // runs the fetch-and-add based implementation if set.
   timer t; t.start();
   //auto trusses = (!no_buckets) ? KTruss(G, num_buckets) : KTruss_no_bucket(G);
-  KTruss_ht(G, num_buckets);
+  using vertex = typename Graph::vertex;
+  using W = typename Graph::weight_type;
+  if constexpr (std::is_same<vertex, symmetric_vertex<W>>::value) {
+    if (ht) {
+      KTruss_ht(G, num_buckets);
+    } else {
+      KTruss_edge_index(G, num_buckets);
+    }
+  } else {
+    KTruss_ht(G, num_buckets);
+  }
   double tt = t.stop();
 
   std::cout << "### Running Time: " << tt << std::endl;
@@ -86,8 +86,12 @@ void initialize_trussness_values(Graph& GA, MT& multi_table) {
 //
 //   3.b Get the entries of the HT, actually decrement their coreness, see if
 //   their bucket needs to be updated and if so, update.
+//
+// Returns the trussness table: the value of edge (u, v) is at
+// big_table[idx(u, v)], and is its peeling level minus one, or
+// std::numeric_limits<int>::max() if the edge is in no triangle.
 template <class Graph>
-void KTruss_ht(Graph& GA, size_t num_buckets = 16) {
+auto KTruss_ht(Graph& GA, size_t num_buckets = 16) {
   using W = typename Graph::weight_type;
   size_t n_edges = GA.m / 2;
 
@@ -179,7 +183,7 @@ void KTruss_ht(Graph& GA, size_t num_buckets = 16) {
     k_max = std::max(k_max, bkt.id);
     std::cout << "k = " << k << " iter = " << iter << " #edges = " << rem_edges.size() << std::endl;
 
-    if (k == 0 || finished == n_edges) {
+    if (k == 0) {
       // No triangles incident to these edges. We set their trussness to MAX,
       // which is safe since there are no readers until we output.
       par_for(0, rem_edges.size(), [&] (size_t i) {
@@ -188,6 +192,14 @@ void KTruss_ht(Graph& GA, size_t num_buckets = 16) {
       });
       continue;
     }
+    if (finished == n_edges) {
+      // The last bucket: no edges are left to decrement, so only unmark these.
+      par_for(0, rem_edges.size(), [&] (size_t i) {
+        edge_t id = rem_edges[i];
+        std::get<1>(trussness_multi.big_table[id]) -= 1;
+      });
+      continue;
+    }
 
     size_t e_size = 2*k*rem_edges.size();
     size_t e_space_required  = (size_t)1 << pbbslib::log2_up((size_t)(e_size*1.2));
@@ -335,6 +347,270 @@ void KTruss_ht(Graph& GA, size_t num_buckets = 16) {
   // == Important: The actual trussness is the stored trussness value + 1.
   // Edges with trussness 0 had their values stored as std::numeric_limits<int>::max()
   std::cout << "iters = " << iter << std::endl;
+  return trussness_multi;
+}
+
+// Edge-indexed k-truss for uncompressed graphs. Instead of hash tables, every
+// undirected edge (u, v), u < v, gets a dense id in [0, m/2), ordered by u and
+// then by v's position in u's (sorted) neighbor list. edge_ids maps each slot
+// of the graph's CSR to the id of its undirected edge; the slots of (v, u)
+// are resolved by a single binary search per slot when the index is built.
+// Support updates are then direct atomics on arrays indexed by edge id, and
+// the edges of a triangle found while intersecting N(u) and N(v) are read off
+// at the positions where the intersection matched.
+//
+// Returns the peeling level of each edge id: the edge is in the (k+2)-truss
+// for k = trussness[id]. Edge ids can be decoded with
+// truss_utils::edge_index::endpoints. Unlike KTruss_ht, the graph is not
+// mutated (adjacency lists are not packed), since ids are CSR positions.
+namespace truss_utils {
+
+  template <class Graph>
+  struct edge_index {
+    using W = typename Graph::weight_type;
+    using edge_t = uintE;
+
+    Graph& G;
+    sequence<uintT> offsets;     // CSR offset of each vertex
+    sequence<edge_t> up_offsets; // first id of the edges (u, v > u) of u
+    sequence<edge_t> edge_ids;   // id of the undirected edge in each CSR slot
+
+    const std::tuple<uintE, W>* neighbors(uintE u) const {
+      return G.get_vertex(u).getOutNeighbors();
+    }
+    uintE degree(uintE u) const { return G.get_vertex(u).getOutDegree(); }
+
+    // The index of the first neighbor of u larger than u.
+    uintE first_up(uintE u) const {
+      auto nghs = neighbors(u);
+      return std::lower_bound(nghs, nghs + degree(u), u,
+          [&] (const std::tuple<uintE, W>& e, uintE x) {
+            return std::get<0>(e) <= x; }) - nghs;
+    }
+
+    edge_index(Graph& G) : G(G) {
+      size_t n = G.n;
+      offsets = sequence<uintT>(n + 1, [&] (size_t u) -> uintT {
+        return (u < n) ? degree(u) : 0; });
+      pbbslib::scan_add_inplace(offsets);
+      auto first = sequence<uintE>(n, [&] (size_t u) { return first_up(u); });
+      up_offsets = sequence<edge_t>(n + 1, [&] (size_t u) -> edge_t {
+        return (u < n) ? degree(u) - first[u] : 0; });
+      pbbslib::scan_add_inplace(up_offsets);
+      edge_ids = sequence<edge_t>::no_init(offsets[n]);
+      parallel_for(0, n, [&] (size_t u) {
+        auto nghs = neighbors(u);
+        uintE d = degree(u);
+        for (uintE j = 0; j < d; j++) {
+          uintE v = std::get<0>(nghs[j]);
+          edge_t id;
+          if (j >= first[u]) {
+            id = up_offsets[u] + (j - first[u]);
+          } else {
+            // Resolve the twin slot (v, u).
+            auto v_nghs = neighbors(v);
+            uintE i = std::lower_bound(v_nghs, v_nghs + degree(v), (uintE)u,
+                [&] (const std::tuple<uintE, W>& e, uintE x) {
+                  return std::get<0>(e) < x; }) - v_nghs;
+            id = up_offsets[v] + (i - first[v]);
+          }
+          edge_ids[offsets[u] + j] = id;
+        }
+      }, 1);
+    }
+
+    size_t num_edges() const { return up_offsets[G.n]; }
+
+    std::pair<uintE, uintE> endpoints(edge_t id) const {
+      uintE u = (std::upper_bound(up_offsets.begin(), up_offsets.end(), id) -
+                 up_offsets.begin()) - 1;
+      uintE v = std::get<0>(neighbors(u)[first_up(u) + (id - up_offsets[u])]);
+      return {u, v};
+    }
+
+    // Calls f(w, uw_id, vw_id) for every w in N(u) and N(v).
+    template <class F>
+    void intersect(uintE u, uintE v, F f) const {
+      auto A = neighbors(u), B = neighbors(v);
+      uintE a = degree(u), b = degree(v);
+      uintT oa = offsets[u], ob = offsets[v];
+      bool swapped = a > b;
+      if (swapped) {
+        std::swap(A, B); std::swap(a, b); std::swap(oa, ob);
+      }
+      auto emit = [&] (uintE w, edge_t a_id, edge_t b_id) {
+        if (swapped) f(w, b_id, a_id); else f(w, a_id, b_id);
+      };
+      auto less = [&] (const std::tuple<uintE, W>& e, uintE x) {
+        return std::get<0>(e) < x; };
+      if (16 * (size_t)a < b) {
+        // Skewed degrees: search for each neighbor of u in N(v).
+        auto lo = B;
+        for (uintE i = 0; i < a && lo != B + b; i++) {
+          uintE x = std::get<0>(A[i]);
+          lo = std::lower_bound(lo, B + b, x, less);
+          if (lo != B + b && std::get<0>(*lo) == x) {
+            emit(x, edge_ids[oa + i], edge_ids[ob + (lo - B)]);
+          }
+        }
+        return;
+      }
+      uintE i = 0, j = 0;
+      while (i < a && j < b) {
+        uintE x = std::get<0>(A[i]), y = std::get<0>(B[j]);
+        if (x == y) {
+          emit(x, edge_ids[oa + i], edge_ids[ob + j]);
+          i++; j++;
+        } else if (x < y) {
+          i++;
+        } else {
+          j++;
+        }
+      }
+    }
+  };
+
+}  // namespace truss_utils
+
+template <class Graph>
+sequence<uintE> KTruss_edge_index(Graph& GA, size_t num_buckets = 16) {
+  using edge_t = uintE;
+  using bucket_t = uintE;
+  using trussness_t = uintE;
+
+  timer it; it.start();
+  auto E = truss_utils::edge_index<Graph>(GA);
+  size_t n_edges = E.num_edges();
+  it.stop(); it.reportTotal("index time");
+
+  // Count triangles with the graph oriented by degree: each triangle
+  // u -> v -> w is found once by intersecting the out-neighbors of u and v.
+  // The oriented lists (and the ids of their edges) are only kept while
+  // counting.
+  timer tct; tct.start();
+  auto rank = truss_utils::rankNodes(GA);
+  auto is_out = [&] (uintE u, uintE v) { return rank[v] > rank[u]; };
+  auto out_offsets = sequence<uintT>(GA.n + 1, [&] (size_t u) -> uintT {
+    if (u == GA.n) return 0;
+    auto nghs = E.neighbors(u);
+    uintT d = 0;
+    for (uintE j = 0; j < E.degree(u); j++) d += is_out(u, std::get<0>(nghs[j]));
+    return d;
+  });
+  pbbslib::scan_add_inplace(out_offsets);
+  auto out_nghs = sequence<uintE>::no_init(n_edges);
+  auto out_ids = sequence<edge_t>::no_init(n_edges);
+  parallel_for(0, GA.n, [&] (size_t u) {
+    auto nghs = E.neighbors(u);
+    uintT k = out_offsets[u];
+    for (uintE j = 0; j < E.degree(u); j++) {
+      uintE v = std::get<0>(nghs[j]);
+      if (is_out(u, v)) {
+        out_nghs[k] = v;
+        out_ids[k++] = E.edge_ids[E.offsets[u] + j];
+      }
+    }
+  }, 1);
+  auto trussness = sequence<trussness_t>(n_edges, (trussness_t)0);
+  parallel_for(0, GA.n, [&] (size_t u) {
+    for (uintT p = out_offsets[u]; p < out_offsets[u + 1]; p++) {
+      uintE v = out_nghs[p];
+      uintT i = out_offsets[u], j = out_offsets[v];
+      while (i < out_offsets[u + 1] && j < out_offsets[v + 1]) {
+        if (out_nghs[i] == out_nghs[j]) {
+          pbbslib::write_add(&trussness[out_ids[p]], 1);
+          pbbslib::write_add(&trussness[out_ids[i]], 1);
+          pbbslib::write_add(&trussness[out_ids[j]], 1);
+          i++; j++;
+        } else if (out_nghs[i] < out_nghs[j]) {
+          i++;
+        } else {
+          j++;
+        }
+      }
+    }
+  }, 1);
+  out_nghs.clear();
+  out_ids.clear();
+  tct.stop(); tct.reportTotal("TC time");
+
+  auto b = make_buckets<edge_t, bucket_t>(n_edges, trussness.slice(),
+                                          increasing, num_buckets);
+  // Triangles removed from each edge in the current round, and the edges
+  // with a non-zero count.
+  auto decrements = sequence<uintE>(n_edges, (uintE)0);
+  auto changed = sequence<edge_t>::no_init(n_edges);
+
+  timer decrement_t, bt, peeling_t; peeling_t.start();
+  size_t finished = 0, k_max = 0, iter = 0;
+  while (finished != n_edges) {
+    bt.start();
+    auto bkt = b.next_bucket();
+    bt.stop();
+    auto rem_edges = bkt.identifiers;
+    uintE k = bkt.id;
+    finished += rem_edges.size();
+    k_max = std::max(k_max, (size_t)k);
+    if (k == 0) {
+      // No triangles incident to these edges. UINT_E_MAX keeps them out of
+      // the bucket structure until the values are finalized below.
+      par_for(0, rem_edges.size(), [&] (size_t i) {
+        trussness[rem_edges[i]] = UINT_E_MAX;
+      });
+      continue;
+    }
+
+    decrement_t.start();
+    size_t num_changed = 0;
+    par_for(0, rem_edges.size(), 1, [&] (size_t i) {
+      edge_t uv_id = rem_edges[i];
+      auto [u, v] = E.endpoints(uv_id);
+      E.intersect(u, v, [&] (uintE w, edge_t uw_id, edge_t vw_id) {
+        trussness_t t_uw = trussness[uw_id], t_vw = trussness[vw_id];
+        if (truss_utils::should_remove(k, k, t_uw, t_vw, uv_id, uw_id, vw_id)) {
+          for (edge_t id : {uw_id, vw_id}) {
+            if (trussness[id] > k &&
+                pbbslib::fetch_and_add(&decrements[id], (uintE)1) == 0) {
+              changed[pbbslib::fetch_and_add(&num_changed, (size_t)1)] = id;
+            }
+          }
+        }
+      });
+    });
+    decrement_t.stop();
+
+    auto moved = sequence<bucket_t>(num_changed, [&] (size_t i) {
+      edge_t id = changed[i];
+      trussness_t current = trussness[id];
+      trussness_t new_t = std::max(current - decrements[id], k);
+      decrements[id] = 0;
+      trussness[id] = new_t;
+      return b.get_bucket(current, new_t);
+    });
+    auto edges_moved_f = [&] (size_t i) {
+      return std::optional<std::tuple<edge_t, bucket_t>>(
+          std::make_tuple(changed[i], moved[i]));
+    };
+    bt.start();
+    b.update_buckets(edges_moved_f, num_changed);
+    bt.stop();
+
+    // Unmark edges removed in this round.
+    par_for(0, rem_edges.size(), [&] (size_t i) {
+      trussness[rem_edges[i]] -= 1;
+    });
+    iter++;
+  }
+  b.del();
+  peeling_t.stop(); peeling_t.reportTotal("peeling time");
+  bt.reportTotal("Bucketing time");
+  decrement_t.reportTotal("Decrement trussness time");
+
+  par_for(0, n_edges, [&] (size_t i) {
+    trussness[i] = (trussness[i] == UINT_E_MAX) ? 0 : trussness[i] + 1;
+  });
+  std::cout << "iters = " << iter << " k_max = " << k_max << std::endl;
+  return trussness;
 }
 
 }  // namespace gbbs
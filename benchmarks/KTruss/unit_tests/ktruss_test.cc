@@ -0,0 +1,93 @@
+#include "benchmarks/KTruss/KTruss.h"
+
+#include <limits>
+#include <map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Returns the peeling level of every edge (u, v), u < v, computed by
+// KTruss_edge_index, after checking it edge for edge against KTruss_ht.
+std::map<std::pair<uintE, uintE>, uintE> CheckedTrussness(
+    uintE n, const std::unordered_set<UndirectedEdge>& edges) {
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(n, edges)};
+  auto trussness = KTruss_edge_index(graph);
+  truss_utils::edge_index<decltype(graph)> E(graph);
+  EXPECT_EQ(trussness.size(), edges.size());
+
+  // KTruss_ht packs the adjacency lists of its graph.
+  auto ht_graph{graph_test::MakeUnweightedSymmetricGraph(n, edges)};
+  auto table = KTruss_ht(ht_graph);
+
+  std::map<std::pair<uintE, uintE>, uintE> result;
+  for (size_t id = 0; id < trussness.size(); id++) {
+    auto [u, v] = E.endpoints(id);
+    EXPECT_LT(u, v);
+    EXPECT_EQ(edges.count({u, v}), 1) << "(" << u << ", " << v << ")";
+    uintE stored = std::get<1>(table.big_table[table.idx(u, v)]);
+    uintE expected =
+        (stored == (uintE)std::numeric_limits<int>::max()) ? 0 : stored + 1;
+    EXPECT_EQ(trussness[id], expected) << "(" << u << ", " << v << ")";
+    result[{u, v}] = trussness[id];
+  }
+  EXPECT_EQ(result.size(), edges.size());
+  return result;
+}
+
+}  // namespace
+
+TEST(KTruss, SmallGraph) {
+  // Graph diagram:
+  //   0 --- 1       5          9 - 10
+  //   | \ / |      / \
+  //   | / \ |     6 - 7
+  //   2 --- 3 - 4    \ /
+  //                   8
+  // {0, 1, 2, 3} is a 4-clique, {5, 6, 7} and {6, 7, 8} are triangles
+  // sharing an edge.
+  constexpr uintE kNumVertices{11};
+  const std::unordered_set<UndirectedEdge> kEdges{
+    {0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}, {3, 4},
+    {5, 6}, {5, 7}, {6, 7}, {6, 8}, {7, 8}, {9, 10},
+  };
+  auto trussness = CheckedTrussness(kNumVertices, kEdges);
+  const std::vector<std::pair<uintE, uintE>> kClique{
+    {0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3},
+  };
+  for (const auto& e : kClique) EXPECT_EQ(trussness[e], 2);
+  EXPECT_EQ((trussness[{3, 4}]), 0);
+  EXPECT_EQ((trussness[{5, 6}]), 1);
+  EXPECT_EQ((trussness[{6, 7}]), 1);
+  EXPECT_EQ((trussness[{7, 8}]), 1);
+  EXPECT_EQ((trussness[{9, 10}]), 0);
+}
+
+TEST(KTruss, Clique) {
+  // Every edge of a 6-clique is in 4 triangles.
+  constexpr uintE kNumVertices{6};
+  std::unordered_set<UndirectedEdge> edges;
+  for (uintE u = 0; u < kNumVertices; u++) {
+    for (uintE v = u + 1; v < kNumVertices; v++) edges.insert({u, v});
+  }
+  for (const auto& [e, t] : CheckedTrussness(kNumVertices, edges)) {
+    EXPECT_EQ(t, kNumVertices - 2);
+  }
+}
+
+TEST(KTruss, PseudorandomGraphs) {
+  // Sparse and dense graphs, the larger ones with enough peeled edges for
+  // KTruss_ht to compact its adjacency lists.
+  CheckedTrussness(100, graph_test::PseudorandomEdges(100, 500, 1));
+  CheckedTrussness(60, graph_test::PseudorandomEdges(60, 1200, 2));
+  CheckedTrussness(500, graph_test::PseudorandomEdges(500, 8000, 3));
+}
+
+}  // namespace gbbs
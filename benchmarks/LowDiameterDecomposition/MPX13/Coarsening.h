@@ -0,0 +1,349 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "LowDiameterDecomposition.h"
+#include "gbbs/contract.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/sample_sort.h"
+
+namespace gbbs {
+namespace coarsening {
+
+struct coarsening_params {
+  double beta = 0.2;
+  // Coarsening stops when a level has no edges, and also after max_levels
+  // contractions, once a level has at most target_n vertices, or when a level
+  // would keep more than max_ratio of the vertices of the previous one.
+  size_t max_levels = std::numeric_limits<size_t>::max();
+  size_t target_n = 1;
+  double max_ratio = 1.0;
+  // Whether the LDD of the input graph permutes its vertices. The LDDs of the
+  // contracted levels always do.
+  bool permute = false;
+};
+
+// Combines the weights of parallel edges into nothing, for unweighted
+// coarsening.
+struct no_weight {
+  using T = pbbslib::empty;
+  T identity;
+  static T f(T a, T b) { return T(); }
+};
+
+// By default, parallel edges keep their lightest weight.
+template <class W>
+using default_combine =
+    std::conditional_t<std::is_same<W, pbbslib::empty>::value, no_weight,
+                       pbbslib::minm<W>>;
+
+// The levels of a coarsening. Level 0 is the input graph; level l + 1 is
+// level l with each of its LDD clusters contracted into a vertex, and an
+// edge between two clusters weighted by combining the weights of the edges
+// between them.
+template <class W>
+struct hierarchy {
+  using graph = symmetric_graph<symmetric_vertex, W>;
+  using edge_type = typename graph::edge_type;
+
+  std::vector<size_t> n;  // the number of vertices of each level
+  std::vector<size_t> m;  // the number of (directed) edges of each level
+  // cluster[l][v] is the cluster of vertex v of level l, in
+  // [0, num_clusters[l]). Clusters [0, n[l + 1]) are the vertices of level
+  // l + 1; the others have no edges leaving them, and are dropped.
+  std::vector<sequence<uintE>> cluster;
+  std::vector<size_t> num_clusters;
+  // The graph of the last level, if it is not the input. The levels are built
+  // in two buffers allocated for the first two levels, so earlier levels are
+  // overwritten; Coarsen shows each level to a callback as it is built.
+  graph coarsest;
+
+  vertex_data* v_data[2] = {nullptr, nullptr};
+  edge_type* edges[2] = {nullptr, nullptr};
+  size_t n_cap[2] = {0, 0};
+  size_t m_cap[2] = {0, 0};
+
+  size_t num_levels() const { return n.size(); }
+
+  // Returns the vertex at `level` of each input vertex, or UINT_E_MAX if its
+  // cluster was dropped at an earlier level.
+  sequence<uintE> vertex_at(size_t level) const {
+    auto ids = sequence<uintE>(n[0], [](size_t i) { return (uintE)i; });
+    for (size_t l = 0; l < level; l++) {
+      par_for(0, n[0], pbbslib::kSequentialForThreshold, [&] (size_t i) {
+        if (ids[i] != UINT_E_MAX) {
+          uintE c = cluster[l][ids[i]];
+          ids[i] = (c < n[l + 1]) ? c : UINT_E_MAX;
+        }
+      });
+    }
+    return ids;
+  }
+
+  // Labels the input vertices by the parts of the last level: its vertices,
+  // and the clusters dropped before it. A part is named by its smallest input
+  // vertex. If the last level has no edges, the parts are the connected
+  // components.
+  sequence<uintE> parts() const {
+    size_t levels = num_levels() - 1;
+    // cluster_rep[l][c] is the smallest input vertex in cluster c of level l.
+    std::vector<sequence<uintE>> cluster_rep(levels);
+    auto rep = sequence<uintE>(n[0], [](size_t i) { return (uintE)i; });
+    for (size_t l = 0; l < levels; l++) {
+      cluster_rep[l] = sequence<uintE>(num_clusters[l], UINT_E_MAX);
+      auto& CR = cluster_rep[l];
+      par_for(0, n[l], pbbslib::kSequentialForThreshold, [&] (size_t v) {
+        uintE c = cluster[l][v];
+        if (rep[v] < CR[c]) {
+          pbbslib::write_min(&CR[c], rep[v], std::less<uintE>());
+        }
+      });
+      rep = sequence<uintE>(n[l + 1], [&](size_t c) { return CR[c]; });
+    }
+    for (size_t l = levels; l > 0; l--) {
+      auto& CR = cluster_rep[l - 1];
+      auto& C = cluster[l - 1];
+      auto next = n[l];
+      rep = sequence<uintE>(n[l - 1], [&](size_t v) {
+        uintE c = C[v];
+        return (c < next) ? rep[c] : CR[c];
+      });
+    }
+    return rep;
+  }
+
+  void del() {
+    for (size_t b = 0; b < 2; b++) {
+      if (v_data[b]) pbbslib::free_arrays(v_data[b], edges[b]);
+      v_data[b] = nullptr;
+      edges[b] = nullptr;
+    }
+    coarsest = graph();
+  }
+};
+
+namespace coarsening_internal {
+
+// An array that is reused across levels. Later levels are smaller, so it is
+// allocated once at the first level (and only grows if an estimate is
+// exceeded).
+template <class T>
+struct scratch {
+  T* a = nullptr;
+  size_t size = 0;
+
+  T* get(size_t needed) {
+    if (needed > size) {
+      if (a) pbbslib::free_array(a);
+      a = pbbslib::new_array_no_init<T>(needed);
+      size = needed;
+    }
+    return a;
+  }
+
+  void del() {
+    if (a) pbbslib::free_array(a);
+    a = nullptr;
+    size = 0;
+  }
+};
+
+// The working space of coarsen_level, kept across levels: the hash table
+// deduplicating inter-cluster edges, the inter-cluster edges, and the cluster
+// numbering, degree offsets and write cursors of the next level.
+template <class CW>
+struct level_space {
+  scratch<std::tuple<contract::edge, CW>> table;
+  scratch<std::tuple<uintE, uintE, CW>> edges;
+  scratch<uintE> active;
+  scratch<size_t> offsets;
+  scratch<size_t> cursors;
+
+  void del() {
+    table.del();
+    edges.del();
+    active.del();
+    offsets.del();
+    cursors.del();
+  }
+};
+
+// Builds level l + 1 of H from GL, the graph of level l, into the buffer
+// not holding GL. Returns false (leaving H unchanged) if coarsening stops at
+// level l.
+template <class Graph, class CW, class M>
+bool coarsen_level(Graph& GL, hierarchy<CW>& H, const coarsening_params& P,
+                   M& combine, level_space<CW>& space) {
+  using edge_type = typename hierarchy<CW>::edge_type;
+  size_t level = H.num_levels() - 1;
+  size_t n = GL.n;
+  if (GL.m == 0 || level >= P.max_levels || n <= P.target_n) return false;
+
+  timer ldd_t;
+  ldd_t.start();
+  auto clusters = LDD(GL, P.beta, P.permute || level > 0);
+  size_t num_clusters = contract::RelabelIds(clusters);
+  ldd_t.stop();
+  debug(ldd_t.reportTotal("ldd time"););
+
+  timer fetch_t;
+  fetch_t.start();
+  size_t max_edges = contract::count_intercluster(GL, clusters);
+  size_t table_size = contract::intercluster_table_size(max_edges);
+  auto edges = space.edges.get(max_edges);
+  size_t num_edges = contract::fetch_intercluster_weighted(
+      GL, clusters, combine, space.table.get(table_size), table_size, edges);
+  fetch_t.stop();
+  debug(fetch_t.reportTotal("fetch edges time"););
+
+  // Number the clusters with an edge first, so that they are the vertices of
+  // the next level, and the others after them.
+  auto active = pbbslib::make_sequence(space.active.get(num_clusters + 1),
+                                       num_clusters + 1);
+  par_for(0, num_clusters + 1, pbbslib::kSequentialForThreshold, [&] (size_t c)
+                  { active[c] = 0; });
+  par_for(0, num_edges, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    uintE u = std::get<0>(edges[i]), v = std::get<1>(edges[i]);
+    if (!active[u]) active[u] = 1;
+    if (!active[v]) active[v] = 1;
+  });
+  size_t num_active = pbbslib::scan_add_inplace(active);
+  if (num_active > P.max_ratio * n) return false;
+  par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t v) {
+    uintE c = clusters[v];
+    clusters[v] = (active[c] != active[c + 1]) ? active[c]
+                                               : num_active + c - active[c];
+  });
+
+  timer build_t;
+  build_t.start();
+  size_t m = 2 * num_edges;
+  size_t b = level % 2;
+  if (!H.v_data[b]) {
+    // The levels only shrink, so the first level using a buffer sizes it.
+    H.v_data[b] = pbbslib::new_array_no_init<vertex_data>(num_active);
+    H.edges[b] = pbbslib::new_array_no_init<edge_type>(m);
+    H.n_cap[b] = num_active;
+    H.m_cap[b] = m;
+  }
+  assert(num_active <= H.n_cap[b] && m <= H.m_cap[b]);
+  auto v_data = H.v_data[b];
+  auto nghs = H.edges[b];
+
+  auto offsets = pbbslib::make_sequence(space.offsets.get(num_active + 1),
+                                        num_active + 1);
+  par_for(0, num_active + 1, pbbslib::kSequentialForThreshold, [&] (size_t c)
+                  { offsets[c] = 0; });
+  par_for(0, num_edges, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    pbbslib::fetch_and_add(&offsets[active[std::get<0>(edges[i])]], (size_t)1);
+    pbbslib::fetch_and_add(&offsets[active[std::get<1>(edges[i])]], (size_t)1);
+  });
+  pbbslib::scan_add_inplace(offsets);
+  auto cursors = space.cursors.get(num_active);
+  par_for(0, num_active, pbbslib::kSequentialForThreshold, [&] (size_t c)
+                  { cursors[c] = offsets[c]; });
+  par_for(0, num_edges, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    auto [c_u, c_v, w] = edges[i];
+    uintE u = active[c_u], v = active[c_v];
+    nghs[pbbslib::fetch_and_add(&cursors[u], (size_t)1)] = edge_type(v, w);
+    nghs[pbbslib::fetch_and_add(&cursors[v], (size_t)1)] = edge_type(u, w);
+  });
+  par_for(0, num_active, 1, [&] (size_t c) {
+    size_t start = offsets[c], end = offsets[c + 1];
+    v_data[c].offset = start;
+    v_data[c].degree = end - start;
+    auto cmp = [](const edge_type& a, const edge_type& b) {
+      return std::get<0>(a) < std::get<0>(b);
+    };
+    // Contracting a giant cluster can leave a few very long lists.
+    if (end - start > 2048) {
+      pbbslib::sample_sort_inplace(
+          pbbslib::make_sequence(nghs + start, end - start), cmp);
+    } else {
+      std::sort(nghs + start, nghs + end, cmp);
+    }
+  });
+  build_t.stop();
+  debug(build_t.reportTotal("build level time"););
+
+  H.cluster.emplace_back(std::move(clusters));
+  H.num_clusters.push_back(num_clusters);
+  H.n.push_back(num_active);
+  H.m.push_back(m);
+  H.coarsest = typename hierarchy<CW>::graph(v_data, num_active, m, []() {}, nghs);
+  return true;
+}
+
+}  // namespace coarsening_internal
+
+// Coarsens G level by level: computes an LDD of the current level, and
+// contracts its clusters into the next level, combining the weights of
+// parallel edges with the monoid `combine` (no_weight drops them). Clusters
+// with no edges leaving them are dropped from the next level, but stay in
+// the cluster maps. visit(l, GL) is called with each level l > 0 as soon as
+// it is built, since it is overwritten two levels later.
+//
+// All levels are built in two buffers sized for the first two levels, and
+// the hash table, edge list and offsets used to build a level are sized for
+// the first level, so only the cluster maps (which the hierarchy keeps) and
+// the LDDs allocate after the second level. Call del() on the result to free
+// the buffers.
+template <class Graph, class M, class Visit>
+hierarchy<typename M::T> Coarsen(Graph& G, const coarsening_params& P,
+                                 M combine, Visit visit) {
+  using CW = typename M::T;
+  hierarchy<CW> H;
+  H.n.push_back(G.n);
+  H.m.push_back(G.m);
+  coarsening_internal::level_space<CW> space;
+  bool more = coarsening_internal::coarsen_level(G, H, P, combine, space);
+  while (more) {
+    visit(H.num_levels() - 1, H.coarsest);
+    more = coarsening_internal::coarsen_level(H.coarsest, H, P, combine, space);
+  }
+  space.del();
+  debug(std::cout << "# coarsening levels = " << H.num_levels() << std::endl;);
+  return H;
+}
+
+template <class Graph, class M>
+hierarchy<typename M::T> Coarsen(Graph& G, const coarsening_params& P,
+                                 M combine) {
+  using CW = typename M::T;
+  return Coarsen(G, P, combine,
+                 [](size_t, typename hierarchy<CW>::graph&) {});
+}
+
+template <class Graph>
+auto Coarsen(Graph& G, const coarsening_params& P = coarsening_params()) {
+  return Coarsen(G, P, default_combine<typename Graph::weight_type>());
+}
+
+}  // namespace coarsening
+}  // namespace gbbs
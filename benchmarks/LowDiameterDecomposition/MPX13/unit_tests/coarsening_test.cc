@@ -0,0 +1,209 @@
+#include "benchmarks/LowDiameterDecomposition/MPX13/Coarsening.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_io.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edges = std::vector<gbbs_io::Edge<intE>>;
+// The edges of a level, as (min, max) -> weight.
+using EdgeMap = std::map<std::pair<uintE, uintE>, intE>;
+
+template <class Graph>
+EdgeMap GetEdges(Graph& G) {
+  EdgeMap edges;
+  uintE prev;
+  auto add = [&](const uintE& src, const uintE& ngh, const intE& w) {
+    edges[{std::min(src, ngh), std::max(src, ngh)}] = w;
+    // Neighbor lists are sorted.
+    EXPECT_TRUE(prev == UINT_E_MAX || prev < ngh) << "vertex " << src;
+    prev = ngh;
+  };
+  for (size_t u = 0; u < G.n; u++) {
+    prev = UINT_E_MAX;
+    G.get_vertex(u).mapOutNgh(u, add, false);
+  }
+  return edges;
+}
+
+// Returns the connected component of every vertex, named by its smallest
+// vertex.
+std::vector<uintE> Components(size_t n, const Edges& edges) {
+  std::vector<std::vector<uintE>> adj(n);
+  for (const auto& e : edges) {
+    adj[e.from].push_back(e.to);
+    adj[e.to].push_back(e.from);
+  }
+  std::vector<uintE> component(n, UINT_E_MAX);
+  for (size_t s = 0; s < n; s++) {
+    if (component[s] != UINT_E_MAX) continue;
+    std::vector<uintE> todo = {(uintE)s};
+    component[s] = s;
+    while (!todo.empty()) {
+      uintE v = todo.back(); todo.pop_back();
+      for (uintE u : adj[v]) {
+        if (component[u] == UINT_E_MAX) {
+          component[u] = s;
+          todo.push_back(u);
+        }
+      }
+    }
+  }
+  return component;
+}
+
+// Coarsens the graph with `combine`, and checks each level against the
+// contraction of the one before it.
+template <class M>
+void CheckCoarsening(size_t n, const Edges& edge_list,
+                     const coarsening::coarsening_params& params, M combine) {
+  auto graph{gbbs_io::edge_list_to_symmetric_graph(edge_list)};
+  ASSERT_EQ(graph.n, n);
+  alloc_init(graph);
+  std::vector<EdgeMap> levels = {GetEdges(graph)};
+  auto visit = [&](size_t l, symmetric_graph<symmetric_vertex, intE>& GL) {
+    EXPECT_EQ(l, levels.size());
+    levels.push_back(GetEdges(GL));
+  };
+  auto H = coarsening::Coarsen(graph, params, combine, visit);
+  size_t num_levels = H.num_levels();
+  ASSERT_EQ(levels.size(), num_levels);
+  ASSERT_EQ(H.cluster.size(), num_levels - 1);
+  EXPECT_LE(num_levels - 1, params.max_levels);
+
+  for (size_t l = 0; l + 1 < num_levels; l++) {
+    const auto& C = H.cluster[l];
+    ASSERT_EQ(C.size(), H.n[l]);
+    EXPECT_LT(H.n[l + 1], H.n[l]);
+    EXPECT_EQ(H.m[l + 1], 2 * levels[l + 1].size());
+    // The clusters are numbered densely.
+    std::set<uintE> used(C.begin(), C.end());
+    EXPECT_EQ(used.size(), H.num_clusters[l]);
+    EXPECT_EQ(*used.rbegin(), H.num_clusters[l] - 1);
+    EdgeMap expected;
+    for (const auto& [e, w] : levels[l]) {
+      uintE a = C[e.first], b = C[e.second];
+      if (a == b) continue;
+      ASSERT_LT(a, H.n[l + 1]);
+      ASSERT_LT(b, H.n[l + 1]);
+      auto key = std::make_pair(std::min(a, b), std::max(a, b));
+      auto it = expected.find(key);
+      expected[key] = (it == expected.end()) ? w : combine.f(it->second, w);
+    }
+    EXPECT_EQ(expected, levels[l + 1]) << "level " << l + 1;
+  }
+
+  // vertex_at follows the cluster maps.
+  auto last = H.vertex_at(num_levels - 1);
+  auto parts = H.parts();
+  for (size_t v = 0; v < n; v++) {
+    uintE u = v;
+    for (size_t l = 0; l + 1 < num_levels && u != UINT_E_MAX; l++) {
+      u = H.cluster[l][u];
+      if (u >= H.n[l + 1]) u = UINT_E_MAX;
+    }
+    EXPECT_EQ(last[v], u);
+    EXPECT_LE(parts[v], v);
+    EXPECT_EQ(parts[parts[v]], parts[v]);
+  }
+  for (size_t v = 0; v < n; v++) {
+    if (last[v] == UINT_E_MAX) continue;
+    EXPECT_EQ(last[parts[v]], last[v]);
+  }
+
+  if (H.m.back() == 0) {
+    // Coarsening to the end leaves one part per component.
+    auto expected = Components(n, edge_list);
+    for (size_t v = 0; v < n; v++) {
+      EXPECT_EQ(parts[v], expected[v]) << "v = " << v;
+    }
+  }
+  H.del();
+}
+
+Edges PseudorandomEdges(uintE n) {
+  // A sparse random graph over the first half of the vertices, paths over
+  // the rest, and a few isolated vertices.
+  graph_test::DistinctEdgeList<intE> edges;
+  graph_test::PseudorandomGenerator generator{1};
+  for (size_t i = 0; i < 2 * n; i++) {
+    uintE u = generator.Next() % (n / 2);
+    uintE v = generator.Next() % (n / 2);
+    edges.Add(u, v, 1 + generator.Next() % 100);
+  }
+  for (uintE v = n / 2; v + 1 < n - 3; v++) {
+    if (v % 17 != 0) edges.Add(v, v + 1, 1 + generator.Next() % 100);
+  }
+  // The last vertex needs an edge for the graph to have n vertices.
+  edges.Add(n - 1, 0, 1);
+  return edges.edges();
+}
+
+}  // namespace
+
+TEST(Coarsening, SmallGraph) {
+  // Graph diagram:
+  //   0 - 1 - 2 - 3     5 - 6     8
+  //    \     /          |
+  //     - 4 -           7
+  const Edges kEdges{
+    {0, 1, 3}, {1, 2, 1}, {2, 3, 4}, {0, 4, 2}, {4, 2, 5},
+    {5, 6, 1}, {5, 7, 2}, {8, 8, 1},
+  };
+  coarsening::coarsening_params params;
+  CheckCoarsening(9, kEdges, params, pbbslib::minm<intE>());
+}
+
+TEST(Coarsening, PseudorandomGraphToComponents) {
+  constexpr uintE kNumVertices{3000};
+  auto edges = PseudorandomEdges(kNumVertices);
+  coarsening::coarsening_params params;
+  CheckCoarsening(kNumVertices, edges, params, pbbslib::minm<intE>());
+  params.permute = true;
+  params.beta = 0.5;
+  CheckCoarsening(kNumVertices, edges, params, pbbslib::addm<intE>());
+}
+
+TEST(Coarsening, StopsEarly) {
+  constexpr uintE kNumVertices{3000};
+  auto edges = PseudorandomEdges(kNumVertices);
+  coarsening::coarsening_params params;
+  params.max_levels = 1;
+  CheckCoarsening(kNumVertices, edges, params, pbbslib::addm<intE>());
+  params.max_levels = std::numeric_limits<size_t>::max();
+  params.beta = 0.05;
+  params.target_n = 500;
+  CheckCoarsening(kNumVertices, edges, params, pbbslib::maxm<intE>());
+}
+
+TEST(Coarsening, LongAdjacencyLists) {
+  // A hub adjacent to the middle of many disjoint paths, so that the hub's
+  // cluster is adjacent to thousands of clusters after the first level.
+  constexpr uintE kNumPaths{3000};
+  constexpr uintE kPathLength{8};
+  Edges edges;
+  for (uintE p = 0; p < kNumPaths; p++) {
+    uintE first = 1 + p * kPathLength;
+    for (uintE i = 0; i + 1 < kPathLength; i++) {
+      edges.push_back({first + i, first + i + 1, (intE)(1 + (p + i) % 7)});
+    }
+    edges.push_back({0, first + kPathLength / 2, (intE)(1 + p % 5)});
+  }
+  coarsening::coarsening_params params;
+  params.beta = 4;
+  CheckCoarsening(1 + kNumPaths * kPathLength, edges, params,
+                  pbbslib::addm<intE>());
+  params.permute = true;
+  CheckCoarsening(1 + kNumPaths * kPathLength, edges, params,
+                  pbbslib::minm<intE>());
+}
+
+}  // namespace gbbs
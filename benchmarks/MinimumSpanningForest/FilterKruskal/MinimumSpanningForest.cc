@@ -0,0 +1,85 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Usage:
+// numactl -i all ./MinimumSpanningForest -s -w -kkt -rounds 1 twitter_wgh_SJ
+// flags:
+//   required:
+//     -s : indicate that the graph is symmetric
+//     -w: indicate that the graph is weighted
+//   optional:
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -base_size <k> : sort and run Kruskal on batches of at most k edges
+//     -boruvka_rounds <k> : the number of Boruvka rounds to run on a batch
+//                           before partitioning it (default 1)
+//     -batch_factor <f> : take about f*n edges out of the graph per round
+//     -kkt : first remove the edges that are heavy for the MSF of a sample
+//     -kkt_sample <p> : the sampling probability for -kkt (default 0.1)
+
+#include "MinimumSpanningForest.h"
+
+namespace gbbs {
+
+template <template <class W> class vertex, class W>
+double MinimumSpanningForest_runner(symmetric_graph<vertex, W>& GA, commandLine P) {
+  MinimumSpanningForest_filter_kruskal::fk_params params;
+  params.base_size = P.getOptionLongValue("-base_size", params.base_size);
+  params.boruvka_rounds =
+      P.getOptionLongValue("-boruvka_rounds", params.boruvka_rounds);
+  params.batch_factor =
+      P.getOptionDoubleValue("-batch_factor", params.batch_factor);
+  params.kkt = P.getOption("-kkt");
+  params.kkt_sample = P.getOptionDoubleValue("-kkt_sample", params.kkt_sample);
+
+  std::cout << "### Application: MinimumSpanningForest (Minimum Spanning Forest)" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << GA.n << std::endl;
+  std::cout << "### m: " << GA.m << std::endl;
+  std::cout << "### Params: -base_size = " << params.base_size
+            << " -boruvka_rounds = " << params.boruvka_rounds
+            << " -batch_factor = " << params.batch_factor
+            << " -kkt = " << params.kkt
+            << " -kkt_sample = " << params.kkt_sample << std::endl;
+  std::cout << "### ------------------------------------" << std::endl;
+
+  timer mst_t;
+  mst_t.start();
+  auto mst = MinimumSpanningForest_filter_kruskal::MinimumSpanningForest(GA, params);
+  double tt = mst_t.stop();
+  auto wgh_imap = pbbslib::make_sequence<size_t>(
+      mst.size(), [&](size_t i) { return std::get<2>(mst[i]); });
+  std::cout << "total weight = " << pbbslib::reduce_add(wgh_imap) << "\n";
+
+  std::cout << "### Running Time: " << tt << std::endl;
+
+  // MinimumSpanningForest mutates the underlying graph (unless it is copied, which we don't do to
+  // prevent memory issues), so we make sure the algorithm is run exactly once.
+  exit(0);
+  return tt;
+}
+
+}  // namespace gbbs
+
+generate_symmetric_weighted_main(gbbs::MinimumSpanningForest_runner, true);
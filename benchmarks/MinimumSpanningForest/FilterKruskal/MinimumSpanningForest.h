@@ -0,0 +1,482 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include "benchmarks/MinimumSpanningForest/Boruvka/MinimumSpanningForest.h"
+#include "benchmarks/SpanningForest/rooted_forest.h"
+#include "gbbs/gbbs.h"
+#include "gbbs/speculative_for.h"
+#include "gbbs/union_find.h"
+#include "gbbs/pbbslib/dyn_arr.h"
+
+#include "pbbslib/random.h"
+#include "pbbslib/sample_sort.h"
+
+// Filter-Kruskal (Osipov, Sanders and Singler) over a mutable graph. Each
+// round takes the edges below a sampled pivot weight out of the graph, and
+// then removes the heavier edges that the new forest shortcuts with
+// connectivity queries, so that heavy edges are filtered before they are ever
+// copied or sorted. Each batch taken out of the graph is solved by the same
+// partition-and-filter recursion in memory, optionally starting every level
+// with Boruvka rounds, and down to a sorted union-find Kruskal on small
+// batches. Optionally, the graph is first thinned by the random-sampling
+// filter of Karger, Klein and Tarjan: the edges that are heavier than every
+// edge on the path between their endpoints in the MSF of a sample are in no
+// MSF.
+
+namespace gbbs {
+namespace MinimumSpanningForest_filter_kruskal {
+
+struct fk_params {
+  // Batches of at most this many edges are sorted and passed to Kruskal.
+  size_t base_size = 1 << 14;
+  // The number of Boruvka rounds run on a batch before it is partitioned.
+  size_t boruvka_rounds = 1;
+  // The number of edges to take out of the graph per round, as a multiple
+  // of n.
+  double batch_factor = 1.0;
+  // Whether to run the KKT sampling filter first, and its sampling rate.
+  bool kkt = false;
+  double kkt_sample = 0.1;
+};
+
+// The number of edges touched by each phase.
+struct fk_stats {
+  size_t extracted = 0;      // taken out of the graph below a pivot
+  size_t graph_filtered = 0; // scanned by the connectivity filter on the graph
+  size_t boruvka = 0;        // scanned by Boruvka rounds
+  size_t partitioned = 0;    // partitioned around a pivot in memory
+  size_t filtered = 0;       // scanned by the connectivity filter in memory
+  size_t sorted = 0;         // sorted by weight for Kruskal
+  size_t kruskal = 0;        // passed to union-find Kruskal
+  size_t kkt_sampled = 0;    // in the KKT sample
+  size_t kkt_removed = 0;    // removed from the graph by the KKT filter
+
+  void report() const {
+    std::cout << "# edges extracted = " << extracted << "\n";
+    std::cout << "# edges filtered on the graph = " << graph_filtered << "\n";
+    std::cout << "# edges in boruvka rounds = " << boruvka << "\n";
+    std::cout << "# edges partitioned = " << partitioned << "\n";
+    std::cout << "# edges filtered in memory = " << filtered << "\n";
+    std::cout << "# edges sorted = " << sorted << "\n";
+    std::cout << "# edges in kruskal = " << kruskal << "\n";
+    std::cout << "# edges in kkt sample = " << kkt_sampled << "\n";
+    std::cout << "# edges removed by kkt = " << kkt_removed << "\n";
+  }
+};
+
+constexpr size_t pivot_sample_size = 1000;
+
+using MinimumSpanningForest_boruvka::hash_to_range;
+using MinimumSpanningForest_boruvka::key_for_pair;
+
+// The state shared by the batches of one MSF computation: the union-find
+// structure over the graph's vertices, scratch space of size n, and the
+// output forest.
+template <class W>
+struct fk_state {
+  using edge = std::tuple<uintE, uintE, W>;
+  using vtxid_wgh_pair = std::pair<uintE, W>;
+  using res = reservation<uintE>;
+
+  size_t n;
+  UnionFind uf;
+  res* R;
+  vtxid_wgh_pair* min_edges;
+  pbbslib::dyn_arr<edge> mst_edges;
+  pbbslib::random r;
+  fk_params params;
+  fk_stats stats;
+
+  fk_state(size_t n, const fk_params& params)
+      : n(n), uf(n), mst_edges(n), params(params) {
+    R = pbbslib::new_array_no_init<res>(n);
+    par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i)
+                    { R[i] = res(); });
+    min_edges = pbbslib::new_array_no_init<vtxid_wgh_pair>(n);
+  }
+
+  void del() {
+    uf.clear();
+    pbbslib::free_array(R);
+    pbbslib::free_array(min_edges);
+  }
+
+  bool connected(const edge& e) {
+    return uf.find(std::get<0>(e)) == uf.find(std::get<1>(e));
+  }
+
+  // Keeps the edges of E whose endpoints are not yet connected.
+  sequence<edge> filter_connected(sequence<edge>& E) {
+    stats.filtered += E.size();
+    return pbbslib::filter(E, [&](const edge& e) { return !connected(e); });
+  }
+
+  // Runs Kruskal on E with the union-find speculative_for from PBBS. E must
+  // be sorted by weight unless all of its weights are equal.
+  void kruskal(sequence<edge>& E, bool sort) {
+    size_t m = E.size();
+    if (m == 0) return;
+    if (sort) {
+      auto cmp_by_wgh = [](const edge& left, const edge& right) {
+        return std::get<2>(left) < std::get<2>(right);
+      };
+      pbbslib::sample_sort_inplace(E.slice(), cmp_by_wgh);
+      stats.sorted += m;
+    }
+    stats.kruskal += m;
+    auto EA = edge_array<W>(E.begin(), n, n, m);
+    auto mstFlags = sequence<bool>(m, false);
+    auto UFStep = make_uf_step<uintE>(EA, R, mstFlags, uf);
+    speculative_for<uintE>(UFStep, 0, m, 8);
+    UFStep.clear();
+    auto edges_ret = pbbslib::pack(E, mstFlags);
+    mst_edges.copyIn(edges_ret, edges_ret.size());
+  }
+
+  // One Boruvka round on E: every component of the current forest that has
+  // an edge in E takes its lightest one. Ties are broken by the position in
+  // E, so the chosen edges form a forest apart from components that choose
+  // each other, where only the larger root is linked. Correct as long as all
+  // edges not yet processed are at least as heavy as every edge of E.
+  void boruvka_round(sequence<edge>& E) {
+    size_t m = E.size();
+    stats.boruvka += m;
+    auto less = [](const vtxid_wgh_pair& a, const vtxid_wgh_pair& b) {
+      return (a.second < b.second) || (a.second == b.second && a.first < b.first);
+    };
+    auto empty = std::make_pair(UINT_E_MAX, std::numeric_limits<W>::max());
+    auto roots = sequence<std::pair<uintE, uintE>>(m, [&](size_t i) {
+      return std::make_pair((uintE)uf.find(std::get<0>(E[i])),
+                            (uintE)uf.find(std::get<1>(E[i])));
+    });
+    par_for(0, m, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      min_edges[roots[i].first] = empty;
+      min_edges[roots[i].second] = empty;
+    });
+    par_for(0, m, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE ru = roots[i].first, rv = roots[i].second;
+      if (ru != rv) {
+        auto cas_e = std::make_pair((uintE)i, std::get<2>(E[i]));
+        pbbslib::write_min(min_edges + ru, cas_e, less);
+        pbbslib::write_min(min_edges + rv, cas_e, less);
+      }
+    });
+    auto chosen = sequence<bool>(m, [&](size_t i) {
+      uintE ru = roots[i].first, rv = roots[i].second;
+      return ru != rv && (min_edges[ru].first == i || min_edges[rv].first == i);
+    });
+    par_for(0, m, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      if (chosen[i]) {
+        uintE ru = roots[i].first, rv = roots[i].second;
+        bool cu = min_edges[ru].first == i, cv = min_edges[rv].first == i;
+        if (cu && cv) {
+          uf.link(std::max(ru, rv), std::min(ru, rv));
+        } else if (cu) {
+          uf.link(ru, rv);
+        } else {
+          uf.link(rv, ru);
+        }
+      }
+    });
+    auto edges_ret = pbbslib::pack(E, chosen);
+    mst_edges.copyIn(edges_ret, edges_ret.size());
+  }
+
+  // Returns a pivot weight: the median of a sample of E's weights.
+  W sample_pivot(sequence<edge>& E) {
+    size_t m = E.size();
+    auto sample = sequence<W>(pivot_sample_size, [&](size_t i) {
+      return std::get<2>(E[r.ith_rand(i) % m]);
+    });
+    r = r.next();
+    pbbslib::sample_sort_inplace(sample.slice(), std::less<W>());
+    return sample[pivot_sample_size / 2];
+  }
+
+  // Adds the MSF edges of E, which must be at most as heavy as every edge
+  // that has not been processed yet, to mst_edges.
+  void filter_kruskal(sequence<edge>& E) {
+    if (E.size() <= params.base_size) {
+      kruskal(E, /* sort = */ true);
+      return;
+    }
+    sequence<edge> filtered;
+    for (size_t i = 0; i < params.boruvka_rounds && E.size() > 0; i++) {
+      boruvka_round(E);
+      filtered = filter_connected(E);
+      E = std::move(filtered);
+    }
+    if (E.size() <= params.base_size) {
+      kruskal(E, /* sort = */ true);
+      return;
+    }
+    // Three-way partition around the pivot, so that the recursion always
+    // makes progress, and the edges equal to the pivot need no sorting.
+    W pivot = sample_pivot(E);
+    stats.partitioned += E.size();
+    auto light = pbbslib::filter(E, [&](const edge& e) {
+      return std::get<2>(e) < pivot;
+    });
+    auto equal = pbbslib::filter(E, [&](const edge& e) {
+      return std::get<2>(e) == pivot;
+    });
+    auto heavy = pbbslib::filter(E, [&](const edge& e) {
+      return std::get<2>(e) > pivot;
+    });
+    E.clear();
+    filter_kruskal(light);
+    light.clear();
+    auto equal_left = filter_connected(equal);
+    equal.clear();
+    kruskal(equal_left, /* sort = */ false);
+    equal_left.clear();
+    auto heavy_left = filter_connected(heavy);
+    heavy.clear();
+    filter_kruskal(heavy_left);
+  }
+};
+
+// Maximum edge weights on forest paths by binary lifting, over the rooted
+// form of the forest: O(n log d) space for a forest of depth d, and
+// O(log d) time per query.
+template <class W>
+struct forest_path_max {
+  spanning_forest::rooted_forest F;
+  std::vector<sequence<uintE>> up;
+  std::vector<sequence<W>> max_wgh;
+
+  template <class Edges>
+  forest_path_max(size_t n, Edges& forest_edges) {
+    size_t k = forest_edges.size();
+    auto edges = sequence<gbbs::edge>(k, [&](size_t i) {
+      return std::make_pair(std::get<0>(forest_edges[i]),
+                            std::get<1>(forest_edges[i]));
+    });
+    F = spanning_forest::RootedForest(n, edges);
+    auto parent_wgh = sequence<W>(n, std::numeric_limits<W>::lowest());
+    par_for(0, k, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE u = std::get<0>(forest_edges[i]), v = std::get<1>(forest_edges[i]);
+      uintE child = (F.parents[u] == v) ? u : v;
+      parent_wgh[child] = std::get<2>(forest_edges[i]);
+    });
+    uintE max_depth = pbbslib::reduce(F.depth, pbbslib::maxm<uintE>());
+    size_t levels = pbbslib::log2_up((size_t)max_depth + 1) + 1;
+    up.push_back(sequence<uintE>(n, [&](size_t v) { return F.parents[v]; }));
+    max_wgh.push_back(std::move(parent_wgh));
+    for (size_t j = 1; j < levels; j++) {
+      auto& U = up[j - 1];
+      auto& M = max_wgh[j - 1];
+      max_wgh.push_back(sequence<W>(n, [&](size_t v) {
+        return std::max(M[v], M[U[v]]);
+      }));
+      up.push_back(sequence<uintE>(n, [&](size_t v) { return U[U[v]]; }));
+    }
+  }
+
+  // Returns the maximum weight on the path between u and v, and false if
+  // they are in different trees.
+  std::pair<bool, W> query(uintE u, uintE v) const {
+    W ret = std::numeric_limits<W>::lowest();
+    if (F.root[u] != F.root[v]) return std::make_pair(false, ret);
+    if (F.depth[u] < F.depth[v]) std::swap(u, v);
+    uintE diff = F.depth[u] - F.depth[v];
+    for (size_t j = 0; diff > 0; j++, diff >>= 1) {
+      if (diff & 1) {
+        ret = std::max(ret, max_wgh[j][u]);
+        u = up[j][u];
+      }
+    }
+    if (u == v) return std::make_pair(true, ret);
+    for (size_t j = up.size(); j-- > 0;) {
+      if (up[j][u] != up[j][v]) {
+        ret = std::max(ret, std::max(max_wgh[j][u], max_wgh[j][v]));
+        u = up[j][u];
+        v = up[j][v];
+      }
+    }
+    ret = std::max(ret, std::max(max_wgh[0][u], max_wgh[0][v]));
+    return std::make_pair(true, ret);
+  }
+};
+
+// The KKT filter: computes the MSF of a sample of the edges (one direction
+// of each, kept with probability params.kkt_sample), and removes from GA
+// every edge that is heavier than the path between its endpoints in it.
+template <template <class W> class vertex, class W>
+inline void kkt_filter(symmetric_graph<vertex, W>& GA, fk_state<W>& S) {
+  size_t n = GA.n;
+  size_t range = (1L << pbbslib::log2_up(GA.m)) - 1;
+  size_t threshold = S.params.kkt_sample * range;
+  auto r = S.r;
+  auto pred = [&](const uintE& src, const uintE& ngh, const W& wgh) -> bool {
+    return src < ngh &&
+           hash_to_range(key_for_pair(src, ngh, r), range) < threshold;
+  };
+  auto sampled = sample_edges(GA, pred);
+  S.r = S.r.next();
+  S.stats.kkt_sampled += sampled.non_zeros;
+  auto sample = sequence<std::tuple<uintE, uintE, W>>(sampled.non_zeros,
+      [&](size_t i) { return sampled.E[i]; });
+  sampled.del();
+
+  auto sample_params = S.params;
+  sample_params.kkt = false;
+  fk_state<W> sample_state(n, sample_params);
+  sample_state.r = S.r;
+  sample_state.filter_kruskal(sample);
+  auto& forest = sample_state.mst_edges;
+  auto forest_edges = pbbs::make_range(forest.A, forest.A + forest.size);
+  forest_path_max<W> PM(n, forest_edges);
+  sample_state.mst_edges.del();
+  sample_state.del();
+
+  size_t m_before = GA.m;
+  auto heavy_pred = [&](const uintE& src, const uintE& ngh,
+                        const W& wgh) -> int {
+    auto [connected, path_wgh] = PM.query(src, ngh);
+    return connected && wgh > path_wgh;
+  };
+  filter_edges(GA, heavy_pred, no_output);
+  S.stats.kkt_removed += m_before - GA.m;
+}
+
+// Takes about k of the lightest edges out of G, one direction each, with the
+// sampled splitter of Boruvka's get_top_k. The other direction of every edge
+// in G is dropped in the first round, where G.m still counts both directions
+// of every edge. Boruvka's version may take no edges when the splitter's
+// weight is tied on a few edges, in which case all of them are taken.
+template <template <class W> class vertex, class W>
+inline edge_array<W> get_top_k(symmetric_graph<vertex, W>& G, size_t k,
+                               pbbslib::random r, bool first_round) {
+  size_t m = first_round ? (G.m / 2) : G.m;
+  auto take_all = [&](const uintE& src, const uintE& ngh, const W& wgh) {
+    return (src < ngh) ? 2 : 1;
+  };
+  if (k >= m) {
+    return filter_edges(G, take_all);
+  }
+  auto E = MinimumSpanningForest_boruvka::get_top_k(
+      G, first_round ? 2 * k : k, r, first_round);
+  if (E.non_zeros == 0) {
+    E.del();
+    return filter_edges(G, take_all);
+  }
+  return E;
+}
+
+// Removes the edges of G whose endpoints are connected by the forest so far.
+template <template <class W> class vertex, class W>
+inline void pack_shortcut_edges(symmetric_graph<vertex, W>& G,
+                                fk_state<W>& S) {
+  S.stats.graph_filtered += G.m;
+  auto filter_pred = [&](const uintE& src, const uintE& ngh,
+                         const W& wgh) -> int {
+    return S.uf.find(src) == S.uf.find(ngh);
+  };
+  filter_edges(G, filter_pred, no_output);
+}
+
+// Returns the edges of a minimum spanning forest of GA. Like the other MSF
+// implementations, this consumes the edges of GA.
+template <template <class W> class vertex, class W,
+          typename std::enable_if<!std::is_same<W, pbbslib::empty>::value,
+                                  int>::type = 0>
+inline sequence<std::tuple<uintE, uintE, W>> MinimumSpanningForest(
+    symmetric_graph<vertex, W>& GA, const fk_params& params = fk_params()) {
+  using edge = std::tuple<uintE, uintE, W>;
+  size_t n = GA.n;
+  fk_state<W> S(n, params);
+
+  if (params.kkt && GA.m > 0) {
+    timer kkt_t;
+    kkt_t.start();
+    kkt_filter(GA, S);
+    kkt_t.stop();
+    kkt_t.reportTotal("kkt filter time");
+    std::cout << "After kkt filter, m is now " << GA.m << "\n";
+  }
+
+  size_t batch_size = std::max((size_t)(params.batch_factor * n), (size_t)1);
+  size_t round = 0;
+  while (GA.m > 0) {
+    timer round_t;
+    round_t.start();
+    debug(std::cout << "round = " << round << " m = " << GA.m
+                    << " MinimumSpanningForest size = " << S.mst_edges.size
+                    << "\n";);
+
+    // 1. Take the edges below a pivot out of the graph.
+    timer get_t;
+    get_t.start();
+    auto E = get_top_k(GA, batch_size, S.r, round == 0);
+    S.r = S.r.next();
+    get_t.stop();
+    debug(get_t.reportTotal("get time"););
+    S.stats.extracted += E.non_zeros;
+    auto batch = sequence<edge>(E.non_zeros, [&](size_t i) { return E.E[i]; });
+    E.del();
+
+    // 2. Solve them in memory.
+    timer fk_t;
+    fk_t.start();
+    S.filter_kruskal(batch);
+    fk_t.stop();
+    debug(fk_t.reportTotal("filter-kruskal time"););
+
+    // 3. Filter the remaining (heavier) edges with connectivity queries.
+    if (GA.m > 0) {
+      timer pack_t;
+      pack_t.start();
+      pack_shortcut_edges(GA, S);
+      pack_t.stop();
+      debug(pack_t.reportTotal("pack time"););
+    }
+    round++;
+    round_t.stop();
+    debug(round_t.reportTotal("round time"););
+  }
+  S.stats.report();
+  std::cout << "#edges in output mst: " << S.mst_edges.size << "\n";
+
+  auto mst = sequence<edge>(S.mst_edges.size,
+                            [&](size_t i) { return S.mst_edges.A[i]; });
+  S.mst_edges.del();
+  S.del();
+  return mst;
+}
+
+template <
+    template <class W> class vertex, class W,
+    typename std::enable_if<std::is_same<W, pbbslib::empty>::value, int>::type = 0>
+inline sequence<std::tuple<uintE, uintE, W>> MinimumSpanningForest(
+    symmetric_graph<vertex, W>& GA, const fk_params& params = fk_params()) {
+  std::cout << "Unimplemented for unweighted graphs"
+            << "\n";
+  exit(0);
+}
+
+}  // namespace MinimumSpanningForest_filter_kruskal
+}  // namespace gbbs
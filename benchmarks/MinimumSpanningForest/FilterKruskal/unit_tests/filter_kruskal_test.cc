@@ -0,0 +1,76 @@
+#include "benchmarks/MinimumSpanningForest/FilterKruskal/MinimumSpanningForest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_io.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edges = std::vector<gbbs_io::Edge<intE>>;
+namespace fk = MinimumSpanningForest_filter_kruskal;
+
+void CheckAllParams(const Edges& edges) {
+  std::vector<fk::fk_params> configs(5);
+  configs[1].base_size = 4;
+  configs[2].base_size = 4;
+  configs[2].boruvka_rounds = 0;
+  configs[3].base_size = 8;
+  configs[3].boruvka_rounds = 3;
+  configs[3].kkt = true;
+  configs[3].kkt_sample = 0.3;
+  configs[4].kkt = true;
+  configs[4].batch_factor = 0.05;
+  for (const auto& params : configs) {
+    // MinimumSpanningForest consumes the graph.
+    auto graph{gbbs_io::edge_list_to_symmetric_graph(edges)};
+    size_t n = graph.n;
+    auto expected = graph_test::KruskalMSF(n, edges);
+    auto mst = fk::MinimumSpanningForest(graph, params);
+    EXPECT_EQ(graph.m, 0);
+    ASSERT_EQ(mst.size(), expected.first);
+    int64_t weight = 0;
+    graph_test::SequentialUnionFind components{n};
+    for (const auto& [u, v, w] : mst) {
+      weight += w;
+      // The output is a forest.
+      EXPECT_TRUE(components.Unite(u, v));
+    }
+    EXPECT_EQ(weight, expected.second);
+  }
+}
+
+}  // namespace
+
+TEST(FilterKruskal, SmallGraph) {
+  // Two components: a weighted 4-cycle with a chord, and a triangle.
+  const Edges kEdges{
+    {0, 1, 4}, {1, 2, 1}, {2, 3, 3}, {3, 0, 2}, {0, 2, 5},
+    {4, 5, 7}, {5, 6, 7}, {4, 6, 7},
+  };
+  CheckAllParams(kEdges);
+}
+
+TEST(FilterKruskal, PseudorandomGraph) {
+  // A random graph with few distinct weights, so that pivots have many
+  // ties, and some isolated pieces. The endpoints are distinct, since the
+  // graph keeps only one weight per pair.
+  constexpr uintE kNumVertices{500};
+  graph_test::DistinctEdgeList<intE> edges;
+  graph_test::PseudorandomGenerator generator{1};
+  for (size_t i = 0; i < 3000; i++) {
+    uintE u = generator.Next() % kNumVertices;
+    uintE v = generator.Next() % kNumVertices;
+    edges.Add(u, v, generator.Next() % 20);
+  }
+  for (uintE v = 1; v < kNumVertices; v += 3) {
+    edges.Add(v - 1, v, 1 + generator.Next() % 1000);
+  }
+  CheckAllParams(edges.edges());
+}
+
+}  // namespace gbbs
@@ -0,0 +1,174 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "gbbs/gbbs.h"
+
+// Boruvka's algorithm directly over the adjacency lists of the graph, for
+// graphs whose edges cannot be materialized, such as byte-compressed weighted
+// graphs that are larger than memory once decompressed. The graph is only
+// read: in each round, every active vertex finds its lightest edge leaving its
+// component with reduceOutNgh, the components hook along their lightest edges,
+// and the contraction is kept lazily as a component label per vertex, so that
+// edges inside a component are skipped when they are next scanned. Vertices
+// without edges leaving their component are never scanned again. Besides the
+// graph, the algorithm uses O(n) space, and O(m + n) work per round.
+
+namespace gbbs {
+namespace MinimumSpanningForest_lazy_boruvka {
+
+// Names an undirected edge by its endpoints, so that both of its directions
+// compare equal.
+inline size_t edge_key(uintE u, uintE v) {
+  if (u > v) std::swap(u, v);
+  return (static_cast<size_t>(u) << 32) + static_cast<size_t>(v);
+}
+
+inline uintE key_first(size_t key) { return key >> 32; }
+inline uintE key_second(size_t key) { return key & UINT_E_MAX; }
+
+// Returns the edges of a minimum spanning forest of GA, without modifying it.
+// Ties between edges of equal weight are broken by their endpoints.
+template <class Graph>
+inline sequence<std::tuple<uintE, uintE, typename Graph::weight_type>>
+MinimumSpanningForest(Graph& GA) {
+  using W = typename Graph::weight_type;
+  using edge = std::tuple<uintE, uintE, W>;
+  using wgh_key = std::pair<W, size_t>;
+  constexpr W max_wgh = std::numeric_limits<W>::max();
+  constexpr size_t no_key = std::numeric_limits<size_t>::max();
+  size_t n = GA.n;
+
+  // comp[v] is the root of v's component. For a root c, min_wgh[c] and
+  // min_key[c] give the lightest edge leaving the component, and parents[c]
+  // the component it hooks onto.
+  auto comp = sequence<uintE>(n, [](size_t i) { return (uintE)i; });
+  auto parents = sequence<uintE>(n, [](size_t i) { return (uintE)i; });
+  auto min_wgh = sequence<W>(n, max_wgh);
+  auto min_key = sequence<size_t>(n, no_key);
+  auto vtxs = sequence<uintE>(n, [](size_t i) { return (uintE)i; });
+  auto best = sequence<wgh_key>::no_init(n);
+  auto mst = sequence<edge>::no_init(n);
+  size_t n_in_mst = 0;
+
+  auto monoid = pbbslib::make_monoid(
+      [](const wgh_key& l, const wgh_key& r) { return std::min(l, r); },
+      std::make_pair(max_wgh, no_key));
+  size_t round = 0;
+  while (vtxs.size() > 0) {
+    size_t k = vtxs.size();
+    debug(std::cout << "Boruvka round: " << round << " active: " << k << "\n";);
+
+    // 1. Find the lightest edge leaving each component, first by weight and
+    // then by key.
+    timer min_t;
+    min_t.start();
+    par_for(0, k, 1, [&] (size_t i) {
+      uintE v = vtxs[i];
+      uintE c = comp[v];
+      auto map_f = [&](const uintE& src, const uintE& ngh, const W& wgh) {
+        return (comp[ngh] == c) ? std::make_pair(max_wgh, no_key)
+                                : std::make_pair(wgh, edge_key(src, ngh));
+      };
+      best[i] = GA.get_vertex(v).template reduceOutNgh<wgh_key>(v, map_f, monoid);
+      min_wgh[c] = max_wgh;
+      min_key[c] = no_key;
+    });
+    par_for(0, k, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE c = comp[vtxs[i]];
+      if (best[i].second != no_key && best[i].first < min_wgh[c]) {
+        pbbslib::write_min(&min_wgh[c], best[i].first, std::less<W>());
+      }
+    });
+    par_for(0, k, pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE c = comp[vtxs[i]];
+      if (best[i].second != no_key && best[i].first == min_wgh[c] &&
+          best[i].second < min_key[c]) {
+        pbbslib::write_min(&min_key[c], best[i].second, std::less<size_t>());
+      }
+    });
+    min_t.stop();
+    debug(min_t.reportTotal("min edge time"););
+
+    // 2. Hook every component onto the other side of its lightest edge. The
+    // hooks form a forest, except for pairs of components that chose the
+    // same edge, where only the larger root hooks.
+    timer hook_t;
+    hook_t.start();
+    auto roots = pbbslib::filter(vtxs, [&](uintE v) {
+      return comp[v] == v && min_key[v] != no_key;
+    });
+    auto hooks = sequence<bool>(roots.size(), [&](size_t i) {
+      uintE c = roots[i];
+      size_t key = min_key[c];
+      uintE u = comp[key_first(key)], v = comp[key_second(key)];
+      uintE other = (u == c) ? v : u;
+      bool mutual = min_key[other] == key && min_wgh[other] == min_wgh[c];
+      parents[c] = (mutual && c < other) ? c : other;
+      return parents[c] != c;
+    });
+    auto new_edges = pbbslib::pack(roots, hooks);
+    par_for(0, new_edges.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE c = new_edges[i];
+      size_t key = min_key[c];
+      mst[n_in_mst + i] =
+          std::make_tuple(key_first(key), key_second(key), min_wgh[c]);
+    });
+    n_in_mst += new_edges.size();
+    hook_t.stop();
+    debug(hook_t.reportTotal("hook time"););
+
+    // 3. Drop the vertices that have no edges leaving their component; the
+    // roots stay while their component has such edges.
+    auto next_vtxs = pbbslib::pack(vtxs, sequence<bool>(k, [&](size_t i) {
+      uintE v = vtxs[i];
+      uintE c = comp[v];
+      return min_key[c] != no_key && (best[i].second != no_key || c == v);
+    }));
+
+    // 4. Pointer jump to the new roots, and relabel all vertices: dropped
+    // vertices can still be neighbors of active ones.
+    timer jump_t;
+    jump_t.start();
+    par_for(0, roots.size(), [&] (size_t i) {
+      uintE c = roots[i];
+      while (parents[c] != parents[parents[c]]) {
+        parents[c] = parents[parents[c]];
+      }
+    });
+    par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t v) {
+      comp[v] = parents[comp[v]];
+    });
+    jump_t.stop();
+    debug(jump_t.reportTotal("jump time"););
+    vtxs = std::move(next_vtxs);
+    round++;
+  }
+  std::cout << "Boruvka finished in " << round << " rounds: total edges added"
+            << " to MinimumSpanningForest = " << n_in_mst << "\n";
+  return sequence<edge>(n_in_mst, [&](size_t i) { return mst[i]; });
+}
+
+}  // namespace MinimumSpanningForest_lazy_boruvka
+}  // namespace gbbs
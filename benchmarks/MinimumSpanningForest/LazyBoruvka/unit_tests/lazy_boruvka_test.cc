@@ -0,0 +1,106 @@
+#include "benchmarks/MinimumSpanningForest/LazyBoruvka/MinimumSpanningForest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_io.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edges = std::vector<gbbs_io::Edge<intE>>;
+namespace lb = MinimumSpanningForest_lazy_boruvka;
+
+// Returns a byte-compressed copy of G.
+symmetric_graph<csv_bytepd_amortized, intE> Compress(
+    symmetric_graph<symmetric_vertex, intE>& G) {
+  using C = csv_bytepd_amortized<intE>::decoder;
+  size_t n = G.n;
+  auto offsets = sequence<size_t>(n + 1, [&](size_t i) {
+    if (i == n) return (size_t)0;
+    auto it = G.get_vertex(i).getOutIter(i);
+    return C::template compressed_size<intE>(G.get_vertex(i).getOutDegree(),
+                                             i, it);
+  });
+  size_t total = pbbslib::scan_add_inplace(offsets);
+  auto bytes = pbbslib::new_array_no_init<uchar>(total);
+  auto v_data = pbbslib::new_array_no_init<vertex_data>(n);
+  par_for(0, n, [&] (size_t i) {
+    auto it = G.get_vertex(i).getOutIter(i);
+    C::template sequentialCompressEdgeSet<intE>(
+        bytes + offsets[i], 0, G.get_vertex(i).getOutDegree(), i, it);
+    v_data[i].offset = offsets[i];
+    v_data[i].degree = G.get_vertex(i).getOutDegree();
+  });
+  return symmetric_graph<csv_bytepd_amortized, intE>(
+      v_data, n, G.m, [=]() { pbbslib::free_arrays(v_data, bytes); }, bytes);
+}
+
+template <class Graph>
+void CheckForest(Graph& graph, const std::pair<size_t, int64_t>& expected) {
+  size_t m = graph.m;
+  auto mst = lb::MinimumSpanningForest(graph);
+  // The graph is not modified.
+  EXPECT_EQ(graph.m, m);
+  ASSERT_EQ(mst.size(), expected.first);
+  int64_t weight = 0;
+  graph_test::SequentialUnionFind components{graph.n};
+  for (const auto& [u, v, w] : mst) {
+    weight += w;
+    // The output is a forest of edges of the graph.
+    EXPECT_TRUE(components.Unite(u, v));
+    auto is_edge = [&, v = v, w = w](const uintE& src, const uintE& ngh,
+                                     const intE& wgh) {
+      return ngh == v && wgh == w;
+    };
+    EXPECT_EQ(graph.get_vertex(u).countOutNgh(u, is_edge), 1)
+        << "(" << u << ", " << v << ", " << w << ")";
+  }
+  EXPECT_EQ(weight, expected.second);
+}
+
+void CheckBothEncodings(const Edges& edges) {
+  auto graph{gbbs_io::edge_list_to_symmetric_graph(edges)};
+  auto expected = graph_test::KruskalMSF(graph.n, edges);
+  CheckForest(graph, expected);
+  auto compressed = Compress(graph);
+  CheckForest(compressed, expected);
+  compressed.del();
+}
+
+}  // namespace
+
+TEST(LazyBoruvka, SmallGraph) {
+  // Two components: a weighted 4-cycle with a chord, and a triangle with
+  // equal weights.
+  const Edges kEdges{
+    {0, 1, 4}, {1, 2, 1}, {2, 3, 3}, {3, 0, 2}, {0, 2, 5},
+    {4, 5, 7}, {5, 6, 7}, {4, 6, 7},
+  };
+  CheckBothEncodings(kEdges);
+}
+
+TEST(LazyBoruvka, PseudorandomGraph) {
+  // A random graph with few distinct weights and some high-degree vertices,
+  // so that compressed lists span several blocks. The endpoints are distinct,
+  // since the graph keeps only one weight per pair.
+  constexpr uintE kNumVertices{2000};
+  graph_test::DistinctEdgeList<intE> edges;
+  graph_test::PseudorandomGenerator generator{1};
+  for (size_t i = 0; i < 6000; i++) {
+    uintE u = generator.Next() % kNumVertices;
+    uintE v = generator.Next() % kNumVertices;
+    edges.Add(u, v, generator.Next() % 20);
+  }
+  for (size_t i = 0; i < 8000; i++) {
+    uintE u = generator.Next() % 4;
+    uintE v = generator.Next() % kNumVertices;
+    edges.Add(u, v, generator.Next() % 1000);
+  }
+  CheckBothEncodings(edges.edges());
+}
+
+}  // namespace gbbs
@@ -0,0 +1,72 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Usage:
+// numactl -i all ./NucleusDecomposition -s -r 3 -S 4 -rounds 1 com-orkut.ungraph.txt_SJ
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the algorithm
+//     -r : the size of the cliques whose nucleus numbers are computed
+//          (default: 2)
+//     -S : the size of the cliques they are peeled by (default: 3); (1, 2)
+//          is the k-core and (2, 3) the k-truss decomposition
+//     -e : the epsilon used by the approximate degeneracy order that orients
+//          the graph (default: 0.1)
+//     -nb : the number of buckets to use in the bucketing implementation
+
+#include "NucleusDecomposition.h"
+
+#include "benchmarks/DegeneracyOrder/GoodrichPszona11/DegeneracyOrder.h"
+
+namespace gbbs {
+template <class Graph>
+double NucleusDecomposition_runner(Graph& G, commandLine P) {
+  size_t r = P.getOptionLongValue("-r", 2);
+  size_t s = P.getOptionLongValue("-S", 3);
+  double epsilon = P.getOptionDoubleValue("-e", 0.1);
+  size_t num_buckets = P.getOptionLongValue("-nb", 16);
+  std::cout << "### Application: NucleusDecomposition" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << G.n << std::endl;
+  std::cout << "### m: " << G.m << std::endl;
+  std::cout << "### Params: -r = " << r << " -S = " << s << " -e = " << epsilon
+            << " -nb (num_buckets) = " << num_buckets << std::endl;
+  std::cout << "### ------------------------------------" << std::endl;
+  assert(P.getOption("-s"));
+
+  timer t; t.start();
+  auto rank = goodrichpszona_degen::DegeneracyOrder_intsort(G, epsilon);
+  auto nd = NucleusDecomposition<uintE>(G, r, s, std::move(rank), num_buckets);
+  double tt = t.stop();
+
+  std::cout << "### Running Time: " << tt << std::endl;
+  return tt;
+}
+}  // namespace gbbs
+
+generate_symmetric_main(gbbs::NucleusDecomposition_runner, false);
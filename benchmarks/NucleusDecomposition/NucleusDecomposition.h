@@ -0,0 +1,420 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "gbbs/bucket.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/assert.h"
+
+// (r, s)-nucleus decomposition. The nucleus number of an r-clique R is the
+// largest k such that R is contained in a subgraph in which every r-clique is
+// contained in at least k s-cliques of the subgraph. (1, 2) is the k-core
+// decomposition and (2, 3) is the k-truss decomposition (with truss numbers
+// shifted by two).
+//
+// The r-cliques are stored in a compact index: the graph is oriented by a
+// ranking, and each r-clique (listed in rank order) is a root-to-leaf path in
+// a trie whose level j stores, for every (j-1)-clique, the sorted vertices
+// completing it to a j-clique. Level 2 is the CSR of the oriented graph, so
+// an r-clique costs one vertex id in level r, plus one offset per
+// (r-1)-clique, and its id is its position in level r.
+namespace gbbs {
+namespace nucleus {
+
+// The largest supported s.
+constexpr size_t kMaxCliqueSize = 8;
+
+using clique_id = uintT;
+
+// Writes the intersection of the sorted arrays A and B to out (if non-null)
+// and returns its size. Searches the larger array when the sizes are skewed.
+inline size_t intersect(const uintE* A, size_t a, const uintE* B, size_t b,
+                        uintE* out) {
+  if (a > b) {
+    if (out != A) return intersect(B, b, A, a, out);
+  }
+  size_t k = 0;
+  if (a * 16 < b) {
+    const uintE* lo = B;
+    const uintE* end = B + b;
+    for (size_t i = 0; i < a && lo != end; i++) {
+      lo = std::lower_bound(lo, end, A[i]);
+      if (lo != end && *lo == A[i]) {
+        if (out) out[k] = A[i];
+        k++;
+      }
+    }
+    return k;
+  }
+  size_t i = 0, j = 0;
+  while (i < a && j < b) {
+    if (A[i] == B[j]) {
+      if (out) out[k] = A[i];
+      k++; i++; j++;
+    } else if (A[i] < B[j]) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+  return k;
+}
+
+// Sorted adjacency lists of the edges of a graph satisfying a predicate.
+struct csr {
+  sequence<uintT> offsets;
+  sequence<uintE> edges;
+
+  uintE degree(uintE v) const { return offsets[v + 1] - offsets[v]; }
+  const uintE* neighbors(uintE v) const { return edges.begin() + offsets[v]; }
+};
+
+template <class Graph, class P>
+inline csr make_csr(Graph& G, P pred) {
+  using W = typename Graph::weight_type;
+  const size_t n = G.n;
+  csr A;
+  A.offsets = sequence<uintT>(n + 1, [&] (size_t v) -> uintT {
+    if (v == n) return 0;
+    uintT deg = 0;
+    auto count_f = [&] (const uintE& u, const uintE& ngh, const W& wgh) {
+      if (pred(u, ngh)) deg++;
+    };
+    G.get_vertex(v).mapOutNgh(v, count_f, false);
+    return deg;
+  });
+  size_t m = pbbslib::scan_add_inplace(A.offsets);
+  A.edges = sequence<uintE>::no_init(m);
+  parallel_for(0, n, [&] (size_t v) {
+    uintT k = A.offsets[v];
+    auto fill_f = [&] (const uintE& u, const uintE& ngh, const W& wgh) {
+      if (pred(u, ngh)) A.edges[k++] = ngh;
+    };
+    G.get_vertex(v).mapOutNgh(v, fill_f, false);
+    std::sort(A.edges.begin() + A.offsets[v], A.edges.begin() + k);
+  }, 1);
+  return A;
+}
+
+// Calls f(c) for every clique c[0, depth) + {w_1, ..., w_t} of size target,
+// where the w_i are drawn from cand (sorted) and are pairwise adjacent in A.
+// If ordered is set, the w_i are increasing in cand; otherwise cand must
+// already be restricted to out-neighbors, as in an oriented graph. buf must
+// hold (target - depth - 1) * num_cand vertices.
+template <class F>
+inline void enumerate_cliques(const csr& A, const uintE* cand, size_t num_cand,
+                              uintE* c, size_t depth, size_t target,
+                              bool ordered, uintE* buf, F& f) {
+  for (size_t i = 0; i < num_cand; i++) {
+    uintE w = cand[i];
+    c[depth] = w;
+    if (depth + 1 == target) {
+      f(c);
+      continue;
+    }
+    size_t start = ordered ? i + 1 : 0;
+    size_t k = intersect(cand + start, num_cand - start, A.neighbors(w),
+                         A.degree(w), buf);
+    if (k > 0) {
+      enumerate_cliques(A, buf, k, c, depth + 1, target, ordered,
+                        buf + num_cand, f);
+    }
+  }
+}
+
+// Compact index of the r-cliques of a graph; see the comment at the top of
+// the file.
+struct clique_index {
+  size_t r;
+  sequence<uintE> rank;
+  csr out;  // level 2: the graph oriented from lower to higher rank
+  // offsets[j - 3] and vertices[j - 3] store level j >= 3.
+  std::vector<sequence<uintT>> offsets;
+  std::vector<sequence<uintE>> vertices;
+
+  size_t num_cliques() const {
+    if (r == 1) return rank.size();
+    if (r == 2) return out.edges.size();
+    return vertices[r - 3].size();
+  }
+
+  // Returns the id of the r-clique c (listed in rank order), or
+  // std::numeric_limits<clique_id>::max() if c is not an r-clique.
+  clique_id find(const uintE* c) const {
+    constexpr clique_id none = std::numeric_limits<clique_id>::max();
+    clique_id node = c[0];
+    if (r == 1) return node;
+    const uintE* nghs = out.neighbors(c[0]);
+    const uintE* end = nghs + out.degree(c[0]);
+    const uintE* it = std::lower_bound(nghs, end, c[1]);
+    if (it == end || *it != c[1]) return none;
+    node = out.offsets[c[0]] + (it - nghs);
+    for (size_t j = 3; j <= r; j++) {
+      const uintE* vs = vertices[j - 3].begin();
+      const uintE* lo = vs + offsets[j - 3][node];
+      const uintE* hi = vs + offsets[j - 3][node + 1];
+      it = std::lower_bound(lo, hi, c[j - 1]);
+      if (it == hi || *it != c[j - 1]) return none;
+      node = it - vs;
+    }
+    return node;
+  }
+
+  // Writes the vertices of the r-clique with the given id to c, in rank order.
+  void decode(clique_id id, uintE* c) const {
+    for (size_t j = r; j >= 3; j--) {
+      c[j - 1] = vertices[j - 3][id];
+      auto& off = offsets[j - 3];
+      id = (std::upper_bound(off.begin(), off.end(), id) - off.begin()) - 1;
+    }
+    if (r >= 2) {
+      c[1] = out.edges[id];
+      id = (std::upper_bound(out.offsets.begin(), out.offsets.end(), id) -
+            out.offsets.begin()) - 1;
+    }
+    c[0] = id;
+  }
+};
+
+// Builds the r-clique index of G oriented by rank.
+template <class Graph>
+inline clique_index make_clique_index(Graph& G, size_t r, sequence<uintE> rank) {
+  clique_index I;
+  I.r = r;
+  I.out = make_csr(G, [&] (uintE u, uintE v) { return rank[u] < rank[v]; });
+  I.rank = std::move(rank);
+  size_t num_parents = I.out.edges.size();
+  for (size_t j = 3; j <= r; j++) {
+    // A j-clique extends a (j-1)-clique x by a vertex adjacent to all of x,
+    // i.e. a sibling of x's last vertex that is also its out-neighbor.
+    auto siblings = [&] (clique_id x, uintE& last, const uintE*& sibs,
+                         size_t& num_sibs) {
+      if (j == 3) {
+        uintE u = (std::upper_bound(I.out.offsets.begin(), I.out.offsets.end(),
+                                    x) - I.out.offsets.begin()) - 1;
+        last = I.out.edges[x];
+        sibs = I.out.neighbors(u);
+        num_sibs = I.out.degree(u);
+      } else {
+        auto& off = I.offsets[j - 4];
+        clique_id p = (std::upper_bound(off.begin(), off.end(), x) -
+                       off.begin()) - 1;
+        last = I.vertices[j - 4][x];
+        sibs = I.vertices[j - 4].begin() + off[p];
+        num_sibs = off[p + 1] - off[p];
+      }
+    };
+    auto off = sequence<uintT>(num_parents + 1, [&] (size_t x) -> uintT {
+      if (x == num_parents) return 0;
+      uintE last; const uintE* sibs; size_t num_sibs;
+      siblings(x, last, sibs, num_sibs);
+      return intersect(sibs, num_sibs, I.out.neighbors(last),
+                       I.out.degree(last), nullptr);
+    });
+    size_t total = pbbslib::scan_add_inplace(off);
+    auto vs = sequence<uintE>::no_init(total);
+    parallel_for(0, num_parents, [&] (size_t x) {
+      uintE last; const uintE* sibs; size_t num_sibs;
+      siblings(x, last, sibs, num_sibs);
+      intersect(sibs, num_sibs, I.out.neighbors(last), I.out.degree(last),
+                vs.begin() + off[x]);
+    }, 1);
+    I.offsets.push_back(std::move(off));
+    I.vertices.push_back(std::move(vs));
+    num_parents = total;
+  }
+  return I;
+}
+
+// The r-subsets of {0, ..., s-1}, as bitmasks.
+inline std::vector<uint32_t> subsets(size_t s, size_t r) {
+  std::vector<uint32_t> ret;
+  for (uint32_t mask = 0; mask < (1u << s); mask++) {
+    if ((size_t)__builtin_popcount(mask) == r) ret.push_back(mask);
+  }
+  return ret;
+}
+
+template <class bucket_t>
+struct decomposition {
+  clique_index index;
+  sequence<bucket_t> nucleus;  // nucleus number of each r-clique, by id
+  size_t num_s_cliques;
+  size_t rounds;
+  bucket_t max_nucleus;
+};
+
+}  // namespace nucleus
+
+// Computes the (r, s)-nucleus decomposition of G, orienting G by rank (e.g. a
+// degeneracy order). bucket_t must be able to hold the number of s-cliques
+// containing any r-clique.
+template <class bucket_t, class Graph>
+inline nucleus::decomposition<bucket_t> NucleusDecomposition(
+    Graph& G, size_t r, size_t s, sequence<uintE> rank,
+    size_t num_buckets = 16) {
+  using namespace nucleus;
+  if (r < 1 || s <= r || s > kMaxCliqueSize) {
+    ABORT("Unsupported (r, s) = (" << r << ", " << s << ")");
+  }
+  decomposition<bucket_t> R;
+  timer t; t.start();
+  R.index = make_clique_index(G, r, std::move(rank));
+  auto& I = R.index;
+  size_t num_cliques = I.num_cliques();
+  std::cout << "### Index Time: " << t.stop() << " num " << r
+            << "-cliques = " << num_cliques << std::endl;
+  auto masks = subsets(s, r);
+  auto adj = make_csr(G, [&] (uintE u, uintE v) { return true; });
+  auto rank_less = [&] (uintE a, uintE b) { return I.rank[a] < I.rank[b]; };
+
+  // Count the s-cliques containing each r-clique by listing the s-cliques of
+  // the oriented graph.
+  t.start();
+  auto D = sequence<bucket_t>(num_cliques, (bucket_t)0);
+  auto tots = sequence<size_t>(G.n, [&] (size_t v) -> size_t {
+    size_t deg = I.out.degree(v);
+    if (deg == 0) return 0;
+    std::vector<uintE> buf(deg * s);
+    size_t total = 0;
+    uintE c[kMaxCliqueSize], q[kMaxCliqueSize];
+    c[0] = v;
+    auto f = [&] (const uintE* c) {
+      total++;
+      for (uint32_t mask : masks) {
+        size_t k = 0;
+        for (size_t i = 0; i < s; i++) if (mask & (1u << i)) q[k++] = c[i];
+        pbbslib::write_add(&D[I.find(q)], 1);
+      }
+    };
+    enumerate_cliques(I.out, I.out.neighbors(v), deg, c, 1, s, false,
+                      buf.data(), f);
+    return total;
+  });
+  R.num_s_cliques = pbbslib::reduce_add(tots);
+  std::cout << "### Count Time: " << t.stop() << " num " << s
+            << "-cliques = " << R.num_s_cliques << std::endl;
+
+  // Peel r-cliques in increasing order of their s-clique counts. state is 0
+  // for remaining r-cliques, 1 for r-cliques peeled in this round, 2 for
+  // r-cliques peeled in earlier rounds and 3 for remaining r-cliques whose
+  // count changed in this round.
+  t.start();
+  auto b = make_buckets<clique_id, bucket_t>(num_cliques, D.slice(),
+                                             increasing, num_buckets);
+  auto state = sequence<uint8_t>(num_cliques, (uint8_t)0);
+  auto changed = sequence<clique_id>::no_init(num_cliques);
+  std::vector<std::vector<uintE>> scratch(num_workers());
+  size_t finished = 0;
+  R.rounds = 0;
+  R.max_nucleus = 0;
+  while (finished != num_cliques) {
+    auto bkt = b.next_bucket();
+    auto& active = bkt.identifiers;
+    bucket_t k = bkt.id;
+    finished += active.size();
+    R.max_nucleus = std::max(R.max_nucleus, k);
+    parallel_for(0, active.size(), [&] (size_t i) { state[active[i]] = 1; });
+
+    size_t num_changed = 0;
+    parallel_for(0, active.size(), [&] (size_t a) {
+      clique_id id = active[a];
+      uintE c[kMaxCliqueSize], S[kMaxCliqueSize], q[kMaxCliqueSize];
+      clique_id ids[70];  // at most (8 choose 4) subsets
+      I.decode(id, c);
+
+      // The common neighbors of the r-clique, followed by room for listing
+      // (s-r)-cliques among them.
+      uintE order[kMaxCliqueSize];
+      std::copy(c, c + r, order);
+      std::sort(order, order + r, [&] (uintE x, uintE y) {
+        return adj.degree(x) < adj.degree(y); });
+      const uintE* cand = adj.neighbors(order[0]);
+      size_t num_cand = adj.degree(order[0]);
+      size_t cap = num_cand;
+      auto& buf = scratch[worker_id()];
+      if (buf.size() < cap * (s - r + 1)) buf.resize(cap * (s - r + 1));
+      for (size_t i = 1; i < r && num_cand > 0; i++) {
+        num_cand = intersect(cand, num_cand, adj.neighbors(order[i]),
+                             adj.degree(order[i]), buf.data());
+        cand = buf.data();
+      }
+      if (num_cand == 0) return;
+
+      // For each remaining s-clique containing the r-clique, decrement the
+      // counts of its other remaining r-cliques. An s-clique containing
+      // several r-cliques peeled in this round is handled by the one with
+      // the smallest id.
+      auto f = [&] (const uintE* t) {
+        std::copy(c, c + r, S);
+        std::copy(t, t + s - r, S + r);
+        std::sort(S, S + s, rank_less);
+        size_t num_ids = 0;
+        for (uint32_t mask : masks) {
+          size_t j = 0;
+          for (size_t i = 0; i < s; i++) if (mask & (1u << i)) q[j++] = S[i];
+          clique_id x = I.find(q);
+          if (x == id) continue;
+          if (state[x] == 2 || (state[x] == 1 && x < id)) return;
+          if (state[x] != 1) ids[num_ids++] = x;
+        }
+        for (size_t i = 0; i < num_ids; i++) {
+          clique_id x = ids[i];
+          bucket_t old = D[x];
+          while (old > k && !pbbslib::atomic_compare_and_swap(&D[x], old, (bucket_t)(old - 1))) {
+            old = D[x];
+          }
+          if (old > k && state[x] == 0 &&
+              pbbslib::atomic_compare_and_swap(&state[x], (uint8_t)0, (uint8_t)3)) {
+            changed[pbbslib::fetch_and_add(&num_changed, (size_t)1)] = x;
+          }
+        }
+      };
+      uintE t[kMaxCliqueSize];
+      enumerate_cliques(adj, cand, num_cand, t, 0, s - r, true,
+                        buf.data() + cap, f);
+    }, 1);
+
+    auto apply_f = [&] (size_t i)
+        -> std::optional<std::tuple<clique_id, bucket_t>> {
+      clique_id x = changed[i];
+      state[x] = 0;
+      return std::make_optional(std::make_tuple(x, b.get_bucket(D[x])));
+    };
+    b.update_buckets(apply_f, num_changed);
+    parallel_for(0, active.size(), [&] (size_t i) { state[active[i]] = 2; });
+    R.rounds++;
+  }
+  std::cout << "### Peel Time: " << t.stop() << std::endl;
+  std::cout << "### rho = " << R.rounds << " max nucleus = " << R.max_nucleus
+            << std::endl;
+  b.del();
+  R.nucleus = std::move(D);
+  return R;
+}
+
+}  // namespace gbbs
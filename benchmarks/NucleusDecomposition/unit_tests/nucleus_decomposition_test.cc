@@ -0,0 +1,126 @@
+#include "benchmarks/NucleusDecomposition/NucleusDecomposition.h"
+
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmarks/KCore/JulienneDBS17/KCore.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+// Lists the cliques of size k (as sorted vertex sets) of the graph with
+// adjacency matrix adj.
+std::vector<std::vector<uintE>> ListCliques(
+    const std::vector<std::vector<bool>>& adj, size_t k) {
+  std::vector<std::vector<uintE>> ret;
+  std::vector<uintE> c;
+  std::function<void(uintE)> rec = [&] (uintE start) {
+    if (c.size() == k) { ret.push_back(c); return; }
+    for (uintE v = start; v < adj.size(); v++) {
+      bool ok = true;
+      for (uintE u : c) ok = ok && adj[u][v];
+      if (!ok) continue;
+      c.push_back(v);
+      rec(v + 1);
+      c.pop_back();
+    }
+  };
+  rec(0);
+  return ret;
+}
+
+// Computes nucleus numbers by sequentially peeling a minimum-count r-clique.
+std::map<std::vector<uintE>, size_t> BruteForceNucleus(
+    size_t n, const std::unordered_set<UndirectedEdge>& edges, size_t r,
+    size_t s) {
+  std::vector<std::vector<bool>> adj(n, std::vector<bool>(n, false));
+  for (const auto& e : edges) {
+    adj[e.endpoints().first][e.endpoints().second] = true;
+    adj[e.endpoints().second][e.endpoints().first] = true;
+  }
+  auto rc = ListCliques(adj, r);
+  auto sc = ListCliques(adj, s);
+  std::map<std::vector<uintE>, size_t> id;
+  for (size_t i = 0; i < rc.size(); i++) id[rc[i]] = i;
+  std::vector<std::vector<size_t>> members(sc.size());
+  std::vector<std::vector<size_t>> containing(rc.size());
+  for (size_t j = 0; j < sc.size(); j++) {
+    for (uint32_t mask : nucleus::subsets(s, r)) {
+      std::vector<uintE> q;
+      for (size_t i = 0; i < s; i++) if (mask & (1u << i)) q.push_back(sc[j][i]);
+      members[j].push_back(id[q]);
+      containing[id[q]].push_back(j);
+    }
+  }
+  std::vector<size_t> count(rc.size());
+  for (size_t i = 0; i < rc.size(); i++) count[i] = containing[i].size();
+  std::vector<bool> peeled(rc.size(), false), dead(sc.size(), false);
+  std::map<std::vector<uintE>, size_t> ret;
+  size_t k = 0;
+  for (size_t round = 0; round < rc.size(); round++) {
+    size_t x = rc.size();
+    for (size_t i = 0; i < rc.size(); i++) {
+      if (!peeled[i] && (x == rc.size() || count[i] < count[x])) x = i;
+    }
+    k = std::max(k, count[x]);
+    ret[rc[x]] = k;
+    peeled[x] = true;
+    for (size_t j : containing[x]) {
+      if (dead[j]) continue;
+      dead[j] = true;
+      for (size_t y : members[j]) if (!peeled[y]) count[y]--;
+    }
+  }
+  return ret;
+}
+
+void CheckNucleus(size_t n, const std::unordered_set<UndirectedEdge>& edges,
+                  size_t r, size_t s) {
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(n, edges)};
+  // Orient by a pseudorandom permutation to exercise the rank order.
+  auto rank = sequence<uintE>(n, [&] (size_t i) { return (uintE)((i * 7919) % n); });
+  auto nd = NucleusDecomposition<uintE>(graph, r, s, rank);
+  auto expected = BruteForceNucleus(n, edges, r, s);
+  ASSERT_EQ(nd.index.num_cliques(), expected.size());
+  for (const auto& [c, k] : expected) {
+    std::vector<uintE> q = c;
+    std::sort(q.begin(), q.end(), [&] (uintE a, uintE b) { return rank[a] < rank[b]; });
+    auto id = nd.index.find(q.data());
+    ASSERT_LT(id, expected.size());
+    std::vector<uintE> decoded(r);
+    nd.index.decode(id, decoded.data());
+    EXPECT_EQ(decoded, q);
+    EXPECT_EQ(nd.nucleus[id], k) << "r = " << r << " s = " << s;
+  }
+}
+
+}  // namespace
+
+TEST(NucleusDecomposition, CoreMatchesKCore) {
+  constexpr uintE kNumVertices{200};
+  auto edges = graph_test::PseudorandomEdges(kNumVertices, 1500, 1);
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  auto cores = KCore(graph);
+  auto rank = sequence<uintE>(kNumVertices, [&] (size_t i) { return (uintE)i; });
+  auto nd = NucleusDecomposition<uintE>(graph, 1, 2, rank);
+  for (size_t v = 0; v < kNumVertices; v++) {
+    EXPECT_EQ(nd.nucleus[v], cores[v]);
+  }
+}
+
+TEST(NucleusDecomposition, MatchesBruteForce) {
+  constexpr uintE kNumVertices{40};
+  auto edges = graph_test::PseudorandomEdges(kNumVertices, 400, 2);
+  CheckNucleus(kNumVertices, edges, 1, 3);
+  CheckNucleus(kNumVertices, edges, 2, 3);
+  CheckNucleus(kNumVertices, edges, 2, 4);
+  CheckNucleus(kNumVertices, edges, 3, 4);
+  CheckNucleus(kNumVertices, edges, 3, 5);
+}
+
+}  // namespace gbbs
@@ -30,6 +30,12 @@
 //     -c : indicate that the graph is compressed
 //     -m : indicate that the graph should be mmap'd
 //     -s : indicate that the graph is symmetric
+//     -em : run the edgeMap-based implementation
+//     -tiled : run the edgeMap-based implementation on a tiled edge array
+//              (COO) built from the graph
+//     -tile_bits : the log of the tile side length used by -tiled (by
+//                  default, the tiles are sized for the L2 cache)
+//     -grid : lay out the tiles in row-major order instead of Hilbert order
 
 #include "PageRank.h"
 
@@ -49,7 +55,19 @@ double PageRank_runner(Graph& G, commandLine P) {
   double eps = P.getOptionDoubleValue("-eps", 0.000001);
   double local_eps = P.getOptionDoubleValue("-leps", 0.01);
   size_t iters = P.getOptionLongValue("-iters", 100);
-  if (P.getOptionValue("-em")) {
+  if (P.getOptionValue("-tiled")) {
+    using W = typename Graph::weight_type;
+    size_t tile_bits = P.getOptionLongValue("-tile_bits",
+        tile_bits_for_cache(sizeof(double)));
+    auto order = P.getOptionValue("-grid") ? grid_order : hilbert_order;
+    timer tile_t; tile_t.start();
+    auto TG = to_tiled_edge_array<W>(G, tile_bits, order);
+    tile_t.stop(); tile_t.reportTotal("tiling time");
+    std::cout << "### tile_bits: " << tile_bits << " tiles: " << TG.num_tiles
+              << std::endl;
+    t.start();
+    PageRank_edgeMap(TG, eps, iters);
+  } else if (P.getOptionValue("-em")) {
     PageRank_edgeMap(G, eps, iters);
   } else if (P.getOptionValue("-delta")) {
     delta::PageRankDelta(G, eps, local_eps, iters);
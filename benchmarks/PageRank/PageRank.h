@@ -33,15 +33,15 @@ template <class Graph>
 struct PR_F {
   using W = typename Graph::weight_type;
   double* p_curr, *p_next;
-  Graph& G;
-  PR_F(double* _p_curr, double* _p_next, Graph& G) :
-    p_curr(_p_curr), p_next(_p_next), G(G) {}
+  uintE* degrees;
+  PR_F(double* _p_curr, double* _p_next, uintE* _degrees) :
+    p_curr(_p_curr), p_next(_p_next), degrees(_degrees) {}
   inline bool update(const uintE& s, const uintE& d, const W& wgh){ //update function applies PageRank equation
-    p_next[d] += p_curr[s]/G.get_vertex(s).getOutDegree();
+    p_next[d] += p_curr[s]/degrees[s];
     return 1;
   }
   inline bool updateAtomic (const uintE& s, const uintE& d, const W& wgh) { //atomic Update
-    pbbs::fetch_and_add(&p_next[d],p_curr[s]/G.get_vertex(s).getOutDegree());
+    pbbs::fetch_and_add(&p_next[d],p_curr[s]/degrees[s]);
     return 1;
   }
   inline bool cond (intT d) { return cond_true(d); }};
@@ -73,8 +73,12 @@ struct PR_Vertex_Reset {
 };
 
 
+// Runs PageRank using edgeMap, where degrees[i] is the out-degree of vertex i.
+// Graph can be any graph type supporting edgeMap, including a
+// tiled_edge_array.
 template <class Graph>
-void PageRank_edgeMap(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
+void PageRank_edgeMap(Graph& G, pbbs::sequence<uintE>& degrees,
+                      double eps = 0.000001, size_t max_iters = 100) {
   const uintE n = G.n;
   const double damping = 0.85;
 
@@ -83,17 +87,13 @@ void PageRank_edgeMap(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
   auto p_next = pbbs::sequence<double>(n, static_cast<double>(0));
   auto frontier = pbbs::sequence<bool>(n, true);
 
-  // read from special array of just degrees
-
-  auto degrees = pbbs::sequence<uintE>(n, [&] (size_t i) { return G.get_vertex(i).getOutDegree(); });
-
   vertexSubset Frontier(n,n,frontier.to_array());
 
   size_t iter = 0;
   while (iter++ < max_iters) {
     debug(timer t; t.start(););
     // SpMV
-    edgeMap(G,Frontier,PR_F<Graph>(p_curr.begin(),p_next.begin(),G), 0, no_output);
+    edgeMap(G,Frontier,PR_F<Graph>(p_curr.begin(),p_next.begin(),degrees.begin()), 0, no_output);
     vertexMap(Frontier,PR_Vertex_F(p_curr.begin(),p_next.begin(),damping,n));
 
     // Check convergence: compute L1-norm between p_curr and p_next
@@ -119,7 +119,20 @@ void PageRank_edgeMap(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
 }
 
 template <class Graph>
-void PageRank(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
+void PageRank_edgeMap(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
+  // read from special array of just degrees
+  auto degrees = pbbs::sequence<uintE>(G.n, [&] (size_t i) { return G.get_vertex(i).getOutDegree(); });
+  PageRank_edgeMap(G, degrees, eps, max_iters);
+}
+
+template <class W>
+void PageRank_edgeMap(tiled_edge_array<W>& G, double eps = 0.000001, size_t max_iters = 100) {
+  PageRank_edgeMap(G, G.degrees, eps, max_iters);
+}
+
+// Returns the PageRank of every vertex.
+template <class Graph>
+pbbs::sequence<double> PageRank(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
   using W = typename Graph::weight_type;
   const uintE n = G.n;
   const double damping = 0.85;
@@ -177,11 +190,14 @@ void PageRank(Graph& G, double eps = 0.000001, size_t max_iters = 100) {
     t.stop(); t.reportTotal("iteration time");
   }
   Frontier.del();
+  // If max_iters was reached, the last swap left the ranks in p_curr.
+  if (iter > max_iters) std::swap(p_curr,p_next);
   auto max_pr = pbbslib::reduce_max(p_next);
   std::cout << "max_pr = " << max_pr << std::endl;
-  for (size_t i=0; i<100; i++) {
+  for (size_t i=0; i<std::min<size_t>(n, 100); i++) {
     std::cout << p_next[i] << std::endl;
   }
+  return p_next;
 }
 
 namespace delta {
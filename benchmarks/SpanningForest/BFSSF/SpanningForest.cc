@@ -31,6 +31,7 @@
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
 //     -stats : print the #ccs, and the #vertices in the largest cc
+//     -rooted : also build the rooted forest (parents and Euler tour)
 
 #include "SpanningForest.h"
 #include "gbbs/gbbs.h"
@@ -48,10 +49,17 @@ double SpanningForest_runner(Graph& G, commandLine P) {
   assert(P.getOption("-s"));
   timer t;
   t.start();
-  auto edges_nd = bfs_sf::SpanningForest(G);
+  auto parents = bfs_sf::SpanningForestParents(G);
   double tt = t.stop();
 
+  if (P.getOptionValue("-rooted")) {
+    timer rt; rt.start();
+    auto F = spanning_forest::RootedForest(parents);
+    rt.stop(); rt.reportTotal("rooted forest time");
+  }
+
   if (P.getOptionValue("-check")) {
+    auto edges_nd = spanning_forest::parents_to_edges(parents);
     auto edges_det = bfs_sf::SpanningForestDet(G);
     spanning_forest::check_spanning_forest(G.n, edges_nd, edges_det);
   }
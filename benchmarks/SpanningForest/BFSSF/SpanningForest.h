@@ -61,8 +61,10 @@ void BFS_SpanningForest(Graph& G, uintE src, pbbs::sequence<parent>& parents) {
 }
 
 
+/* Returns the BFS forest as a parent array: parents[v] == v for the root of
+ * every tree, which is the smallest vertex of its component. */
 template <class Graph>
-inline pbbs::sequence<edge> SpanningForest(Graph& G) {
+inline pbbs::sequence<parent> SpanningForestParents(Graph& G) {
   size_t n = G.n;
   auto parents = pbbs::sequence<parent>(n, UINT_E_MAX);
   for (size_t i=0; i<n; i++) {
@@ -71,6 +73,12 @@ inline pbbs::sequence<edge> SpanningForest(Graph& G) {
       BFS_SpanningForest(G, i, parents);
     }
   }
+  return parents;
+}
+
+template <class Graph>
+inline pbbs::sequence<edge> SpanningForest(Graph& G) {
+  auto parents = SpanningForestParents(G);
   return spanning_forest::parents_to_edges(parents);
 }
 
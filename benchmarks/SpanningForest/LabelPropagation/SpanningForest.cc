@@ -48,6 +48,12 @@ double SF_runner(Graph& G, commandLine P) {
   double tt = t.stop();
   std::cout << "### Running Time: " << tt << std::endl;
 
+  if (P.getOptionValue("-rooted")) {
+    timer rt; rt.start();
+    auto F = spanning_forest::RootedForest(G.n, edges);
+    rt.stop(); rt.reportTotal("rooted forest time");
+  }
+
   if (P.getOptionValue("-check")) {
     auto bfs_edges = bfs_sf::SpanningForestDet(G);
     spanning_forest::check_spanning_forest(G.n, bfs_edges, edges);
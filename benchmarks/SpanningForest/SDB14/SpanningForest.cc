@@ -31,6 +31,7 @@
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
 //     -stats : print the #ccs, and the #vertices in the largest cc
+//     -rooted : also build the rooted forest (parents and Euler tour)
 
 #include "SpanningForest.h"
 #include "benchmarks/SpanningForest/BFSSF/SpanningForest.h"
@@ -60,6 +61,12 @@ double SpanningForest_runner(Graph& G, commandLine P) {
 
   std::cout << "vtx 0 has degree: " << G.get_vertex(0).getOutDegree() << std::endl;
 
+  if (P.getOptionValue("-rooted")) {
+    timer rt; rt.start();
+    auto F = spanning_forest::RootedForest(G.n, edges);
+    rt.stop(); rt.reportTotal("rooted forest time");
+  }
+
   if (P.getOptionValue("-check")) {
     auto bfs_edges = bfs_sf::SpanningForestDet(G);
     spanning_forest::check_spanning_forest(G.n, bfs_edges, edges);
@@ -31,6 +31,7 @@
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
 //     -stats : print the #ccs, and the #vertices in the largest cc
+//     -rooted : also build the rooted forest (parents and Euler tour)
 
 #include "SpanningForest.h"
 #include "gbbs/gbbs.h"
@@ -53,6 +54,12 @@ double SpanningForest_runner(Graph& G, commandLine P) {
   double tt = t.stop();
   std::cout << "### Running Time: " << tt << std::endl;
 
+  if (P.getOptionValue("-rooted")) {
+    timer rt; rt.start();
+    auto F = spanning_forest::RootedForest(G.n, edges);
+    rt.stop(); rt.reportTotal("rooted forest time");
+  }
+
   if (P.getOptionValue("-check")) {
     auto edges_det = bfs_sf::SpanningForestDet(G);
     spanning_forest::check_spanning_forest(G.n, edges, edges_det);
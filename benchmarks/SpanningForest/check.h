@@ -4,6 +4,7 @@
 #include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
 
 #include "common.h"
+#include "rooted_forest.h"
 
 namespace gbbs {
 namespace spanning_forest {
@@ -81,6 +82,44 @@ namespace spanning_forest {
     return double_in;
   }
 
+  void check_rooted_forest(pbbs::sequence<edge>& edges, rooted_forest& F) {
+    size_t n = F.n;
+    auto fail = [&] (const std::string& msg, uintE v) {
+      std::cout << "## Rooted forest is incorrect at vertex " << v << ": " << msg << std::endl;
+      exit(-1);
+    };
+    size_t non_roots = 0;
+    auto seen = pbbs::sequence<bool>(n, false);
+    auto child_sizes = pbbs::sequence<uintE>(n, (uintE)0);
+    for (size_t v=0; v<n; v++) {
+      if (F.preorder[v] >= n || seen[F.preorder[v]]) fail("preorder is not a permutation", v);
+      seen[F.preorder[v]] = true;
+      if (F.is_root(v)) {
+        if (F.root[v] != v || F.depth[v] != 0) fail("bad root", v);
+        continue;
+      }
+      non_roots++;
+      uintE p = F.parents[v];
+      if (F.root[v] != F.root[p] || F.root[v] > v) fail("bad root", v);
+      if (F.depth[v] != F.depth[p] + 1) fail("bad depth", v);
+      if (!F.is_ancestor(p, v) || F.preorder[v] == F.preorder[p]) fail("bad preorder", v);
+      if (F.tour[F.enter[v]] != std::make_pair(p, (uintE)v)) fail("bad tour", v);
+      child_sizes[p] += F.subtree_size[v];
+    }
+    for (size_t v=0; v<n; v++) {
+      if (F.subtree_size[v] != child_sizes[v] + 1) fail("bad subtree size", v);
+    }
+    if (non_roots != edges.size()) {
+      std::cout << "## Rooted forest has " << non_roots << " tree edges, but the forest has " << edges.size() << std::endl;
+      exit(-1);
+    }
+    for (size_t i=0; i<edges.size(); i++) {
+      auto [u, v] = edges[i];
+      if (F.parents[u] != v && F.parents[v] != u) fail("missing forest edge", u);
+    }
+    std::cout << "# rooted forest check: 1 (trees = " << F.num_trees << ")" << std::endl;
+  }
+
   void check_spanning_forest(size_t n, pbbs::sequence<edge>& correct, pbbs::sequence<edge>& check) {
     // check sizes
     if (correct.size() != check.size()) {
@@ -100,6 +139,9 @@ namespace spanning_forest {
     num_cc(conn_check);
 
     cc_check(conn_correct, conn_check);
+
+    auto F = RootedForest(n, check);
+    check_rooted_forest(check, F);
   }
 
 }  // namespace spanning_forest
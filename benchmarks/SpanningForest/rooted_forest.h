@@ -0,0 +1,362 @@
+#pragma once
+
+#include "gbbs/gbbs.h"
+#include "pbbslib/sample_sort.h"
+
+#include "common.h"
+
+/* ***************************** Rooted forests *****************************
+ * A compact form of the spanning forest computed by any of the SpanningForest
+ * variants: a parent array together with an Euler tour of every tree, from
+ * which the preorder numbers, subtree sizes and depths follow by scans. It is
+ * built in parallel either from a parent array, for the variants that grow
+ * rooted trees (BFSSF), or from the forest edges in any orientation, for the
+ * variants that hook components together through arbitrary edges. It feeds
+ * Euler-tour tree computations (ancestor tests, LCA, subtree aggregates over
+ * preorder ranges). */
+
+namespace gbbs {
+namespace spanning_forest {
+
+  struct rooted_forest {
+    size_t n;
+    size_t num_trees;
+    /* parents[v] == v for the root of every tree. The tree rooted at r
+     * contains the vertices whose root is r. */
+    pbbs::sequence<parent> parents;
+    pbbs::sequence<uintE> root;
+    /* The Euler tour of every tree, as directed tree edges, laid out tree by
+     * tree in the order of the roots. Each tree edge appears twice: once
+     * going down (parent, child) and once going up (child, parent). */
+    pbbs::sequence<edge> tour;
+    /* Position in tour of the edge (parents[v], v); UINT_E_MAX for roots. */
+    pbbs::sequence<uintE> enter;
+    /* Preorder numbers are contiguous across the forest, so the subtree of v
+     * holds exactly the preorder numbers
+     *   [preorder[v], preorder[v] + subtree_size[v]). */
+    pbbs::sequence<uintE> preorder;
+    pbbs::sequence<uintE> subtree_size;
+    pbbs::sequence<uintE> depth;
+
+    bool is_root(uintE v) const { return parents[v] == v; }
+
+    /* Returns whether u is an ancestor of v (every vertex is its own). */
+    bool is_ancestor(uintE u, uintE v) const {
+      return preorder[u] <= preorder[v] &&
+             preorder[v] < preorder[u] + subtree_size[u];
+    }
+
+    /* Returns the vertices ordered by their preorder number. */
+    pbbs::sequence<uintE> vertices_in_preorder() const {
+      auto order = pbbs::sequence<uintE>::no_init(n);
+      parallel_for(0, n, [&] (size_t v) { order[preorder[v]] = v; });
+      return order;
+    }
+  };
+
+  namespace rooted_forest_internal {
+    constexpr uintE kNone = UINT_E_MAX;
+
+    /* Wyllie's pointer jumping over the successor lists in succ (kNone marks
+     * the end of a list, and lists may also be cycles). After the call, for a
+     * list val[e] is the sum of val over e and its successors, and for a cycle
+     * it is combine over the whole cycle. */
+    template <class T, class Combine>
+    void pointer_jump(pbbs::sequence<uintE>& succ, pbbs::sequence<T>& val,
+                      const Combine& combine) {
+      size_t k = succ.size();
+      auto nxt = succ;
+      auto nxt2 = pbbs::sequence<uintE>::no_init(k);
+      auto val2 = pbbs::sequence<T>::no_init(k);
+      for (size_t len = 1; len < k; len *= 2) {
+        parallel_for(0, k, [&] (size_t e) {
+          uintE s = nxt[e];
+          if (s == kNone) {
+            val2[e] = val[e];
+            nxt2[e] = kNone;
+          } else {
+            val2[e] = combine(val[e], val[s]);
+            nxt2[e] = nxt[s];
+          }
+        });
+        std::swap(nxt, nxt2);
+        std::swap(val, val2);
+      }
+    }
+  }  // namespace rooted_forest_internal
+
+  namespace rooted_forest_internal {
+    /* Builds the rooted forest on n vertices from its k directed tree edges D
+     * (both directions of every edge). If root is empty, each tree is rooted
+     * at its smallest vertex; otherwise root[v] is the root of v's tree. */
+    inline rooted_forest from_directed(size_t n, pbbs::sequence<edge>& D,
+                                       pbbs::sequence<uintE>& root) {
+      size_t k = D.size();
+
+      /* 1. Directed tree edges grouped by source, and sorted by target within
+       * each group. */
+      pbbslib::sample_sort_inplace(D.slice(), std::less<edge>());
+      auto start = pbbs::sequence<uintE>(n, kNone);
+      auto degree = pbbs::sequence<uintE>(n, (uintE)0);
+      parallel_for(0, k, [&] (size_t i) {
+        uintE u = D[i].first;
+        if (i == 0 || D[i - 1].first != u) start[u] = i;
+      });
+      parallel_for(0, k, [&] (size_t i) {
+        uintE u = D[i].first;
+        if (i == k - 1 || D[i + 1].first != u) degree[u] = i + 1 - start[u];
+      });
+
+      /* 2. The twin of (u, v) is (v, u), and the tour continues from (u, v)
+       * with the edge after (v, u) in v's list, wrapping around. */
+      auto twin = pbbs::sequence<uintE>::no_init(k);
+      auto succ = pbbs::sequence<uintE>::no_init(k);
+      parallel_for(0, k, [&] (size_t e) {
+        auto [u, v] = D[e];
+        auto first = D.begin() + start[v];
+        auto last = first + degree[v];
+        uintE t = std::lower_bound(first, last, std::make_pair(v, u)) - D.begin();
+        twin[e] = t;
+        succ[e] = start[v] + (t - start[v] + 1) % degree[v];
+      });
+
+      /* 3. The root of the tree (cycle) of every edge. */
+      pbbs::sequence<uintE> tree_root;
+      if (root.size() == 0) {
+        tree_root = pbbs::sequence<uintE>(k, [&] (size_t e) { return D[e].first; });
+        pointer_jump(succ, tree_root, [] (uintE a, uintE b) { return std::min(a, b); });
+      } else {
+        tree_root = pbbs::sequence<uintE>(k, [&] (size_t e) { return root[D[e].first]; });
+      }
+
+      /* 4. Break every cycle before the first edge of its root, so the tour of
+       * a tree rooted at r runs from start[r] and ends at the edge into r from
+       * r's last neighbor. */
+      auto is_root = pbbs::sequence<bool>(n, [&] (size_t v) {
+        return degree[v] == 0 || tree_root[start[v]] == v;
+      });
+      parallel_for(0, n, [&] (size_t r) {
+        if (degree[r] > 0 && is_root[r]) {
+          succ[twin[start[r] + degree[r] - 1]] = kNone;
+        }
+      });
+
+      /* 5. List ranking: the number of edges after each edge in its tour. */
+      auto to_end = pbbs::sequence<uintE>(k, [&] (size_t e) {
+        return (uintE)((succ[e] == kNone) ? 0 : 1);
+      });
+      pointer_jump(succ, to_end, [] (uintE a, uintE b) { return a + b; });
+
+      /* 6. Lay out the tours and the preorder numbers tree by tree. */
+      auto tour_start = pbbs::sequence<uintE>(n, [&] (size_t v) {
+        return (is_root[v] && degree[v] > 0) ? to_end[start[v]] + 1 : 0;
+      });
+      pbbslib::scan_add_inplace(tour_start.slice());
+      auto tree_size = pbbs::sequence<uintE>(n, [&] (size_t v) {
+        if (!is_root[v]) return (uintE)0;
+        return (degree[v] == 0) ? (uintE)1 : (uintE)((to_end[start[v]] + 1) / 2 + 1);
+      });
+      auto pre_base = tree_size;
+      pbbslib::scan_add_inplace(pre_base.slice());
+
+      rooted_forest F;
+      F.n = n;
+      F.num_trees = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(n, [&] (size_t v) {
+        return (size_t)is_root[v];
+      }));
+      F.tour = pbbs::sequence<edge>::no_init(k);
+      auto pos = pbbs::sequence<uintE>::no_init(k);
+      parallel_for(0, k, [&] (size_t e) {
+        uintE r = tree_root[e];
+        uintE len = to_end[start[r]] + 1;
+        pos[e] = tour_start[r] + (len - 1 - to_end[e]);
+        F.tour[pos[e]] = D[e];
+      });
+
+      /* 7. An edge goes down iff it precedes its twin in the tour. */
+      auto down = pbbs::sequence<uintE>(k, [&] (size_t p) { return (uintE)0; });
+      auto delta = pbbs::sequence<intE>::no_init(k);
+      parallel_for(0, k, [&] (size_t e) {
+        bool is_down = pos[e] < pos[twin[e]];
+        down[pos[e]] = is_down;
+        delta[pos[e]] = is_down ? 1 : -1;
+      });
+      pbbslib::scan_add_inplace(down.slice());   // exclusive
+      pbbslib::scan_add_inplace(delta.slice(), pbbslib::fl_scan_inclusive);
+
+      F.parents = pbbs::sequence<parent>::no_init(n);
+      F.root = pbbs::sequence<uintE>::no_init(n);
+      F.enter = pbbs::sequence<uintE>::no_init(n);
+      F.preorder = pbbs::sequence<uintE>::no_init(n);
+      F.subtree_size = pbbs::sequence<uintE>::no_init(n);
+      F.depth = pbbs::sequence<uintE>::no_init(n);
+      parallel_for(0, n, [&] (size_t v) {
+        if (is_root[v]) {
+          F.parents[v] = v;
+          F.root[v] = v;
+          F.enter[v] = kNone;
+          F.preorder[v] = pre_base[v];
+          F.subtree_size[v] = tree_size[v];
+          F.depth[v] = 0;
+        }
+      });
+      parallel_for(0, k, [&] (size_t e) {
+        uintE p = pos[e], q = pos[twin[e]];
+        if (p < q) {
+          auto [u, v] = D[e];
+          uintE r = tree_root[e];
+          F.parents[v] = u;
+          F.root[v] = r;
+          F.enter[v] = p;
+          F.preorder[v] = pre_base[r] + (down[p] - down[tour_start[r]]) + 1;
+          F.subtree_size[v] = (q - p + 1) / 2;
+          F.depth[v] = delta[p];
+        }
+      });
+      return F;
+    }
+  }  // namespace rooted_forest_internal
+
+  /* Builds the rooted forest on n vertices with the given tree edges. Each
+   * tree is rooted at its smallest vertex. O(k log k) work and O(log^2 k)
+   * depth for k edges. */
+  inline rooted_forest RootedForest(size_t n, pbbs::sequence<edge>& edges) {
+    auto D = pbbs::sequence<edge>(2 * edges.size(), [&] (size_t i) {
+      auto e = edges[i / 2];
+      return (i % 2 == 0) ? e : std::make_pair(e.second, e.first);
+    });
+    auto root = pbbs::sequence<uintE>();
+    return rooted_forest_internal::from_directed(n, D, root);
+  }
+
+  /* Builds the rooted forest with the given parent array (parents[v] == v for
+   * the roots), keeping its roots, without materializing the forest edges.
+   * O(n log n) work and O(log^2 n) depth. */
+  inline rooted_forest RootedForest(pbbs::sequence<parent>& parents) {
+    using namespace rooted_forest_internal;
+    size_t n = parents.size();
+    auto succ = pbbs::sequence<uintE>(n, [&] (size_t v) {
+      return (parents[v] == v) ? kNone : (uintE)parents[v];
+    });
+    auto root = pbbs::sequence<uintE>(n, [&] (size_t v) { return (uintE)v; });
+    pointer_jump(succ, root, [] (uintE a, uintE b) { return b; });
+    auto children = pbbslib::filter(
+        pbbs::delayed_seq<uintE>(n, [&] (size_t v) { return (uintE)v; }),
+        [&] (uintE v) { return parents[v] != v; });
+    auto D = pbbs::sequence<edge>(2 * children.size(), [&] (size_t i) {
+      uintE v = children[i / 2], p = parents[v];
+      return (i % 2 == 0) ? std::make_pair(p, v) : std::make_pair(v, p);
+    });
+    return from_directed(n, D, root);
+  }
+
+  /* Returns, for every vertex v, the combine of val over the subtree of v,
+   * where val is indexed by preorder number and combine is associative,
+   * commutative and idempotent (e.g. min or max). Subtrees are preorder
+   * ranges, so each is answered by block prefix and suffix values and a
+   * sparse table over the block values: O(n) work and space and O(log n)
+   * depth. */
+  template <class T, class Combine>
+  pbbs::sequence<T> subtree_aggregate(const rooted_forest& F,
+                                      pbbs::sequence<T>& val,
+                                      const Combine& combine) {
+    constexpr size_t kBlock = 64;
+    size_t n = F.n;
+    size_t num_blocks = pbbs::num_blocks(n, kBlock);
+    auto prefix = pbbs::sequence<T>::no_init(n);
+    auto suffix = pbbs::sequence<T>::no_init(n);
+    parallel_for(0, num_blocks, [&] (size_t b) {
+      size_t s = b * kBlock, e = std::min(s + kBlock, n);
+      prefix[s] = val[s];
+      for (size_t i = s + 1; i < e; i++) prefix[i] = combine(prefix[i - 1], val[i]);
+      suffix[e - 1] = val[e - 1];
+      for (size_t i = e - 1; i > s; i--) suffix[i - 1] = combine(val[i - 1], suffix[i]);
+    }, 1);
+
+    /* table[j][b] is the combine over blocks [b, b + 2^j). */
+    std::vector<pbbs::sequence<T>> table;
+    table.emplace_back(num_blocks, [&] (size_t b) { return suffix[b * kBlock]; });
+    for (size_t len = 1; 2 * len <= num_blocks; len *= 2) {
+      auto& prev = table.back();
+      auto next = pbbs::sequence<T>(num_blocks - 2 * len + 1, [&] (size_t b) {
+        return combine(prev[b], prev[b + len]);
+      });
+      table.push_back(std::move(next));
+    }
+
+    return pbbs::sequence<T>(n, [&] (size_t v) {
+      size_t l = F.preorder[v], r = l + F.subtree_size[v] - 1;
+      size_t lb = l / kBlock, rb = r / kBlock;
+      if (lb == rb) {
+        T res = val[l];
+        for (size_t i = l + 1; i <= r; i++) res = combine(res, val[i]);
+        return res;
+      }
+      T res = combine(suffix[l], prefix[r]);
+      if (lb + 1 < rb) {
+        size_t level = pbbs::log2_up(rb - lb) - 1;
+        res = combine(res, combine(table[level][lb + 1],
+                                   table[level][rb - ((size_t)1 << level)]));
+      }
+      return res;
+    });
+  }
+
+  /* Range minimum queries over a fixed sequence of values by a sparse table:
+   * O(n log n) work to build and O(1) per query. The table holds the values
+   * themselves, so it stays valid when copied or moved. */
+  template <class T>
+  struct range_min {
+    std::vector<pbbs::sequence<T>> table;
+
+    range_min() {}
+    explicit range_min(pbbs::sequence<T> vals) {
+      size_t n = vals.size();
+      table.push_back(std::move(vals));
+      for (size_t len = 1; 2 * len <= n; len *= 2) {
+        auto& prev = table.back();
+        auto next = pbbs::sequence<T>(n - 2 * len + 1, [&] (size_t i) {
+          return std::min(prev[i], prev[i + len]);
+        });
+        table.push_back(std::move(next));
+      }
+    }
+
+    /* Returns the smallest value in [l, r] (inclusive). */
+    T query(size_t l, size_t r) const {
+      size_t level = pbbs::log2_up(r - l + 2) - 1;
+      return std::min(table[level][l], table[level][r + 1 - ((size_t)1 << level)]);
+    }
+  };
+
+  /* Lowest common ancestors in O(1) per query after O(n log n) work, by the
+   * preorder numbering: for u != v with preorder[u] < preorder[v] and u not an
+   * ancestor of v, the vertex of smallest depth with preorder number in
+   * (preorder[u], preorder[v]] is the child of the LCA towards v. The range
+   * minima are taken over (depth, vertex) keys indexed by preorder number. F
+   * must outlive the structure. */
+  struct forest_lca {
+    const rooted_forest& F;
+    range_min<std::pair<uintE, uintE>> rmq;
+
+    explicit forest_lca(const rooted_forest& F) : F(F) {
+      auto keys = pbbs::sequence<std::pair<uintE, uintE>>::no_init(F.n);
+      parallel_for(0, F.n, [&] (size_t v) {
+        keys[F.preorder[v]] = std::make_pair(F.depth[v], (uintE)v);
+      });
+      rmq = range_min<std::pair<uintE, uintE>>(std::move(keys));
+    }
+
+    /* Returns the LCA of u and v, or UINT_E_MAX if they are in different
+     * trees. */
+    uintE lca(uintE u, uintE v) const {
+      if (F.root[u] != F.root[v]) return UINT_E_MAX;
+      if (F.preorder[u] > F.preorder[v]) std::swap(u, v);
+      if (F.is_ancestor(u, v)) return u;
+      uintE w = rmq.query(F.preorder[u] + 1, F.preorder[v]).second;
+      return F.parents[w];
+    }
+  };
+
+}  // namespace spanning_forest
+}  // namespace gbbs
@@ -0,0 +1,192 @@
+#include "benchmarks/SpanningForest/rooted_forest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace gbbs {
+namespace spanning_forest {
+
+namespace {
+
+// A forest on n vertices whose roots are not necessarily the smallest vertex
+// of their tree: vertices are attached in a random order, each to a random
+// earlier vertex, or made a root with probability root_prob.
+pbbs::sequence<parent> RandomForest(size_t n, double root_prob,
+                                    uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<uintE> order(n);
+  for (size_t i = 0; i < n; i++) order[i] = i;
+  std::shuffle(order.begin(), order.end(), gen);
+  std::uniform_real_distribution<double> coin(0, 1);
+  auto parents = pbbs::sequence<parent>(n);
+  for (size_t i = 0; i < n; i++) {
+    uintE v = order[i];
+    if (i == 0 || coin(gen) < root_prob) {
+      parents[v] = v;
+    } else {
+      parents[v] = order[std::uniform_int_distribution<size_t>(0, i - 1)(gen)];
+    }
+  }
+  return parents;
+}
+
+// The ancestors of v, from v up to its root.
+std::vector<uintE> Ancestors(const pbbs::sequence<parent>& parents, uintE v) {
+  std::vector<uintE> path = {v};
+  while (parents[v] != v) {
+    v = parents[v];
+    path.push_back(v);
+  }
+  return path;
+}
+
+uintE NaiveLca(const pbbs::sequence<parent>& parents, uintE u, uintE v) {
+  auto pu = Ancestors(parents, u);
+  auto pv = Ancestors(parents, v);
+  if (pu.back() != pv.back()) return UINT_E_MAX;
+  for (uintE a : pu) {
+    if (std::find(pv.begin(), pv.end(), a) != pv.end()) return a;
+  }
+  return UINT_E_MAX;
+}
+
+// Checks F against the forest given by parents, including subtree_aggregate
+// and LCA against brute force.
+void CheckForest(const rooted_forest& F, const pbbs::sequence<parent>& parents) {
+  size_t n = parents.size();
+  ASSERT_EQ(F.n, n);
+  size_t num_trees = 0;
+  std::vector<uintE> subtree_size(n, 0);
+  std::vector<bool> seen(n, false);
+  for (size_t v = 0; v < n; v++) {
+    auto path = Ancestors(parents, v);
+    EXPECT_EQ(F.parents[v], parents[v]) << "v = " << v;
+    EXPECT_EQ(F.root[v], path.back()) << "v = " << v;
+    EXPECT_EQ(F.depth[v], path.size() - 1) << "v = " << v;
+    EXPECT_EQ(F.is_root(v), parents[v] == v);
+    for (uintE a : path) subtree_size[a]++;
+    num_trees += (parents[v] == v);
+    ASSERT_LT(F.preorder[v], n);
+    EXPECT_FALSE(seen[F.preorder[v]]);
+    seen[F.preorder[v]] = true;
+    if (parents[v] != v) {
+      EXPECT_EQ(F.tour[F.enter[v]], std::make_pair((uintE)parents[v], (uintE)v));
+    }
+  }
+  EXPECT_EQ(F.num_trees, num_trees);
+  EXPECT_EQ(F.tour.size(), 2 * (n - num_trees));
+  for (size_t v = 0; v < n; v++) {
+    EXPECT_EQ(F.subtree_size[v], subtree_size[v]) << "v = " << v;
+  }
+  auto order = F.vertices_in_preorder();
+  for (size_t i = 0; i < n; i++) EXPECT_EQ(F.preorder[order[i]], i);
+
+  // Subtree minima and maxima of a value per vertex, indexed by preorder.
+  std::mt19937 gen(n);
+  std::vector<uintE> val_of(n);
+  for (size_t v = 0; v < n; v++) val_of[v] = gen() % 1000;
+  auto val = pbbs::sequence<uintE>(n, [&] (size_t i) { return val_of[order[i]]; });
+  auto sub_min = subtree_aggregate(F, val, [] (uintE a, uintE b) {
+    return std::min(a, b);
+  });
+  auto sub_max = subtree_aggregate(F, val, [] (uintE a, uintE b) {
+    return std::max(a, b);
+  });
+  std::vector<uintE> expected_min(val_of), expected_max(val_of);
+  for (size_t v = 0; v < n; v++) {
+    for (uintE a : Ancestors(parents, v)) {
+      expected_min[a] = std::min(expected_min[a], val_of[v]);
+      expected_max[a] = std::max(expected_max[a], val_of[v]);
+    }
+  }
+  for (size_t v = 0; v < n; v++) {
+    EXPECT_EQ(sub_min[v], expected_min[v]) << "v = " << v;
+    EXPECT_EQ(sub_max[v], expected_max[v]) << "v = " << v;
+  }
+
+  // LCA and ancestor tests, on all pairs of a small forest and a sample of a
+  // large one.
+  forest_lca L(F);
+  size_t step = (n <= 64) ? 1 : 7;
+  for (size_t u = 0; u < n; u += step) {
+    for (size_t v = 0; v < n; v += step) {
+      uintE expected = NaiveLca(parents, u, v);
+      EXPECT_EQ(L.lca(u, v), expected) << "u = " << u << ", v = " << v;
+      EXPECT_EQ(F.is_ancestor(u, v), expected == u)
+          << "u = " << u << ", v = " << v;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(RootedForest, SmallForestFromEdges) {
+  // Forest diagram:
+  //       0          5      7
+  //     / | \        |
+  //    1  2  6       8
+  //   / \
+  //  3   4
+  auto edges = pbbs::sequence<edge>(6);
+  edges[0] = {1, 0};
+  edges[1] = {0, 2};
+  edges[2] = {3, 1};
+  edges[3] = {1, 4};
+  edges[4] = {6, 0};
+  edges[5] = {8, 5};
+  auto F = RootedForest(9, edges);
+  auto parents = pbbs::sequence<parent>(9);
+  const parent kParents[] = {0, 0, 0, 1, 1, 5, 0, 7, 5};
+  for (size_t v = 0; v < 9; v++) parents[v] = kParents[v];
+  CheckForest(F, parents);
+  EXPECT_EQ(F.num_trees, 3);
+  // Children are visited in increasing order.
+  const uintE kPreorder[] = {0, 1, 4, 2, 3, 6, 5, 8, 7};
+  for (size_t v = 0; v < 9; v++) EXPECT_EQ(F.preorder[v], kPreorder[v]);
+}
+
+TEST(RootedForest, SmallForestFromParents) {
+  // The forest above, rerooted so that no root is the smallest vertex of its
+  // tree except for the singleton.
+  const parent kParents[] = {1, 1, 0, 1, 1, 8, 0, 7, 8};
+  auto parents = pbbs::sequence<parent>(9);
+  for (size_t v = 0; v < 9; v++) parents[v] = kParents[v];
+  auto F = RootedForest(parents);
+  CheckForest(F, parents);
+  forest_lca L(F);
+  EXPECT_EQ(L.lca(2, 6), 0);
+  EXPECT_EQ(L.lca(2, 3), 1);
+  EXPECT_EQ(L.lca(5, 8), 8);
+  EXPECT_EQ(L.lca(5, 7), UINT_E_MAX);
+}
+
+TEST(RootedForest, RandomForests) {
+  for (size_t n : {1, 2, 50, 1000}) {
+    for (double root_prob : {0.0, 0.01, 0.3}) {
+      auto parents = RandomForest(n, root_prob, n + 7);
+      CheckForest(RootedForest(parents), parents);
+
+      // Built from the edges, each tree is rerooted at its smallest vertex.
+      auto edges = parents_to_edges(parents);
+      auto F = RootedForest(n, edges);
+      auto rerooted = pbbs::sequence<parent>(F.parents);
+      CheckForest(F, rerooted);
+      std::vector<uintE> tree_min(n, UINT_E_MAX);
+      for (size_t v = 0; v < n; v++) {
+        uintE r = Ancestors(parents, v).back();
+        tree_min[r] = std::min(tree_min[r], (uintE)v);
+      }
+      for (size_t v = 0; v < n; v++) {
+        EXPECT_EQ(F.root[v], tree_min[Ancestors(parents, v).back()]);
+        uintE p = parents[v];
+        EXPECT_TRUE(p == v || F.parents[v] == p || F.parents[p] == v);
+      }
+    }
+  }
+}
+
+}  // namespace spanning_forest
+}  // namespace gbbs
@@ -0,0 +1,204 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "StronglyConnectedComponents.h"
+#include "gbbs/contract.h"
+#include "gbbs/gbbs.h"
+#include "gbbs/pbbslib/sparse_table.h"
+#include "pbbslib/sample_sort.h"
+
+namespace gbbs {
+
+using dag_graph = asymmetric_graph<asymmetric_vertex, pbbslib::empty>;
+
+// The condensation of a directed graph: the DAG with a vertex per SCC and an
+// edge (a, b) iff some edge of the graph goes from SCC a to SCC b. The DAG is
+// an ordinary asymmetric graph (with sorted adjacency lists), so the other
+// benchmarks can run on it directly; call dag.del() to free it.
+struct condensation {
+  dag_graph dag;
+  sequence<uintE> scc;  // the DAG vertex of each graph vertex
+  // level[a] is the number of vertices on the longest path ending at a,
+  // minus one; every edge (a, b) has level[a] < level[b].
+  sequence<uintE> level;
+  size_t num_levels;
+  // The DAG vertices in a topological order, sorted by level: the vertices of
+  // level l are order[level_offsets[l], level_offsets[l + 1]).
+  sequence<uintE> order;
+  sequence<size_t> level_offsets;
+};
+
+namespace condensation_internal {
+
+using edge = std::tuple<uintE, uintE>;
+
+// Returns the distinct edges between different SCCs, deduplicated by
+// hashing as in contract::fetch_intercluster_te.
+template <class Graph>
+sequence<edge> fetch_inter_scc_edges(Graph& GA, sequence<uintE>& scc) {
+  using W = typename Graph::weight_type;
+  using K = edge;
+  using V = pbbslib::empty;
+  using KV = std::tuple<K, V>;
+  size_t n = GA.n;
+
+  auto pred = [&](const uintE& src, const uintE& ngh, const W& w) {
+    return scc[src] != scc[ngh];
+  };
+  auto degrees = pbbs::delayed_seq<size_t>(n, [&](size_t i) {
+    return GA.get_vertex(i).countOutNgh(i, pred);
+  });
+  size_t num_edges = pbbslib::reduce_add(degrees);
+
+  KV empty =
+      std::make_tuple(std::make_tuple(UINT_E_MAX, UINT_E_MAX), pbbslib::empty());
+  auto hash_pair = [](const edge& t) {
+    size_t key = (static_cast<size_t>(std::get<0>(t)) << 32) + std::get<1>(t);
+    return pbbslib::hash64_2(key);
+  };
+  auto edge_table = pbbslib::make_sparse_table<K, V>(
+      std::max(num_edges, (size_t)1), empty, hash_pair);
+  auto map_f = [&](const uintE& src, const uintE& ngh, const W& w) {
+    uintE c_src = scc[src];
+    uintE c_ngh = scc[ngh];
+    if (c_src != c_ngh) {
+      edge_table.insert(
+          std::make_tuple(std::make_tuple(c_src, c_ngh), pbbslib::empty()));
+    }
+  };
+  par_for(0, n, 1, [&] (size_t i) { GA.get_vertex(i).mapOutNgh(i, map_f); });
+  auto entries = edge_table.entries();
+  edge_table.del();
+  return sequence<edge>(entries.size(), [&](size_t i) {
+    return std::get<0>(entries[i]);
+  });
+}
+
+// Builds the vertex data for the edges sorted by source, and writes the
+// targets to nghs.
+inline vertex_data* sorted_edges_to_csr(size_t n, sequence<edge>& edges,
+                                        std::tuple<uintE, pbbslib::empty>* nghs) {
+  auto v_data = pbbslib::new_array_no_init<vertex_data>(n);
+  par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t v) {
+    auto lower = [&](uintE u) {
+      return std::lower_bound(edges.begin(), edges.end(),
+                              std::make_tuple(u, (uintE)0)) - edges.begin();
+    };
+    size_t start = lower(v);
+    size_t end = (v + 1 < n) ? lower(v + 1) : edges.size();
+    v_data[v].offset = start;
+    v_data[v].degree = end - start;
+  });
+  par_for(0, edges.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    nghs[i] = std::make_tuple(std::get<1>(edges[i]), pbbslib::empty());
+  });
+  return v_data;
+}
+
+// Used to peel the DAG level by level (Kahn's algorithm in rounds).
+struct Level_F {
+  intE* in_degrees;
+  Level_F(intE* _in_degrees) : in_degrees(_in_degrees) {}
+  inline bool update(uintE s, uintE d) {
+    in_degrees[d]--;
+    return in_degrees[d] == 0;
+  }
+  inline bool updateAtomic(uintE s, uintE d) {
+    return pbbslib::fetch_and_add(&in_degrees[d], -1) == 1;
+  }
+  inline bool cond(uintE d) { return true; }
+};
+
+}  // namespace condensation_internal
+
+// Builds the condensation of GA given labels from StronglyConnectedComponents,
+// and its topological levels. Inter-SCC edges are deduplicated by hashing;
+// the levels are peeled off in rounds, one per level.
+template <class Graph>
+inline condensation Condensation(Graph& GA, sequence<label_type>& labels) {
+  using namespace condensation_internal;
+  size_t n = GA.n;
+  condensation C;
+
+  timer rt; rt.start();
+  C.scc = sequence<uintE>(n, [&](size_t i) { return (uintE)labels[i]; });
+  size_t k = contract::RelabelIds(C.scc);
+  rt.stop(); rt.reportTotal("relabel time");
+
+  timer et; et.start();
+  auto out_edges = fetch_inter_scc_edges(GA, C.scc);
+  size_t m = out_edges.size();
+  pbbslib::sample_sort_inplace(out_edges.slice(), std::less<edge>());
+  auto in_edges = sequence<edge>(m, [&](size_t i) {
+    return std::make_tuple(std::get<1>(out_edges[i]), std::get<0>(out_edges[i]));
+  });
+  pbbslib::sample_sort_inplace(in_edges.slice(), std::less<edge>());
+
+  using edge_type = typename dag_graph::edge_type;
+  auto out_nghs = pbbslib::new_array_no_init<edge_type>(m);
+  auto in_nghs = pbbslib::new_array_no_init<edge_type>(m);
+  auto v_out = sorted_edges_to_csr(k, out_edges, out_nghs);
+  auto v_in = sorted_edges_to_csr(k, in_edges, in_nghs);
+  auto deletion_fn = [=]() {
+    pbbslib::free_arrays(v_out, v_in, out_nghs, in_nghs);
+  };
+  C.dag = dag_graph(v_out, v_in, k, m, deletion_fn, out_nghs, in_nghs);
+  et.stop(); et.reportTotal("condensation edges time");
+
+  timer lt; lt.start();
+  auto in_degrees = sequence<intE>(k, [&](size_t a) {
+    return (intE)C.dag.get_vertex(a).getInDegree();
+  });
+  C.level = sequence<uintE>(k);
+  C.order = sequence<uintE>(k);
+  std::vector<size_t> offsets = {0};
+  auto sources = pbbslib::filter(
+      pbbs::delayed_seq<uintE>(k, [](size_t a) { return (uintE)a; }),
+      [&](uintE a) { return in_degrees[a] == 0; });
+  auto frontier = vertexSubset(k, std::move(sources));
+  for (uintE l = 0; !frontier.isEmpty(); l++) {
+    frontier.toSparse();
+    size_t off = offsets.back();
+    par_for(0, frontier.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+      uintE a = frontier.vtx(i);
+      C.level[a] = l;
+      C.order[off + i] = a;
+    });
+    offsets.push_back(off + frontier.size());
+    vertexSubset output = edgeMap(
+        C.dag, frontier, wrap_em_f<pbbslib::empty>(Level_F(in_degrees.begin())),
+        -1, sparse_blocked);
+    frontier.del();
+    frontier = output;
+  }
+  C.num_levels = offsets.size() - 1;
+  C.level_offsets = sequence<size_t>(offsets.size(), [&](size_t i) {
+    return offsets[i];
+  });
+  lt.stop(); lt.reportTotal("topological levels time");
+  return C;
+}
+
+}  // namespace gbbs
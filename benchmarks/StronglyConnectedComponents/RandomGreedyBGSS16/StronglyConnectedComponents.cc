@@ -30,31 +30,60 @@
 //     -beta <value> : the base of the exponent to use (controls how quickly
 //                     vertices are added)
 //     -rounds : the number of times to run the algorithm
+//     -trim_rounds <k> : the number of rounds of trim-1 within subproblems
+//                        (default 0)
+//     -trim2 : also trim pairs of vertices forming an SCC
+//     -no_pivot : skip the single-pivot search for the giant SCC
+//     -retrim : trim again after the pivot search
+//     -coloring_rounds <k> : the number of rounds of coloring to run before
+//                            the multi-search rounds (default 0)
 //     -stats : print the #sccs, and the #vertices in the largest scc
+//     -condense : also build the condensation DAG and its topological levels
 
+#include "Condensation.h"
 #include "StronglyConnectedComponents.h"
 
 namespace gbbs {
 template <class Graph>
 double StronglyConnectedComponents_runner(Graph& G, commandLine P) {
-  double beta = P.getOptionDoubleValue("-beta", 1.1);
+  scc_params params;
+  params.beta = P.getOptionDoubleValue("-beta", 1.1);
+  params.trim_rounds = P.getOptionLongValue("-trim_rounds", 0);
+  params.trim2 = P.getOption("-trim2");
+  params.pivot = !P.getOption("-no_pivot");
+  params.retrim = P.getOption("-retrim");
+  params.coloring_rounds = P.getOptionLongValue("-coloring_rounds", 0);
   std::cout << "### Application: StronglyConnectedComponents (Strongly Connected Components)" << std::endl;
   std::cout << "### Graph: " << P.getArgument(0) << std::endl;
   std::cout << "### Threads: " << num_workers() << std::endl;
   std::cout << "### n: " << G.n << std::endl;
   std::cout << "### m: " << G.m << std::endl;
-  std::cout << "### Params: -beta = " << beta << std::endl;
+  std::cout << "### Params: -beta = " << params.beta
+            << " -trim_rounds = " << params.trim_rounds
+            << " -trim2 = " << params.trim2 << " -pivot = " << params.pivot
+            << " -retrim = " << params.retrim
+            << " -coloring_rounds = " << params.coloring_rounds << std::endl;
   std::cout << "### ------------------------------------" << std::endl;
 
   assert(!P.getOption("-s"));
   timer scc_t;
   scc_t.start();
-  auto labels = StronglyConnectedComponents(G, beta);
+  auto labels = StronglyConnectedComponents(G, params);
   double tt = scc_t.stop();
   if (P.getOption("-stats")) {
     num_scc(labels);
     scc_stats(labels);
   }
+  if (P.getOption("-condense")) {
+    timer ct;
+    ct.start();
+    auto C = Condensation(G, labels);
+    ct.stop();
+    ct.reportTotal("condensation time");
+    std::cout << "### Condensation: n = " << C.dag.n << " m = " << C.dag.m
+              << " levels = " << C.num_levels << std::endl;
+    C.dag.del();
+  }
 
   std::cout << "### Running Time: " << tt << std::endl;
   return tt;
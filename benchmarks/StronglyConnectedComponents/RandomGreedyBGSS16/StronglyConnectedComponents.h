@@ -194,8 +194,212 @@ inline bool* first_search(Graph& GA, L& labels, uintE start,
   return Flags.to_array();
 }
 
+// Configures the phases run before the multi-search rounds. The vertices with
+// no in- or out-edges are always removed first as singleton SCCs. The
+// defaults then only run the pivot, as the original pipeline did; the other
+// phases are opt-in. Each phase finishes some SCCs and splits the remaining
+// vertices into subproblems.
+//   trim_rounds: rounds of trim-1, each removing the vertices with no in- or
+//     out-neighbors (other than themselves) in their subproblem as singleton
+//     SCCs.
+//   trim2: also remove the pairs {u, v} where u and v are each other's only
+//     in-neighbor (or only out-neighbor) in their subproblem.
+//   pivot: search forwards and backwards from the vertex of largest
+//     out-degree, which finds the giant SCC.
+//   retrim: run the trim phases again on the subproblems the pivot creates.
+//   coloring_rounds: rounds of coloring, which each finish at least one SCC
+//     per subproblem (suited to the tail of small SCCs).
+//   beta: the base of the exponent for the multi-search batch sizes.
+struct scc_params {
+  size_t trim_rounds = 0;
+  bool trim2 = false;
+  bool pivot = true;
+  bool retrim = false;
+  size_t coloring_rounds = 0;
+  double beta = 1.5;
+};
+
+// Returns the number of in-neighbors (or out-neighbors, if out is set) of v
+// other than itself in its subproblem.
+template <class Graph, class Seq>
+inline size_t subproblem_degree(Graph& GA, Seq& labels, uintE v, bool out) {
+  using W = typename Graph::weight_type;
+  auto pred = [&](const uintE& src, const uintE& ngh, const W& wgh) {
+    return ngh != src && labels[ngh] == labels[src];
+  };
+  return out ? GA.get_vertex(v).countOutNgh(v, pred)
+             : GA.get_vertex(v).countInNgh(v, pred);
+}
+
+// Trim-1: the active vertices with no in- or out-neighbors in their
+// subproblem are singleton SCCs. Returns the remaining active vertices.
+template <class Graph, class Seq>
+inline sequence<uintE> trim_singletons(Graph& GA, Seq& labels,
+                                       sequence<uintE>& active,
+                                       size_t& label_offset) {
+  auto trimmed = pbbslib::filter(active, [&](uintE v) {
+    return subproblem_degree(GA, labels, v, false) == 0 ||
+           subproblem_degree(GA, labels, v, true) == 0;
+  });
+  par_for(0, trimmed.size(), pbbslib::kSequentialForThreshold, [&] (size_t i)
+                  { labels[trimmed[i]] = (label_offset + i) | TOP_BIT; });
+  label_offset += trimmed.size();
+  return pbbslib::filter(active, [&](uintE v) {
+    return !(labels[v] & TOP_BIT);
+  });
+}
+
+// Trim-2: if u's only in-neighbor in its subproblem is v and v's is u, then
+// {u, v} is an SCC, and similarly for out-neighbors. Returns the remaining
+// active vertices.
+template <class Graph, class Seq>
+inline sequence<uintE> trim_pairs(Graph& GA, Seq& labels,
+                                  sequence<uintE>& active,
+                                  size_t& label_offset) {
+  using W = typename Graph::weight_type;
+  size_t n = GA.n;
+  auto in_partner = sequence<uintE>(n, UINT_E_MAX);
+  auto out_partner = sequence<uintE>(n, UINT_E_MAX);
+  par_for(0, active.size(), 1, [&] (size_t i) {
+    uintE v = active[i];
+    auto set_in = [&](const uintE& src, const uintE& ngh, const W& wgh) {
+      if (ngh != src && labels[ngh] == labels[src]) in_partner[src] = ngh;
+    };
+    auto set_out = [&](const uintE& src, const uintE& ngh, const W& wgh) {
+      if (ngh != src && labels[ngh] == labels[src]) out_partner[src] = ngh;
+    };
+    if (subproblem_degree(GA, labels, v, false) == 1) {
+      GA.get_vertex(v).mapInNgh(v, set_in, false);
+    }
+    if (subproblem_degree(GA, labels, v, true) == 1) {
+      GA.get_vertex(v).mapOutNgh(v, set_out, false);
+    }
+  });
+  // A vertex is in at most one such pair, as both pairs would be its SCC.
+  auto partner = [&](uintE v) {
+    uintE u = in_partner[v];
+    if (u != UINT_E_MAX && in_partner[u] == v) return u;
+    u = out_partner[v];
+    if (u != UINT_E_MAX && out_partner[u] == v) return u;
+    return UINT_E_MAX;
+  };
+  auto reps = pbbslib::filter(active, [&](uintE v) {
+    uintE u = partner(v);
+    return u != UINT_E_MAX && v < u;
+  });
+  par_for(0, reps.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    uintE v = reps[i];
+    labels[v] = (label_offset + i) | TOP_BIT;
+    labels[partner(v)] = (label_offset + i) | TOP_BIT;
+  });
+  label_offset += reps.size();
+  return pbbslib::filter(active, [&](uintE v) {
+    return !(labels[v] & TOP_BIT);
+  });
+}
+
+// Propagates the largest color forwards within each subproblem.
+template <class C, class L>
+struct Color_F {
+  C& colors;
+  L& labels;
+  bool* bits;
+  Color_F(C& _colors, L& _labels, bool* _bits)
+      : colors(_colors), labels(_labels), bits(_bits) {}
+  inline bool update(uintE s, uintE d) { return updateAtomic(s, d); }
+  inline bool updateAtomic(uintE s, uintE d) {
+    uintE c = colors[s];
+    if (labels[s] == labels[d] && c > colors[d]) {
+      pbbslib::write_max(&colors[d], c);
+      return pbbslib::CAS(&bits[d], false, true);
+    }
+    return false;
+  }
+  inline bool cond(uintE d) { return !(labels[d] & TOP_BIT); }
+};
+
+// Searches backwards from each color's root over vertices of the same color.
+template <class V, class C, class L>
+struct Color_Search_F {
+  V& visited;
+  C& colors;
+  L& labels;
+  Color_Search_F(V& _visited, C& _colors, L& _labels)
+      : visited(_visited), colors(_colors), labels(_labels) {}
+  inline bool update(uintE s, uintE d) { return updateAtomic(s, d); }
+  inline bool updateAtomic(uintE s, uintE d) {
+    if (labels[s] == labels[d] && colors[s] == colors[d]) {
+      return pbbslib::CAS(&visited[d], false, true);
+    }
+    return false;
+  }
+  inline bool cond(uintE d) { return !(labels[d] & TOP_BIT) && !visited[d]; }
+};
+
+// One round of coloring: every active vertex takes the largest id that
+// reaches it in its subproblem. A vertex r keeping its own color is the root
+// of its color, and r's SCC is the vertices of its color that reach r. The
+// rest of each color becomes a new subproblem. Returns the remaining active
+// vertices.
+template <class Graph, class Seq>
+inline sequence<uintE> coloring_round(Graph& GA, Seq& labels, bool* bits,
+                                      sequence<uintE>& active,
+                                      size_t& label_offset) {
+  using W = typename Graph::weight_type;
+  size_t n = GA.n;
+  auto colors = sequence<uintE>(n, UINT_E_MAX);
+  par_for(0, active.size(), pbbslib::kSequentialForThreshold, [&] (size_t i)
+                  { colors[active[i]] = active[i]; });
+
+  auto frontier = vertexSubset(n, active.size(), sequence<uintE>(active).to_array());
+  while (!frontier.isEmpty()) {
+    frontier.toSparse();
+    par_for(0, frontier.size(), [&] (size_t i) {
+      bits[frontier.s[i]] = false;
+    }, (frontier.size() > 2000));
+    vertexSubset output = edgeMap(
+        GA, frontier, wrap_em_f<W>(Color_F(colors, labels, bits)), -1,
+        sparse_blocked);
+    frontier.del();
+    frontier = output;
+  }
+  par_for(0, active.size(), pbbslib::kSequentialForThreshold, [&] (size_t i)
+                  { bits[active[i]] = false; });
+
+  auto roots = pbbslib::filter(active, [&](uintE v) { return colors[v] == v; });
+  auto visited = sequence<bool>(n, false);
+  auto root_label = sequence<label_type>::no_init(n);
+  par_for(0, roots.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    visited[roots[i]] = true;
+    root_label[roots[i]] = label_offset + i;
+  });
+  label_offset += roots.size();
+
+  size_t roots_size = roots.size();
+  frontier = vertexSubset(n, roots_size, roots.to_array());
+  while (!frontier.isEmpty()) {
+    vertexSubset output = edgeMap(
+        GA, frontier, wrap_em_f<W>(Color_Search_F(visited, colors, labels)), -1,
+        in_edges | sparse_blocked);
+    frontier.del();
+    frontier = output;
+  }
+
+  // The new subproblem ids reuse the root's label, which is larger than every
+  // current label.
+  par_for(0, active.size(), pbbslib::kSequentialForThreshold, [&] (size_t i) {
+    uintE v = active[i];
+    label_type label = root_label[colors[v]];
+    labels[v] = visited[v] ? (label | TOP_BIT) : label;
+  });
+  return pbbslib::filter(active, [&](uintE v) {
+    return !(labels[v] & TOP_BIT);
+  });
+}
+
 template <class Graph>
-inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta = 1.5) {
+inline sequence<label_type> StronglyConnectedComponents(Graph& GA,
+                                                        const scc_params& params) {
   timer initt;
   initt.start();
   size_t n = GA.n;
@@ -208,27 +412,51 @@ inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta =
   auto zero = pbbslib::filter(v_im, [&](size_t i) {
     return (GA.get_vertex(i).getOutDegree() == 0) || (GA.get_vertex(i).getInDegree() == 0);
   });
-  auto NZ = pbbslib::filter(v_im, [&](size_t i) {
+  auto active = pbbslib::filter(v_im, [&](size_t i) {
     return (GA.get_vertex(i).getOutDegree() > 0) && (GA.get_vertex(i).getInDegree() > 0);
   });
-
-  auto P = pbbslib::random_shuffle(NZ);
   std::cout << "Filtered: " << zero.size()
-            << " vertices. Num remaining = " << P.size() << "\n";
+            << " vertices. Num remaining = " << active.size() << "\n";
 
   // Assign labels from [0...zero.size())
   par_for(0, zero.size(), pbbslib::kSequentialForThreshold, [&] (size_t i)
                   { labels[zero[i]] = i | TOP_BIT; });
 
   size_t step_size = 1, cur_offset = 0, finished = 0, cur_round = 0;
-  double step_multiplier = beta;
+  double step_multiplier = params.beta;
   size_t label_offset = zero.size() + 1; // TODO(laxmand): zero.size()?
 
   initt.stop();
   initt.reportTotal("init");
 
+  auto trim = [&]() {
+    if (params.trim_rounds > 0) {
+      timer tt; tt.start();
+      size_t before = active.size();
+      for (size_t r = 0; r < params.trim_rounds; r++) {
+        size_t round_before = active.size();
+        active = trim_singletons(GA, labels, active, label_offset);
+        if (active.size() == round_before) break;
+      }
+      tt.stop(); tt.reportTotal("trim time");
+      std::cout << "Trimmed: " << (before - active.size())
+                << " vertices. Num remaining = " << active.size() << "\n";
+    }
+    if (params.trim2) {
+      timer t2; t2.start();
+      size_t before = active.size();
+      active = trim_pairs(GA, labels, active, label_offset);
+      t2.stop(); t2.reportTotal("trim-2 time");
+      std::cout << "Trimmed pairs: " << (before - active.size())
+                << " vertices. Num remaining = " << active.size() << "\n";
+    }
+  };
+  trim();
+
+  auto P = pbbslib::random_shuffle(active);
+
   // Run the first search (BFS)
-  {
+  if (params.pivot && n > 0) {
     timer hd; hd.start();
     auto deg_im_f = [&](size_t i) {
       return std::make_tuple(i, GA.get_vertex(i).getOutDegree());
@@ -261,15 +489,33 @@ inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta =
       pbbslib::free_array(in_visits);
       pbbslib::free_array(out_visits);
       label_offset += 1;
+      active = pbbslib::filter(active, [&](uintE v) {
+        return !(labels[v] & TOP_BIT);
+      });
       hd.stop();
       hd.reportTotal("big scc time");
+      // The pivot splits the graph into subproblems, which may expose more
+      // vertices to trim.
+      if (params.retrim) trim();
+    }
+  }
+
+  if (params.coloring_rounds > 0) {
+    timer ct; ct.start();
+    size_t before = active.size();
+    for (size_t r = 0; r < params.coloring_rounds && active.size() > 0; r++) {
+      active = coloring_round(GA, labels, bits, active, label_offset);
     }
+    ct.stop(); ct.reportTotal("coloring time");
+    std::cout << "Colored: " << (before - active.size())
+              << " vertices. Num remaining = " << active.size() << "\n";
   }
 
   auto Q = pbbslib::filter(P, [&](uintE v) { return !(labels[v] & TOP_BIT); });
   std::cout << "After first round, Q = " << Q.size()
             << " vertices remain. Total done = " << (n - Q.size()) << "\n";
 
+  timer mst; mst.start();
   while (finished < Q.size()) {
     timer rt;
     rt.start();
@@ -375,6 +621,8 @@ inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta =
     rt.stop();
     rt.reportTotal("Round time");
   }
+  mst.stop(); mst.reportTotal("multi-search time");
+  pbbslib::free_array(bits);
 
   parallel_for(0, labels.size(), [&] (size_t i) {
     labels[i] = labels[i] & VAL_MASK;
@@ -382,6 +630,13 @@ inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta =
   return labels;
 }
 
+template <class Graph>
+inline sequence<label_type> StronglyConnectedComponents(Graph& GA, double beta = 1.5) {
+  scc_params params;
+  params.beta = beta;
+  return StronglyConnectedComponents(GA, params);
+}
+
 template <class Seq>
 inline size_t num_done(Seq& labels) {
   auto im_f = [&](size_t i) {
@@ -396,12 +651,9 @@ template <class Seq>
 inline size_t num_scc(Seq& labels) {
   size_t n = labels.size();
   auto flags = sequence<uintE>(n + 1, [&](size_t i) { return 0; });
+  // Label 0 is a valid SCC label (the first vertex removed by the zero-degree
+  // filter), so unlabeled vertices cannot be told apart here.
   par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i) {
-    if (labels[i] == 0) {
-      std::cout << "unlabeled"
-                << "\n";
-      exit(0);
-    }
     size_t label = labels[i] & VAL_MASK;
     if (!flags[label]) {
       flags[label] = 1;
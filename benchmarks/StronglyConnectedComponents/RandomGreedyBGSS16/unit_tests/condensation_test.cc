@@ -0,0 +1,108 @@
+#include "benchmarks/StronglyConnectedComponents/RandomGreedyBGSS16/Condensation.h"
+
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_io.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edges = std::vector<gbbs_io::Edge<pbbslib::empty>>;
+
+void CheckCondensation(const Edges& edges) {
+  auto graph{gbbs_io::edge_list_to_asymmetric_graph(edges)};
+  size_t n = graph.n;
+  alloc_init(graph);
+  uintE num_sccs;
+  auto expected = graph_test::TarjanSCC(n, edges, &num_sccs);
+
+  auto labels = StronglyConnectedComponents(graph);
+  auto C = Condensation(graph, labels);
+  auto& dag = C.dag;
+  ASSERT_EQ(dag.n, num_sccs);
+
+  // The DAG vertex of each Tarjan SCC.
+  std::vector<uintE> vertex_of(num_sccs, UINT_E_MAX);
+  for (size_t v = 0; v < n; v++) {
+    ASSERT_LT(C.scc[v], num_sccs);
+    if (vertex_of[expected[v]] == UINT_E_MAX) {
+      vertex_of[expected[v]] = C.scc[v];
+    }
+    EXPECT_EQ(C.scc[v], vertex_of[expected[v]]) << "v = " << v;
+  }
+
+  std::set<std::pair<uintE, uintE>> dag_edges;
+  for (const auto& e : edges) {
+    if (C.scc[e.from] != C.scc[e.to]) {
+      dag_edges.insert({C.scc[e.from], C.scc[e.to]});
+    }
+  }
+  ASSERT_EQ(dag.m, dag_edges.size());
+  std::vector<std::pair<uintE, uintE>> out_edges, in_edges;
+  for (size_t a = 0; a < dag.n; a++) {
+    auto vtx = dag.get_vertex(a);
+    for (size_t i = 0; i < vtx.getOutDegree(); i++) {
+      out_edges.push_back({a, vtx.getOutNeighbor(i)});
+    }
+    for (size_t i = 0; i < vtx.getInDegree(); i++) {
+      in_edges.push_back({vtx.getInNeighbor(i), a});
+    }
+  }
+  // Adjacency lists are sorted, so out_edges is in lexicographic order.
+  std::vector<std::pair<uintE, uintE>> expected_edges(dag_edges.begin(),
+                                                      dag_edges.end());
+  EXPECT_EQ(out_edges, expected_edges);
+  std::sort(in_edges.begin(), in_edges.end());
+  EXPECT_EQ(in_edges, out_edges);
+
+  // Longest paths, over the Tarjan SCCs in topological order.
+  std::vector<std::vector<uintE>> dag_adj(num_sccs);
+  for (const auto& [a, b] : dag_edges) dag_adj[a].push_back(b);
+  std::vector<uintE> level(num_sccs, 0);
+  size_t num_levels = 0;
+  for (uintE t = num_sccs; t-- > 0;) {
+    uintE a = vertex_of[t];
+    num_levels = std::max(num_levels, (size_t)level[a] + 1);
+    for (uintE b : dag_adj[a]) level[b] = std::max(level[b], level[a] + 1);
+  }
+  EXPECT_EQ(C.num_levels, num_levels);
+  ASSERT_EQ(C.level_offsets.size(), num_levels + 1);
+  EXPECT_EQ(C.level_offsets[num_levels], num_sccs);
+  std::vector<bool> seen(num_sccs, false);
+  for (size_t l = 0; l < num_levels; l++) {
+    for (size_t i = C.level_offsets[l]; i < C.level_offsets[l + 1]; i++) {
+      uintE a = C.order[i];
+      EXPECT_FALSE(seen[a]);
+      seen[a] = true;
+      EXPECT_EQ(C.level[a], l);
+      EXPECT_EQ(level[a], l) << "a = " << a;
+    }
+  }
+  dag.del();
+}
+
+}  // namespace
+
+TEST(Condensation, SmallGraph) {
+  // Graph diagram (all edges point right or down unless marked):
+  //   0 -> 1 -> 2 -> 3 <-> 4     7 -> 8 -> 9
+  //        ^    |              ^      |
+  //        '----'              '------'
+  //   5 <-> 6 -> 0
+  const Edges kEdges{
+    {0, 1}, {1, 2}, {2, 1}, {2, 3}, {3, 4}, {4, 3},
+    {5, 6}, {6, 5}, {6, 0}, {7, 8}, {8, 7}, {8, 9},
+  };
+  CheckCondensation(kEdges);
+}
+
+TEST(Condensation, PseudorandomGraph) {
+  constexpr uintE kNumVertices{400};
+  CheckCondensation(graph_test::GiantSCCEdges(kNumVertices));
+}
+
+}  // namespace gbbs
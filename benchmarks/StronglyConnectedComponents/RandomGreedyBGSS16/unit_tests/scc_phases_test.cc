@@ -0,0 +1,64 @@
+#include "benchmarks/StronglyConnectedComponents/RandomGreedyBGSS16/StronglyConnectedComponents.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_io.h"
+#include "gbbs/graph_test_utils.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edges = std::vector<gbbs_io::Edge<pbbslib::empty>>;
+
+void CheckAllPhases(const Edges& edges) {
+  auto graph{gbbs_io::edge_list_to_asymmetric_graph(edges)};
+  size_t n = graph.n;
+  alloc_init(graph);
+  auto expected = graph_test::TarjanSCC(n, edges);
+
+  std::vector<scc_params> configs(6);
+  configs[1].trim_rounds = 10;
+  configs[1].trim2 = true;
+  configs[2].pivot = false;
+  configs[2].coloring_rounds = 2;
+  configs[3].pivot = false;
+  configs[4].trim_rounds = 3;
+  configs[4].trim2 = true;
+  configs[4].coloring_rounds = n;
+  configs[5].trim_rounds = 1;
+  configs[5].retrim = true;
+  for (const auto& params : configs) {
+    auto labels = StronglyConnectedComponents(graph, params);
+    for (size_t v = 0; v < n; v++) {
+      EXPECT_LE(labels[v], n);
+      for (size_t u = 0; u < v; u++) {
+        EXPECT_EQ(labels[u] == labels[v], expected[u] == expected[v])
+            << "u = " << u << ", v = " << v;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(StronglyConnectedComponents, SmallGraph) {
+  // Graph diagram (all edges point right or down unless marked):
+  //   0 -> 1 -> 2 -> 3 <-> 4     7 -> 8 -> 9
+  //        ^    |              ^      |
+  //        '----'              '------'
+  //   5 <-> 6 -> 0
+  const Edges kEdges{
+    {0, 1}, {1, 2}, {2, 1}, {2, 3}, {3, 4}, {4, 3},
+    {5, 6}, {6, 5}, {6, 0}, {7, 8}, {8, 7}, {8, 9},
+  };
+  CheckAllPhases(kEdges);
+}
+
+TEST(StronglyConnectedComponents, PseudorandomGraph) {
+  constexpr uintE kNumVertices{400};
+  CheckAllPhases(graph_test::GiantSCCEdges(kNumVertices));
+}
+
+}  // namespace gbbs
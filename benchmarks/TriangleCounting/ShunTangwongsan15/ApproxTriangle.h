@@ -0,0 +1,247 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include <cassert>
+#include <cmath>
+
+#include "pbbslib/random.h"
+#include "Triangle.h"
+
+namespace gbbs {
+
+// An unbiased estimate of a count, together with an estimate of its variance.
+struct count_estimate {
+  double estimate = 0;
+  double variance = 0;  // estimated variance of `estimate`
+  size_t samples = 0;   // number of independent samples averaged
+  double seconds = 0;   // time spent sampling
+
+  double std_error() const { return std::sqrt(variance); }
+
+  // Critical value of the two-sided 95% confidence interval: Student's t for
+  // few samples (e.g. Doulion trials), otherwise the normal approximation.
+  double critical_value() const {
+    static constexpr double t95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    return (samples >= 2 && samples <= 31) ? t95[samples - 2] : 1.96;
+  }
+  // Half-width of the 95% confidence interval.
+  double half_width() const { return critical_value() * std_error(); }
+  double relative_error() const {
+    return (estimate > 0) ? half_width() / estimate : INFINITY;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const count_estimate& e) {
+  os << std::llround(e.estimate) << " +/- " << std::llround(e.half_width())
+     << " (95% CI, stderr = " << std::llround(e.std_error())
+     << ", samples = " << e.samples << ")";
+  return os;
+}
+
+// Controls how many samples the estimators draw. Sampling stops as soon as
+// one of the enabled conditions holds, checked after every round (rounds
+// double in size, starting at min_samples). For Doulion, a sample is a whole
+// sparsify-and-count trial, so min_samples should be small.
+struct sampling_params {
+  size_t min_samples = 1000;
+  size_t max_samples = 100000000;
+  // Stop once the 95% confidence interval is within this fraction of the
+  // estimate (0 disables).
+  double relative_error = 0;
+  // Stop once this many seconds have been spent (0 disables).
+  double time_budget = 0;
+  size_t seed = 0;
+};
+
+namespace approx_triangle {
+
+// Averages i.i.d. samples x_i, with E[scale * x_i] = the count, drawn in
+// rounds by draw(first, num, out), which writes samples first, ...,
+// first + num - 1 to out.
+template <class Draw>
+inline count_estimate estimate_mean(const Draw& draw, double scale,
+                                    const sampling_params& params) {
+  timer t; t.start();
+  count_estimate e;
+  double sum = 0, sum_sq = 0;
+  // The sample variance needs at least two samples.
+  size_t max_samples = std::max(params.max_samples, (size_t)2);
+  size_t round = std::max(params.min_samples, (size_t)2);
+  auto buffer = sequence<double>();
+  while (true) {
+    size_t num = std::min(round, max_samples - e.samples);
+    if (buffer.size() < num) buffer = sequence<double>::no_init(num);
+    draw(e.samples, num, buffer.begin());
+    auto B = buffer.slice(0, num);
+    sum += pbbslib::reduce_add(B);
+    sum_sq += pbbslib::reduce_add(
+        pbbs::delayed_seq<double>(num, [&](size_t i) { return B[i] * B[i]; }));
+    e.samples += num;
+    double mean = sum / e.samples;
+    double sample_var = std::max(0.0, (sum_sq - e.samples * mean * mean) /
+                                          (e.samples - 1));
+    e.estimate = scale * mean;
+    e.variance = scale * scale * sample_var / e.samples;
+    e.seconds = t.get_total();
+    if (e.samples >= max_samples) break;
+    if (params.time_budget > 0 && e.seconds >= params.time_budget) break;
+    if (params.relative_error > 0 && e.relative_error() <= params.relative_error) {
+      break;
+    }
+    round *= 2;
+    if (params.time_budget > 0) {
+      // Shrink the next round to the samples that fit in the remaining time.
+      // (A round can finish below the timer's resolution.)
+      if (e.seconds > 0) {
+        double rate = e.samples / e.seconds;
+        double fit = rate * (params.time_budget - e.seconds);
+        if (fit < 1) break;
+        round = std::min(round, (size_t)fit);
+      }
+    }
+  }
+  return e;
+}
+
+// Returns whether v is in the (sorted) neighbor list of u.
+template <class Graph>
+inline bool has_edge(Graph& G, uintE u, uintE v) {
+  using W = typename Graph::weight_type;
+  auto vtx = G.get_vertex(u);
+  auto nghs = vtx.getOutNeighbors();
+  auto end = nghs + vtx.getOutDegree();
+  auto it = std::lower_bound(nghs, end, v,
+      [&](const std::tuple<uintE, W>& e, uintE x) { return std::get<0>(e) < x; });
+  return it != end && std::get<0>(*it) == v;
+}
+
+}  // namespace approx_triangle
+
+// Estimates the number of triangles by wedge sampling. A wedge (path of
+// length two) is drawn uniformly at random by picking its center v with
+// probability proportional to deg(v) choose 2 and then two distinct neighbors
+// of v; each triangle closes exactly three wedges, so
+//   T = (#wedges / 3) * Pr[a random wedge is closed].
+// Requires an uncompressed symmetric graph with sorted neighbor lists.
+template <class Graph>
+inline count_estimate WedgeSampling(Graph& G, const sampling_params& params) {
+  size_t n = G.n;
+  auto wedges = sequence<size_t>(n, [&](size_t v) {
+    size_t d = G.get_vertex(v).getOutDegree();
+    return (d < 2) ? 0 : d * (d - 1) / 2;
+  });
+  size_t total = pbbslib::scan_add_inplace(wedges);
+  if (total == 0) return count_estimate();
+  auto r = pbbs::random(params.seed);
+  auto draw = [&](size_t first, size_t num, double* out) {
+    parallel_for(0, num, [&](size_t i) {
+      auto rr = r.fork(first + i);
+      size_t x = rr.ith_rand(0) % total;
+      // The center is the last vertex whose first wedge is at most x.
+      uintE v = std::upper_bound(wedges.begin(), wedges.end(), x) -
+                wedges.begin() - 1;
+      auto vtx = G.get_vertex(v);
+      uintE d = vtx.getOutDegree();
+      uintE a = rr.ith_rand(1) % d;
+      uintE b = rr.ith_rand(2) % (d - 1);
+      if (b >= a) b++;
+      uintE u = vtx.getOutNeighbor(a), w = vtx.getOutNeighbor(b);
+      if (G.get_vertex(u).getOutDegree() > G.get_vertex(w).getOutDegree()) {
+        std::swap(u, w);
+      }
+      out[i] = approx_triangle::has_edge(G, u, w) ? 1.0 : 0.0;
+    });
+  };
+  return approx_triangle::estimate_mean(draw, total / 3.0, params);
+}
+
+// Estimates the number of triangles by edge sampling: an edge (u, v) is drawn
+// uniformly at random and the triangles containing it are counted with the
+// graph's intersection routine. Each triangle contains three edges, so
+//   T = (#edges / 3) * E[|N(u) \cap N(v)|].
+// Requires an uncompressed symmetric graph.
+template <class Graph>
+inline count_estimate EdgeSampling(Graph& G, const sampling_params& params) {
+  size_t n = G.n;
+  auto offsets = sequence<size_t>(n, [&](size_t v) {
+    return (size_t)G.get_vertex(v).getOutDegree(); });
+  size_t total = pbbslib::scan_add_inplace(offsets);
+  if (total == 0) return count_estimate();
+  auto r = pbbs::random(params.seed);
+  auto draw = [&](size_t first, size_t num, double* out) {
+    parallel_for(0, num, [&](size_t i) {
+      size_t x = r.ith_rand(first + i) % total;
+      uintE u = std::upper_bound(offsets.begin(), offsets.end(), x) -
+                offsets.begin() - 1;
+      auto u_vtx = G.get_vertex(u);
+      uintE v = u_vtx.getOutNeighbor(x - offsets[u]);
+      auto v_vtx = G.get_vertex(v);
+      out[i] = u_vtx.intersect(&v_vtx, u, v);
+    });
+  };
+  // total counts both directions of every edge.
+  return approx_triangle::estimate_mean(draw, (total / 2) / 3.0, params);
+}
+
+// DOULION: keeps every edge independently with probability p, counts the
+// triangles of the sparsified graph exactly and scales the count by 1 / p^3.
+// The sparsification is fused with the degree orientation, so each trial
+// builds a single filtered graph and reuses CountDirectedBalanced. Trials use
+// independent coins, and the variance is estimated from their spread (at
+// least two trials are always run). Works for compressed graphs as well.
+// Requires 0 < p <= 1.
+template <class Graph>
+inline count_estimate Doulion(Graph& G, double p, const sampling_params& params) {
+  using W = typename Graph::weight_type;
+  assert(p > 0 && p <= 1);
+  uintE* rank = rankNodes(G, G.n);
+  auto counts = sequence<size_t>(G.n);
+  auto threshold = (uint64_t)(p * std::ldexp(1.0, 63)) << 1;
+  auto draw = [&](size_t first, size_t num, double* out) {
+    for (size_t i = 0; i < num; i++) {
+      auto r = pbbs::random(params.seed).fork(first + i);
+      auto pack_predicate = [&](const uintE& u, const uintE& v, const W& wgh) {
+        if (rank[u] >= rank[v]) return false;
+        if (p == 1.0) return true;
+        // The same coin for both directions of the edge.
+        return r.ith_rand(((uint64_t)std::min(u, v) << 32) + std::max(u, v)) <
+               threshold;
+      };
+      auto DG = filterGraph(G, pack_predicate);
+      par_for(0, G.n, pbbslib::kSequentialForThreshold, [&] (size_t j)
+                      { counts[j] = 0; });
+      auto f = [&](uintE u, uintE v, uintE w) {};
+      out[i] = CountDirectedBalanced(DG, counts.begin(), f);
+      DG.del();
+    }
+  };
+  auto e = approx_triangle::estimate_mean(draw, 1.0 / (p * p * p), params);
+  pbbslib::free_array(rank);
+  return e;
+}
+
+}  // namespace gbbs
@@ -30,11 +30,68 @@
 //     -m : indicate that the graph should be mmap'd
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
+//     -approx : estimate the count instead, using one of
+//               wedge, edge (uncompressed graphs only) or doulion
+//     -samples : the initial number of samples (trials for doulion)
+//     -max_samples : the maximum number of samples
+//     -err : stop sampling once the 95% confidence interval is within
+//            this fraction of the estimate
+//     -budget : stop sampling after this many seconds
+//     -p : the edge sampling probability for doulion, in (0, 1]
+//     -seed : the seed of the random samples (default 0)
 
+#include "ApproxTriangle.h"
 #include "Triangle.h"
 
 namespace gbbs {
 
+template <class Graph>
+double ApproxTriangle_runner(Graph& G, const std::string& approx, commandLine& P) {
+  sampling_params params;
+  params.min_samples = P.getOptionLongValue("-samples", (approx == "doulion") ? 2 : 100000);
+  params.max_samples = P.getOptionLongValue("-max_samples", params.max_samples);
+  params.relative_error = P.getOptionDoubleValue("-err", 0.0);
+  params.time_budget = P.getOptionDoubleValue("-budget", 0.0);
+  params.seed = P.getOptionLongValue("-seed", 0);
+  if (params.relative_error == 0 && params.time_budget == 0) {
+    params.max_samples = params.min_samples;
+  }
+  std::cout << "### Approximation: " << approx << " -samples = "
+            << params.min_samples << " -err = " << params.relative_error
+            << " -budget = " << params.time_budget << std::endl;
+
+  using vertex = typename Graph::vertex;
+  using W = typename Graph::weight_type;
+  constexpr bool uncompressed = std::is_same<vertex, symmetric_vertex<W>>::value;
+  count_estimate e;
+  timer t; t.start();
+  if (approx == "doulion") {
+    double p = P.getOptionDoubleValue("-p", 0.1);
+    if (!(p > 0 && p <= 1)) {
+      std::cerr << "-p must be in (0, 1], got " << p << '\n';
+      exit(1);
+    }
+    e = Doulion(G, p, params);
+  } else if constexpr (uncompressed) {
+    if (approx == "wedge") {
+      e = WedgeSampling(G, params);
+    } else if (approx == "edge") {
+      e = EdgeSampling(G, params);
+    } else {
+      std::cerr << "Unexpected estimator: " << approx << '\n';
+      exit(1);
+    }
+  } else {
+    std::cerr << "Only -approx doulion supports compressed graphs" << '\n';
+    exit(1);
+  }
+  double tt = t.stop();
+  std::cout << "### Estimated triangles = " << e << "\n";
+  std::cout << "### Relative error (95%) = " << e.relative_error() << "\n";
+  std::cout << "### Running Time: " << tt << std::endl;
+  return tt;
+}
+
 template <class Graph>
 double Triangle_runner(Graph& G, commandLine P) {
   auto ordering = P.getOptionValue("-ordering", "degree");
@@ -46,6 +103,10 @@ double Triangle_runner(Graph& G, commandLine P) {
   std::cout << "### Params: ordering=" << ordering << std::endl;
   std::cout << "### ------------------------------------" << std::endl;
   assert(P.getOption("-s"));
+  auto approx = P.getOptionValue("-approx", "");
+  if (!approx.empty()) {
+    return ApproxTriangle_runner(G, approx, P);
+  }
   size_t count = 0;
   auto f = [&] (uintE u, uintE v, uintE w) { };
   timer t; t.start();
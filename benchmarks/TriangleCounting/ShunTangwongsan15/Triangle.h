@@ -88,6 +88,43 @@ inline size_t CountDirected(Graph& DG, size_t* counts,
   return count;
 }
 
+// Splits the vertices of the directed graph DG into blocks of roughly equal
+// intersection work, where the work of vertex u is the sum of the out-degrees
+// of its out-neighbors, and runs block_f(start, end) on each block of vertex
+// ids in parallel.
+template <class Graph, class B>
+inline void ParallelForBalanced(Graph& DG, const B& block_f) {
+  using W = typename Graph::weight_type;
+  size_t n = DG.n;
+
+  auto parallel_work = sequence<size_t>(n);
+  {
+    auto map_f = [&](uintE u, uintE v, W wgh) -> size_t {
+      return DG.get_vertex(v).getOutDegree();
+    };
+    par_for(0, n, [&] (size_t i) {
+      auto monoid = pbbslib::addm<size_t>();
+      parallel_work[i] = DG.get_vertex(i).template reduceOutNgh<size_t>(i, map_f, monoid);
+    });
+  }
+  size_t total_work = pbbslib::scan_add_inplace(parallel_work.slice());
+
+  size_t block_size = 50000;
+  size_t n_blocks = total_work/block_size + 1;
+  size_t work_per_block = (total_work + n_blocks - 1) / n_blocks;
+  debug(std::cout << "Total work = " << total_work << " nblocks = " << n_blocks
+            << " work per block = " << work_per_block << "\n";);
+
+  par_for(0, n_blocks, 1, [&] (size_t i) {
+    size_t start = i * work_per_block;
+    size_t end = (i + 1) * work_per_block;
+    auto less_fn = std::less<size_t>();
+    size_t start_ind = pbbslib::binary_search(parallel_work, start, less_fn);
+    size_t end_ind = pbbslib::binary_search(parallel_work, end, less_fn);
+    block_f(start_ind, end_ind);
+  });
+}
+
 // Returns the number of directed triangles in the input graph of the following
 // orientation:
 //        w
@@ -107,25 +144,6 @@ inline size_t CountDirectedBalanced(Graph& DG, size_t* counts,
   using W = typename Graph::weight_type;
   debug(std::cout << "Starting counting"
             << "\n";);
-  size_t n = DG.n;
-
-  auto parallel_work = sequence<size_t>(n);
-  {
-    auto map_f = [&](uintE u, uintE v, W wgh) -> size_t {
-      return DG.get_vertex(v).getOutDegree();
-    };
-    par_for(0, n, [&] (size_t i) {
-      auto monoid = pbbslib::addm<size_t>();
-      parallel_work[i] = DG.get_vertex(i).template reduceOutNgh<size_t>(i, map_f, monoid);
-    });
-  }
-  size_t total_work = pbbslib::scan_add_inplace(parallel_work.slice());
-
-  size_t block_size = 50000;
-  size_t n_blocks = total_work/block_size + 1;
-  size_t work_per_block = (total_work + n_blocks - 1) / n_blocks;
-  std::cout << "Total work = " << total_work << " nblocks = " << n_blocks
-            << " work per block = " << work_per_block << "\n";
 
   auto run_intersection = [&](size_t start_ind, size_t end_ind) {
     for (size_t i = start_ind; i < end_ind; i++) {  // check LEQ
@@ -139,15 +157,7 @@ inline size_t CountDirectedBalanced(Graph& DG, size_t* counts,
       counts[i] = total_ct;
     }
   };
-
-  par_for(0, n_blocks, 1, [&] (size_t i) {
-    size_t start = i * work_per_block;
-    size_t end = (i + 1) * work_per_block;
-    auto less_fn = std::less<size_t>();
-    size_t start_ind = pbbslib::binary_search(parallel_work, start, less_fn);
-    size_t end_ind = pbbslib::binary_search(parallel_work, end, less_fn);
-    run_intersection(start_ind, end_ind);
-  });
+  ParallelForBalanced(DG, run_intersection);
 
   auto count_seq = pbbslib::make_sequence<size_t>(counts, DG.n);
   size_t count = pbbslib::reduce_add(count_seq);
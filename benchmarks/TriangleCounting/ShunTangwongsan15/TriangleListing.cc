@@ -0,0 +1,98 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures the throughput of listing triangles through a streaming sink.
+// Usage:
+// numactl -i all ./TriangleListing -rounds 2 -s -c -m clueweb_sym.bytepda
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the algorithm
+//     -batch : the number of triangles passed to the sink per call
+//     -support : also compute the per-edge triangle counts (uncompressed
+//                graphs only)
+
+#include "TriangleListing.h"
+
+namespace gbbs {
+
+template <class Graph>
+double TriangleListing_runner(Graph& G, commandLine P) {
+  size_t batch_size = P.getOptionLongValue("-batch", 4096);
+  bool support = P.getOption("-support");
+  std::cout << "### Application: Triangle Listing" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << G.n << std::endl;
+  std::cout << "### m: " << G.m << std::endl;
+  std::cout << "### Params: -batch = " << batch_size << " -support = "
+            << support << std::endl;
+  std::cout << "### ------------------------------------" << std::endl;
+  assert(P.getOption("-s"));
+
+  // A sink that consumes every triangle: per-worker checksums, padded to
+  // avoid false sharing.
+  constexpr size_t kStride = 8;
+  auto sums = sequence<size_t>(num_workers() * kStride, (size_t)0);
+  auto batches = sequence<size_t>(num_workers() * kStride, (size_t)0);
+  auto sink = [&](size_t worker, const triangle* tris, size_t num) {
+    size_t sum = 0;
+    for (size_t i = 0; i < num; i++) {
+      auto [u, v, w] = tris[i];
+      sum += (size_t)u ^ ((size_t)v << 20) ^ ((size_t)w << 40);
+    }
+    sums[worker * kStride] += sum;
+    batches[worker * kStride]++;
+  };
+
+  timer t; t.start();
+  size_t count = ListTriangles(G, sink, batch_size);
+  double tt = t.stop();
+  size_t checksum = pbbslib::reduce_add(sums);
+  std::cout << "### Num triangles = " << count << "\n";
+  std::cout << "### Batches = " << pbbslib::reduce_add(batches)
+            << " checksum = " << checksum << "\n";
+  std::cout << "### Triangles per second = " << (count / tt) << "\n";
+
+  using vertex = typename Graph::vertex;
+  using W = typename Graph::weight_type;
+  if constexpr (std::is_same<vertex, symmetric_vertex<W>>::value) {
+    if (support) {
+      timer st; st.start();
+      auto supports = TriangleEdgeSupport(G);
+      st.stop(); st.reportTotal("edge support time");
+      std::cout << "### Sum of edge supports / 6 = "
+                << (pbbslib::reduce_add(supports) / 6) << "\n";
+    }
+  }
+
+  std::cout << "### Running Time: " << tt << std::endl;
+  return tt;
+}
+
+}  // namespace gbbs
+
+generate_symmetric_main(gbbs::TriangleListing_runner, false);
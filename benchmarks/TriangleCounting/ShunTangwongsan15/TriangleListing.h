@@ -0,0 +1,182 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include <tuple>
+#include <vector>
+
+#include "Triangle.h"
+
+namespace gbbs {
+
+using triangle = std::tuple<uintE, uintE, uintE>;
+
+// Lists every triangle of G exactly once, streaming them to a consumer in
+// batches instead of materializing all triangles.
+//
+// Arguments:
+//   G
+//     Symmetric graph (compressed or uncompressed).
+//   sink: (size_t worker, const triangle* tris, size_t num) -> void
+//     Called concurrently from the workers with a batch of at most
+//     `batch_size` triangles. A batch is only valid during the call. The
+//     worker id is in [0, num_workers()) and no two calls with the same id
+//     run at the same time, so the sink can keep per-worker state (e.g.,
+//     output buffers) indexed by it without synchronization. The sink should
+//     not run parallel code.
+//   batch_size
+//     Maximum number of triangles per call to `sink`.
+//
+// Each triangle is reported as (u, v, w) where u, v, w are ordered by
+// increasing rank in the degree ordering used for counting.
+//
+// Returns:
+//   The number of triangles in `G`.
+template <class Graph, class Sink>
+inline size_t ListTriangles(Graph& G, Sink& sink, size_t batch_size = 4096) {
+  using W = typename Graph::weight_type;
+  timer gt; gt.start();
+  uintE* rank = rankNodes(G, G.n);
+  auto pack_predicate = [&](const uintE& u, const uintE& v, const W& wgh) {
+    return rank[u] < rank[v];
+  };
+  auto DG = filterGraph(G, pack_predicate);
+  gt.stop(); gt.reportTotal("build graph time");
+
+  timer lt; lt.start();
+  auto counts = sequence<size_t>(DG.n, (size_t)0);
+  // Each block has its own batch and flushes it before finishing. Blocks run
+  // sequentially, so a worker never interleaves two batches.
+  auto list_block = [&](size_t start_ind, size_t end_ind) {
+    std::vector<triangle> batch;
+    batch.reserve(batch_size);
+    auto f = [&](uintE u, uintE v, uintE w) {
+      batch.emplace_back(u, v, w);
+      if (batch.size() == batch_size) {
+        sink((size_t)worker_id(), batch.data(), batch.size());
+        batch.clear();
+      }
+    };
+    for (size_t i = start_ind; i < end_ind; i++) {
+      auto vtx = DG.get_vertex(i);
+      size_t total_ct = 0;
+      auto map_f = [&](uintE u, uintE v, W wgh) {
+        auto v_vtx = DG.get_vertex(v);
+        total_ct += vtx.intersect_f(&v_vtx, u, v, f);
+      };
+      vtx.mapOutNgh(i, map_f, false);
+      counts[i] = total_ct;
+    }
+    if (batch.size() > 0) {
+      sink((size_t)worker_id(), batch.data(), batch.size());
+    }
+  };
+  ParallelForBalanced(DG, list_block);
+  size_t count = pbbslib::reduce_add(counts);
+  lt.stop(); lt.reportTotal("list time");
+
+  DG.del();
+  pbbslib::free_array(rank);
+  return count;
+}
+
+// Returns the number of triangles containing each edge of an uncompressed
+// symmetric graph, aligned with the graph's CSR: the support of the edge to
+// the j-th neighbor of u is at G.v_data[u].offset + j. Both directions of an
+// edge hold the same value.
+//
+// Triangles are counted once on the degree-oriented graph (whose out-lists
+// carry the CSR slot of each edge) with an atomic add per edge, and the
+// support of each in-edge slot is then copied from its twin slot, found by
+// binary search in the neighbor's list.
+template <class Graph>
+inline sequence<size_t> TriangleEdgeSupport(Graph& G) {
+  using W = typename Graph::weight_type;
+  size_t n = G.n;
+  uintE* rank = rankNodes(G, n);
+  auto is_out = [&](uintE u, uintE v) { return rank[u] < rank[v]; };
+  auto slot = [&](uintE u, size_t j) { return G.v_data[u].offset + j; };
+
+  // Degree-oriented out-lists, with the CSR slot of each out-edge.
+  auto out_offsets = sequence<size_t>(n + 1, [&](size_t u) -> size_t {
+    if (u == n) return 0;
+    auto nghs = G.get_vertex(u).getOutNeighbors();
+    size_t d = 0;
+    for (uintE j = 0; j < G.get_vertex(u).getOutDegree(); j++) {
+      d += is_out(u, std::get<0>(nghs[j]));
+    }
+    return d;
+  });
+  size_t n_out = pbbslib::scan_add_inplace(out_offsets);
+  auto out_nghs = sequence<uintE>::no_init(n_out);
+  auto out_slots = sequence<size_t>::no_init(n_out);
+  par_for(0, n, 1, [&](size_t u) {
+    auto nghs = G.get_vertex(u).getOutNeighbors();
+    size_t k = out_offsets[u];
+    for (uintE j = 0; j < G.get_vertex(u).getOutDegree(); j++) {
+      uintE v = std::get<0>(nghs[j]);
+      if (is_out(u, v)) {
+        out_nghs[k] = v;
+        out_slots[k++] = slot(u, j);
+      }
+    }
+  });
+
+  auto support = sequence<size_t>(G.m, (size_t)0);
+  par_for(0, n, 1, [&](size_t u) {
+    for (size_t p = out_offsets[u]; p < out_offsets[u + 1]; p++) {
+      uintE v = out_nghs[p];
+      size_t i = out_offsets[u], j = out_offsets[v];
+      while (i < out_offsets[u + 1] && j < out_offsets[v + 1]) {
+        if (out_nghs[i] == out_nghs[j]) {
+          pbbslib::write_add(&support[out_slots[p]], (size_t)1);
+          pbbslib::write_add(&support[out_slots[i]], (size_t)1);
+          pbbslib::write_add(&support[out_slots[j]], (size_t)1);
+          i++; j++;
+        } else if (out_nghs[i] < out_nghs[j]) {
+          i++;
+        } else {
+          j++;
+        }
+      }
+    }
+  });
+
+  // Copy the support of each out-edge (v, u) to the slot of (u, v).
+  par_for(0, n, 1, [&](size_t u) {
+    auto nghs = G.get_vertex(u).getOutNeighbors();
+    for (uintE j = 0; j < G.get_vertex(u).getOutDegree(); j++) {
+      uintE v = std::get<0>(nghs[j]);
+      if (is_out(u, v)) continue;
+      auto v_nghs = G.get_vertex(v).getOutNeighbors();
+      size_t i = std::lower_bound(v_nghs, v_nghs + G.get_vertex(v).getOutDegree(),
+          (uintE)u, [&](const std::tuple<uintE, W>& e, uintE x) {
+            return std::get<0>(e) < x; }) - v_nghs;
+      support[slot(u, j)] = support[slot(v, i)];
+    }
+  });
+  pbbslib::free_array(rank);
+  return support;
+}
+
+}  // namespace gbbs
@@ -0,0 +1,90 @@
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/ApproxTriangle.h"
+
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+template <class Graph>
+size_t ExactCount(Graph& G) {
+  auto f = [&](uintE u, uintE v, uintE w) {};
+  return Triangle_degree_ordering(G, f);
+}
+
+}  // namespace
+
+TEST(ApproxTriangle, DoulionWithAllEdgesIsExact) {
+  constexpr uintE kNumVertices{100};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(
+      kNumVertices, graph_test::PseudorandomEdges(kNumVertices, 1500, 1))};
+  size_t exact = ExactCount(graph);
+  ASSERT_GT(exact, 0);
+
+  sampling_params params;
+  params.min_samples = 2;
+  params.max_samples = 2;
+  auto e = Doulion(graph, 1.0, params);
+  EXPECT_EQ(e.estimate, exact);
+  EXPECT_EQ(e.variance, 0);
+  EXPECT_EQ(e.samples, 2);
+}
+
+TEST(ApproxTriangle, EstimatesAreWithinConfidenceInterval) {
+  constexpr uintE kNumVertices{200};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(
+      kNumVertices, graph_test::PseudorandomEdges(kNumVertices, 4000, 7))};
+  double exact = ExactCount(graph);
+  ASSERT_GT(exact, 0);
+
+  sampling_params params;
+  params.seed = 11;
+  params.min_samples = 20000;
+  params.max_samples = 20000;
+  auto wedge = WedgeSampling(graph, params);
+  auto edge = EdgeSampling(graph, params);
+  params.min_samples = 10;
+  params.max_samples = 10;
+  auto doulion = Doulion(graph, 0.5, params);
+
+  for (const auto& e : {wedge, edge, doulion}) {
+    EXPECT_GT(e.variance, 0);
+    EXPECT_LE(std::abs(e.estimate - exact), e.half_width())
+        << "estimate = " << e << ", exact = " << exact;
+  }
+}
+
+TEST(ApproxTriangle, TooFewMaxSamplesStillDrawsTwo) {
+  constexpr uintE kNumVertices{50};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(
+      kNumVertices, graph_test::PseudorandomEdges(kNumVertices, 400, 3))};
+
+  for (size_t max_samples : {0, 1}) {
+    sampling_params params;
+    params.min_samples = 1;
+    params.max_samples = max_samples;
+    auto e = WedgeSampling(graph, params);
+    EXPECT_EQ(e.samples, 2);
+    EXPECT_TRUE(std::isfinite(e.estimate));
+    EXPECT_TRUE(std::isfinite(e.variance));
+  }
+}
+
+TEST(ApproxTriangle, TimeBudgetStopsSampling) {
+  constexpr uintE kNumVertices{50};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(
+      kNumVertices, graph_test::PseudorandomEdges(kNumVertices, 400, 5))};
+
+  sampling_params params;
+  params.min_samples = 2;
+  params.time_budget = 0.05;
+  auto e = WedgeSampling(graph, params);
+  EXPECT_GE(e.samples, 2);
+  EXPECT_LT(e.samples, params.max_samples);
+}
+
+}  // namespace gbbs
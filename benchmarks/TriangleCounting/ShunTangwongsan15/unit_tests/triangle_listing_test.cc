@@ -0,0 +1,66 @@
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/TriangleListing.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+TEST(TriangleListing, MatchesBruteForce) {
+  constexpr uintE kNumVertices{150};
+  auto edges = graph_test::PseudorandomEdges(kNumVertices, 2000, 3);
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  std::vector<std::vector<bool>> adj(kNumVertices,
+                                     std::vector<bool>(kNumVertices, false));
+  for (const auto& e : edges) {
+    adj[e.endpoints().first][e.endpoints().second] = true;
+    adj[e.endpoints().second][e.endpoints().first] = true;
+  }
+  std::vector<triangle> expected;
+  for (uintE u = 0; u < kNumVertices; u++) {
+    for (uintE v = u + 1; v < kNumVertices; v++) {
+      for (uintE w = v + 1; w < kNumVertices; w++) {
+        if (adj[u][v] && adj[u][w] && adj[v][w]) expected.emplace_back(u, v, w);
+      }
+    }
+  }
+  ASSERT_GT(expected.size(), 0);
+
+  // Small batches, so that blocks flush several times.
+  std::mutex mutex;
+  std::vector<triangle> listed;
+  size_t max_batch = 0;
+  auto sink = [&] (size_t worker, const triangle* tris, size_t num) {
+    EXPECT_LT(worker, num_workers());
+    std::lock_guard<std::mutex> lock(mutex);
+    max_batch = std::max(max_batch, num);
+    for (size_t i = 0; i < num; i++) {
+      uintE t[3] = {std::get<0>(tris[i]), std::get<1>(tris[i]), std::get<2>(tris[i])};
+      std::sort(t, t + 3);
+      listed.emplace_back(t[0], t[1], t[2]);
+    }
+  };
+  size_t count = ListTriangles(graph, sink, 7);
+  EXPECT_EQ(count, expected.size());
+  EXPECT_LE(max_batch, 7);
+  std::sort(listed.begin(), listed.end());
+  EXPECT_EQ(listed, expected);
+
+  auto support = TriangleEdgeSupport(graph);
+  for (uintE u = 0; u < kNumVertices; u++) {
+    auto vtx = graph.get_vertex(u);
+    for (uintE j = 0; j < vtx.getOutDegree(); j++) {
+      uintE v = std::get<0>(vtx.getOutNeighbors()[j]);
+      size_t s = 0;
+      for (uintE w = 0; w < kNumVertices; w++) s += adj[u][w] && adj[v][w];
+      EXPECT_EQ(support[graph.v_data[u].offset + j], s);
+    }
+  }
+}
+
+}  // namespace gbbs
@@ -26,6 +26,7 @@ namespace gbbs {
   using pbbs::parallel_for_alloc;
   using pbbs::num_workers;
   using pbbs::worker_id;
+  using pbbs::run_root;
 
   template <typename F>
   static void par_for(size_t start, size_t end, size_t granularity, F f, bool parallel=true) {
@@ -86,6 +87,7 @@ namespace pbbslib {
   using pbbs::parallel_for_alloc;
   using pbbs::num_workers;
   using pbbs::worker_id;
+  using pbbs::run_root;
 
   using pbbs::free_array;
   using pbbs::delete_array;
@@ -35,12 +35,20 @@
 // This also means that the current code could be optimized to run much faster
 // in a case where many buckets will be processed; please contact us if you have
 // such a use-case.
+//
+// The structure keeps a bitmap of the non-empty materialized buckets, so that
+// next_bucket() jumps directly to the next non-empty bucket, and when the
+// materialized range runs out, unpacking moves directly to the next range
+// containing an identifier instead of stepping through empty ranges. The
+// scratch space used by update_buckets is kept across calls.
 #pragma once
 
 #include <limits>
 #include <tuple>
 #include <cassert>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "vertex_subset.h"
 #include "bridge.h"
@@ -55,7 +63,10 @@ namespace gbbs {
 enum bucket_order { decreasing, increasing };
 
 // Maintains a dynamic mapping from a set of ident_t's to a set of buckets with
-// integer type bucket_t.
+// integer type bucket_t. D is the type of the map from identifiers to buckets,
+// which is read whenever a bucket is extracted. It is a reference type when
+// the caller owns the map (make_vertex_buckets), and a view such as a slice or
+// a delayed sequence held by value otherwise (make_buckets).
 template <class D, class ident_t, class bucket_t>
 struct buckets {
  public:
@@ -96,6 +107,7 @@ struct buckets {
         allocated(true) {
     // Initialize array consisting of the materialized buckets.
     bkts = pbbslib::new_array<id_dyn_arr>(total_buckets);
+    nonempty = sequence<uint64_t>((open_buckets + 63) / 64, (uint64_t)0);
 
     // Set the current range being processed based on the order.
     if (order == increasing) {
@@ -130,14 +142,33 @@ struct buckets {
   // Returns the next non-empty bucket from the bucket structure. The return
   // value's bkt_id is null_bkt when no further buckets remain.
   inline bucket next_bucket() {
-    while (!curBucketNonEmpty() && num_elms > 0) {
-      _next_bucket();
+    while (num_elms > 0) {
+      size_t b = next_nonempty(cur_bkt);
+      if (b < open_buckets) {
+        cur_bkt = b;
+        return get_cur_bucket();
+      }
+      unpack();
+      cur_bkt = 0;
     }
-    if (num_elms == 0) {
-      size_t bkt_num = null_bkt;  // no buckets remain
-      return bucket(bkt_num, sequence<ident_t>());
+    size_t bkt_num = null_bkt;  // no buckets remain
+    return bucket(bkt_num, sequence<ident_t>());
+  }
+
+  // Returns the ids and sizes of up to k of the next non-empty buckets in
+  // the materialized range, in the order they will be returned by
+  // next_bucket(), without removing them. Fewer than k buckets are returned
+  // if the materialized range holds fewer non-empty buckets. Since buckets
+  // are filtered lazily, a size is an upper bound on the number of
+  // identifiers that next_bucket() returns for that bucket.
+  std::vector<std::pair<bucket_id, size_t>> peek_buckets(size_t k) {
+    std::vector<std::pair<bucket_id, size_t>> ret;
+    size_t b = next_nonempty(cur_bkt);
+    while (ret.size() < k && b < open_buckets) {
+      ret.emplace_back(get_bucket_num(b), bkts[b].size);
+      b = next_nonempty(b + 1);
     }
-    return get_cur_bucket();
+    return ret;
   }
 
   // Computes a bucket_dest for an identifier moving from bucket_id prev to
@@ -179,6 +210,9 @@ struct buckets {
         bkts[i].clear();
       }
       pbbslib::free_array(bkts);
+      hists.clear();
+      outs.clear();
+      nonempty.clear();
       allocated = false;
     }
   }
@@ -199,59 +233,62 @@ struct buckets {
     num_blocks = 1 << block_bits;
     size_t block_size = (k + num_blocks - 1) / num_blocks;
 
-    bucket_id* hists = pbbslib::new_array_no_init<bucket_id>((num_blocks + 1) *
-                                                  total_buckets * CACHE_LINE_S);
-//    bucket_id* outs =
-//        pbbslib::new_array_no_init<bucket_id>((num_blocks + 1) * total_buckets);
+    // Each block owns a row of per-bucket counters, padded to a multiple of
+    // a cache line to avoid false sharing between blocks.
+    constexpr size_t line = CACHE_LINE_S / sizeof(bucket_id);
+    size_t stride = ((total_buckets + line - 1) / line) * line;
+    if (hists.size() < num_blocks * stride) {
+      hists = sequence<bucket_id>::no_init(num_blocks * stride);
+    }
+    size_t last_ind = (num_blocks * total_buckets);
+    if (outs.size() < last_ind + 1) {
+      outs = sequence<bucket_id>::no_init(last_ind + 1);
+    }
 
     // 1. Compute per-block histograms
     par_for(0, num_blocks, 1, [&] (size_t i) {
       size_t s = i * block_size;
       size_t e = std::min(s + block_size, k);
-      bucket_id* hist = &(hists[i * total_buckets]);
+      bucket_id* hist = &(hists[i * stride]);
 
       for (size_t j = 0; j < total_buckets; j++) {
         hist[j] = 0;
       }
       for (size_t j = s; j < e; j++) {
         auto m = f(j);
-        bucket_id b = std::get<1>(*m);
-        if (m.has_value() && b != null_bkt) {
-          hist[b]++;
+        if (m.has_value() && std::get<1>(*m) != null_bkt) {
+          hist[std::get<1>(*m)]++;
         }
       }
     });
 
-    // 2. Aggregate histograms into a single histogram.
-    auto get = [&](size_t i) {
+    // 2. Aggregate histograms into a single histogram, ordered by bucket and
+    // then by block.
+    parallel_for(0, last_ind, [&] (size_t i) {
       size_t col = i % num_blocks;
       size_t row = i / num_blocks;
-      return hists[col * total_buckets + row];
-    };
-
-    size_t last_ind = (num_blocks * total_buckets);
-    auto outs = sequence<bucket_id>(last_ind + 1);
-    parallel_for(0, last_ind, [&] (size_t i) {
-      outs[i] = get(i);
+      outs[i] = hists[col * stride + row];
     });
     outs[last_ind] = 0;
 
-    pbbslib::scan_inplace(outs.slice(), pbbslib::addm<bucket_id>());
-//    outs[num_blocks * total_buckets] = sum;
+    pbbslib::scan_inplace(outs.slice(0, last_ind + 1),
+                          pbbslib::addm<bucket_id>());
 
     // 3. Resize buckets based on the summed histogram.
     for (size_t i = 0; i < total_buckets; i++) {
       size_t num_inc = outs[(i + 1) * num_blocks] - outs[i * num_blocks];
-      bkts[i].resize(num_inc);
+      if (num_inc > 0) {
+        bkts[i].resize(num_inc);
+        mark_nonempty(i);
+      }
       num_elms += num_inc;
     }
 
-    // 4. Compute the starting offsets for each block.
-    par_for(0, total_buckets, 1, [&] (size_t i) {
-      size_t start = outs[i * num_blocks];
-      for (size_t j = 0; j < num_blocks; j++) {
-        hists[(i * num_blocks + j) * CACHE_LINE_S] =
-            outs[i * num_blocks + j] - start;
+    // 4. Compute the starting offset of each block within each bucket.
+    par_for(0, num_blocks, 1, [&] (size_t j) {
+      bucket_id* hist = &(hists[j * stride]);
+      for (size_t i = 0; i < total_buckets; i++) {
+        hist[i] = outs[i * num_blocks + j] - outs[i * num_blocks];
       }
     });
 
@@ -260,15 +297,13 @@ struct buckets {
     par_for(0, num_blocks, 1, [&] (size_t i) {
       size_t s = i * block_size;
       size_t e = std::min(s + block_size, k);
-      // our buckets are now spread out, across outs
+      bucket_id* hist = &(hists[i * stride]);
       for (size_t j = s; j < e; j++) {
         auto m = f(j);
-        ident_t v = std::get<0>(*m);
-        bucket_id b = std::get<1>(*m);
-        if (m.has_value() && b != null_bkt) {
-          size_t ind = hists[(b * num_blocks + i) * CACHE_LINE_S];
-          bkts[b].insert(v, ind);
-          hists[(b * num_blocks + i) * CACHE_LINE_S]++;
+        if (m.has_value() && std::get<1>(*m) != null_bkt) {
+          bucket_id b = std::get<1>(*m);
+          bkts[b].insert(std::get<0>(*m), hist[b]);
+          hist[b]++;
         }
       }
     });
@@ -280,14 +315,12 @@ struct buckets {
       m += num_inc;
     }
 
-    pbbslib::free_array(hists);
-    // pbbslib::free_array(outs);
     return num_elms - ne_before;
   }
 
  private:
   size_t n;  // total number of identifiers in the system
-  D& d;
+  D d;
   const bucket_order order;
   size_t open_buckets;
   size_t total_buckets;
@@ -299,15 +332,45 @@ struct buckets {
   size_t cur_range;
   id_dyn_arr* bkts;
 
+  // Scratch space for update_buckets, kept across calls.
+  sequence<bucket_id> hists;
+  sequence<bucket_id> outs;
+  // Bit i is set iff the i'th materialized bucket is non-empty.
+  sequence<uint64_t> nonempty;
+
+  inline void mark_nonempty(size_t b) {
+    if (b < open_buckets) nonempty[b / 64] |= ((uint64_t)1 << (b % 64));
+  }
+
+  inline void mark_empty(size_t b) {
+    nonempty[b / 64] &= ~((uint64_t)1 << (b % 64));
+  }
+
+  // Returns the first non-empty materialized bucket >= b, or open_buckets if
+  // there is none.
+  inline size_t next_nonempty(size_t b) const {
+    size_t words = nonempty.size();
+    size_t w = b / 64;
+    if (w >= words) return open_buckets;
+    uint64_t bits = nonempty[w] & (~(uint64_t)0 << (b % 64));
+    while (bits == 0) {
+      if (++w == words) return open_buckets;
+      bits = nonempty[w];
+    }
+    return std::min(open_buckets, w * 64 + __builtin_ctzll(bits));
+  }
+
   template <class F>
   inline size_t update_buckets_seq(F& f, size_t k) {
     size_t ne_before = num_elms;
     for (size_t i = 0; i < k; i++) {
       auto m = f(i);
+      if (!m.has_value()) continue;
       bucket_id bkt = std::get<1>(*m);
-      if (m.has_value() && bkt != null_bkt) {
+      if (bkt != null_bkt) {
         bkts[bkt].resize(1);
         insert_in_bucket(bkt, std::get<0>(*m));
+        mark_nonempty(bkt);
         num_elms++;
       }
     }
@@ -321,27 +384,16 @@ struct buckets {
     bkts[bkt].size++;
   }
 
-  inline bool curBucketNonEmpty() { return bkts[cur_bkt].size > 0; }
-
+  // Redistributes the identifiers in the overflow bucket, moving directly
+  // to the next range that contains a live identifier.
   inline void unpack() {
     size_t m = bkts[open_buckets].size;
     auto tmp = sequence<ident_t>(m);
     ident_t* A = bkts[open_buckets].A;
     par_for(0, m, pbbslib::kSequentialForThreshold, [&] (size_t i)
                     { tmp[i] = A[i]; });
-    if (order == increasing) {
-      cur_range++;  // increment range
-    } else {
-      cur_range--;
-    }
     bkts[open_buckets].size = 0;  // reset size
 
-    auto g = [&](ident_t i) -> std::optional<std::tuple<ident_t, bucket_id> > {
-      ident_t v = tmp[i];
-      bucket_id bkt = to_range(d[v]);
-      return std::optional<std::tuple<ident_t, bucket_id> >(std::make_tuple(v, bkt));
-    };
-
     if (m != num_elms) {
       std::cout << "m = " << m << " num_elms = " << num_elms << "\n";
       cur_bkt = 0;
@@ -350,29 +402,36 @@ struct buckets {
                 << "\n";
       assert(m == num_elms);  // corrruption in bucket structure.
     }
-    size_t updated = update_buckets(g, m);
-    size_t num_in_range = updated - bkts[open_buckets].size;
-    //none in range
-    if(num_in_range == 0 && bkts[open_buckets].size > 0) {
-      auto imap = pbbslib::make_sequence<bucket_t>(bkts[open_buckets].size, [&] (size_t j) { return (size_t)d[bkts[open_buckets].A[j]]; });
-      if(order == increasing) {
-        size_t minBkt = pbbs::reduce(imap, pbbs::minm<size_t>());
-        cur_range = minBkt/open_buckets-1; //will be incremented in next unpack() call
-      }
-      else if(order == decreasing) {
-        size_t minBkt = pbbs::reduce(imap, pbbs::maxm<size_t>());
-        cur_range = (open_buckets+minBkt)/open_buckets+1; //will be decremented in next unpack() call
-      }
-    }
-    num_elms -= m;
-  }
 
-  inline void _next_bucket() {
-    cur_bkt++;
-    if (cur_bkt == open_buckets) {
-      unpack();
-      cur_bkt = 0;
+    // Identifiers whose bucket is in a range that was already processed are
+    // stale, and are dropped by to_range below.
+    if (order == increasing) {
+      size_t lo = (cur_range + 1) * open_buckets;
+      auto imap = pbbslib::make_sequence<size_t>(m, [&] (size_t i) {
+        size_t b = d[tmp[i]];
+        return (b >= lo && b != null_bkt) ? b
+                                          : std::numeric_limits<size_t>::max();
+      });
+      size_t min_b = pbbslib::reduce(imap, pbbslib::minm<size_t>());
+      cur_range = (min_b == std::numeric_limits<size_t>::max())
+                      ? cur_range + 1 : min_b / open_buckets;
+    } else {
+      size_t hi = (cur_range - 1) * open_buckets;
+      auto imap = pbbslib::make_sequence<size_t>(m, [&] (size_t i) {
+        size_t b = d[tmp[i]];
+        return (b < hi) ? b + 1 : 0;
+      });
+      size_t max_b = pbbslib::reduce(imap, pbbslib::maxm<size_t>());
+      cur_range = (max_b == 0) ? cur_range - 1 : (max_b - 1) / open_buckets + 1;
     }
+
+    auto g = [&](ident_t i) -> std::optional<std::tuple<ident_t, bucket_id> > {
+      ident_t v = tmp[i];
+      bucket_id bkt = to_range(d[v]);
+      return std::optional<std::tuple<ident_t, bucket_id> >(std::make_tuple(v, bkt));
+    };
+    update_buckets(g, m);
+    num_elms -= m;
   }
 
   // increasing: [cur_range*open_buckets, (cur_range+1)*open_buckets)
@@ -396,14 +455,16 @@ struct buckets {
     }
   }
 
-  size_t get_cur_bucket_num() const {
+  size_t get_bucket_num(size_t b) const {
     if (order == increasing) {
-      return cur_range * open_buckets + cur_bkt;
+      return cur_range * open_buckets + b;
     } else {
-      return (cur_range) * (open_buckets)-cur_bkt - 1;
+      return (cur_range) * (open_buckets)-b - 1;
     }
   }
 
+  size_t get_cur_bucket_num() const { return get_bucket_num(cur_bkt); }
+
   inline bucket get_cur_bucket() {
     id_dyn_arr bkt = bkts[cur_bkt];
     size_t size = bkt.size;
@@ -413,6 +474,7 @@ struct buckets {
     auto p = [&](size_t i) { return d[i] == cur_bkt_num; };
     size_t m = pbbslib::filterf(bkt.A, out, size, p);
     bkts[cur_bkt].size = 0;
+    mark_empty(cur_bkt);
     if (m == 0) {
       pbbslib::free_array(out);
       return next_bucket();
@@ -440,16 +502,16 @@ inline buckets<D, ident_t, bucket_t> make_buckets(size_t n, D d, bucket_order or
 
 // ident_t := uintE, bucket_t := uintE
 template <class D>
-inline buckets<D, uintE, uintE> make_vertex_buckets(size_t n, D& d, bucket_order
+inline buckets<D&, uintE, uintE> make_vertex_buckets(size_t n, D& d, bucket_order
       order, size_t total_buckets = 128) {
-  return buckets<D, uintE, uintE>(n, d, order, total_buckets);
+  return buckets<D&, uintE, uintE>(n, d, order, total_buckets);
 }
 
 // ident_t := uintE, bucket_t := bucket_t
 template <class bucket_t, class D>
-inline buckets<D, uintE, bucket_t> make_vertex_custom_buckets(size_t n, D& d, bucket_order
+inline buckets<D&, uintE, bucket_t> make_vertex_custom_buckets(size_t n, D& d, bucket_order
       order, size_t total_buckets = 128) {
-  return buckets<D, uintE, bucket_t>(n, d, order, total_buckets);
+  return buckets<D&, uintE, bucket_t>(n, d, order, total_buckets);
 }
 
 }  // namespace gbbs
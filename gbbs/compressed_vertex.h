@@ -35,6 +35,7 @@
 #pragma once
 
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "encodings/decoders.h"
@@ -215,6 +216,7 @@ inline size_t getVirtualDegree(uintE d, uchar* nghArr) {
 template <class W, class C>
 struct compressed_symmetric_vertex {
   using vertex = compressed_symmetric_vertex<W, C>;
+  using decoder = C;
   using edge_type = uchar;
 
   edge_type* neighbors;
@@ -479,6 +481,7 @@ struct compressed_symmetric_vertex {
 template <class W, class C>
 struct compressed_asymmetric_vertex {
   using vertex = compressed_symmetric_vertex<W, C>;
+  using decoder = C;
   using edge_type = uchar;
 
   edge_type* inNeighbors;
@@ -770,4 +773,68 @@ struct csv_byte
   using inner::inner;
 };
 
+template <class W>
+struct csv_streamvbyte
+    : compressed_symmetric_vertex<W, streamvbyte_decode> {
+  using inner = compressed_symmetric_vertex<W, streamvbyte_decode>;
+  using inner::inner;
+};
+
+template <class W>
+struct cav_streamvbyte
+    : compressed_asymmetric_vertex<W, streamvbyte_decode> {
+  using inner = compressed_asymmetric_vertex<W, streamvbyte_decode>;
+  using inner::inner;
+};
+
+template <class W>
+struct csv_bitpacked
+    : compressed_symmetric_vertex<W, bitpacked_decode> {
+  using inner = compressed_symmetric_vertex<W, bitpacked_decode>;
+  using inner::inner;
+};
+
+template <class W>
+struct cav_bitpacked
+    : compressed_asymmetric_vertex<W, bitpacked_decode> {
+  using inner = compressed_asymmetric_vertex<W, bitpacked_decode>;
+  using inner::inner;
+};
+
+// Whether V is a compressed vertex type whose encoding can be written as
+// well as read (see the decoders' sequentialCompressEdgeSet and
+// compressed_size), so that graphs filtered from it keep its encoding.
+template <class V>
+struct is_compressed_symmetric_vertex : std::false_type {};
+template <class W>
+struct is_compressed_symmetric_vertex<csv_bytepd_amortized<W>>
+    : std::true_type {};
+template <class W>
+struct is_compressed_symmetric_vertex<csv_streamvbyte<W>> : std::true_type {};
+template <class W>
+struct is_compressed_symmetric_vertex<csv_bitpacked<W>> : std::true_type {};
+
+template <class V>
+struct is_compressed_asymmetric_vertex : std::false_type {};
+template <class W>
+struct is_compressed_asymmetric_vertex<cav_bytepd_amortized<W>>
+    : std::true_type {};
+template <class W>
+struct is_compressed_asymmetric_vertex<cav_streamvbyte<W>> : std::true_type {};
+template <class W>
+struct is_compressed_asymmetric_vertex<cav_bitpacked<W>> : std::true_type {};
+
+// The default block encoding of graphs read by gbbs_io::read_compressed_*.
+// The encoding is not recorded in the compressed file, so the mains read
+// bytepd_amortized by default, streamvbyte with -DSTREAMVBYTE or bitpacked
+// with -DBITPACKED (for graphs written by `compressor -enc streamvbyte` or
+// `compressor -enc bitpacked`).
+#if defined(STREAMVBYTE)
+using compressed_encoding = streamvbyte_decode;
+#elif defined(BITPACKED)
+using compressed_encoding = bitpacked_decode;
+#else
+using compressed_encoding = bytepd_amortized_decode;
+#endif
+
 }  // namespace gbbs
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tuple>
+#include <type_traits>
 
 #include "gbbs/graph.h"
 #include "gbbs/pbbslib/sparse_table.h"
@@ -182,6 +183,90 @@ namespace contract {
     return std::make_pair(edge_ret, edge_size);
   }
 
+  // Returns the number of edges of GA from a cluster to a larger one, an upper
+  // bound on the number of edges fetch_intercluster_weighted returns.
+  template <class Graph, class C>
+  size_t count_intercluster(Graph& GA, C& clusters) {
+    using W = typename Graph::weight_type;
+    auto pred = [&](const uintE& src, const uintE& ngh, const W& w) {
+      return clusters[src] < clusters[ngh];
+    };
+    auto degrees = pbbs::delayed_seq<size_t>(GA.n, [&](size_t i) {
+      return GA.get_vertex(i).countOutNgh(i, pred);
+    });
+    return pbbslib::reduce_add(degrees);
+  }
+
+  // The size of a hash table holding num_edges inter-cluster edges, as
+  // allocated by make_sparse_table.
+  inline size_t intercluster_table_size(size_t num_edges) {
+    return (size_t)1 << pbbslib::log2_up((size_t)(1.1 * num_edges) + 1);
+  }
+
+  // Fetches the edges between clusters like fetch_intercluster_te, but keeps
+  // their weights: writes a (c_src, c_ngh, w) to out for each pair of
+  // adjacent clusters c_src < c_ngh, where w combines the weights of all edges
+  // between them with the monoid `combine` (e.g. minm for distances, addm for
+  // cut weights), and returns the number written. If the monoid's type is
+  // pbbslib::empty, the weights are dropped.
+  //
+  // The hash table is built in table_space, which has table_size entries (a
+  // power of two, at least intercluster_table_size(count_intercluster(GA,
+  // clusters))), and out has room for count_intercluster(GA, clusters)
+  // edges. Both can be reused by the caller across calls.
+  template <class Graph, class C, class M>
+  size_t fetch_intercluster_weighted(
+      Graph& GA, C& clusters, M combine,
+      std::tuple<edge, typename M::T>* table_space, size_t table_size,
+      std::tuple<uintE, uintE, typename M::T>* out) {
+    using W = typename Graph::weight_type;
+    using CW = typename M::T;
+    using KV = std::tuple<edge, CW>;
+    size_t n = GA.n;
+
+    KV empty = std::make_tuple(std::make_tuple(UINT_E_MAX, UINT_E_MAX),
+                               combine.identity);
+    auto hash_pair = [](const edge& t) {
+      size_t key = (static_cast<size_t>(std::get<0>(t)) << 32) + std::get<1>(t);
+      return pbbslib::hash64_2(key);
+    };
+    auto edge_table = pbbslib::make_sparse_table<edge, CW>(
+        table_space, table_size, empty, hash_pair);
+
+    auto map_f = [&](const uintE& src, const uintE& ngh, const W& w) {
+      uintE c_src = clusters[src];
+      uintE c_ngh = clusters[ngh];
+      if (c_src < c_ngh) {
+        if constexpr (std::is_same<CW, pbbslib::empty>::value) {
+          edge_table.insert(std::make_tuple(std::make_tuple(c_src, c_ngh), pbbslib::empty()));
+        } else {
+          auto kv = std::make_tuple(std::make_tuple(c_src, c_ngh), (CW)w);
+          // Slots start at the identity, so both new and existing keys are
+          // updated by combining.
+          edge_table.insert_f(kv, [&](CW* value, const KV& kv) {
+            CW w_new = std::get<1>(kv);
+            CW old, combined;
+            do {
+              old = *value;
+              combined = combine.f(old, w_new);
+            } while (combined != old && !pbbslib::CAS(value, old, combined));
+          });
+        }
+      }
+    };
+    par_for(0, n, 1, [&] (size_t i) { GA.get_vertex(i).mapOutNgh(i, map_f); });
+    auto entries = pbbs::delayed_seq<std::tuple<uintE, uintE, CW>>(
+        table_size, [&](size_t i) {
+          auto& [e, w] = table_space[i];
+          return std::make_tuple(std::get<0>(e), std::get<1>(e), w);
+        });
+    return pbbslib::filter_out(
+        entries, pbbslib::make_sequence(out, table_size),
+        [](const std::tuple<uintE, uintE, CW>& e) {
+          return std::get<0>(e) != UINT_E_MAX;
+        });
+  }
+
   // Given a graph and a vertex partitioning of the graph, returns a contracted
   // graph where each vertex grouping/cluster in the partition is contracted
   // into a single vertex. Self-loop edges and duplicate edges are removed, and
@@ -24,7 +24,9 @@
 #pragma once
 
 #include "bridge.h"
+#include "flags.h"
 #include "macros.h"
+#include "vertex_subset.h"
 
 namespace gbbs {
 
@@ -100,4 +102,232 @@ inline edge_array<W> to_edge_array(Graph& G) {
   return edge_array<W>(arr, n, n, m);
 }
 
+// ==================== Tiled (cache-blocked) edge arrays ====================
+// The order in which the tiles of a tiled_edge_array are laid out.
+//   grid_order : row-major order over the (source-block, target-block) grid.
+//   hilbert_order : the order of the tiles along a Hilbert curve over the
+//     grid, so that consecutive tiles share their source or target block.
+enum tile_order { grid_order, hilbert_order };
+
+// The L2 cache size assumed when choosing a default tile size.
+constexpr size_t kL2CacheBytes = 256 * 1024;
+
+// The maximum number of edges processed sequentially as one task when mapping
+// over a tiled_edge_array. Larger tiles are split into several tasks.
+constexpr size_t kTileTaskSize = 4096;
+
+// edgeMap over a tiled_edge_array processes the target blocks in parallel
+// (and so avoids atomic updates) when there are at least this many target
+// blocks per worker.
+constexpr size_t kTileColumnsPerWorker = 4;
+
+// Returns the log of the largest power-of-two tile side length such that the
+// per-vertex state of the sources and the targets of a tile, each using
+// bytes_per_vertex bytes, fit in a cache of size cache_bytes.
+inline size_t tile_bits_for_cache(size_t bytes_per_vertex,
+                                  size_t cache_bytes = kL2CacheBytes) {
+  size_t side = cache_bytes / (2 * std::max(bytes_per_vertex, (size_t)1));
+  return (side > 1) ? pbbs::log2_up(side + 1) - 1 : 0;
+}
+
+// Returns the position of the cell (x, y) along the Hilbert curve filling a
+// side x side grid, where side is a power of two.
+inline size_t hilbert_index(size_t side, size_t x, size_t y) {
+  size_t d = 0;
+  for (size_t s = side / 2; s > 0; s /= 2) {
+    size_t rx = (x & s) > 0;
+    size_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry == 0) {
+      if (rx == 1) {
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+// An edge array (COO) whose edges are grouped into 2D tiles. The tile (i, j)
+// contains the edges from source block i to target block j, where a block is a
+// range of 2^tile_bits consecutive vertex ids, so that the per-vertex data
+// read and written by the edges of a tile stays in cache. The tiles are laid
+// out contiguously in the given tile_order, and the edges within a tile keep
+// their input (CSR) order.
+template <class W>
+struct tiled_edge_array {
+  using weight_type = W;
+  using edge = std::tuple<uintE, uintE, W>;
+
+  size_t n;
+  size_t m;
+  size_t tile_bits;
+  size_t num_tiles;  // the number of non-empty tiles
+  tile_order order;
+
+  sequence<edge> E;
+  // The out-degree of each vertex.
+  sequence<uintE> degrees;
+  // The tasks used to map over the edges: task i covers the edges
+  // [task_offsets[i], task_offsets[i+1]), all of which have their source in
+  // the source block task_rows[i].
+  sequence<size_t> task_offsets;
+  sequence<uintE> task_rows;
+  // The tasks whose edges have their target in target block j are
+  // column_tasks[column_offsets[j], column_offsets[j+1]), in tile order.
+  sequence<size_t> column_offsets;
+  sequence<size_t> column_tasks;
+
+  tiled_edge_array() : n(0), m(0), tile_bits(0), num_tiles(0) {}
+
+  size_t size() { return m; }
+  size_t num_tasks() { return task_rows.size(); }
+  size_t num_blocks() { return (n + ((size_t)1 << tile_bits) - 1) >> tile_bits; }
+  uintE get_out_degree(uintE v) { return degrees[v]; }
+
+  // Applies f(u, v, w) to every edge. Tasks are run in parallel, and the edges
+  // of a task are processed sequentially in tile order.
+  template <class F>
+  void map_edges(F f) {
+    parallel_for(0, num_tasks(), [&] (size_t i) {
+      for (size_t j = task_offsets[i]; j < task_offsets[i + 1]; j++) {
+        const auto& [u, v, w] = E[j];
+        f(u, v, w);
+      }
+    }, 1);
+  }
+
+  void del() {
+    E.clear();
+    degrees.clear();
+    task_offsets.clear();
+    task_rows.clear();
+    column_offsets.clear();
+    column_tasks.clear();
+  }
+};
+
+// Builds a tiled_edge_array from the out-edges of G using tiles whose side
+// length is 2^tile_bits vertices.
+template <class W, class Graph>
+inline tiled_edge_array<W> to_tiled_edge_array(Graph& G, size_t tile_bits,
+                                                tile_order order = hilbert_order) {
+  using edge = std::tuple<uintE, uintE, W>;
+  size_t n = G.n;
+  tiled_edge_array<W> T;
+  T.n = n;
+  T.tile_bits = tile_bits;
+  T.order = order;
+  T.degrees = sequence<uintE>(n, [&] (size_t i) {
+    return G.get_vertex(i).getOutDegree(); });
+
+  size_t blocks = T.num_blocks();
+  size_t side = (size_t)1 << pbbs::log2_up(std::max(blocks, (size_t)1));
+  auto tile_id = [&] (const edge& e) -> size_t {
+    size_t x = std::get<0>(e) >> tile_bits;
+    size_t y = std::get<1>(e) >> tile_bits;
+    return (order == hilbert_order) ? hilbert_index(side, x, y)
+                                    : x * blocks + y;
+  };
+  size_t key_bits = pbbs::log2_up(side * side);
+
+  auto coo = to_edge_array<W>(G);
+  auto unsorted = coo.to_seq();
+  T.E = pbbs::integer_sort(unsorted, tile_id, key_bits);
+  unsorted.clear();
+  T.m = T.E.size();
+
+  // Find the start of every non-empty tile.
+  auto tile_starts = pbbs::pack_index<size_t>(
+      pbbs::delayed_seq<bool>(T.m, [&] (size_t i) {
+        return (i == 0) || tile_id(T.E[i - 1]) != tile_id(T.E[i]);
+      }));
+  T.num_tiles = tile_starts.size();
+
+  // Split each tile into tasks of at most kTileTaskSize edges.
+  auto tasks_per_tile = sequence<size_t>(T.num_tiles + 1, [&] (size_t i) {
+    if (i == T.num_tiles) return (size_t)0;
+    size_t end = (i + 1 < T.num_tiles) ? tile_starts[i + 1] : T.m;
+    return pbbs::num_blocks(end - tile_starts[i], kTileTaskSize);
+  });
+  size_t num_tasks = pbbslib::scan_add_inplace(tasks_per_tile);
+  T.task_offsets = sequence<size_t>(num_tasks + 1);
+  T.task_rows = sequence<uintE>(num_tasks);
+  parallel_for(0, T.num_tiles, [&] (size_t i) {
+    size_t start = tile_starts[i];
+    uintE row = std::get<0>(T.E[start]) >> tile_bits;
+    for (size_t j = tasks_per_tile[i]; j < tasks_per_tile[i + 1]; j++) {
+      T.task_offsets[j] = start + (j - tasks_per_tile[i]) * kTileTaskSize;
+      T.task_rows[j] = row;
+    }
+  });
+  T.task_offsets[num_tasks] = T.m;
+
+  // Group the tasks by target block, keeping them in tile order.
+  auto task_column = [&] (size_t i) -> size_t {
+    return std::get<1>(T.E[T.task_offsets[i]]) >> tile_bits;
+  };
+  auto task_ids = pbbs::delayed_seq<size_t>(num_tasks, [] (size_t i) { return i; });
+  auto [sorted_tasks, column_counts] =
+      pbbs::integer_sort_with_counts<size_t>(task_ids, task_column, blocks);
+  T.column_tasks = std::move(sorted_tasks);
+  T.column_offsets = sequence<size_t>(blocks + 1, [&] (size_t i) {
+    return (i == blocks) ? 0 : column_counts[i]; });
+  pbbslib::scan_add_inplace(T.column_offsets);
+  return T;
+}
+
+// An edgeMap over a tiled_edge_array, using the same edgeMap struct (update,
+// updateAtomic, cond) as the CSR edgeMap, applied to every edge (u, v) with u
+// in vs and cond(v) true. If there are enough target blocks, the target blocks
+// are processed in parallel, each by a single task that runs over its tiles in
+// tile order and applies update. Otherwise all tasks run in parallel and apply
+// updateAtomic. Tasks whose source block contains no vertex of vs are skipped.
+// The output is a dense vertexSubset containing the targets for which the
+// update returned true (empty if no_output is set).
+template <class W, class VS, class F>
+inline vertexSubset edgeMap(tiled_edge_array<W>& G, VS& vs, F f,
+                            intT threshold = -1, const flags& fl = 0) {
+  size_t n = G.n;
+  vs.toDense();
+  auto active_rows = sequence<bool>(G.num_blocks(), false);
+  parallel_for(0, n, [&] (size_t i) {
+    size_t row = i >> G.tile_bits;
+    if (vs.isIn(i) && !active_rows[row]) active_rows[row] = true;
+  });
+
+  bool output = should_output(fl);
+  bool* next = output ? pbbs::new_array<bool>(n) : nullptr;
+  if (output) {
+    parallel_for(0, n, [&] (size_t i) { next[i] = false; });
+  }
+  size_t num_columns = G.num_blocks();
+  if (num_columns >= kTileColumnsPerWorker * num_workers()) {
+    parallel_for(0, num_columns, [&] (size_t c) {
+      for (size_t k = G.column_offsets[c]; k < G.column_offsets[c + 1]; k++) {
+        size_t i = G.column_tasks[k];
+        if (!active_rows[G.task_rows[i]]) continue;
+        for (size_t j = G.task_offsets[i]; j < G.task_offsets[i + 1]; j++) {
+          const auto& [u, v, w] = G.E[j];
+          if (vs.isIn(u) && f.cond(v) && f.update(u, v, w) && output) {
+            next[v] = true;
+          }
+        }
+      }
+    }, 1);
+  } else {
+    parallel_for(0, G.num_tasks(), [&] (size_t i) {
+      if (!active_rows[G.task_rows[i]]) return;
+      for (size_t j = G.task_offsets[i]; j < G.task_offsets[i + 1]; j++) {
+        const auto& [u, v, w] = G.E[j];
+        if (vs.isIn(u) && f.cond(v) && f.updateAtomic(u, v, w) && output) {
+          if (!next[v]) next[v] = true;
+        }
+      }
+    }, 1);
+  }
+  return output ? vertexSubset(n, next) : vertexSubset(n);
+}
+
 }  // namespace gbbs
@@ -0,0 +1,894 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Frame-of-reference bit-packed encoding of the PARALLEL_DEGREE blocks of an
+// adjacency list.
+//
+// The block structure is identical to bytepd_amortized:
+//   [virtual_degree][block_offsets (num_blocks - 1)][block_0]...[block_k]
+// and every block is a [start_offset : uintE] followed by a sequence of
+// miniblocks of at most kMiniblockSize edges. A miniblock with c edges is
+//   [base : uintE][width : uchar][c : uchar][packed offsets][weights]
+// where base is its first neighbor and the offsets ngh - base of its edges are
+// stored using width = bits(last neighbor - base) bits each. Full miniblocks
+// (c = kMiniblockSize) store all offsets in the BP128 layout: offset k lives in
+// lane k % 4 of four interleaved streams of 32-bit words, so an SSE register
+// unpacks four offsets at a time with shifts and masks. Other miniblocks store
+// the offsets of edges 1..c-1 contiguously. Weights use the bytepd_amortized
+// weight encoding.
+//
+// Since the offsets are relative to a fixed base (and not to the previous
+// edge), the i'th edge of a miniblock can be read in O(1) time, and removing
+// edges never increases the size of a miniblock, which lets pack work in
+// place. Neighbor lists must be sorted, and the neighbors of a miniblock must
+// span less than 2^32 ids.
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(EDGELONG)
+#include <immintrin.h>
+#define BITPACKED_SIMD
+#endif
+
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "byte_pd_amortized.h"
+
+namespace gbbs {
+namespace bitpacked {
+
+constexpr size_t kMiniblockSize = 128;
+
+namespace internal {
+
+constexpr size_t kHeaderBytes = sizeof(uintE) + 2;
+
+__attribute__((always_inline)) inline uchar bit_width(uintE x) {
+  uchar w = 0;
+  while (x > 0) {
+    w++;
+    x >>= 1;
+  }
+  return w;
+}
+
+__attribute__((always_inline)) inline uint64_t width_mask(uchar w) {
+  return (((uint64_t)1) << w) - 1;
+}
+
+// Number of bytes used by the packed offsets of a miniblock with count edges
+// and the given width.
+__attribute__((always_inline)) inline size_t packed_bytes(size_t count,
+                                                          uchar width) {
+  return (count == kMiniblockSize) ? (kMiniblockSize / 8) * width
+                                   : ((count - 1) * width + 7) / 8;
+}
+
+// Reads the k'th 32-bit word of lane l of a full miniblock.
+__attribute__((always_inline)) inline uint32_t lane_word(const uchar* data,
+                                                         size_t l, size_t k) {
+  uint32_t word;
+  memcpy(&word, data + 4 * (4 * k + l), sizeof(uint32_t));
+  return word;
+}
+
+// Returns offset k of a full (vertical) miniblock.
+__attribute__((always_inline)) inline uintE get_vertical(const uchar* data,
+                                                         uchar width,
+                                                         size_t k) {
+  size_t lane = k & 3;
+  size_t bit = (k >> 2) * width;
+  size_t word = bit >> 5, shift = bit & 31;
+  uint64_t v = lane_word(data, lane, word);
+  if (shift + width > 32) {
+    v |= ((uint64_t)lane_word(data, lane, word + 1)) << 32;
+  }
+  return (v >> shift) & width_mask(width);
+}
+
+// Returns offset k (k >= 1) of a partial (horizontal) miniblock.
+__attribute__((always_inline)) inline uintE get_horizontal(const uchar* data,
+                                                           uchar width,
+                                                           size_t k) {
+  size_t bit = (k - 1) * width;
+  const uchar* p = data + (bit >> 3);
+  size_t shift = bit & 7;
+  size_t nbytes = (shift + width + 7) / 8;
+  uint64_t v = 0;
+  for (size_t b = 0; b < nbytes; b++) {
+    v |= ((uint64_t)p[b]) << (8 * b);
+  }
+  return (v >> shift) & width_mask(width);
+}
+
+// Unpacks the kMiniblockSize offsets of a full miniblock of width W, adding
+// base to each of them. Reads exactly the packed_bytes(kMiniblockSize, W)
+// bytes at data, and none for W = 0.
+template <size_t W>
+inline void unpack_vertical(const uchar* data, uintE base, uintE* out) {
+  if constexpr (W == 0) {
+    for (size_t k = 0; k < kMiniblockSize; k++) {
+      out[k] = base;
+    }
+    return;
+  }
+#ifdef BITPACKED_SIMD
+  const __m128i* in = (const __m128i*)data;
+  const __m128i mask = _mm_set1_epi32((uint32_t)width_mask(W));
+  const __m128i b = _mm_set1_epi32(base);
+  __m128i cur = _mm_loadu_si128(in++);
+  size_t shift = 0;
+  for (size_t k = 0; k < kMiniblockSize / 4; k++) {
+    __m128i v = _mm_srl_epi32(cur, _mm_cvtsi32_si128(shift));
+    shift += W;
+    if (shift > 32) {
+      cur = _mm_loadu_si128(in++);
+      shift -= 32;
+      v = _mm_or_si128(v, _mm_sll_epi32(cur, _mm_cvtsi32_si128(W - shift)));
+    } else if (shift == 32 && k + 1 < kMiniblockSize / 4) {
+      cur = _mm_loadu_si128(in++);
+      shift = 0;
+    }
+    v = _mm_add_epi32(_mm_and_si128(v, mask), b);
+    _mm_storeu_si128((__m128i*)(out + 4 * k), v);
+  }
+#else
+  for (size_t k = 0; k < kMiniblockSize; k++) {
+    out[k] = base + get_vertical(data, W, k);
+  }
+#endif
+}
+
+using unpack_fn = void (*)(const uchar*, uintE, uintE*);
+
+template <size_t... Ws>
+constexpr std::array<unpack_fn, sizeof...(Ws)> make_unpackers(
+    std::index_sequence<Ws...>) {
+  return {&unpack_vertical<Ws>...};
+}
+
+// unpack_vertical specialized for every width in [0, 32].
+inline constexpr std::array<unpack_fn, 33> kUnpackers =
+    make_unpackers(std::make_index_sequence<33>{});
+
+// Decodes the neighbors of the miniblock at finger into nghs, and sets count
+// to its number of edges. Returns a pointer to the weights of the miniblock.
+__attribute__((always_inline)) inline uchar* decode_miniblock(uchar* finger,
+                                                              uintE* nghs,
+                                                              size_t& count) {
+  uintE base = *((uintE*)finger);
+  uchar width = finger[sizeof(uintE)];
+  count = finger[sizeof(uintE) + 1];
+  uchar* data = finger + kHeaderBytes;
+  if (count == kMiniblockSize) {
+    kUnpackers[width](data, base, nghs);
+  } else {
+    nghs[0] = base;
+    uint64_t mask = width_mask(width);
+    size_t nbytes = packed_bytes(count, width);
+    size_t k = 1, bit = 0;
+    // Offsets whose 8-byte window lies inside the packed data are read with
+    // a single unaligned load; the last few are read byte by byte.
+    for (; k < count && (bit >> 3) + 8 <= nbytes; k++, bit += width) {
+      uint64_t v;
+      memcpy(&v, data + (bit >> 3), sizeof(uint64_t));
+      nghs[k] = base + ((v >> (bit & 7)) & mask);
+    }
+    for (; k < count; k++) {
+      nghs[k] = base + get_horizontal(data, width, k);
+    }
+  }
+  return data + packed_bytes(count, width);
+}
+
+// Returns a pointer to the first byte after the miniblock at finger, and sets
+// count to its number of edges.
+template <class W>
+__attribute__((always_inline)) inline uchar* skip_miniblock(uchar* finger,
+                                                            size_t& count) {
+  uchar width = finger[sizeof(uintE)];
+  count = finger[sizeof(uintE) + 1];
+  finger += kHeaderBytes + packed_bytes(count, width);
+  if constexpr (!std::is_same<W, pbbslib::empty>::value) {
+    for (size_t k = 0; k < count; k++) {
+      bytepd_amortized::eatWeight<W>(finger);
+    }
+  }
+  return finger;
+}
+
+// Returns the address of block i and its [start, end) edge offsets.
+__attribute__((always_inline)) inline uchar* get_block(
+    uchar* edge_start, uintE degree, size_t num_blocks, size_t i,
+    uintE& start_offset, uintE& end_offset) {
+  uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+  uchar* finger = (i > 0) ? (edge_start + block_offsets[i - 1])
+                          : (edge_start + (num_blocks - 1) * sizeof(uintE) +
+                             sizeof(uintE));  // block offs + virtual_degree
+  start_offset = *((uintE*)finger);
+  end_offset = (i == (num_blocks - 1))
+                   ? degree
+                   : (*((uintE*)(edge_start + block_offsets[i])));
+  return finger + sizeof(uintE);
+}
+
+__attribute__((always_inline)) inline size_t get_num_blocks(uchar* edge_start) {
+  uintE virtual_degree = *((uintE*)edge_start);
+  return 1 + (virtual_degree - 1) / PARALLEL_DEGREE;
+}
+
+}  // namespace internal
+
+// Encodes the 0 < c <= kMiniblockSize edges in E as a miniblock at
+// start + offset. Returns the offset after the miniblock.
+template <class W>
+inline long compress_miniblock(uchar* start, long offset,
+                               const std::tuple<uintE, W>* E, size_t c) {
+  uintE base = std::get<0>(E[0]);
+  uchar width = internal::bit_width(std::get<0>(E[c - 1]) - base);
+  assert(width <= 32);
+  uchar* finger = start + offset;
+  *((uintE*)finger) = base;
+  finger[sizeof(uintE)] = width;
+  finger[sizeof(uintE) + 1] = c;
+  uchar* data = finger + internal::kHeaderBytes;
+  if (c == kMiniblockSize) {
+    uint32_t words[kMiniblockSize];  // at most 4 lanes of 32 words
+    memset(words, 0, internal::packed_bytes(c, width));
+    for (size_t k = 0; k < c; k++) {
+      uint64_t v = std::get<0>(E[k]) - base;
+      size_t lane = k & 3;
+      size_t bit = (k >> 2) * width;
+      size_t word = bit >> 5, shift = bit & 31;
+      words[4 * word + lane] |= (uint32_t)(v << shift);
+      if (shift + width > 32) {
+        words[4 * (word + 1) + lane] |= (uint32_t)(v >> (32 - shift));
+      }
+    }
+    memcpy(data, words, internal::packed_bytes(c, width));
+    data += internal::packed_bytes(c, width);
+  } else {
+    uint64_t buf = 0;
+    size_t bits = 0;
+    for (size_t k = 1; k < c; k++) {
+      buf |= ((uint64_t)(std::get<0>(E[k]) - base)) << bits;
+      bits += width;
+      while (bits >= 8) {
+        *data++ = buf & 0xFF;
+        buf >>= 8;
+        bits -= 8;
+      }
+    }
+    if (bits > 0) {
+      *data++ = buf & 0xFF;
+    }
+  }
+  offset = data - start;
+  for (size_t k = 0; k < c; k++) {
+    offset = bytepd_amortized::compressWeight<W>(start, offset,
+                                                 std::get<1>(E[k]));
+  }
+  return offset;
+}
+
+// Encodes the d > 0 edges in E as the body of a block (everything after the
+// start_offset) at start + offset. Returns the offset after the block.
+template <class W>
+inline long compress_block(uchar* start, long offset, const uintE& source,
+                           const std::tuple<uintE, W>* E, size_t d) {
+  for (size_t i = 0; i < d; i += kMiniblockSize) {
+    size_t c = std::min(kMiniblockSize, d - i);
+    offset = compress_miniblock<W>(start, offset, E + i, c);
+  }
+  return offset;
+}
+
+// Returns the number of bytes compress_block uses for the d > 0 edges in E.
+template <class W>
+inline size_t compressed_block_size(const uintE& source,
+                                    const std::tuple<uintE, W>* E, size_t d) {
+  uchar tmp[16];
+  size_t bytes = 0;
+  for (size_t i = 0; i < d; i += kMiniblockSize) {
+    size_t c = std::min(kMiniblockSize, d - i);
+    uchar width = internal::bit_width(std::get<0>(E[i + c - 1]) -
+                                      std::get<0>(E[i]));
+    bytes += internal::kHeaderBytes + internal::packed_bytes(c, width);
+    for (size_t k = i; k < i + c; k++) {
+      bytes += bytepd_amortized::compressWeight<W>(tmp, 0, std::get<1>(E[k]));
+    }
+  }
+  return bytes;
+}
+
+// Calls t(ngh, wgh, edge_id) on every edge of the block. Stops early if t
+// returns false.
+template <class W, class T>
+__attribute__((always_inline)) inline bool decode_block_body(
+    T& t, uchar* finger, const uintE& source, uintE start_offset,
+    uintE end_offset) {
+  uintE nghs[kMiniblockSize];
+  size_t edge_id = start_offset;
+  while (edge_id < end_offset) {
+    size_t count;
+    finger = internal::decode_miniblock(finger, nghs, count);
+    for (size_t j = 0; j < count; j++) {
+      W wgh = bytepd_amortized::eatWeight<W>(finger);
+      if (!t(nghs[j], wgh, edge_id + j)) return false;
+    }
+    edge_id += count;
+  }
+  return true;
+}
+
+template <class W>
+struct iter {
+  uchar* base;
+  uchar* weights;  // the next weight; the next miniblock once all are read
+  uintE src;
+  uintT degree;
+
+  uintE num_blocks;
+  uintE cur_block;
+  uintE block_remaining;  // edges of the current block in later miniblocks
+
+  uintE nghs[kMiniblockSize];
+  size_t miniblock_count;
+  size_t read_in_miniblock;
+
+  std::tuple<uintE, W> last_edge;
+  uintE read_total;
+
+  iter() {}
+
+  iter(uchar* _base, uintT _degree, uintE _src)
+      : base(_base), src(_src), degree(_degree), cur_block(0) {
+    if (degree == 0) return;
+    num_blocks = internal::get_num_blocks(base);
+    cur_block = -1;  // start_next_miniblock advances to block 0
+    block_remaining = 0;
+    start_next_miniblock();
+    read_total = 1;
+  }
+
+  // Decodes the next non-empty miniblock and reads its first edge.
+  inline void start_next_miniblock() {
+    uchar* finger = weights;
+    while (block_remaining == 0) {
+      cur_block++;
+      uintE start_offset, end_offset;
+      finger = internal::get_block(base, degree, num_blocks, cur_block,
+                                   start_offset, end_offset);
+      block_remaining = end_offset - start_offset;
+    }
+    weights = internal::decode_miniblock(finger, nghs, miniblock_count);
+    block_remaining -= miniblock_count;
+    std::get<0>(last_edge) = nghs[0];
+    std::get<1>(last_edge) = bytepd_amortized::eatWeight<W>(weights);
+    read_in_miniblock = 1;
+  }
+
+  __attribute__((always_inline)) inline std::tuple<uintE, W> cur() {
+    return last_edge;
+  }
+
+  __attribute__((always_inline)) inline std::tuple<uintE, W> next() {
+    if (read_in_miniblock == miniblock_count) {
+      start_next_miniblock();
+    } else {
+      std::get<0>(last_edge) = nghs[read_in_miniblock++];
+      std::get<1>(last_edge) = bytepd_amortized::eatWeight<W>(weights);
+    }
+    read_total++;
+    return last_edge;
+  }
+
+  __attribute__((always_inline)) inline bool has_next() {
+    return read_total < degree;
+  }
+};
+
+// Decode edges. The callback t(source, ngh, wgh, edge_id) returns false to
+// stop decoding; blocks other than the first are decoded in parallel when
+// parallel is true, in which case only the current block stops early.
+template <class W, class T>
+inline void decode(T& t, uchar* edge_start, const uintE& source,
+                   const uintT& degree, const bool parallel = true) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+      return t(source, ngh, wgh, edge_id);
+    };
+    auto decode_ith_block = [&](size_t i) {
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      return decode_block_body<W>(block_t, finger, source, start_offset,
+                                  end_offset);
+    };
+    if (!decode_ith_block(0)) return;
+    if ((num_blocks > 2) && parallel) {
+      parallel_for(1, num_blocks, [&](size_t i) { decode_ith_block(i); }, 1);
+    } else {
+      for (size_t i = 1; i < num_blocks; i++) {
+        if (!decode_ith_block(i)) return;
+      }
+    }
+  }
+}
+
+template <class W, class T>
+inline void decode_block(T t, uchar* edge_start, const uintE& source,
+                         const uintT& degree, uintE block_num) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks,
+                                        block_num, start_offset, end_offset);
+    auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+      t(ngh, wgh, edge_id);
+      return true;
+    };
+    decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+  }
+}
+
+// r: E -> E -> E
+template <class W, class E, class M, class Monoid>
+inline E map_reduce(uchar* edge_start, const uintE& source, const uintT& degree,
+                    M& m, Monoid& reduce, const bool par = true) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+
+    E stk[100];
+    E* block_outputs;
+    if (num_blocks > 100) {
+      block_outputs = pbbslib::new_array_no_init<E>(num_blocks);
+    } else {
+      block_outputs = (E*)stk;
+    }
+
+    par_for(0, num_blocks, 1, [&] (size_t i) {
+      auto cur = reduce.identity;
+      auto block_t = [&](const uintE& ngh, W& wgh,
+                         const uintT& edge_id) {
+        cur = reduce.f(cur, m(source, ngh, wgh));
+        return true;
+      };
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+      block_outputs[i] = cur;
+    }, par && (num_blocks > 2));
+
+    auto im = pbbslib::make_sequence(block_outputs, num_blocks);
+    E res = pbbslib::reduce(im, reduce);
+    if (num_blocks > 100) {
+      pbbslib::free_array(block_outputs);
+    }
+    return res;
+  } else {
+    return reduce.identity;
+  }
+}
+
+template <class W>
+inline size_t intersect(uchar* l1, uchar* l2, uintE l1_size, uintE l2_size,
+                        uintE l1_src, uintE l2_src) {
+  if (l1_size == 0 || l2_size == 0) return 0;
+  auto it_1 = iter<W>(l1, l1_size, l1_src);
+  auto it_2 = iter<W>(l2, l2_size, l2_src);
+  size_t i = 0, j = 0, ct = 0;
+  while (i < l1_size && j < l2_size) {
+    uintE e1 = std::get<0>(it_1.cur());
+    uintE e2 = std::get<0>(it_2.cur());
+    if (e1 == e2) {
+      i++, j++, ct++;
+      if (i < l1_size) it_1.next();
+      if (j < l2_size) it_2.next();
+    } else if (e1 < e2) {
+      i++;
+      if (i < l1_size) it_1.next();
+    } else {
+      j++;
+      if (j < l2_size) it_2.next();
+    }
+  }
+  return ct;
+}
+
+template <class W, class F>
+size_t intersect_f(uchar* l1, uchar* l2, uintE l1_size, uintE l2_size,
+                   uintE l1_src, uintE l2_src, const F& f) {
+  if (l1_size == 0 || l2_size == 0) return 0;
+  auto it_1 = iter<W>(l1, l1_size, l1_src);
+  auto it_2 = iter<W>(l2, l2_size, l2_src);
+  size_t i = 0, j = 0, ct = 0;
+  while (i < l1_size && j < l2_size) {
+    uintE e1 = std::get<0>(it_1.cur());
+    uintE e2 = std::get<0>(it_2.cur());
+    if (e1 == e2) {
+      f(l1_src, l2_src, e1);
+      i++, j++, ct++;
+      if (i < l1_size) it_1.next();
+      if (j < l2_size) it_2.next();
+    } else if (e1 < e2) {
+      i++;
+      if (i < l1_size) it_1.next();
+    } else {
+      j++;
+      if (j < l2_size) it_2.next();
+    }
+  }
+  return ct;
+}
+
+// Returns the i'th edge. The block is found by binary search and the
+// miniblock by skipping over the (at most PARALLEL_DEGREE / kMiniblockSize)
+// miniblock headers before it; the neighbor is then read directly.
+template <class W>
+inline std::tuple<uintE, W> get_ith_neighbor(uchar* edge_start, uintE source,
+                                             uintE degree, size_t i) {
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+  uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+  auto blocks_f = [&](size_t j) {
+    uintE end = (j == (num_blocks - 1))
+                    ? degree
+                    : (*((uintE*)(edge_start + block_offsets[j])));
+    return end;
+  };
+  auto blocks_imap = pbbslib::make_sequence<size_t>(num_blocks, blocks_f);
+  // This is essentially searching a plus_scan'd, incl arr.
+  auto lte = [&](const size_t& l, const size_t& r) { return l <= r; };
+  size_t block = pbbslib::binary_search(blocks_imap, i, lte);
+  assert(block < num_blocks);
+
+  uintE start_offset, end_offset;
+  uchar* finger = internal::get_block(edge_start, degree, num_blocks, block,
+                                      start_offset, end_offset);
+  size_t k = i - start_offset;
+  size_t count;
+  while (true) {
+    uchar* next = internal::skip_miniblock<W>(finger, count);
+    if (k < count) break;
+    k -= count;
+    finger = next;
+  }
+  uintE base = *((uintE*)finger);
+  uchar width = finger[sizeof(uintE)];
+  uchar* data = finger + internal::kHeaderBytes;
+  uintE ngh = base;
+  if (count == kMiniblockSize) {
+    ngh += internal::get_vertical(data, width, k);
+  } else if (k > 0) {
+    ngh += internal::get_horizontal(data, width, k);
+  }
+  uchar* weights = data + internal::packed_bytes(count, width);
+  W wgh = bytepd_amortized::eatWeight<W>(weights);
+  if constexpr (!std::is_same<W, pbbslib::empty>::value) {
+    for (size_t j = 0; j < k; j++) {
+      wgh = bytepd_amortized::eatWeight<W>(weights);
+    }
+  }
+  return std::make_tuple(ngh, wgh);
+}
+
+// Decodes the [start_offset, end_offset) edges of the block at finger into
+// out[start..end).
+template <class W>
+inline void decode_block(uchar* finger, std::tuple<uintE, W>* out,
+                         size_t start, size_t end, const uintE& source) {
+  auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+    out[edge_id] = std::make_tuple(ngh, wgh);
+    return true;
+  };
+  decode_block_body<W>(block_t, finger, source, start, end);
+}
+
+// Returns the address of the first byte after the block at finger.
+template <class W>
+inline uchar* block_end(uchar* finger, uintE start_offset, uintE end_offset) {
+  size_t edges = end_offset - start_offset;
+  while (edges > 0) {
+    size_t count;
+    finger = internal::skip_miniblock<W>(finger, count);
+    edges -= count;
+  }
+  return finger;
+}
+
+template <class W>
+inline void repack(const uintE& source, const uintE& degree, uchar* edge_start,
+                   std::tuple<uintE, W>* tmp_space, bool par = true) {
+  // No need to repack if degree == 0; all other methods abort when the vertex
+  // degree is 0.
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+
+    // 1. Copy all live edges into U
+    using uintEW = std::tuple<uintE, W>;
+    uintEW tmp_stack[100];
+    uintEW* U = tmp_stack;
+    if (degree > 100) {
+      U = pbbslib::new_array_no_init<uintEW>(degree);
+    }
+    par_for(0, num_blocks, 2, [&] (size_t i) {
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      decode_block<W>(finger, U, start_offset, end_offset, source);
+    }, par);
+
+    // 2. Compute #bytes per new block
+    size_t new_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    uintE offs_stack[100];
+    uintE* offs =
+        ((new_blocks + 1) <= 100) ? offs_stack : pbbslib::new_array_no_init<uintE>(new_blocks + 1);
+    par_for(0, new_blocks, 2, [&] (size_t i) {
+      size_t start = i * PARALLEL_DEGREE;
+      size_t end = start + std::min<size_t>(PARALLEL_DEGREE, degree - start);
+      offs[i] = sizeof(uintE) +  // block_deg
+                compressed_block_size<W>(source, U + start, end - start);
+    }, par);
+
+    // 3. Scan to compute offset for each block
+    offs[new_blocks] = 0;
+    auto bytes_imap = pbbslib::make_sequence(offs, new_blocks + 1);
+    size_t new_bytes = pbbslib::scan_add_inplace(bytes_imap);
+
+    // 4. Repack each block. Regrouping edges into full miniblocks can
+    // increase their widths, so we only repack if the new list fits in the
+    // space used by the current one.
+    uchar* nghs_start = edge_start + (new_blocks - 1) * sizeof(uintE) +
+                        sizeof(uintE);  // update ngh_start
+    uintE last_start, last_end;
+    uchar* last_block = internal::get_block(edge_start, degree, num_blocks,
+                                            num_blocks - 1, last_start,
+                                            last_end);
+    uchar* old_end = block_end<W>(last_block, last_start, last_end);
+    if (nghs_start + new_bytes <= old_end) {
+      uintE* virtual_degree_ptr = (uintE*)edge_start;
+      *virtual_degree_ptr = degree;  // update the virtual degree
+      par_for(0, new_blocks, 2, [&] (size_t i) {
+        size_t start = i * PARALLEL_DEGREE;
+        size_t end = start + std::min<size_t>(PARALLEL_DEGREE, degree - start);
+        uchar* finger = nghs_start + bytes_imap[i];
+        // update block offsets with the distance from the start
+        if (i > 0) {
+          block_offsets[i - 1] = finger - edge_start;
+        }
+        *((uintE*)finger) = start;
+        compress_block<W>(finger, sizeof(uintE), source, U + start,
+                          end - start);
+      }, par);
+    }
+
+    if ((new_blocks + 1) > 100) {
+      pbbslib::free_array(offs);
+    }
+    if (degree > 100) {
+      pbbslib::free_array(U);
+    }
+  }
+}
+
+template <class W, class P>
+inline size_t pack(P& pred, uchar* edge_start, const uintE& source,
+                   const uintE& degree, std::tuple<uintE, W>* tmp_space,
+                   bool par = true) {
+  using uintEW = std::tuple<uintE, W>;
+  uintE virtual_degree = *((uintE*)edge_start);
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+
+  size_t block_cts_stack[100];
+  size_t* block_cts =
+      (num_blocks > 100) ? pbbslib::new_array_no_init<size_t>(num_blocks + 1) : block_cts_stack;
+
+  par_for(0, num_blocks, 2, [&] (size_t i) {
+    uintE start_offset, end_offset;
+    uchar* read_finger = internal::get_block(edge_start, degree, num_blocks,
+                                             i, start_offset, end_offset);
+    uchar* write_finger = read_finger;
+    size_t edges = end_offset - start_offset;
+    size_t block_ct = 0;
+
+    // Filter each miniblock and recompress it in place. The live edges of a
+    // miniblock have a base that is no smaller and a last neighbor that is no
+    // larger, so the recompressed miniblock is never larger than the
+    // original one, and is written before the next miniblock is read.
+    while (edges > 0) {
+      uintE nghs[kMiniblockSize];
+      size_t count;
+      read_finger = internal::decode_miniblock(read_finger, nghs, count);
+      uintEW tmp[kMiniblockSize];
+      size_t ct = 0;
+      for (size_t j = 0; j < count; j++) {
+        W wgh = bytepd_amortized::eatWeight<W>(read_finger);
+        if (pred(source, nghs[j], wgh)) {
+          tmp[ct++] = std::make_tuple(nghs[j], wgh);
+        }
+      }
+      if (ct > 0) {
+        write_finger = write_finger +
+                       compress_miniblock<W>(write_finger, 0, tmp, ct);
+      }
+      block_ct += ct;
+      edges -= count;
+    }
+    block_cts[i] = block_ct;
+  }, par);
+
+  // 2. Scan block_cts to get offsets within blocks
+  block_cts[num_blocks] = 0;
+  auto scan_cts = pbbslib::make_sequence(block_cts, num_blocks + 1);
+  size_t deg_remaining = pbbslib::scan_add_inplace(scan_cts);
+
+  par_for(0, num_blocks, 1000, [&] (size_t i) {
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                        start_offset, end_offset);
+    *((uintE*)(finger - sizeof(uintE))) = scan_cts[i];
+  });
+
+  if (num_blocks > 100) {
+    pbbslib::free_array(block_cts);
+  }
+
+  if (deg_remaining < (virtual_degree / 10)) {
+    repack<W>(source, deg_remaining, edge_start, tmp_space, par);
+  }
+
+  return deg_remaining;
+}
+
+template <class W, class P, class O>
+inline void filter_sequential(P pred, uchar* edge_start, const uintE& source,
+                              const uintE& degree, O& out) {
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+  size_t k = 0;
+  auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+    if (pred(source, ngh, wgh)) {
+      out(k++, std::make_tuple(ngh, wgh));
+    }
+    return true;
+  };
+  for (size_t i = 0; i < num_blocks; i++) {
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                        start_offset, end_offset);
+    decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+  }
+}
+
+template <class W, class P, class O>
+inline void filter(P pred, uchar* edge_start, const uintE& source,
+                   const uintE& degree, std::tuple<uintE, W>* tmp, O& out) {
+  if (degree <= PD_PACK_THRESHOLD && degree > 0) {
+    filter_sequential<W, P, O>(pred, edge_start, source, degree, out);
+  } else if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+
+    size_t tmp_size = degree / kTemporarySpaceConstant;
+    size_t blocks_per_iter = tmp_size / PARALLEL_DEGREE;
+    size_t blocks_finished = 0, out_off = 0;
+
+    while (blocks_finished < num_blocks) {
+      size_t start_block = blocks_finished;
+      size_t end_block = std::min(start_block + blocks_per_iter, num_blocks);
+      size_t total_blocks = end_block - start_block;
+
+      uintE first_offset, first_end;
+      internal::get_block(edge_start, degree, num_blocks, start_block,
+                          first_offset, first_end);
+      size_t last_offset = 0;
+
+      par_for(start_block, end_block, 1, [&] (size_t i) {
+        uintE start_offset, end_offset;
+        uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                            start_offset, end_offset);
+        if (i == (end_block - 1)) {
+          last_offset = end_offset - first_offset;
+        }
+        decode_block<W>(finger, tmp, start_offset - first_offset,
+                        end_offset - first_offset, source);
+      }, total_blocks > 1);
+
+      // filter edges into tmp2
+      auto pd = [&](const std::tuple<uintE, W>& nw) {
+        return pred(source, std::get<0>(nw), std::get<1>(nw));
+      };
+      uintE k = pbbslib::filterf(tmp, last_offset, pd, out, out_off);
+      out_off += k;
+
+      blocks_finished += total_blocks;
+    }
+  }
+}
+
+// Returns the number of bytes used by sequentialCompressEdgeSet to encode the
+// degree edges produced by it.
+template <class W, class I>
+inline size_t compressed_size(uintT degree, uintE source, I& it) {
+  size_t bytes = 0;
+  if (degree > 0) {
+    size_t num_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    bytes += sizeof(uintE) + (num_blocks - 1) * sizeof(uintE);
+    std::tuple<uintE, W> E[PARALLEL_DEGREE];
+    for (size_t i = 0; i < num_blocks; i++) {
+      size_t o = i * PARALLEL_DEGREE;
+      size_t end = std::min<size_t>(PARALLEL_DEGREE, degree - o);
+      for (size_t j = 0; j < end; j++) {
+        E[j] = (i == 0 && j == 0) ? it.cur() : it.next();
+      }
+      bytes += sizeof(uintE) + compressed_block_size<W>(source, E, end);
+    }
+  }
+  return bytes;
+}
+
+template <class W, class I>
+inline long sequentialCompressEdgeSet(uchar* edgeArray, size_t current_offset,
+                                      uintT degree, uintE source, I& it) {
+  if (degree > 0) {
+    size_t start_offset = current_offset;
+    size_t num_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    uintE* vertex_ctr = (uintE*)(edgeArray + start_offset);
+    *vertex_ctr = degree;
+    uintE* block_offsets = (uintE*)(edgeArray + start_offset + sizeof(uintE));
+    current_offset +=
+        sizeof(uintE) +
+        (num_blocks - 1) * sizeof(uintE);  // virtual deg + block_offs
+    std::tuple<uintE, W> E[PARALLEL_DEGREE];
+    for (size_t i = 0; i < num_blocks; i++) {
+      size_t o = i * PARALLEL_DEGREE;
+      size_t end = std::min<size_t>(PARALLEL_DEGREE, degree - o);
+
+      if (i > 0)
+        block_offsets[i - 1] =
+            current_offset -
+            start_offset;  // store offset for all chunks but the first
+      uintE* block_deg = (uintE*)(edgeArray + current_offset);
+      *block_deg = o;
+      current_offset += sizeof(uintE);
+
+      for (size_t j = 0; j < end; j++) {
+        E[j] = (i == 0 && j == 0) ? it.cur() : it.next();
+      }
+      current_offset =
+          compress_block<W>(edgeArray, current_offset, source, E, end);
+    }
+  }
+  return current_offset;
+}
+
+}  // namespace bitpacked
+}  // namespace gbbs
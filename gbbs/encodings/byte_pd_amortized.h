@@ -1191,6 +1191,33 @@ inline void filter(P pred, uchar* edge_start, const uintE& source,
   }
 }
 
+// Returns the number of bytes used by sequentialCompressEdgeSet to encode the
+// degree edges produced by it.
+template <class W, class I>
+inline size_t compressed_size(uintT degree, uintE source, I& it) {
+  size_t bytes = 0;
+  if (degree > 0) {
+    size_t num_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    // virtual degree, block offsets and per-block start offsets
+    bytes += sizeof(uintE) + (num_blocks - 1) * sizeof(uintE) +
+             num_blocks * sizeof(uintE);
+    uchar tmp[16];
+    uintE last_ngh = 0;
+    for (size_t i = 0; i < degree; i++) {
+      std::tuple<uintE, W> nxt = (i == 0) ? it.cur() : it.next();
+      uintE ngh = std::get<0>(nxt);
+      if ((i % PARALLEL_DEGREE) == 0) {
+        bytes += compressFirstEdge(tmp, 0, source, ngh);
+      } else {
+        bytes += compressEdge(tmp, 0, ngh - last_ngh);
+      }
+      bytes += compressWeight<W>(tmp, 0, std::get<1>(nxt));
+      last_ngh = ngh;
+    }
+  }
+  return bytes;
+}
+
 template <class W, class I>
 inline long sequentialCompressEdgeSet(uchar* edgeArray, size_t current_offset,
                                       uintT degree, uintE source, I& it, size_t encoded_degree=PARALLEL_DEGREE) {
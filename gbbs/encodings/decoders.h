@@ -25,6 +25,8 @@
 
 #include "byte.h"
 #include "byte_pd_amortized.h"
+#include "bit_packed.h"
+#include "stream_vbyte.h"
 
 namespace gbbs {
 
@@ -141,10 +143,16 @@ struct bytepd_amortized_decode {
                                                size_t current_offset,
                                                uintT degree, uintE source,
                                                I& it) {
-    return bytepd_amortized::sequentialCompressEdgeSet(
+    return bytepd_amortized::sequentialCompressEdgeSet<W>(
         edgeArray, current_offset, degree, source, it);
   }
 
+  // The number of bytes used by sequentialCompressEdgeSet.
+  template <class W, class I>
+  static inline size_t compressed_size(uintT degree, uintE source, I& it) {
+    return bytepd_amortized::compressed_size<W>(degree, source, it);
+  }
+
   template <class W, class P, class O>
   static inline void filter(P pred, uchar* edge_start, const uintE& source,
                             const uintE& degree, std::tuple<uintE, W>* tmp,
@@ -204,4 +212,192 @@ struct bytepd_amortized_decode {
   }
 };
 
+struct streamvbyte_decode {
+
+  template <class W>
+  static inline size_t intersect(uchar* l1, uchar* l2, uintE l1_size,
+                                 uintE l2_size, uintE l1_src, uintE l2_src) {
+    return streamvbyte::intersect<W>(l1, l2, l1_size, l2_size, l1_src, l2_src);
+  }
+
+  template <class W, class F>
+  static inline size_t intersect_f(uchar* l1, uchar* l2, uintE l1_size,
+                                   uintE l2_size, uintE l1_src, uintE l2_src,
+                                   const F& f) {
+    return streamvbyte::intersect_f<W>(l1, l2, l1_size, l2_size, l1_src,
+                                       l2_src, f);
+  }
+
+  template <class W>
+  static inline auto iter(uchar* edge_start, uintE degree, uintE id)
+      -> streamvbyte::iter<W> {
+    return streamvbyte::iter<W>(edge_start, degree, id);
+  }
+
+  template <class W, class I>
+  static inline long sequentialCompressEdgeSet(uchar* edgeArray,
+                                               size_t current_offset,
+                                               uintT degree, uintE source,
+                                               I& it) {
+    return streamvbyte::sequentialCompressEdgeSet<W>(
+        edgeArray, current_offset, degree, source, it);
+  }
+
+  // The number of bytes used by sequentialCompressEdgeSet.
+  template <class W, class I>
+  static inline size_t compressed_size(uintT degree, uintE source, I& it) {
+    return streamvbyte::compressed_size<W>(degree, source, it);
+  }
+
+  template <class W, class P, class O>
+  static inline void filter(P pred, uchar* edge_start, const uintE& source,
+                            const uintE& degree, std::tuple<uintE, W>* tmp,
+                            O& out) {
+    return streamvbyte::filter(pred, edge_start, source, degree, tmp, out);
+  }
+
+  template <class W, class P>
+  static inline size_t pack(P& pred, uchar* edge_start, const uintE& source,
+                            const uintE& degree,
+                            std::tuple<uintE, W>* tmp_space, bool par = true) {
+    return streamvbyte::pack(pred, edge_start, source, degree, tmp_space, par);
+  }
+
+  template <class W, class E, class M, class Monoid>
+  static inline E map_reduce(uchar* edge_start, const uintE& source,
+                             const uintT& degree, M& m, Monoid& reduce,
+                             const bool par = true) {
+    return streamvbyte::map_reduce<W, E>(edge_start, source, degree, m, reduce,
+                                         par);
+  }
+
+  template <class W, class T>
+ __attribute__((always_inline)) static inline void decode(T& t, uchar* edge_start, const uintE& source,
+                            const uintT& degree, const bool parallel=true) {
+    return streamvbyte::decode<W, T>(t, edge_start, source, degree, parallel);
+  }
+
+  static inline size_t get_virtual_degree(uintE d, uchar* nghArr) {
+    return bytepd_amortized::get_virtual_degree(d, nghArr);
+  }
+
+  template <class W, class T>
+  static inline void decode_block(T t, uchar* edge_start,
+                                      const uintE& source, const uintT& degree,
+                                      uintE block_num) {
+    return streamvbyte::decode_block<W, T>(t, edge_start, source, degree,
+                                           block_num);
+  }
+
+  template <class W>
+  static inline std::tuple<uintE, W> get_ith_neighbor(uchar* edge_start,
+                                                      uintE source,
+                                                      uintE degree, size_t i) {
+    return streamvbyte::get_ith_neighbor<W>(edge_start, source, degree, i);
+  }
+
+  // The block structure is shared with bytepd_amortized.
+  static inline uintE get_num_blocks(uchar* edge_start, uintE degree) {
+    return bytepd_amortized::get_num_blocks(edge_start, degree);
+  }
+
+  static inline uintE get_block_degree(uchar* edge_start, uintE degree, uintE block_num) {
+    return bytepd_amortized::get_block_degree(edge_start, degree, block_num);
+  }
+};
+
+struct bitpacked_decode {
+
+  template <class W>
+  static inline size_t intersect(uchar* l1, uchar* l2, uintE l1_size,
+                                 uintE l2_size, uintE l1_src, uintE l2_src) {
+    return bitpacked::intersect<W>(l1, l2, l1_size, l2_size, l1_src, l2_src);
+  }
+
+  template <class W, class F>
+  static inline size_t intersect_f(uchar* l1, uchar* l2, uintE l1_size,
+                                   uintE l2_size, uintE l1_src, uintE l2_src,
+                                   const F& f) {
+    return bitpacked::intersect_f<W>(l1, l2, l1_size, l2_size, l1_src,
+                                       l2_src, f);
+  }
+
+  template <class W>
+  static inline auto iter(uchar* edge_start, uintE degree, uintE id)
+      -> bitpacked::iter<W> {
+    return bitpacked::iter<W>(edge_start, degree, id);
+  }
+
+  template <class W, class I>
+  static inline long sequentialCompressEdgeSet(uchar* edgeArray,
+                                               size_t current_offset,
+                                               uintT degree, uintE source,
+                                               I& it) {
+    return bitpacked::sequentialCompressEdgeSet<W>(
+        edgeArray, current_offset, degree, source, it);
+  }
+
+  // The number of bytes used by sequentialCompressEdgeSet.
+  template <class W, class I>
+  static inline size_t compressed_size(uintT degree, uintE source, I& it) {
+    return bitpacked::compressed_size<W>(degree, source, it);
+  }
+
+  template <class W, class P, class O>
+  static inline void filter(P pred, uchar* edge_start, const uintE& source,
+                            const uintE& degree, std::tuple<uintE, W>* tmp,
+                            O& out) {
+    return bitpacked::filter(pred, edge_start, source, degree, tmp, out);
+  }
+
+  template <class W, class P>
+  static inline size_t pack(P& pred, uchar* edge_start, const uintE& source,
+                            const uintE& degree,
+                            std::tuple<uintE, W>* tmp_space, bool par = true) {
+    return bitpacked::pack(pred, edge_start, source, degree, tmp_space, par);
+  }
+
+  template <class W, class E, class M, class Monoid>
+  static inline E map_reduce(uchar* edge_start, const uintE& source,
+                             const uintT& degree, M& m, Monoid& reduce,
+                             const bool par = true) {
+    return bitpacked::map_reduce<W, E>(edge_start, source, degree, m, reduce,
+                                         par);
+  }
+
+  template <class W, class T>
+ __attribute__((always_inline)) static inline void decode(T& t, uchar* edge_start, const uintE& source,
+                            const uintT& degree, const bool parallel=true) {
+    return bitpacked::decode<W, T>(t, edge_start, source, degree, parallel);
+  }
+
+  static inline size_t get_virtual_degree(uintE d, uchar* nghArr) {
+    return bytepd_amortized::get_virtual_degree(d, nghArr);
+  }
+
+  template <class W, class T>
+  static inline void decode_block(T t, uchar* edge_start,
+                                      const uintE& source, const uintT& degree,
+                                      uintE block_num) {
+    return bitpacked::decode_block<W, T>(t, edge_start, source, degree,
+                                           block_num);
+  }
+
+  template <class W>
+  static inline std::tuple<uintE, W> get_ith_neighbor(uchar* edge_start,
+                                                      uintE source,
+                                                      uintE degree, size_t i) {
+    return bitpacked::get_ith_neighbor<W>(edge_start, source, degree, i);
+  }
+
+  // The block structure is shared with bytepd_amortized.
+  static inline uintE get_num_blocks(uchar* edge_start, uintE degree) {
+    return bytepd_amortized::get_num_blocks(edge_start, degree);
+  }
+
+  static inline uintE get_block_degree(uchar* edge_start, uintE degree, uintE block_num) {
+    return bytepd_amortized::get_block_degree(edge_start, degree, block_num);
+  }
+};
+
 }  // namespace gbbs
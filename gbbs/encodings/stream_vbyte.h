@@ -0,0 +1,756 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Stream-VByte encoding of the difference codes inside each PARALLEL_DEGREE
+// block of an adjacency list.
+//
+// The block structure is identical to bytepd_amortized:
+//   [virtual_degree][block_offsets (num_blocks - 1)][block_0]...[block_k]
+// and every block with d edges is laid out as
+//   [start_offset : uintE][first edge : signed VarInt, relative to source]
+//   [control stream : ceil((d-1)/4) bytes][data stream][weights]
+// The d-1 differences are stored with 1--4 bytes each in the data stream, and
+// the 2-bit length codes of four consecutive differences share one control
+// byte. Unlike the VarInt encoding, where every byte depends on the previous
+// one, the length of four differences is known from a single control byte,
+// which lets us decode four differences at a time with one shuffle (SSSE3)
+// and reconstruct the neighbors with a vectorized prefix sum. Weights are
+// stored after the data stream using the bytepd_amortized weight encoding.
+//
+// Differences must fit in 32 bits; decoding is vectorized only when uintE is
+// 32 bits wide (i.e. EDGELONG is not set).
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#if defined(__SSSE3__) && !defined(EDGELONG)
+#include <immintrin.h>
+#define STREAMVBYTE_SIMD
+#endif
+
+#include "gbbs/bridge.h"
+#include "gbbs/macros.h"
+#include "byte_pd_amortized.h"
+
+namespace gbbs {
+namespace streamvbyte {
+
+namespace internal {
+
+// Lookup tables indexed by a control byte: the total number of data bytes used
+// by the four differences, and the pshufb mask that expands them to four
+// 32-bit integers.
+struct tables {
+  uchar length[256];
+  uchar shuffle[256][16];
+  constexpr tables() : length(), shuffle() {
+    for (size_t c = 0; c < 256; c++) {
+      uchar pos = 0;
+      for (size_t j = 0; j < 4; j++) {
+        uchar len = ((c >> (2 * j)) & 3) + 1;
+        for (size_t b = 0; b < 4; b++) {
+          shuffle[c][4 * j + b] = (b < len) ? (pos + b) : 0xFF;
+        }
+        pos += len;
+      }
+      length[c] = pos;
+    }
+  }
+};
+
+inline constexpr tables kTables{};
+
+__attribute__((always_inline)) inline uchar code_length(uint32_t d) {
+  return (d < (1U << 8)) ? 1 : (d < (1U << 16)) ? 2 : (d < (1U << 24)) ? 3 : 4;
+}
+
+__attribute__((always_inline)) inline uchar get_length(const uchar* control,
+                                                       size_t i) {
+  return ((control[i >> 2] >> (2 * (i & 3))) & 3) + 1;
+}
+
+// Reads a little-endian code of len bytes.
+__attribute__((always_inline)) inline uint32_t read_code(uchar*& data,
+                                                         uchar len) {
+  uint32_t d = data[0];
+  switch (len) {
+    case 4: d |= ((uint32_t)data[3]) << 24;  // fall through
+    case 3: d |= ((uint32_t)data[2]) << 16;  // fall through
+    case 2: d |= ((uint32_t)data[1]) << 8;
+  }
+  data += len;
+  return d;
+}
+
+// Returns the address of block i and its [start, end) edge offsets.
+__attribute__((always_inline)) inline uchar* get_block(
+    uchar* edge_start, uintE degree, size_t num_blocks, size_t i,
+    uintE& start_offset, uintE& end_offset) {
+  uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+  uchar* finger = (i > 0) ? (edge_start + block_offsets[i - 1])
+                          : (edge_start + (num_blocks - 1) * sizeof(uintE) +
+                             sizeof(uintE));  // block offs + virtual_degree
+  start_offset = *((uintE*)finger);
+  end_offset = (i == (num_blocks - 1))
+                   ? degree
+                   : (*((uintE*)(edge_start + block_offsets[i])));
+  return finger + sizeof(uintE);
+}
+
+__attribute__((always_inline)) inline size_t get_num_blocks(uchar* edge_start) {
+  uintE virtual_degree = *((uintE*)edge_start);
+  return 1 + (virtual_degree - 1) / PARALLEL_DEGREE;
+}
+
+}  // namespace internal
+
+// Decodes the neighbors of a block with block_deg > 0 edges into nghs.
+// Returns a pointer to the first byte after the data stream, i.e., to the
+// weights of the block.
+__attribute__((always_inline)) inline uchar* decode_nghs(uchar* finger,
+                                                         const uintE& source,
+                                                         size_t block_deg,
+                                                         uintE* nghs) {
+  uintE ngh = bytepd_amortized::eatFirstEdge(finger, source);
+  nghs[0] = ngh;
+  size_t num_diffs = block_deg - 1;
+  const uchar* control = finger;
+  uchar* data = finger + (num_diffs + 3) / 4;
+  size_t i = 0;
+#ifdef STREAMVBYTE_SIMD
+  // Every quad of differences uses at least 4 data bytes, so 16-byte loads are
+  // safe while at least three full quads follow. For the last quads we check
+  // that the load stays inside the data stream.
+  size_t full_quads = num_diffs / 4;
+  size_t safe_quads = (full_quads > 3) ? (full_quads - 3) : 0;
+  __m128i prev = _mm_set1_epi32(ngh);
+  auto decode_quad = [&](size_t q) __attribute__((always_inline)) {
+    uchar c = control[q];
+    __m128i v = _mm_loadu_si128((const __m128i*)data);
+    v = _mm_shuffle_epi8(
+        v, _mm_loadu_si128((const __m128i*)internal::kTables.shuffle[c]));
+    data += internal::kTables.length[c];
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+    v = _mm_add_epi32(v, prev);
+    _mm_storeu_si128((__m128i*)(nghs + 1 + 4 * q), v);
+    prev = _mm_shuffle_epi32(v, 0xFF);
+  };
+  size_t q = 0;
+  for (; q < safe_quads; q++) {
+    decode_quad(q);
+  }
+  if (q < full_quads) {
+    size_t tail_bytes = 0;
+    for (size_t j = q; j < full_quads; j++) {
+      tail_bytes += internal::kTables.length[control[j]];
+    }
+    for (size_t j = 4 * full_quads; j < num_diffs; j++) {
+      tail_bytes += internal::get_length(control, j);
+    }
+    for (; q < full_quads && tail_bytes >= 16; q++) {
+      tail_bytes -= internal::kTables.length[control[q]];
+      decode_quad(q);
+    }
+  }
+  i = 4 * q;
+  ngh = nghs[i];
+#endif
+  for (; i < num_diffs; i++) {
+    ngh += internal::read_code(data, internal::get_length(control, i));
+    nghs[i + 1] = ngh;
+  }
+  return data;
+}
+
+// Encodes the d > 0 edges in E as the body of a block (everything after the
+// start_offset) at start + offset. Returns the offset after the block.
+template <class W>
+inline long compress_block(uchar* start, long offset, const uintE& source,
+                           const std::tuple<uintE, W>* E, size_t d) {
+  offset = bytepd_amortized::compressFirstEdge(start, offset, source,
+                                               std::get<0>(E[0]));
+  size_t num_diffs = d - 1;
+  uchar* control = start + offset;
+  size_t control_bytes = (num_diffs + 3) / 4;
+  memset(control, 0, control_bytes);
+  uchar* data = control + control_bytes;
+  for (size_t i = 0; i < num_diffs; i++) {
+    uintE ngh_diff = std::get<0>(E[i + 1]) - std::get<0>(E[i]);
+    uint32_t diff = ngh_diff;
+    assert(diff == ngh_diff);
+    uchar len = internal::code_length(diff);
+    control[i >> 2] |= (len - 1) << (2 * (i & 3));
+    memcpy(data, &diff, len);
+    data += len;
+  }
+  offset = data - start;
+  for (size_t i = 0; i < d; i++) {
+    offset = bytepd_amortized::compressWeight<W>(start, offset,
+                                                 std::get<1>(E[i]));
+  }
+  return offset;
+}
+
+// Returns the number of bytes compress_block uses for the d > 0 edges in E.
+template <class W>
+inline size_t compressed_block_size(const uintE& source,
+                                    const std::tuple<uintE, W>* E, size_t d) {
+  uchar tmp[16];
+  size_t bytes =
+      bytepd_amortized::compressFirstEdge(tmp, 0, source, std::get<0>(E[0]));
+  bytes += bytepd_amortized::compressWeight<W>(tmp, 0, std::get<1>(E[0]));
+  bytes += (d + 2) / 4;  // control stream for the d-1 differences
+  for (size_t i = 1; i < d; i++) {
+    bytes += internal::code_length(std::get<0>(E[i]) - std::get<0>(E[i - 1]));
+    bytes += bytepd_amortized::compressWeight<W>(tmp, 0, std::get<1>(E[i]));
+  }
+  return bytes;
+}
+
+// Calls t(ngh, wgh, edge_id) on every edge of the block. Stops early if t
+// returns false.
+template <class W, class T>
+__attribute__((always_inline)) inline bool decode_block_body(
+    T& t, uchar* finger, const uintE& source, uintE start_offset,
+    uintE end_offset) {
+  if (start_offset < end_offset) {
+    uintE nghs[PARALLEL_DEGREE];
+    finger = decode_nghs(finger, source, end_offset - start_offset, nghs);
+    for (size_t j = 0; j < end_offset - start_offset; j++) {
+      W wgh = bytepd_amortized::eatWeight<W>(finger);
+      if (!t(nghs[j], wgh, start_offset + j)) return false;
+    }
+  }
+  return true;
+}
+
+template <class W>
+struct iter {
+  uchar* base;
+  uchar* control;
+  uchar* data;
+  uchar* weights;
+  uintE src;
+  uintT degree;
+
+  uintE num_blocks;
+  uintE cur_chunk;
+  uintE cur_chunk_degree;
+
+  std::tuple<uintE, W> last_edge;
+  uintE read_in_block;
+  uintE read_total;
+
+  iter() {}
+
+  iter(uchar* _base, uintT _degree, uintE _src)
+      : base(_base), src(_src), degree(_degree), cur_chunk(0) {
+    if (degree == 0) return;
+    num_blocks = internal::get_num_blocks(base);
+    cur_chunk = -1;  // start_next_block advances to block 0
+    start_next_block();
+    read_total = 1;
+  }
+
+  // Advances to the next non-empty block and reads its first edge.
+  inline void start_next_block() {
+    uintE start_offset, end_offset;
+    uchar* finger;
+    do {
+      cur_chunk++;
+      finger = internal::get_block(base, degree, num_blocks, cur_chunk,
+                                   start_offset, end_offset);
+    } while (start_offset == end_offset);
+    cur_chunk_degree = end_offset - start_offset;
+    std::get<0>(last_edge) = bytepd_amortized::eatFirstEdge(finger, src);
+    control = finger;
+    data = control + (cur_chunk_degree + 2) / 4;
+    // Skip the data stream to find the weights.
+    weights = data;
+    if constexpr (!std::is_same<W, pbbslib::empty>::value) {
+      for (size_t i = 0; i + 1 < cur_chunk_degree; i++) {
+        weights += internal::get_length(control, i);
+      }
+    }
+    std::get<1>(last_edge) = bytepd_amortized::eatWeight<W>(weights);
+    read_in_block = 1;
+  }
+
+  __attribute__((always_inline)) inline std::tuple<uintE, W> cur() {
+    return last_edge;
+  }
+
+  __attribute__((always_inline)) inline std::tuple<uintE, W> next() {
+    if (read_in_block == cur_chunk_degree) {
+      start_next_block();
+    } else {
+      std::get<0>(last_edge) += internal::read_code(
+          data, internal::get_length(control, read_in_block - 1));
+      std::get<1>(last_edge) = bytepd_amortized::eatWeight<W>(weights);
+      read_in_block++;
+    }
+    read_total++;
+    return last_edge;
+  }
+
+  __attribute__((always_inline)) inline bool has_next() {
+    return read_total < degree;
+  }
+};
+
+// Decode edges. The callback t(source, ngh, wgh, edge_id) returns false to
+// stop decoding; blocks other than the first are decoded in parallel when
+// parallel is true, in which case only the current block stops early.
+template <class W, class T>
+inline void decode(T& t, uchar* edge_start, const uintE& source,
+                   const uintT& degree, const bool parallel = true) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+      return t(source, ngh, wgh, edge_id);
+    };
+    auto decode_ith_block = [&](size_t i) {
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      return decode_block_body<W>(block_t, finger, source, start_offset,
+                                  end_offset);
+    };
+    if (!decode_ith_block(0)) return;
+    if ((num_blocks > 2) && parallel) {
+      parallel_for(1, num_blocks, [&](size_t i) { decode_ith_block(i); }, 1);
+    } else {
+      for (size_t i = 1; i < num_blocks; i++) {
+        if (!decode_ith_block(i)) return;
+      }
+    }
+  }
+}
+
+template <class W, class T>
+inline void decode_block(T t, uchar* edge_start, const uintE& source,
+                         const uintT& degree, uintE block_num) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks,
+                                        block_num, start_offset, end_offset);
+    auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+      t(ngh, wgh, edge_id);
+      return true;
+    };
+    decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+  }
+}
+
+// r: E -> E -> E
+template <class W, class E, class M, class Monoid>
+inline E map_reduce(uchar* edge_start, const uintE& source, const uintT& degree,
+                    M& m, Monoid& reduce, const bool par = true) {
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+
+    E stk[100];
+    E* block_outputs;
+    if (num_blocks > 100) {
+      block_outputs = pbbslib::new_array_no_init<E>(num_blocks);
+    } else {
+      block_outputs = (E*)stk;
+    }
+
+    par_for(0, num_blocks, 1, [&] (size_t i) {
+      auto cur = reduce.identity;
+      auto block_t = [&](const uintE& ngh, W& wgh,
+                         const uintT& edge_id) {
+        cur = reduce.f(cur, m(source, ngh, wgh));
+        return true;
+      };
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+      block_outputs[i] = cur;
+    }, par && (num_blocks > 2));
+
+    auto im = pbbslib::make_sequence(block_outputs, num_blocks);
+    E res = pbbslib::reduce(im, reduce);
+    if (num_blocks > 100) {
+      pbbslib::free_array(block_outputs);
+    }
+    return res;
+  } else {
+    return reduce.identity;
+  }
+}
+
+template <class W>
+inline size_t intersect(uchar* l1, uchar* l2, uintE l1_size, uintE l2_size,
+                        uintE l1_src, uintE l2_src) {
+  if (l1_size == 0 || l2_size == 0) return 0;
+  auto it_1 = iter<W>(l1, l1_size, l1_src);
+  auto it_2 = iter<W>(l2, l2_size, l2_src);
+  size_t i = 0, j = 0, ct = 0;
+  while (i < l1_size && j < l2_size) {
+    uintE e1 = std::get<0>(it_1.cur());
+    uintE e2 = std::get<0>(it_2.cur());
+    if (e1 == e2) {
+      i++, j++, ct++;
+      if (i < l1_size) it_1.next();
+      if (j < l2_size) it_2.next();
+    } else if (e1 < e2) {
+      i++;
+      if (i < l1_size) it_1.next();
+    } else {
+      j++;
+      if (j < l2_size) it_2.next();
+    }
+  }
+  return ct;
+}
+
+template <class W, class F>
+size_t intersect_f(uchar* l1, uchar* l2, uintE l1_size, uintE l2_size,
+                   uintE l1_src, uintE l2_src, const F& f) {
+  if (l1_size == 0 || l2_size == 0) return 0;
+  auto it_1 = iter<W>(l1, l1_size, l1_src);
+  auto it_2 = iter<W>(l2, l2_size, l2_src);
+  size_t i = 0, j = 0, ct = 0;
+  while (i < l1_size && j < l2_size) {
+    uintE e1 = std::get<0>(it_1.cur());
+    uintE e2 = std::get<0>(it_2.cur());
+    if (e1 == e2) {
+      f(l1_src, l2_src, e1);
+      i++, j++, ct++;
+      if (i < l1_size) it_1.next();
+      if (j < l2_size) it_2.next();
+    } else if (e1 < e2) {
+      i++;
+      if (i < l1_size) it_1.next();
+    } else {
+      j++;
+      if (j < l2_size) it_2.next();
+    }
+  }
+  return ct;
+}
+
+template <class W>
+inline std::tuple<uintE, W> get_ith_neighbor(uchar* edge_start, uintE source,
+                                             uintE degree, size_t i) {
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+  uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+  auto blocks_f = [&](size_t j) {
+    uintE end = (j == (num_blocks - 1))
+                    ? degree
+                    : (*((uintE*)(edge_start + block_offsets[j])));
+    return end;
+  };
+  auto blocks_imap = pbbslib::make_sequence<size_t>(num_blocks, blocks_f);
+  // This is essentially searching a plus_scan'd, incl arr.
+  auto lte = [&](const size_t& l, const size_t& r) { return l <= r; };
+  size_t block = pbbslib::binary_search(blocks_imap, i, lte);
+  assert(block < num_blocks);
+
+  uintE start_offset, end_offset;
+  uchar* finger = internal::get_block(edge_start, degree, num_blocks, block,
+                                      start_offset, end_offset);
+  uintE nghs[PARALLEL_DEGREE];
+  finger = decode_nghs(finger, source, end_offset - start_offset, nghs);
+  W wgh = bytepd_amortized::eatWeight<W>(finger);
+  for (size_t edgeID = start_offset + 1; edgeID <= i; edgeID++) {
+    wgh = bytepd_amortized::eatWeight<W>(finger);
+  }
+  return std::make_tuple(nghs[i - start_offset], wgh);
+}
+
+// Decodes the [start_offset, end_offset) edges of the block at finger into
+// out[start..end).
+template <class W>
+inline void decode_block(uchar* finger, std::tuple<uintE, W>* out,
+                         size_t start, size_t end, const uintE& source) {
+  if (end - start > 0) {
+    uintE nghs[PARALLEL_DEGREE];
+    finger = decode_nghs(finger, source, end - start, nghs);
+    for (size_t i = start; i < end; i++) {
+      W wgh = bytepd_amortized::eatWeight<W>(finger);
+      out[i] = std::make_tuple(nghs[i - start], wgh);
+    }
+  }
+}
+
+template <class W>
+inline void repack(const uintE& source, const uintE& degree, uchar* edge_start,
+                   std::tuple<uintE, W>* tmp_space, bool par = true) {
+  // No need to repack if degree == 0; all other methods abort when the vertex
+  // degree is 0.
+  if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+    uintE* block_offsets = (uintE*)(edge_start + sizeof(uintE));
+
+    // 1. Copy all live edges into U
+    using uintEW = std::tuple<uintE, W>;
+    uintEW tmp_stack[100];
+    uintEW* U = tmp_stack;
+    if (degree > 100) {
+      U = pbbslib::new_array_no_init<uintEW>(degree);
+    }
+    par_for(0, num_blocks, 2, [&] (size_t i) {
+      uintE start_offset, end_offset;
+      uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                          start_offset, end_offset);
+      decode_block<W>(finger, U, start_offset, end_offset, source);
+    }, par);
+
+    // 2. Compute #bytes per new block
+    size_t new_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    uintE offs_stack[100];
+    uintE* offs =
+        ((new_blocks + 1) <= 100) ? offs_stack : pbbslib::new_array_no_init<uintE>(new_blocks + 1);
+    par_for(0, new_blocks, 2, [&] (size_t i) {
+      size_t start = i * PARALLEL_DEGREE;
+      size_t end = start + std::min<size_t>(PARALLEL_DEGREE, degree - start);
+      offs[i] = sizeof(uintE) +  // block_deg
+                compressed_block_size<W>(source, U + start, end - start);
+    }, par);
+
+    // 3. Scan to compute offset for each block
+    offs[new_blocks] = 0;
+    auto bytes_imap = pbbslib::make_sequence(offs, new_blocks + 1);
+    pbbslib::scan_add_inplace(bytes_imap);
+
+    // 4. Repack each block. Merging blocks only removes per-block headers,
+    // so the repacked list fits in the space of the original list.
+    uintE* virtual_degree_ptr = (uintE*)edge_start;
+    *virtual_degree_ptr = degree;  // update the virtual degree
+    uchar* nghs_start = edge_start + (new_blocks - 1) * sizeof(uintE) +
+                        sizeof(uintE);  // update ngh_start
+    par_for(0, new_blocks, 2, [&] (size_t i) {
+      size_t start = i * PARALLEL_DEGREE;
+      size_t end = start + std::min<size_t>(PARALLEL_DEGREE, degree - start);
+      uchar* finger = nghs_start + bytes_imap[i];
+      // update block offsets with the distance from the start
+      if (i > 0) {
+        block_offsets[i - 1] = finger - edge_start;
+      }
+      *((uintE*)finger) = start;
+      compress_block<W>(finger, sizeof(uintE), source, U + start, end - start);
+    }, par);
+
+    if ((new_blocks + 1) > 100) {
+      pbbslib::free_array(offs);
+    }
+    if (degree > 100) {
+      pbbslib::free_array(U);
+    }
+  }
+}
+
+template <class W, class P>
+inline size_t pack(P& pred, uchar* edge_start, const uintE& source,
+                   const uintE& degree, std::tuple<uintE, W>* tmp_space,
+                   bool par = true) {
+  using uintEW = std::tuple<uintE, W>;
+  uintE virtual_degree = *((uintE*)edge_start);
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+
+  size_t block_cts_stack[100];
+  size_t* block_cts =
+      (num_blocks > 100) ? pbbslib::new_array_no_init<size_t>(num_blocks + 1) : block_cts_stack;
+
+  par_for(0, num_blocks, 2, [&] (size_t i) {
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                        start_offset, end_offset);
+    uintE block_deg = end_offset - start_offset;
+
+    // A) Uncompress and filter edges into tmp
+    uintEW tmp[PARALLEL_DEGREE];
+    size_t ct = 0;
+    auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+      if (pred(source, ngh, wgh)) {
+        tmp[ct++] = std::make_tuple(ngh, wgh);
+      }
+      return true;
+    };
+    decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+
+    // B) write the number of live edges in this block to block_cts
+    block_cts[i] = ct;
+
+    // C) Recompress inside this block. Dropping edges never increases the
+    // length of a difference code, so the block shrinks.
+    if (ct > 0 && ct < block_deg) {
+      compress_block<W>(finger, 0, source, tmp, ct);
+    }
+  }, par);
+
+  // 2. Scan block_cts to get offsets within blocks
+  block_cts[num_blocks] = 0;
+  auto scan_cts = pbbslib::make_sequence(block_cts, num_blocks + 1);
+  size_t deg_remaining = pbbslib::scan_add_inplace(scan_cts);
+
+  par_for(0, num_blocks, 1000, [&] (size_t i) {
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                        start_offset, end_offset);
+    *((uintE*)(finger - sizeof(uintE))) = scan_cts[i];
+  });
+
+  if (num_blocks > 100) {
+    pbbslib::free_array(block_cts);
+  }
+
+  if (deg_remaining < (virtual_degree / 10)) {
+    repack<W>(source, deg_remaining, edge_start, tmp_space, par);
+  }
+
+  return deg_remaining;
+}
+
+template <class W, class P, class O>
+inline void filter_sequential(P pred, uchar* edge_start, const uintE& source,
+                              const uintE& degree, O& out) {
+  size_t num_blocks = internal::get_num_blocks(edge_start);
+  size_t k = 0;
+  auto block_t = [&](const uintE& ngh, W& wgh, const uintT& edge_id) {
+    if (pred(source, ngh, wgh)) {
+      out(k++, std::make_tuple(ngh, wgh));
+    }
+    return true;
+  };
+  for (size_t i = 0; i < num_blocks; i++) {
+    uintE start_offset, end_offset;
+    uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                        start_offset, end_offset);
+    decode_block_body<W>(block_t, finger, source, start_offset, end_offset);
+  }
+}
+
+template <class W, class P, class O>
+inline void filter(P pred, uchar* edge_start, const uintE& source,
+                   const uintE& degree, std::tuple<uintE, W>* tmp, O& out) {
+  if (degree <= PD_PACK_THRESHOLD && degree > 0) {
+    filter_sequential<W, P, O>(pred, edge_start, source, degree, out);
+  } else if (degree > 0) {
+    size_t num_blocks = internal::get_num_blocks(edge_start);
+
+    size_t tmp_size = degree / kTemporarySpaceConstant;
+    size_t blocks_per_iter = tmp_size / PARALLEL_DEGREE;
+    size_t blocks_finished = 0, out_off = 0;
+
+    while (blocks_finished < num_blocks) {
+      size_t start_block = blocks_finished;
+      size_t end_block = std::min(start_block + blocks_per_iter, num_blocks);
+      size_t total_blocks = end_block - start_block;
+
+      uintE first_offset, first_end;
+      internal::get_block(edge_start, degree, num_blocks, start_block,
+                          first_offset, first_end);
+      size_t last_offset = 0;
+
+      par_for(start_block, end_block, 1, [&] (size_t i) {
+        uintE start_offset, end_offset;
+        uchar* finger = internal::get_block(edge_start, degree, num_blocks, i,
+                                            start_offset, end_offset);
+        if (i == (end_block - 1)) {
+          last_offset = end_offset - first_offset;
+        }
+        decode_block<W>(finger, tmp, start_offset - first_offset,
+                        end_offset - first_offset, source);
+      }, total_blocks > 1);
+
+      // filter edges into tmp2
+      auto pd = [&](const std::tuple<uintE, W>& nw) {
+        return pred(source, std::get<0>(nw), std::get<1>(nw));
+      };
+      uintE k = pbbslib::filterf(tmp, last_offset, pd, out, out_off);
+      out_off += k;
+
+      blocks_finished += total_blocks;
+    }
+  }
+}
+
+// Returns the number of bytes used by sequentialCompressEdgeSet to encode the
+// degree edges produced by it.
+template <class W, class I>
+inline size_t compressed_size(uintT degree, uintE source, I& it) {
+  size_t bytes = 0;
+  if (degree > 0) {
+    size_t num_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    bytes += sizeof(uintE) + (num_blocks - 1) * sizeof(uintE);
+    std::tuple<uintE, W> E[PARALLEL_DEGREE];
+    for (size_t i = 0; i < num_blocks; i++) {
+      size_t o = i * PARALLEL_DEGREE;
+      size_t end = std::min<size_t>(PARALLEL_DEGREE, degree - o);
+      for (size_t j = 0; j < end; j++) {
+        E[j] = (i == 0 && j == 0) ? it.cur() : it.next();
+      }
+      bytes += sizeof(uintE) + compressed_block_size<W>(source, E, end);
+    }
+  }
+  return bytes;
+}
+
+template <class W, class I>
+inline long sequentialCompressEdgeSet(uchar* edgeArray, size_t current_offset,
+                                      uintT degree, uintE source, I& it) {
+  if (degree > 0) {
+    size_t start_offset = current_offset;
+    size_t num_blocks = 1 + (degree - 1) / PARALLEL_DEGREE;
+    uintE* vertex_ctr = (uintE*)(edgeArray + start_offset);
+    *vertex_ctr = degree;
+    uintE* block_offsets = (uintE*)(edgeArray + start_offset + sizeof(uintE));
+    current_offset +=
+        sizeof(uintE) +
+        (num_blocks - 1) * sizeof(uintE);  // virtual deg + block_offs
+    std::tuple<uintE, W> E[PARALLEL_DEGREE];
+    for (size_t i = 0; i < num_blocks; i++) {
+      size_t o = i * PARALLEL_DEGREE;
+      size_t end = std::min<size_t>(PARALLEL_DEGREE, degree - o);
+
+      if (i > 0)
+        block_offsets[i - 1] =
+            current_offset -
+            start_offset;  // store offset for all chunks but the first
+      uintE* block_deg = (uintE*)(edgeArray + current_offset);
+      *block_deg = o;
+      current_offset += sizeof(uintE);
+
+      for (size_t j = 0; j < end; j++) {
+        E[j] = (i == 0 && j == 0) ? it.cur() : it.next();
+      }
+      current_offset =
+          compress_block<W>(edgeArray, current_offset, source, E, end);
+    }
+  }
+  return current_offset;
+}
+
+}  // namespace streamvbyte
+}  // namespace gbbs
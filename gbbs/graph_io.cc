@@ -125,7 +125,7 @@ asymmetric_graph<asymmetric_vertex, intE> read_weighted_asymmetric_graph(
   pbbs::free_array(offsets);
 
   uintT* tOffsets = pbbslib::new_array_no_init<uintT>(n+1);
-  par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i)
+  par_for(0, n+1, pbbslib::kSequentialForThreshold, [&] (size_t i)
                   { tOffsets[i] = INT_T_MAX; });
   intTriple* temp = pbbslib::new_array_no_init<intTriple>(m);
   par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i) {
@@ -258,8 +258,8 @@ asymmetric_graph<asymmetric_vertex, pbbslib::empty> read_unweighted_asymmetric_g
   pbbs::free_array(offsets);
 
   /* construct transpose of the graph */
-  uintT* tOffsets = pbbslib::new_array_no_init<uintT>(n);
-  par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i)
+  uintT* tOffsets = pbbslib::new_array_no_init<uintT>(n+1);
+  par_for(0, n+1, pbbslib::kSequentialForThreshold, [&] (size_t i)
                   { tOffsets[i] = INT_T_MAX; });
   intPair* temp = pbbslib::new_array_no_init<intPair>(m);
   par_for(0, n, pbbslib::kSequentialForThreshold, [&] (size_t i) {
@@ -287,7 +287,7 @@ asymmetric_graph<asymmetric_vertex, pbbslib::empty> read_unweighted_asymmetric_g
 
   // fill in offsets of degree 0 vertices by taking closest non-zero
   // offset to the right
-  auto t_seq = pbbslib::make_sequence(tOffsets, n).rslice();
+  auto t_seq = pbbslib::make_sequence(tOffsets, n+1).rslice();
   auto M = pbbslib::minm<uintT>();
   M.identity = m;
   pbbslib::scan_inplace(t_seq, M, pbbslib::fl_scan_inclusive);
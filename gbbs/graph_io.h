@@ -122,9 +122,38 @@ asymmetric_graph<asymmetric_vertex, pbbslib::empty> read_unweighted_asymmetric_g
 std::tuple<char*, size_t> parse_compressed_graph(
     const char* fname, bool mmap, bool mmapcopy);
 
-template <class weight_type>
-symmetric_graph<csv_bytepd_amortized, weight_type>
-read_compressed_symmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
+// Wraps adjacency lists encoded with `decoder` in the matching symmetric and
+// asymmetric compressed graph types.
+template <class weight_type, class decoder, class... Args>
+auto make_compressed_symmetric_graph(Args&&... args) {
+  if constexpr (std::is_same<decoder, streamvbyte_decode>::value) {
+    return symmetric_graph<csv_streamvbyte, weight_type>(args...);
+  } else if constexpr (std::is_same<decoder, bitpacked_decode>::value) {
+    return symmetric_graph<csv_bitpacked, weight_type>(args...);
+  } else {
+    static_assert(std::is_same<decoder, bytepd_amortized_decode>::value,
+                  "unsupported compressed encoding");
+    return symmetric_graph<csv_bytepd_amortized, weight_type>(args...);
+  }
+}
+
+template <class weight_type, class decoder, class... Args>
+auto make_compressed_asymmetric_graph(Args&&... args) {
+  if constexpr (std::is_same<decoder, streamvbyte_decode>::value) {
+    return asymmetric_graph<cav_streamvbyte, weight_type>(args...);
+  } else if constexpr (std::is_same<decoder, bitpacked_decode>::value) {
+    return asymmetric_graph<cav_bitpacked, weight_type>(args...);
+  } else {
+    static_assert(std::is_same<decoder, bytepd_amortized_decode>::value,
+                  "unsupported compressed encoding");
+    return asymmetric_graph<cav_bytepd_amortized, weight_type>(args...);
+  }
+}
+
+// Reads a compressed graph whose lists are encoded with `decoder` (by default
+// compressed_encoding, selected at compile time).
+template <class weight_type, class decoder = compressed_encoding>
+auto read_compressed_symmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
   char* bytes;
   size_t bytes_size;
   std::tie(bytes, bytes_size) = parse_compressed_graph(fname, mmap, mmapcopy);
@@ -155,13 +184,12 @@ read_compressed_symmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
       unmmap(bytes, bytes_size);
     };
   }
-  symmetric_graph<csv_bytepd_amortized, weight_type> G(v_data, n, m, deletion_fn, edges);
-  return G;
+  return make_compressed_symmetric_graph<weight_type, decoder>(
+      v_data, n, m, deletion_fn, edges);
 }
 
-template <class weight_type>
-asymmetric_graph<cav_bytepd_amortized, weight_type>
-read_compressed_asymmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
+template <class weight_type, class decoder = compressed_encoding>
+auto read_compressed_asymmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
   char* bytes;
   size_t bytes_size;
   std::tie(bytes, bytes_size) = parse_compressed_graph(fname, mmap, mmapcopy);
@@ -213,8 +241,8 @@ read_compressed_asymmetric_graph(const char* fname, bool mmap, bool mmapcopy) {
     };
   }
 
-  asymmetric_graph<cav_bytepd_amortized, weight_type> G(v_data, v_in_data, n, m, deletion_fn, edges, inEdges);
-  return G;
+  return make_compressed_asymmetric_graph<weight_type, decoder>(
+      v_data, v_in_data, n, m, deletion_fn, edges, inEdges);
 }
 
 // Read weighted edges from a file that has the following format:
@@ -69,69 +69,61 @@ inline std::tuple<size_t, size_t, vertex_data*, typename symmetric_vertex<W>::ed
   return std::make_tuple(G.num_vertices(), outEdgeCount, out_vdata, out_edge_arr);
 }
 
-// byte version
+// Compressed version. The filtered adjacency lists are re-encoded in the
+// encoding used by G, so that filtered (e.g., oriented) graphs built from
+// compressed inputs remain compressed. Each list is decoded and filtered
+// once, and encoded into its own buffer; the buffers are then copied into an
+// array sized by the prefix sum of their sizes.
 template <template <class W> class vertex, class W, class Graph, typename P,
           typename std::enable_if<
-              std::is_same<vertex<W>, csv_bytepd_amortized<W>>::value,
+              is_compressed_symmetric_vertex<vertex<W>>::value,
               int>::type = 0>
 inline auto filter_graph(Graph& G, P& pred) {
+  using C = typename vertex<W>::decoder;
+  using edge = std::tuple<uintE, W>;
   size_t n = G.num_vertices();
 
   debug(std::cout << "# Filtering" << "\n");
 
-  // 1. Calculate total size
   auto degrees = sequence<uintE>(n);
   auto byte_offsets = sequence<uintT>(n + 1);
+  auto lists = sequence<uchar*>(n);
   parallel_for(0, n, [&] (size_t i) {
-    size_t total_bytes = 0;
-    uintE last_ngh = 0;
-    size_t deg = 0;
-    uchar tmp[16];
-    auto f = [&](uintE u, uintE v, W w) {
-      if (pred(u, v, w)) {
-        size_t bytes = 0;
-        if (deg == 0) {
-          bytes = byte::compressFirstEdge(tmp, bytes, u, v);
-          bytes = byte::compressWeight<W>(tmp, bytes, w);
-        } else {
-          bytes = byte::compressEdge(tmp, bytes, v - last_ngh);
-          bytes = byte::compressWeight<W>(tmp, bytes, w);
+    auto v = G.get_vertex(i);
+    uintE deg = v.getOutDegree();
+    degrees[i] = 0;
+    byte_offsets[i] = 0;
+    lists[i] = nullptr;
+    if (deg > 0) {
+      auto tmp_edges = sequence<edge>::no_init(deg);
+      size_t new_deg = 0;
+      auto f = [&](const uintE& u, const uintE& ngh, const W& w) {
+        if (pred(u, ngh, w)) {
+          tmp_edges[new_deg++] = std::make_tuple(ngh, w);
         }
-        last_ngh = v;
-        total_bytes += bytes;
-        deg++;
+      };
+      v.mapOutNgh(i, f, false);
+      if (new_deg > 0) {
+        auto size_it = vertex_ops::get_iter(tmp_edges.begin(), new_deg);
+        size_t nbytes = C::template compressed_size<W>(new_deg, i, size_it);
+        lists[i] = pbbslib::new_array_no_init<uchar>(nbytes);
+        auto it = vertex_ops::get_iter(tmp_edges.begin(), new_deg);
+        C::template sequentialCompressEdgeSet<W>(lists[i], 0, new_deg, i, it);
+        degrees[i] = new_deg;
+        byte_offsets[i] = nbytes;
       }
-      return false;
-    };
-    G.get_vertex(i).mapOutNgh(i, f, false);
-
-    degrees[i] = deg;
-    byte_offsets[i] = total_bytes;
+    }
   }, 1);
   byte_offsets[n] = 0;
   size_t last_offset = pbbslib::scan_add_inplace(byte_offsets);
-  std::cout << "# size is: " << last_offset << "\n";
-
-  auto edges = sequence<uchar>(last_offset);
+  debug(std::cout << "# size is: " << last_offset << "\n");
 
+  auto edges = sequence<uchar>::no_init(last_offset);
   parallel_for(0, n, [&] (size_t i) {
-    uintE new_deg = degrees[i];
-    if (new_deg > 0) {
-      auto app_pred = [&](std::tuple<uintE, W> val) {
-        return pred(i, std::get<0>(val), std::get<1>(val));
-      };
-
-      auto iter = G.get_vertex(i).getOutIter(i);
-      auto f_it =
-          pbbslib::make_filter_iter<std::tuple<uintE, W>>(iter, app_pred);
-      size_t nbytes = byte::sequentialCompressEdgeSet<W>(
-          edges.begin() + byte_offsets[i], 0, new_deg, i, f_it);
-      if (nbytes != (byte_offsets[i + 1] - byte_offsets[i])) {
-        std::cout << "# degree is: " << new_deg << " nbytes should be: "
-                  << (byte_offsets[i + 1] - byte_offsets[i])
-                  << " but is: " << nbytes << "\n";
-        assert(nbytes == (byte_offsets[i + 1] - byte_offsets[i]));
-      }
+    if (lists[i]) {
+      memcpy(edges.begin() + byte_offsets[i], lists[i],
+             byte_offsets[i + 1] - byte_offsets[i]);
+      pbbslib::free_array(lists[i]);
     }
   }, 1);
 
@@ -145,10 +137,10 @@ inline auto filter_graph(Graph& G, P& pred) {
   auto deg_f = [&](size_t i) { return degrees[i]; };
   auto deg_map = pbbslib::make_sequence<size_t>(n, deg_f);
   uintT total_deg = pbbslib::reduce_add(deg_map);
-  size_t newM = edges.size();
   auto edge_arr = edges.to_array();
-  std::cout << "# Filtered, total_deg = " << total_deg << "\n";
-  return std::make_tuple(G.num_vertices(), newM, out_vdata, edge_arr);
+  debug(std::cout << "# Filtered, total_deg = " << total_deg
+                  << " bytes = " << last_offset << "\n";);
+  return std::make_tuple(G.num_vertices(), total_deg, out_vdata, edge_arr);
 }
 
 template <
@@ -164,7 +156,7 @@ inline auto filter_graph(Graph& G, P& pred) -> decltype(G) {
 template <
     template <class W> class vertex, class W, class Graph, typename P,
     typename std::enable_if<
-        std::is_same<vertex<W>, cav_bytepd_amortized<W>>::value, int>::type = 0>
+        is_compressed_asymmetric_vertex<vertex<W>>::value, int>::type = 0>
 inline auto filter_graph(Graph& G, P& pred) -> decltype(G) {
   std::cout << "# Filter graph not implemented for directed graphs" << std::endl;
   assert(false);  // Not implemented for directed graphs
@@ -1,5 +1,8 @@
 #include "gbbs/graph_test_utils.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <tuple>
 
 namespace gbbs {
@@ -40,5 +43,142 @@ symmetric_graph<symmetric_vertex, pbbslib::empty> MakeUnweightedSymmetricGraph(
   return sym_graph_from_edges(edge_sequence, num_vertices, kEdgesAreSorted);
 }
 
+uint64_t PseudorandomGenerator::NextState() {
+  state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+  return state_;
+}
+
+std::unordered_set<UndirectedEdge> PseudorandomEdges(
+    const uintE num_vertices, const size_t num_samples, const uint64_t seed) {
+  std::unordered_set<UndirectedEdge> edges;
+  PseudorandomGenerator generator{seed};
+  for (size_t i = 0; i < num_samples; i++) {
+    const uint64_t state{generator.NextState()};
+    const uintE u = (state >> 33) % num_vertices;
+    const uintE v = (state >> 17) % num_vertices;
+    if (u != v) {
+      edges.insert({u, v});
+    }
+  }
+  return edges;
+}
+
+SequentialUnionFind::SequentialUnionFind(const size_t num_vertices)
+  : parents_(num_vertices) {
+  std::iota(parents_.begin(), parents_.end(), 0);
+}
+
+uintE SequentialUnionFind::Find(uintE u) {
+  while (parents_[u] != u) {
+    u = parents_[u] = parents_[parents_[u]];
+  }
+  return u;
+}
+
+bool SequentialUnionFind::Unite(const uintE u, const uintE v) {
+  const uintE root_u{Find(u)};
+  const uintE root_v{Find(v)};
+  if (root_u == root_v) {
+    return false;
+  }
+  parents_[root_u] = root_v;
+  return true;
+}
+
+std::pair<size_t, int64_t> KruskalMSF(
+    const size_t num_vertices, std::vector<gbbs_io::Edge<intE>> edges) {
+  std::stable_sort(
+      edges.begin(),
+      edges.end(),
+      [](const gbbs_io::Edge<intE>& left, const gbbs_io::Edge<intE>& right) {
+        return left.weight < right.weight;
+      });
+  SequentialUnionFind components{num_vertices};
+  size_t size{0};
+  int64_t weight{0};
+  for (const auto& edge : edges) {
+    if (components.Unite(edge.from, edge.to)) {
+      size++;
+      weight += edge.weight;
+    }
+  }
+  return {size, weight};
+}
+
+std::vector<uintE> TarjanSCC(
+    const size_t num_vertices,
+    const std::vector<gbbs_io::Edge<pbbslib::empty>>& edges,
+    uintE* const num_sccs) {
+  std::vector<std::vector<uintE>> adjacency(num_vertices);
+  for (const auto& edge : edges) {
+    adjacency[edge.from].push_back(edge.to);
+  }
+  std::vector<uintE> index(num_vertices, UINT_E_MAX);
+  std::vector<uintE> low(num_vertices);
+  std::vector<uintE> scc(num_vertices, UINT_E_MAX);
+  std::vector<uintE> stack;
+  uintE time{0};
+  uintE num_found{0};
+  std::function<void(uintE)> dfs = [&](const uintE v) {
+    index[v] = low[v] = time++;
+    stack.push_back(v);
+    for (const uintE u : adjacency[v]) {
+      if (index[u] == UINT_E_MAX) {
+        dfs(u);
+        low[v] = std::min(low[v], low[u]);
+      } else if (scc[u] == UINT_E_MAX) {
+        low[v] = std::min(low[v], index[u]);
+      }
+    }
+    if (low[v] == index[v]) {
+      uintE u;
+      do {
+        u = stack.back();
+        stack.pop_back();
+        scc[u] = num_found;
+      } while (u != v);
+      num_found++;
+    }
+  };
+  for (size_t v = 0; v < num_vertices; v++) {
+    if (index[v] == UINT_E_MAX) {
+      dfs(v);
+    }
+  }
+  if (num_sccs != nullptr) {
+    *num_sccs = num_found;
+  }
+  return scc;
+}
+
+std::vector<gbbs_io::Edge<pbbslib::empty>> GiantSCCEdges(
+    const uintE num_vertices) {
+  const uintE giant_size{num_vertices / 4};
+  std::vector<gbbs_io::Edge<pbbslib::empty>> edges;
+  PseudorandomGenerator generator{1};
+  for (uintE v = 0; v < giant_size; v++) {
+    edges.emplace_back(v, (v + 1) % giant_size);
+  }
+  for (size_t i = 0; i < giant_size / 2; i++) {
+    const uintE u = generator.Next() % giant_size;
+    const uintE v = generator.Next() % giant_size;
+    edges.emplace_back(u, v);
+  }
+  for (size_t i = 0; i < num_vertices; i++) {
+    const uintE u = giant_size + generator.Next() % (num_vertices - giant_size);
+    const uintE v = generator.Next() % num_vertices;
+    if (u != v) {
+      edges.emplace_back(u, v);
+    }
+  }
+  for (uintE v = giant_size; v + 1 < num_vertices; v += 7) {
+    edges.emplace_back(v, v + 1);
+    edges.emplace_back(v + 1, v);
+  }
+  // An edge from the tail into the giant SCC.
+  edges.emplace_back(num_vertices - 1, 0);
+  return edges;
+}
+
 }  // namespace graph_test
 }  // namespace gbbs
@@ -2,12 +2,16 @@
 // tests.
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <set>
 #include <utility>
 #include <unordered_set>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "gbbs/graph.h"
+#include "gbbs/graph_io.h"
 #include "gbbs/macros.h"
 #include "gbbs/undirected_edge.h"
 #include "gbbs/vertex.h"
@@ -31,6 +35,79 @@ symmetric_graph<symmetric_vertex, pbbslib::empty> MakeUnweightedSymmetricGraph(
     const uintE num_vertices,
     const std::unordered_set<UndirectedEdge>& edges);
 
+// A 64-bit linear congruential generator, so that pseudorandom test graphs
+// are the same on every platform and standard library.
+class PseudorandomGenerator {
+ public:
+  explicit PseudorandomGenerator(uint64_t seed) : state_{seed} {}
+
+  // Advances the generator and returns its full 64-bit state.
+  uint64_t NextState();
+
+  // Advances the generator and returns its top 31 bits.
+  uint64_t Next() { return NextState() >> 33; }
+
+ private:
+  uint64_t state_;
+};
+
+// Returns `num_samples` pseudorandom pairs of vertices in [0, num_vertices)
+// as undirected edges, without self-loops and duplicates.
+std::unordered_set<UndirectedEdge> PseudorandomEdges(
+    uintE num_vertices, size_t num_samples, uint64_t seed);
+
+// A list of weighted edges that keeps only the first edge added between each
+// pair of vertices and drops self-loops, for graphs that keep one weight per
+// pair.
+template <typename Weight>
+class DistinctEdgeList {
+ public:
+  void Add(uintE u, uintE v, Weight weight) {
+    if (u != v && pairs_.insert({std::min(u, v), std::max(u, v)}).second) {
+      edges_.emplace_back(u, v, weight);
+    }
+  }
+
+  const std::vector<gbbs_io::Edge<Weight>>& edges() const { return edges_; }
+
+ private:
+  std::vector<gbbs_io::Edge<Weight>> edges_;
+  std::set<std::pair<uintE, uintE>> pairs_;
+};
+
+// Sequential union-find with path halving, used as a reference.
+class SequentialUnionFind {
+ public:
+  explicit SequentialUnionFind(size_t num_vertices);
+
+  uintE Find(uintE u);
+  // Returns false if u and v were already connected.
+  bool Unite(uintE u, uintE v);
+  bool Connected(uintE u, uintE v) { return Find(u) == Find(v); }
+
+ private:
+  std::vector<uintE> parents_;
+};
+
+// Returns the number of edges and the total weight of a minimum spanning
+// forest of the undirected graph with the given edges, by sequential Kruskal.
+std::pair<size_t, int64_t> KruskalMSF(
+    size_t num_vertices, std::vector<gbbs_io::Edge<intE>> edges);
+
+// Returns the strongly connected component of every vertex of the directed
+// graph with the given edges by a sequential Tarjan DFS. The components are
+// numbered in reverse topological order, and their number is stored in
+// `num_sccs` if it is not null.
+std::vector<uintE> TarjanSCC(
+    size_t num_vertices,
+    const std::vector<gbbs_io::Edge<pbbslib::empty>>& edges,
+    uintE* num_sccs = nullptr);
+
+// Returns the directed edges of a giant SCC on a cycle with chords over the
+// first quarter of the vertices, plus a tail of sparse pseudorandom edges over
+// the rest that form small SCCs, chains and parallel edges between SCCs.
+std::vector<gbbs_io::Edge<pbbslib::empty>> GiantSCCEdges(uintE num_vertices);
+
 // Check that vertex has `expected_neighbors` as its out-neighbors. Does not
 // check edge weights. Ordering matters.
 template <class Vertex>
@@ -97,13 +97,13 @@ static inline symmetric_graph<symmetric_vertex, wgh_type> filterGraph(
 template <
     template <class inner_wgh> class vtx_type, class wgh_type, typename P,
     typename std::enable_if<
-        std::is_same<vtx_type<wgh_type>, csv_bytepd_amortized<wgh_type>>::value,
+        is_compressed_symmetric_vertex<vtx_type<wgh_type>>::value,
         int>::type = 0>
-static inline symmetric_graph<csv_byte, wgh_type> filterGraph(
+static inline symmetric_graph<vtx_type, wgh_type> filterGraph(
     symmetric_graph<vtx_type, wgh_type>& G, P& pred) {
   auto[newN, newM, newVData, newEdges] = filter_graph<vtx_type, wgh_type>(G, pred);
   assert(newN == G.num_vertices());
-  return symmetric_graph<csv_byte, wgh_type>(
+  return symmetric_graph<vtx_type, wgh_type>(
       newVData, newN, newM,
       [newVData = newVData, newEdges = newEdges]() {
         pbbslib::free_arrays(newVData, newEdges);
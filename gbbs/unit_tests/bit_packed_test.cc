@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "gbbs/encodings/bit_packed.h"
+
+#include <tuple>
+#include <vector>
+
+namespace gbbs {
+
+namespace {
+
+  // Iterator over an uncompressed adjacency list, as expected by
+  // bitpacked::sequentialCompressEdgeSet.
+  template <class W>
+  struct list_iter {
+    const std::vector<std::tuple<uintE, W>>& E;
+    size_t i;
+    std::tuple<uintE, W> cur() { return E[i]; }
+    std::tuple<uintE, W> next() { return E[++i]; }
+  };
+
+  // Builds a sorted neighbor list of the given degree whose miniblocks have
+  // widths between 17 and 29 bits, with weight (ngh % 7) - 3.
+  std::vector<std::tuple<uintE, intE>> make_list(uintE source, size_t degree) {
+    std::vector<std::tuple<uintE, intE>> E;
+    uintE ngh = (source > 10) ? source - 10 : 0;
+    for (size_t i = 0; i < degree; i++) {
+      E.emplace_back(ngh, (intE)(ngh % 7) - 3);
+      switch (i % 5) {
+        case 0: ngh += 1; break;
+        case 1: ngh += 300; break;
+        case 2: ngh += 70000; break;
+        case 3: ngh += (i < 100) ? 20000000 : 70000; break;
+        default: ngh += 3; break;
+      }
+    }
+    return E;
+  }
+
+  std::vector<uchar> encode(uintE source,
+                            const std::vector<std::tuple<uintE, intE>>& E) {
+    auto it = list_iter<intE>{E, 0};
+    size_t bytes = bitpacked::compressed_size<intE>(E.size(), source, it);
+    std::vector<uchar> out(bytes + 16);
+    auto it2 = list_iter<intE>{E, 0};
+    size_t written = bitpacked::sequentialCompressEdgeSet<intE>(
+        out.data(), 0, E.size(), source, it2);
+    EXPECT_EQ(written, bytes);
+    return out;
+  }
+
+}
+
+TEST(TestBitPacked, TestDecode) {
+  uintE source = 1000;
+  for (size_t degree : {1, 2, 3, 4, 5, 9, 999, 1000, 1001, 3007}) {
+    auto E = make_list(source, degree);
+    auto enc = encode(source, E);
+
+    std::vector<std::tuple<uintE, intE>> decoded(degree);
+    auto f = [&](const uintE& src, const uintE& ngh, const intE& wgh,
+                 const uintT& edge_id) {
+      decoded[edge_id] = std::make_tuple(ngh, wgh);
+      return true;
+    };
+    bitpacked::decode<intE>(f, enc.data(), source, degree, true);
+    ASSERT_EQ(decoded, E);
+
+    auto it = bitpacked::iter<intE>(enc.data(), degree, source);
+    ASSERT_EQ(it.cur(), E[0]);
+    for (size_t i = 1; i < degree; i++) {
+      ASSERT_TRUE(it.has_next());
+      ASSERT_EQ(it.next(), E[i]);
+    }
+    ASSERT_FALSE(it.has_next());
+
+    for (size_t i = 0; i < degree; i += 97) {
+      ASSERT_EQ(bitpacked::get_ith_neighbor<intE>(enc.data(), source,
+                                                    degree, i), E[i]);
+    }
+  }
+}
+
+TEST(TestBitPacked, TestUnpackVerticalBounds) {
+  // A full miniblock of width w is 16 * w bytes; the unpacker must not read
+  // past it (the width-0 miniblock has no data at all).
+  for (size_t w = 0; w <= 32; w++) {
+    size_t nbytes = bitpacked::internal::packed_bytes(bitpacked::kMiniblockSize,
+                                                      w);
+    ASSERT_EQ(nbytes, 16 * w);
+    std::vector<uchar> data(nbytes, 0xff);
+    uintE out[bitpacked::kMiniblockSize];
+    bitpacked::internal::kUnpackers[w](nbytes ? data.data() : nullptr, 5, out);
+    uintE expected = 5 + (uintE)bitpacked::internal::width_mask(w);
+    for (size_t k = 0; k < bitpacked::kMiniblockSize; k++) {
+      ASSERT_EQ(out[k], expected) << "w = " << w << ", k = " << k;
+    }
+  }
+}
+
+TEST(TestBitPacked, TestPack) {
+  uintE source = 5;
+  for (size_t degree : {7, 1000, 2500, 20011}) {
+    auto E = make_list(source, degree);
+    auto enc = encode(source, E);
+
+    std::vector<std::tuple<uintE, intE>> expected;
+    for (auto& e : E) {
+      if (std::get<0>(e) % 3 != 0) expected.push_back(e);
+    }
+    auto pred = [&](const uintE& src, const uintE& ngh, const intE& wgh) {
+      return ngh % 3 != 0;
+    };
+    std::vector<std::tuple<uintE, intE>> tmp(degree);
+    size_t new_degree = bitpacked::pack<intE>(pred, enc.data(), source,
+                                                degree, tmp.data());
+    ASSERT_EQ(new_degree, expected.size());
+
+    std::vector<std::tuple<uintE, intE>> decoded;
+    auto f = [&](const uintE& src, const uintE& ngh, const intE& wgh,
+                 const uintT& edge_id) {
+      decoded.emplace_back(ngh, wgh);
+      return true;
+    };
+    bitpacked::decode<intE>(f, enc.data(), source, new_degree, false);
+    ASSERT_EQ(decoded, expected);
+  }
+}
+
+TEST(TestBitPacked, TestRepack) {
+  // Removing all but every 16th edge triggers repacking into fewer blocks.
+  uintE source = 5;
+  size_t degree = 20011;
+  auto E = make_list(source, degree);
+  auto enc = encode(source, E);
+
+  std::vector<std::tuple<uintE, intE>> expected;
+  for (size_t i = 0; i < degree; i += 16) {
+    expected.push_back(E[i]);
+  }
+  size_t idx = 0;
+  std::vector<bool> keep(degree, false);
+  for (size_t i = 0; i < degree; i += 16) keep[i] = true;
+  auto pred = [&](const uintE& src, const uintE& ngh, const intE& wgh) {
+    return keep[idx++];
+  };
+  std::vector<std::tuple<uintE, intE>> tmp(degree);
+  size_t new_degree = bitpacked::pack<intE>(pred, enc.data(), source, degree,
+                                            tmp.data(), /* par = */false);
+  ASSERT_EQ(new_degree, expected.size());
+  ASSERT_EQ(*((uintE*)enc.data()), new_degree);  // the virtual degree
+
+  auto it = bitpacked::iter<intE>(enc.data(), new_degree, source);
+  ASSERT_EQ(it.cur(), expected[0]);
+  for (size_t i = 1; i < new_degree; i++) {
+    ASSERT_EQ(it.next(), expected[i]);
+  }
+  for (size_t i = 0; i < new_degree; i++) {
+    ASSERT_EQ(bitpacked::get_ith_neighbor<intE>(enc.data(), source,
+                                                new_degree, i), expected[i]);
+  }
+}
+
+TEST(TestBitPacked, TestIntersect) {
+  auto E1 = make_list(100, 2000);
+  auto E2 = make_list(100, 1500);
+  auto enc1 = encode(100, E1);
+  auto enc2 = encode(100, E2);
+  size_t ct = bitpacked::intersect<intE>(enc1.data(), enc2.data(),
+                                           E1.size(), E2.size(), 100, 100);
+  ASSERT_EQ(ct, 1500);
+}
+
+}  // namespace gbbs
@@ -0,0 +1,94 @@
+#include "gbbs/bucket.h"
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace gbbs {
+
+namespace {
+
+  // Drains b, returning the (bucket id, identifiers) pairs in order.
+  template <class B>
+  std::vector<std::pair<size_t, std::vector<uintE>>> drain(B& b) {
+    std::vector<std::pair<size_t, std::vector<uintE>>> ret;
+    while (true) {
+      auto bkt = b.next_bucket();
+      if (bkt.id == b.null_bkt) break;
+      std::vector<uintE> ids(bkt.identifiers.begin(), bkt.identifiers.end());
+      std::sort(ids.begin(), ids.end());
+      ret.emplace_back(bkt.id, ids);
+    }
+    return ret;
+  }
+
+}
+
+TEST(TestBuckets, IncreasingSkipsEmptyRanges) {
+  // Priorities spread over many ranges of 3 materialized buckets.
+  auto D = sequence<uintE>(6);
+  D[0] = 1000; D[1] = 0; D[2] = 1000; D[3] = 5; D[4] = 70001;
+  D[5] = UINT_E_MAX;
+  auto b = make_vertex_buckets(D.size(), D, increasing, 4);
+  auto out = drain(b);
+  std::vector<std::pair<size_t, std::vector<uintE>>> expected = {
+      {0, {1}}, {5, {3}}, {1000, {0, 2}}, {70001, {4}}};
+  EXPECT_EQ(out, expected);
+  b.del();
+}
+
+TEST(TestBuckets, DecreasingSkipsEmptyRanges) {
+  auto D = sequence<uintE>(5);
+  D[0] = 3; D[1] = 90000; D[2] = 12; D[3] = 90000; D[4] = 0;
+  auto b = make_vertex_buckets(D.size(), D, decreasing, 4);
+  auto out = drain(b);
+  std::vector<std::pair<size_t, std::vector<uintE>>> expected = {
+      {90000, {1, 3}}, {12, {2}}, {3, {0}}, {0, {4}}};
+  EXPECT_EQ(out, expected);
+  b.del();
+}
+
+TEST(TestBuckets, PeekBuckets) {
+  size_t n = 100000;
+  auto D = sequence<uintE>(n, [&] (size_t i) { return (uintE)(2 * (i % 10)); });
+  auto b = make_vertex_buckets(n, D, increasing, 8);
+  // Materialized buckets hold priorities 0..6.
+  auto peek = b.peek_buckets(3);
+  ASSERT_EQ(peek.size(), 3);
+  EXPECT_EQ(peek[0], std::make_pair((uintE)0, (size_t)10000));
+  EXPECT_EQ(peek[1], std::make_pair((uintE)2, (size_t)10000));
+  EXPECT_EQ(peek[2], std::make_pair((uintE)4, (size_t)10000));
+  EXPECT_EQ(b.peek_buckets(100).size(), 4);
+
+  // Peeking does not remove anything.
+  auto bkt = b.next_bucket();
+  EXPECT_EQ(bkt.id, 0);
+  EXPECT_EQ(bkt.identifiers.size(), 10000);
+  peek = b.peek_buckets(1);
+  ASSERT_EQ(peek.size(), 1);
+  EXPECT_EQ(peek[0].first, 2);
+
+  // Move identifiers from bucket 6 to bucket 3.
+  auto moved = sequence<uintE>(10000, [&] (size_t i) { return (uintE)(10 * i + 3); });
+  par_for(0, moved.size(), [&] (size_t i) { D[moved[i]] = 3; });
+  b.update_buckets([&] (size_t i) {
+    return wrap(moved[i], b.get_bucket(6, 3)); }, moved.size());
+  peek = b.peek_buckets(3);
+  ASSERT_EQ(peek.size(), 3);
+  EXPECT_EQ(peek[0].first, 2);
+  EXPECT_EQ(peek[1], std::make_pair((uintE)3, (size_t)10000));
+  EXPECT_EQ(peek[2].first, 4);
+
+  size_t total = 10000;
+  while (true) {
+    auto bkt = b.next_bucket();
+    if (bkt.id == b.null_bkt) break;
+    for (auto v : bkt.identifiers) EXPECT_EQ(D[v], bkt.id);
+    total += bkt.identifiers.size();
+  }
+  EXPECT_EQ(total, n);
+  b.del();
+}
+
+}  // namespace gbbs
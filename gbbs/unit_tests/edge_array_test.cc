@@ -0,0 +1,179 @@
+#include "gbbs/edge_array.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/undirected_edge.h"
+
+namespace gbbs {
+
+namespace {
+
+using Edge = std::pair<uintE, uintE>;
+
+template <class Graph>
+std::vector<Edge> SortedGraphEdges(Graph& G) {
+  std::vector<Edge> edges;
+  for (size_t u = 0; u < G.n; u++) {
+    auto vertex = G.get_vertex(u);
+    for (size_t i = 0; i < vertex.getOutDegree(); i++) {
+      edges.emplace_back(u, vertex.getOutNeighbor(i));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+// Checks that T holds exactly the edges of G, both in its edge array and when
+// mapped over, and that its tiles and tasks are laid out as documented.
+template <class Graph>
+void CheckTiledEdgeArray(Graph& G, size_t tile_bits, tile_order order) {
+  auto T = to_tiled_edge_array<pbbslib::empty>(G, tile_bits, order);
+  auto expected = SortedGraphEdges(G);
+  ASSERT_EQ(T.size(), expected.size());
+  for (size_t v = 0; v < G.n; v++) {
+    EXPECT_EQ(T.get_out_degree(v), G.get_vertex(v).getOutDegree());
+  }
+
+  std::vector<Edge> stored;
+  for (size_t i = 0; i < T.m; i++) {
+    stored.emplace_back(std::get<0>(T.E[i]), std::get<1>(T.E[i]));
+  }
+  std::sort(stored.begin(), stored.end());
+  EXPECT_EQ(stored, expected);
+
+  std::vector<Edge> mapped;
+  std::mutex mapped_mutex;
+  T.map_edges([&](const uintE& u, const uintE& v, const pbbslib::empty&) {
+    std::lock_guard<std::mutex> lock(mapped_mutex);
+    mapped.emplace_back(u, v);
+  });
+  std::sort(mapped.begin(), mapped.end());
+  EXPECT_EQ(mapped, expected);
+
+  // Tasks cover the edges in order, stay within one tile, and are no larger
+  // than kTileTaskSize.
+  auto block = [&](uintE v) { return v >> tile_bits; };
+  ASSERT_EQ(T.task_offsets.size(), T.num_tasks() + 1);
+  EXPECT_EQ(T.task_offsets[0], 0);
+  EXPECT_EQ(T.task_offsets[T.num_tasks()], T.m);
+  std::vector<size_t> tasks_in_column(T.num_blocks(), 0);
+  for (size_t i = 0; i < T.num_tasks(); i++) {
+    size_t start = T.task_offsets[i], end = T.task_offsets[i + 1];
+    ASSERT_LT(start, end);
+    EXPECT_LE(end - start, kTileTaskSize);
+    size_t column = block(std::get<1>(T.E[start]));
+    tasks_in_column[column]++;
+    for (size_t j = start; j < end; j++) {
+      EXPECT_EQ(block(std::get<0>(T.E[j])), T.task_rows[i]);
+      EXPECT_EQ(block(std::get<1>(T.E[j])), column);
+    }
+  }
+
+  // Each tile is contiguous, so the number of tile boundaries gives the
+  // number of tiles.
+  size_t num_tiles = 0;
+  for (size_t i = 0; i < T.m; i++) {
+    num_tiles += (i == 0) ||
+                 block(std::get<0>(T.E[i - 1])) != block(std::get<0>(T.E[i])) ||
+                 block(std::get<1>(T.E[i - 1])) != block(std::get<1>(T.E[i]));
+  }
+  EXPECT_EQ(T.num_tiles, num_tiles);
+
+  // The columns list every task once, grouped by target block.
+  ASSERT_EQ(T.column_offsets.size(), T.num_blocks() + 1);
+  ASSERT_EQ(T.column_tasks.size(), T.num_tasks());
+  std::vector<bool> seen(T.num_tasks(), false);
+  for (size_t c = 0; c < T.num_blocks(); c++) {
+    EXPECT_EQ(T.column_offsets[c + 1] - T.column_offsets[c],
+              tasks_in_column[c]);
+    for (size_t k = T.column_offsets[c]; k < T.column_offsets[c + 1]; k++) {
+      size_t i = T.column_tasks[k];
+      ASSERT_LT(i, T.num_tasks());
+      EXPECT_FALSE(seen[i]);
+      seen[i] = true;
+      EXPECT_EQ(block(std::get<1>(T.E[T.task_offsets[i]])), c);
+    }
+  }
+  T.del();
+}
+
+}  // namespace
+
+TEST(HilbertIndex, IsABijectionAlongAContinuousCurve) {
+  for (size_t side = 1; side <= 64; side *= 2) {
+    std::vector<Edge> cell_at(side * side, {UINT_E_MAX, UINT_E_MAX});
+    for (size_t x = 0; x < side; x++) {
+      for (size_t y = 0; y < side; y++) {
+        size_t d = hilbert_index(side, x, y);
+        ASSERT_LT(d, side * side) << "side = " << side;
+        EXPECT_EQ(cell_at[d].first, UINT_E_MAX)
+            << "side = " << side << ", d = " << d;
+        cell_at[d] = {x, y};
+      }
+    }
+    EXPECT_EQ(cell_at[0], Edge(0, 0));
+    // Consecutive cells along the curve are adjacent in the grid.
+    for (size_t d = 1; d < side * side; d++) {
+      int dx = std::abs((int)cell_at[d].first - (int)cell_at[d - 1].first);
+      int dy = std::abs((int)cell_at[d].second - (int)cell_at[d - 1].second);
+      EXPECT_EQ(dx + dy, 1) << "side = " << side << ", d = " << d;
+    }
+  }
+}
+
+TEST(TiledEdgeArray, PseudorandomGraph) {
+  constexpr uintE kNumVertices{1000};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(
+      kNumVertices, graph_test::PseudorandomEdges(kNumVertices, 5000, 1))};
+  for (size_t tile_bits : {0, 3, 6, 10, 20}) {
+    for (tile_order order : {grid_order, hilbert_order}) {
+      SCOPED_TRACE(testing::Message() << "tile_bits = " << tile_bits
+                                      << ", order = " << order);
+      CheckTiledEdgeArray(graph, tile_bits, order);
+    }
+  }
+}
+
+TEST(TiledEdgeArray, LargeTilesAreSplitIntoTasks) {
+  // A star with about 3 * kTileTaskSize leaves, plus a few isolated vertices
+  // at the end. With a single block, its one tile is split into tasks.
+  constexpr uintE kNumVertices{3 * kTileTaskSize};
+  std::unordered_set<UndirectedEdge> edges;
+  for (uintE v = 1; v + 3 < kNumVertices; v++) edges.insert({0, v});
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+  for (size_t tile_bits : {4, 20}) {
+    for (tile_order order : {grid_order, hilbert_order}) {
+      SCOPED_TRACE(testing::Message() << "tile_bits = " << tile_bits
+                                      << ", order = " << order);
+      CheckTiledEdgeArray(graph, tile_bits, order);
+    }
+  }
+  auto T = to_tiled_edge_array<pbbslib::empty>(graph, 20);
+  EXPECT_EQ(T.num_tiles, 1);
+  EXPECT_EQ(T.num_tasks(), pbbs::num_blocks(T.m, kTileTaskSize));
+  T.del();
+}
+
+TEST(TiledEdgeArray, EmptyGraph) {
+  constexpr uintE kNumVertices{10};
+  auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, {})};
+  auto T = to_tiled_edge_array<pbbslib::empty>(graph, 2);
+  EXPECT_EQ(T.size(), 0);
+  EXPECT_EQ(T.num_tiles, 0);
+  EXPECT_EQ(T.num_tasks(), 0);
+  size_t visited = 0;
+  T.map_edges([&](const uintE&, const uintE&, const pbbslib::empty&) {
+    visited++;
+  });
+  EXPECT_EQ(visited, 0);
+  T.del();
+}
+
+}  // namespace gbbs
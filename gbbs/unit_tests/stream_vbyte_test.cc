@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "gbbs/encodings/stream_vbyte.h"
+
+#include <tuple>
+#include <vector>
+
+namespace gbbs {
+
+namespace {
+
+  // Iterator over an uncompressed adjacency list, as expected by
+  // streamvbyte::sequentialCompressEdgeSet.
+  template <class W>
+  struct list_iter {
+    const std::vector<std::tuple<uintE, W>>& E;
+    size_t i;
+    std::tuple<uintE, W> cur() { return E[i]; }
+    std::tuple<uintE, W> next() { return E[++i]; }
+  };
+
+  // Builds a sorted neighbor list of the given degree whose differences use
+  // every code length (1--4 bytes), with weight (ngh % 7) - 3.
+  std::vector<std::tuple<uintE, intE>> make_list(uintE source, size_t degree) {
+    std::vector<std::tuple<uintE, intE>> E;
+    uintE ngh = (source > 10) ? source - 10 : 0;
+    for (size_t i = 0; i < degree; i++) {
+      E.emplace_back(ngh, (intE)(ngh % 7) - 3);
+      switch (i % 5) {
+        case 0: ngh += 1; break;
+        case 1: ngh += 300; break;
+        case 2: ngh += 70000; break;
+        case 3: ngh += (i < 100) ? 20000000 : 70000; break;
+        default: ngh += 3; break;
+      }
+    }
+    return E;
+  }
+
+  std::vector<uchar> encode(uintE source,
+                            const std::vector<std::tuple<uintE, intE>>& E) {
+    auto it = list_iter<intE>{E, 0};
+    size_t bytes = streamvbyte::compressed_size<intE>(E.size(), source, it);
+    std::vector<uchar> out(bytes + 16);
+    auto it2 = list_iter<intE>{E, 0};
+    size_t written = streamvbyte::sequentialCompressEdgeSet<intE>(
+        out.data(), 0, E.size(), source, it2);
+    EXPECT_EQ(written, bytes);
+    return out;
+  }
+
+}
+
+TEST(TestStreamVByte, TestDecode) {
+  uintE source = 1000;
+  for (size_t degree : {1, 2, 3, 4, 5, 9, 999, 1000, 1001, 3007}) {
+    auto E = make_list(source, degree);
+    auto enc = encode(source, E);
+
+    std::vector<std::tuple<uintE, intE>> decoded(degree);
+    auto f = [&](const uintE& src, const uintE& ngh, const intE& wgh,
+                 const uintT& edge_id) {
+      decoded[edge_id] = std::make_tuple(ngh, wgh);
+      return true;
+    };
+    streamvbyte::decode<intE>(f, enc.data(), source, degree, true);
+    ASSERT_EQ(decoded, E);
+
+    auto it = streamvbyte::iter<intE>(enc.data(), degree, source);
+    ASSERT_EQ(it.cur(), E[0]);
+    for (size_t i = 1; i < degree; i++) {
+      ASSERT_TRUE(it.has_next());
+      ASSERT_EQ(it.next(), E[i]);
+    }
+    ASSERT_FALSE(it.has_next());
+
+    for (size_t i = 0; i < degree; i += 97) {
+      ASSERT_EQ(streamvbyte::get_ith_neighbor<intE>(enc.data(), source,
+                                                    degree, i), E[i]);
+    }
+  }
+}
+
+TEST(TestStreamVByte, TestPack) {
+  uintE source = 5;
+  for (size_t degree : {7, 1000, 2500, 20011}) {
+    auto E = make_list(source, degree);
+    auto enc = encode(source, E);
+
+    std::vector<std::tuple<uintE, intE>> expected;
+    for (auto& e : E) {
+      if (std::get<0>(e) % 3 != 0) expected.push_back(e);
+    }
+    auto pred = [&](const uintE& src, const uintE& ngh, const intE& wgh) {
+      return ngh % 3 != 0;
+    };
+    std::vector<std::tuple<uintE, intE>> tmp(degree);
+    size_t new_degree = streamvbyte::pack<intE>(pred, enc.data(), source,
+                                                degree, tmp.data());
+    ASSERT_EQ(new_degree, expected.size());
+
+    std::vector<std::tuple<uintE, intE>> decoded;
+    auto f = [&](const uintE& src, const uintE& ngh, const intE& wgh,
+                 const uintT& edge_id) {
+      decoded.emplace_back(ngh, wgh);
+      return true;
+    };
+    streamvbyte::decode<intE>(f, enc.data(), source, new_degree, false);
+    ASSERT_EQ(decoded, expected);
+  }
+}
+
+TEST(TestStreamVByte, TestIntersect) {
+  auto E1 = make_list(100, 2000);
+  auto E2 = make_list(100, 1500);
+  auto enc1 = encode(100, E1);
+  auto enc2 = encode(100, E2);
+  size_t ct = streamvbyte::intersect<intE>(enc1.data(), enc2.data(),
+                                           E1.size(), E2.size(), 100, 100);
+  ASSERT_EQ(ct, 1500);
+}
+
+}  // namespace gbbs
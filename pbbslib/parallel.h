@@ -43,6 +43,14 @@ template <typename A, typename Af, typename Df, typename F>
 static void parallel_for_alloc(Af init_alloc, Df finish_alloc, long start,
                                long end, F f, long granularity = 0,
                                bool conservative = false);
+
+// runs the thunk f as a root computation, and returns once it finishes.
+//    may be called concurrently from several threads, whose roots then
+//    share the workers. With the homegrown scheduler, a root with a higher
+//    priority preempts lower-priority roots at their next fork; the other
+//    schedulers ignore the priority.
+template <typename F>
+static void run_root(F f, int priority = 0);
 }  // namespace pbbs
 
 //***************************************
@@ -113,6 +121,11 @@ inline void parallel_for_alloc(Af init_alloc, Df finish_alloc, long start,
                  granularity, conservative);
 }
 
+template <typename F>
+inline void run_root(F f, int priority) {
+  f();
+}
+
 inline int num_workers() { return __cilkrts_get_nworkers(); }
 inline int worker_id() { return __cilkrts_get_worker_number(); }
 #ifdef SAGE
@@ -171,6 +184,11 @@ inline void parallel_run(Job job, int num_threads = 0) {
   job();
 }
 
+template <typename F>
+inline void run_root(F f, int priority) {
+  f();
+}
+
 template <typename A, typename Af, typename Df, typename F>
 inline void parallel_for_alloc(Af init_alloc, Df finish_alloc, long start,
                                long end, F f, long granularity,
@@ -223,6 +241,11 @@ inline void parallel_run(Job job, int num_threads = 0) {
   job();
 }
 
+template <typename F>
+inline void run_root(F f, int priority) {
+  pbbs::global_scheduler.run(f, priority);
+}
+
 template <typename A, typename Af, typename Df, typename F>
 inline void parallel_for_alloc(Af init_alloc, Df finish_alloc, long start,
                                long end, F f, long granularity,
@@ -271,6 +294,11 @@ inline void parallel_run(Job job, int num_threads = 0) {
   job();
 }
 
+template <typename F>
+inline void run_root(F f, int priority) {
+  f();
+}
+
 template <typename A, typename Af, typename Df, typename F>
 inline void parallel_for_alloc(Af init_alloc, Df finish_alloc, long start,
                                long end, F f, long granularity,
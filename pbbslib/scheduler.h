@@ -1,10 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #ifdef SAGE
 #include <pthread.h>
@@ -39,6 +44,13 @@ namespace pbbs {
 // long* a = new long[n];
 //
 // init(a, n);
+//
+// EXAMPLE USE 3:
+//
+// // Called concurrently from several client threads. Each call is a root
+// // computation; roots share the workers, and a root with a higher priority
+// // preempts lower-priority roots at their next fork.
+// fj.run([&] () { init(a, n); }, /* priority = */ 1);
 
 // Deque from Arora, Blumofe, and Plaxton (SPAA, 1998).
 template <typename Job>
@@ -151,6 +163,14 @@ struct scheduler {
   int num_threads;
 
   static thread_local int thread_id;
+  // Whether this thread is a worker: always true for the spawned workers, and
+  // true for an outside thread while it runs a root computation as worker 0.
+  static thread_local bool active;
+  // The priority of the root computation that the running job belongs to.
+  static thread_local int priority;
+
+  // The priority of a spawned worker that is not running any job.
+  static constexpr int idle_priority = std::numeric_limits<int>::min();
 
 #ifdef SAGE
     static thread_local int numa_node;
@@ -169,6 +189,8 @@ struct scheduler {
       for (int i=1; i<num_threads; i++) {
         spawned_threads[i-1] = std::thread([&, i, finished] () {
           thread_id = i; // thread-local write
+          active = true;
+          priority = idle_priority;
           numa_node = numa_node_of_cpu(i);
           start(finished);
         });
@@ -199,6 +221,8 @@ struct scheduler {
     for (int i = 1; i < num_threads; i++) {
       spawned_threads[i - 1] = std::thread([&, i, finished]() {
         thread_id = i;  // thread-local write
+        active = true;
+        priority = idle_priority;
         start(finished);
       });
     }
@@ -234,6 +258,77 @@ struct scheduler {
       start(finished);
   }
 
+  // Runs job as a root computation, and returns once it has finished. May be
+  // called concurrently from any number of threads. A call from a worker
+  // (i.e. from within a computation) just runs job. Otherwise, if no outside
+  // thread currently holds worker 0's slot, the calling thread takes it and
+  // runs job as worker 0. Otherwise job waits until either a worker picks it
+  // up (see try_run_pending) or the slot is released, where pending roots
+  // are ordered by priority and then by arrival.
+  void run_root(Job* job, int prio) {
+    if (active) {
+      (*job)();
+      return;
+    }
+    std::unique_lock<std::mutex> lock(roots_mutex);
+    root_task r{job, prio, root_seq++, false, false};
+    if (!root_slot_busy) {
+      root_slot_busy = true;
+      lock.unlock();
+      run_in_root_slot(r);
+      return;
+    }
+    pending_roots.push_back(&r);
+    num_pending++;
+    while (!r.done) {
+      if (!r.started && !root_slot_busy && best_pending() == &r) {
+        remove_pending(&r);
+        r.started = true;
+        root_slot_busy = true;
+        lock.unlock();
+        run_in_root_slot(r);
+        return;
+      }
+      roots_cv.wait(lock);
+    }
+  }
+
+  // Runs the most urgent pending root computation on this worker, if its
+  // priority is higher than that of the job currently being run. Called at
+  // forks and while looking for work, so a high-priority root preempts
+  // lower-priority roots, and idle workers pick up new roots before stealing.
+  // Returns true if a root was run.
+  bool try_run_pending() {
+    if (num_pending.load(std::memory_order_relaxed) == 0) return false;
+    root_task* r;
+    {
+      std::lock_guard<std::mutex> lock(roots_mutex);
+      r = best_pending();
+      if (r == nullptr || r->priority <= priority) return false;
+      remove_pending(r);
+      r->started = true;
+    }
+    int saved_priority = priority;
+    priority = r->priority;
+    (*r->job)();
+    priority = saved_priority;
+    {
+      std::lock_guard<std::mutex> lock(roots_mutex);
+      r->done = true;  // r may be destroyed once the lock is released
+    }
+    roots_cv.notify_all();
+    return true;
+  }
+
+  bool is_active() { return active; }
+  int current_priority() { return priority; }
+  // Sets the priority of the running job, returning the previous one.
+  int exchange_priority(int p) {
+    int old = priority;
+    priority = p;
+    return old;
+  }
+
   // All scheduler threads quit after this is called.
   void finish() { finished_flag = 1; }
 
@@ -269,12 +364,69 @@ struct scheduler {
     size_t val;
   };
 
+  // A root computation submitted by an outside thread.
+  struct root_task {
+    Job* job;
+    int priority;
+    uint64_t seq;
+    bool started;  // picked up by a worker or by the submitting thread
+    bool done;
+  };
+
   int num_deques;
   Deque<Job>* deques;
   attempt* attempts;
   std::thread* spawned_threads;
   int finished_flag;
 
+  // Root computations waiting to run, guarded by roots_mutex.
+  std::mutex roots_mutex;
+  std::condition_variable roots_cv;
+  std::vector<root_task*> pending_roots;
+  std::atomic<size_t> num_pending{0};
+  uint64_t root_seq = 0;
+  // Whether an outside thread is running a root computation as worker 0.
+  bool root_slot_busy = false;
+
+  // Returns the pending root with the highest priority, breaking ties by
+  // arrival. Requires roots_mutex.
+  root_task* best_pending() {
+    root_task* best = nullptr;
+    for (root_task* r : pending_roots) {
+      if (best == nullptr || r->priority > best->priority ||
+          (r->priority == best->priority && r->seq < best->seq)) {
+        best = r;
+      }
+    }
+    return best;
+  }
+
+  // Requires roots_mutex.
+  void remove_pending(root_task* r) {
+    for (size_t i = 0; i < pending_roots.size(); i++) {
+      if (pending_roots[i] == r) {
+        pending_roots[i] = pending_roots.back();
+        pending_roots.pop_back();
+        num_pending--;
+        return;
+      }
+    }
+  }
+
+  // Runs r on the calling outside thread, which holds worker 0's slot.
+  void run_in_root_slot(root_task& r) {
+    thread_id = 0;
+    active = true;
+    priority = r.priority;
+    (*r.job)();
+    active = false;
+    {
+      std::lock_guard<std::mutex> lock(roots_mutex);
+      root_slot_busy = false;
+    }
+    roots_cv.notify_all();
+  }
+
   // Start an individual scheduler task.  Runs until finished().
   template <typename F>
   void start(F finished) {
@@ -303,6 +455,7 @@ struct scheduler {
       // By coupon collector's problem, this should touch all.
       for (int i = 0; i <= num_deques * 100; i++) {
         if (finished()) return NULL;
+        if (try_run_pending() && finished()) return NULL;
         job = try_steal(id);
         if (job) return job;
       }
@@ -322,6 +475,12 @@ struct scheduler {
 template <typename T>
 thread_local int scheduler<T>::thread_id = 0;
 
+template <typename T>
+thread_local bool scheduler<T>::active = false;
+
+template <typename T>
+thread_local int scheduler<T>::priority = 0;
+
 #ifdef SAGE
 template<typename T>
 thread_local int scheduler<T>::numa_node = 0;
@@ -349,12 +508,35 @@ struct fork_join_scheduler {
   int numanode() { return sched->numanode(); }
 #endif
 
+  // Runs f as a root computation with the given priority, and returns once
+  // it has finished. Unlike pardo and parfor, which run as a root with
+  // priority 0 when called from outside of the scheduler, run may be called
+  // concurrently from several threads: the roots share the workers, and the
+  // most urgent pending root runs as soon as a worker is idle, or as soon as
+  // a worker running a lower-priority root forks. All parallel work of a
+  // client thread should be done inside run, since code outside of a root
+  // does not own a worker id.
+  template <typename F>
+  void run(F f, int priority = 0) {
+    Job job = [&]() { f(); };
+    sched->run_root(&job, priority);
+  }
+
   // Fork two thunks and wait until they both finish.
   template <typename L, typename R>
   void pardo(L left, R right, bool conservative = false) {
+    if (!sched->is_active()) {
+      run([&]() { pardo(left, right, conservative); });
+      return;
+    }
+    sched->try_run_pending();
     bool right_done = false;
-    Job right_job = [&]() {
+    int priority = sched->current_priority();
+    Job right_job = [&, priority]() {
+      // right may be stolen by a worker running another root.
+      int saved_priority = sched->exchange_priority(priority);
       right();
+      sched->exchange_priority(saved_priority);
       right_done = true;
     };
     sched->spawn(&right_job);
@@ -387,6 +569,10 @@ struct fork_join_scheduler {
   template <typename F>
   void parfor(size_t start, size_t end, F f, size_t granularity = 0,
               bool conservative = false) {
+    if (!sched->is_active()) {
+      run([&]() { parfor(start, end, f, granularity, conservative); });
+      return;
+    }
     if (granularity == 0) {
       size_t done = get_granularity(start, end, f);
       granularity = std::max(done, (end - start) / (128 * sched->num_threads));
@@ -0,0 +1,77 @@
+#include "pbbslib/parallel.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Sums 0, ..., n-1 using a parallel reduction tree of par_dos.
+long parallel_sum(long start, long end) {
+  if (end - start <= 64) {
+    long sum = 0;
+    for (long i = start; i < end; i++) sum += i;
+    return sum;
+  }
+  long mid = start + (end - start) / 2;
+  long left, right;
+  pbbs::par_do([&]() { left = parallel_sum(start, mid); },
+               [&]() { right = parallel_sum(mid, end); });
+  return left + right;
+}
+
+}  // namespace
+
+TEST(Scheduler, ConcurrentRoots) {
+  constexpr long kN = 1 << 18;
+  constexpr int kThreads = 8;
+  std::vector<long> sums(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int r = 0; r < 10; r++) {
+        pbbs::run_root([&]() { sums[t] = parallel_sum(0, kN + t); }, t % 3);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  for (int t = 0; t < kThreads; t++) {
+    long n = kN + t;
+    EXPECT_EQ(sums[t], n * (n - 1) / 2);
+  }
+}
+
+TEST(Scheduler, HighPriorityRootPreemptsLowPriorityRoot) {
+  std::atomic<bool> high_done{false};
+  std::atomic<bool> low_started{false};
+  bool high_finished_first = false;
+  std::thread low([&]() {
+    pbbs::run_root([&]() {
+      low_started = true;
+      // Keeps forking until the high-priority root has run.
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (!high_done && std::chrono::steady_clock::now() < deadline) {
+        parallel_sum(0, 1 << 12);
+      }
+      high_finished_first = high_done;
+    }, 0);
+  });
+  while (!low_started) std::this_thread::yield();
+  pbbs::run_root([&]() {
+    parallel_sum(0, 1 << 12);
+    high_done = true;
+  }, 1);
+  low.join();
+  EXPECT_TRUE(high_finished_first);
+}
+
+TEST(Scheduler, RootFromWorkerRunsInline) {
+  long sum = 0;
+  pbbs::run_root([&]() {
+    pbbs::run_root([&]() { sum = parallel_sum(0, 1000); }, 5);
+  });
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+}
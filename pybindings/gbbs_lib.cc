@@ -9,9 +9,14 @@
 #include "benchmarks/Biconnectivity/TarjanVishkin/Biconnectivity.h"
 #include "benchmarks/CliqueCounting/Clique.h"
 #include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
+#include "benchmarks/GeneralWeightSSSP/BellmanFord/BellmanFord.h"
+#include "benchmarks/GraphColoring/Hasenplaugh14/GraphColoring.h"
 #include "benchmarks/KCore/JulienneDBS17/KCore.h"
 #include "benchmarks/CoSimRank/CoSimRank.h"
+#include "benchmarks/MaximalIndependentSet/RandomGreedy/MaximalIndependentSet.h"
+#include "benchmarks/PageRank/PageRank.h"
 #include "benchmarks/StronglyConnectedComponents/RandomGreedyBGSS16/StronglyConnectedComponents.h"
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/Triangle.h"
 
 #include "pybind11/pybind11.h"
 #include "pybind11/numpy.h"
@@ -49,12 +54,158 @@ auto wrap_array(E* arr, size_t n) {
       free_when_done); // numpy array references this parent
 }
 
+template <class E>
+auto wrap_array(sequence<E>&& seq) {
+  size_t n = seq.size();
+  return wrap_array(seq.to_array(), n);
+}
+
+/* Runs f with the GIL released, so that other Python threads can make progress
+ * while gbbs runs in parallel. f must not touch any Python objects. */
+template <class F>
+auto without_gil(F f) {
+  py::gil_scoped_release release;
+  return f();
+}
+
+/* Holder for graphs owned by Python: frees the graph's storage (by calling its
+ * deletion_fn) when the Python object is garbage collected. */
+template <class Graph>
+struct graph_deleter {
+  void operator()(Graph* G) {
+    G->del();
+    delete G;
+  }
+};
+
+template <class Graph>
+using graph_holder = std::unique_ptr<Graph, graph_deleter<Graph>>;
+
+/* ========================== CSR (NumPy/SciPy) input ========================
+ * Graphs can be built directly from the `indptr`, `indices` (and `data`)
+ * arrays of a CSR matrix, e.g., scipy.sparse.csr_matrix. The vertex_data of
+ * the graph (O(n) words) is always built from indptr. For unweighted graphs,
+ * `indices` is used in place as the edge array if it is a C-contiguous array
+ * of 32-bit integers (the default for SciPy), in which case the returned graph
+ * keeps `indices` alive, and must not be used after `indices` is modified.
+ * Otherwise, and for weighted graphs, the edges are copied. */
+using empty_edge = std::tuple<uintE, pbbs::empty>;
+static_assert(sizeof(empty_edge) == sizeof(uintE),
+              "unweighted edges must have the same layout as uintE");
+
+/* Builds the vertex_data of a graph from a CSR row-pointer array. Returns
+ * (vertex_data, n, m). */
+inline std::tuple<vertex_data*, size_t, size_t> csr_vertex_data(
+    py::array& indptr, py::array& indices) {
+  auto offsets = py::array_t<uintT, py::array::c_style | py::array::forcecast>::ensure(indptr);
+  if (!offsets || offsets.ndim() != 1 || offsets.size() == 0) {
+    throw std::invalid_argument("indptr must be a 1-D array of n+1 offsets");
+  }
+  size_t n = offsets.size() - 1;
+  const uintT* o = offsets.data();
+  if (o[n] < o[0] || o[n] > (uintT)indices.size()) {
+    throw std::invalid_argument("indptr is inconsistent with indices");
+  }
+  auto v_data = pbbs::new_array_no_init<vertex_data>(n);
+  parallel_for(0, n, [&] (size_t i) {
+    v_data[i].offset = o[i];
+    v_data[i].degree = o[i + 1] - o[i];
+  });
+  return std::make_tuple(v_data, n, (size_t)(o[n] - o[0]));
+}
+
+/* Returns the unweighted edges stored in `indices`, and whether they were
+ * copied into a new array (which must then be freed by the graph). */
+inline std::pair<empty_edge*, bool> csr_edges(py::array& indices) {
+  auto kind = indices.dtype().kind();
+  if ((kind == 'i' || kind == 'u') && indices.itemsize() == sizeof(uintE) &&
+      indices.ndim() == 1 && (indices.flags() & py::array::c_style)) {
+    auto data = static_cast<const uintE*>(indices.data());
+    return {reinterpret_cast<empty_edge*>(const_cast<uintE*>(data)), false};
+  }
+  auto ids = py::array_t<uintE, py::array::c_style | py::array::forcecast>::ensure(indices);
+  if (!ids) {
+    throw std::invalid_argument("indices must be an array of vertex ids");
+  }
+  size_t m = ids.size();
+  const uintE* id = ids.data();
+  auto edges = pbbs::new_array_no_init<empty_edge>(m);
+  parallel_for(0, m, [&] (size_t i) {
+    edges[i] = std::make_tuple(id[i], pbbs::empty());
+  });
+  return {edges, true};
+}
+
+/* Copies the edges and weights stored in `indices` and `data` into a new array
+ * of weighted edges. */
+template <class W>
+inline std::tuple<uintE, W>* csr_weighted_edges(py::array& indices, py::array& data) {
+  auto ids = py::array_t<uintE, py::array::c_style | py::array::forcecast>::ensure(indices);
+  auto wghs = py::array_t<W, py::array::c_style | py::array::forcecast>::ensure(data);
+  if (!ids || !wghs || ids.size() != wghs.size()) {
+    throw std::invalid_argument("indices and data must have the same length");
+  }
+  size_t m = ids.size();
+  const uintE* id = ids.data();
+  const W* w = wghs.data();
+  auto edges = pbbs::new_array_no_init<std::tuple<uintE, W>>(m);
+  parallel_for(0, m, [&] (size_t i) {
+    edges[i] = std::make_tuple(id[i], w[i]);
+  });
+  return edges;
+}
+
+inline symmetric_graph<symmetric_vertex, pbbs::empty> symmetric_graph_from_csr(
+    py::array& indptr, py::array& indices) {
+  auto [v_data, n, m] = csr_vertex_data(indptr, indices);
+  auto [edges, copied] = csr_edges(indices);
+  return symmetric_graph<symmetric_vertex, pbbs::empty>(
+      v_data, n, m,
+      [v_data = v_data, edges = edges, copied = copied]() {
+        pbbs::free_array(v_data);
+        if (copied) pbbs::free_array(edges);
+      }, edges);
+}
+
+template <class W>
+inline symmetric_graph<symmetric_vertex, W> symmetric_weighted_graph_from_csr(
+    py::array& indptr, py::array& indices, py::array& data) {
+  auto [v_data, n, m] = csr_vertex_data(indptr, indices);
+  auto edges = csr_weighted_edges<W>(indices, data);
+  return symmetric_graph<symmetric_vertex, W>(
+      v_data, n, m,
+      [v_data = v_data, edges = edges]() {
+        pbbslib::free_arrays(v_data, edges);
+      }, edges);
+}
+
+inline asymmetric_graph<asymmetric_vertex, pbbs::empty> asymmetric_graph_from_csr(
+    py::array& indptr, py::array& indices,
+    py::array& in_indptr, py::array& in_indices) {
+  auto [out_data, n, m] = csr_vertex_data(indptr, indices);
+  auto [in_data, in_n, in_m] = csr_vertex_data(in_indptr, in_indices);
+  if (n != in_n || m != in_m) {
+    pbbslib::free_arrays(out_data, in_data);
+    throw std::invalid_argument("the in-edge CSR must be the transpose of the out-edge CSR");
+  }
+  auto [out_edges, out_copied] = csr_edges(indices);
+  auto [in_edges, in_copied] = csr_edges(in_indices);
+  return asymmetric_graph<asymmetric_vertex, pbbs::empty>(
+      out_data, in_data, n, m,
+      [out_data = out_data, in_data = in_data, out_edges = out_edges,
+       in_edges = in_edges, out_copied = out_copied, in_copied = in_copied]() {
+        pbbslib::free_arrays(out_data, in_data);
+        if (out_copied) pbbs::free_array(out_edges);
+        if (in_copied) pbbs::free_array(in_edges);
+      }, out_edges, in_edges);
+}
+
 /* Defines symmetric graph functions */
 template <template <class W> class vertex_type, class W>
 void SymGraphRegister(py::module& m, std::string graph_name) {
   /* register graph */
   using graph = symmetric_graph<vertex_type, W>;
-  py::class_<graph>(m, graph_name.c_str())
+  py::class_<graph, graph_holder<graph>>(m, graph_name.c_str())
     .def("numVertices", [](const graph& G) -> size_t {
       return G.n;
     })
@@ -62,23 +213,38 @@ void SymGraphRegister(py::module& m, std::string graph_name) {
       return G.m;
     })
     .def("BFS", [&] (graph& G, const size_t src) {
-      auto parents = BFS(G, src);
-      return 1.0;
+      return wrap_array(without_gil([&] { return BFS(G, src); }));
     }, py::arg("src"))
     .def("Connectivity", [&] (graph& G) {
-      auto ccs = workefficient_cc::CC(G);
-      uintE* arr = ccs.to_array();
-      return wrap_array(arr, G.n);
+      return wrap_array(without_gil([&] { return workefficient_cc::CC(G); }));
     })
     .def("KCore", [&] (graph& G) {
-      auto cores = KCore(G);
-      uintE* arr = cores.to_array();
-      return wrap_array(arr, G.n);
+      return wrap_array(without_gil([&] { return KCore(G); }));
     })
     .def("CoSimRank", [&] (graph& G, const size_t src, const size_t dest) {
-      CoSimRank(G, src, dest);
+      without_gil([&] { CoSimRank(G, src, dest); });
       return 1.0;
-    }, py::arg("src"), py::arg("dest"));
+    }, py::arg("src"), py::arg("dest"))
+    .def("PageRank", [&] (graph& G, const double eps, const size_t max_iters) {
+      return wrap_array(without_gil([&] { return PageRank(G, eps, max_iters); }));
+    }, py::arg("eps") = 0.000001, py::arg("max_iters") = 100)
+    .def("SSSP", [&] (graph& G, const size_t src) {
+      return wrap_array(without_gil([&] { return BellmanFord(G, src); }));
+    }, py::arg("src"))
+    .def("TriangleCount", [&] (graph& G) {
+      return without_gil([&] {
+        auto f = [&] (uintE u, uintE v, uintE w) { };
+        return Triangle_degree_ordering(G, f);
+      });
+    })
+    .def("MaximalIndependentSet", [&] (graph& G) {
+      return wrap_array(without_gil([&] {
+        return MaximalIndependentSet_rootset::MaximalIndependentSet(G);
+      }));
+    })
+    .def("Coloring", [&] (graph& G) {
+      return wrap_array(without_gil([&] { return Coloring(G); }));
+    });
 }
 
 /* Defines asymmetric vertex functions */
@@ -109,7 +275,7 @@ template <template <class W> class vertex_type, class W>
 void AsymGraphRegister(py::module& m, std::string graph_name) {
   /* register graph */
   using graph = asymmetric_graph<vertex_type, W>;
-  py::class_<graph>(m, graph_name.c_str())
+  py::class_<graph, graph_holder<graph>>(m, graph_name.c_str())
     .def("numVertices", [](const graph& G) -> size_t {
       return G.n;
     })
@@ -117,14 +283,17 @@ void AsymGraphRegister(py::module& m, std::string graph_name) {
       return G.m;
     })
     .def("BFS", [&] (graph& G, const size_t src) {
-      auto parents = BFS(G, src);
-      return 1.0;
+      return wrap_array(without_gil([&] { return BFS(G, src); }));
     }, py::arg("src"))
     .def("StronglyConnectedComponents", [&] (graph& G) {
-      auto sccs = StronglyConnectedComponents(G);
-      size_t* arr = sccs.to_array();
-      return wrap_array(arr, G.n);
-    });
+      return wrap_array(without_gil([&] { return StronglyConnectedComponents(G); }));
+    })
+    .def("PageRank", [&] (graph& G, const double eps, const size_t max_iters) {
+      return wrap_array(without_gil([&] { return PageRank(G, eps, max_iters); }));
+    }, py::arg("eps") = 0.000001, py::arg("max_iters") = 100)
+    .def("SSSP", [&] (graph& G, const size_t src) {
+      return wrap_array(without_gil([&] { return BellmanFord(G, src); }));
+    }, py::arg("src"));
 }
 
 PYBIND11_MODULE(gbbs_lib, m) {
@@ -152,6 +321,34 @@ PYBIND11_MODULE(gbbs_lib, m) {
   AsymGraphRegister<asymmetric_vertex, pbbs::empty>(m, "AsymmetricGraph");
   AsymGraphRegister<cav_bytepd_amortized, pbbs::empty>(m, "CompressedAsymmetricGraph");
 
+  SymGraphRegister<symmetric_vertex, intE>(m, "SymmetricWeightedGraph");
+
+  /* ============================== CSR input ============================ */
+  m.def("symmetricGraphFromCSR", [&] (py::array indptr, py::array indices) {
+    auto G = symmetric_graph_from_csr(indptr, indices);
+    alloc_init(G);
+    return G;
+  }, py::arg("indptr"), py::arg("indices"), py::keep_alive<0, 2>());
+
+  m.def("symmetricWeightedGraphFromCSR", [&] (py::array indptr,
+                                              py::array indices,
+                                              py::array data) {
+    auto G = symmetric_weighted_graph_from_csr<intE>(indptr, indices, data);
+    alloc_init(G);
+    return G;
+  }, py::arg("indptr"), py::arg("indices"), py::arg("data"));
+
+  /* The in-edges are given by the CSR of the transpose (e.g., the indptr and
+   * indices of the matrix's tocsc()). */
+  m.def("asymmetricGraphFromCSR", [&] (py::array indptr, py::array indices,
+                                       py::array in_indptr,
+                                       py::array in_indices) {
+    auto G = asymmetric_graph_from_csr(indptr, indices, in_indptr, in_indices);
+    alloc_init(G);
+    return G;
+  }, py::arg("indptr"), py::arg("indices"), py::arg("in_indptr"),
+     py::arg("in_indices"), py::keep_alive<0, 2>(), py::keep_alive<0, 4>());
+
   /* ============================== Graph IO ============================= */
   m.def("readSymmetricUnweightedGraph", [&] (std::string& path) {
     auto G = gbbs_io::read_unweighted_symmetric_graph(
@@ -102,6 +102,8 @@ WEIGHTED_GRAPH_BENCHMARKS = [
     "//benchmarks/GeneralWeightSSSP/BellmanFord:BellmanFord_main",
     "//benchmarks/IntegralWeightSSSP/JulienneDBS17:wBFS_main",
     "//benchmarks/MinimumSpanningForest/Boruvka:MinimumSpanningForest_main",
+    "//benchmarks/MinimumSpanningForest/FilterKruskal:MinimumSpanningForest_main",
+    "//benchmarks/MinimumSpanningForest/LazyBoruvka:MinimumSpanningForest_main",
     "//benchmarks/MinimumSpanningForest/PBBSMST:MinimumSpanningForest_main",
     "//benchmarks/PositiveWeightSSSP/DeltaStepping:DeltaStepping_main",
     "//benchmarks/SSWidestPath/JulienneDBS17:SSWidestPath_main",
@@ -1,429 +1,417 @@
+// Usage:
+// numactl -i all ./compressor -s -enc bytepd-amortized -o soc-LJ_sym.bytepda soc-LiveJournal1_sym.adj
+// flags:
+//   required:
+//     -o : the output file
+//   optional:
+//     -s : indicate that the graph is symmetric
+//     -c : indicate that the input is compressed, in the encoding this binary
+//          reads (bytepd-amortized, or as selected by -DSTREAMVBYTE or
+//          -DBITPACKED), so that it can be re-encoded
+//     -m : indicate that the input should be mmap'd
+//     -enc : the block encoding to use: bytepd-amortized (default),
+//            streamvbyte or bitpacked
+//     -chunk : the number of bytes of input text (and roughly of compressed
+//              output) held in memory at once (default 2^28)
+//
+// Converts an (unweighted) adjacency graph into the compressed format read by
+// gbbs_io::read_compressed_symmetric_graph and
+// gbbs_io::read_compressed_asymmetric_graph.
+//
+// Symmetric graphs are compressed while streaming over the mmap'd input: each
+// chunk of the edge section is tokenized in parallel, the vertices whose edges
+// it completes are compressed in parallel into a buffer sized by a prefix sum
+// over their compressed sizes, and the buffer is written out by a separate
+// thread while the next chunk is processed. Only the offsets and degrees of
+// the vertices (O(n) words) and O(chunk) bytes of edges are kept in memory, so
+// the input and the output can be larger than memory. Asymmetric graphs are
+// loaded into memory to compute their in-edges, and are written in the same
+// chunked fashion.
+
 #include "gbbs/gbbs.h"
 #include "gbbs/io.h"
 #include "gbbs/parse_command_line.h"
-#include "pbbslib/utilities.h"
-#include "pbbslib/random.h"
+#include "pbbslib/strings/string_basics.h"
 
-#include <iostream>
-#include <fstream>
-#include <stdlib.h>
-#include <cmath>
+#include <sys/mman.h>
 
-// Provides utilities for converting between different compressed
-// representations.
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
 
 namespace gbbs {
-namespace encodings {
-namespace bytepd_amortized {
-
-  template <class Graph>
-  void write_graph_bytepd_amortized_directed(Graph& GA, std::ofstream& out) {
-    using W = typename Graph::weight_type;
-    size_t n = GA.n;
-
-    // out-edges
-    // 1. Calculate total size
-    {
-      auto degrees = sequence<uintE>(n);
-      auto byte_offsets = sequence<uintT>(n+1);
-      par_for(0, n, [&] (size_t i) {
-        size_t total_bytes = 0;
-        uintE last_ngh = 0;
-        size_t deg = 0;
-        uchar tmp[16];
-        auto f = [&] (uintE u, uintE v, W w) {
-          long bytes = 0;
-          if ((deg % PARALLEL_DEGREE) == 0) {
-            bytes = byte::compressFirstEdge(tmp, bytes, u, v);
-            bytes = byte::compressWeight<W>(tmp, bytes, w);
-          } else {
-            bytes = byte::compressEdge(tmp, bytes, v - last_ngh);
-            bytes = byte::compressWeight<W>(tmp, bytes, w);
-          }
-          last_ngh = v;
-          total_bytes += bytes;
-          deg++;
-          return false;
-        };
-        GA.get_vertex(i).mapOutNgh(i, f, false);
-
-        if (deg > 0) {
-          size_t n_chunks = 1+(deg-1)/PARALLEL_DEGREE;
-          // To account for the byte offsets
-          total_bytes += (n_chunks-1)*sizeof(uintE);
-          // To account for the per-block counters
-          total_bytes += (n_chunks)*sizeof(uintE);
-          // To account for the virtual degree
-          total_bytes += sizeof(uintE);
-        }
+namespace compressor {
+
+// Iterator over an uncompressed neighbor list, as expected by
+// sequentialCompressEdgeSet.
+struct array_iter {
+  uintE* edges;
+  size_t i;
+  std::tuple<uintE, pbbslib::empty> cur() {
+    return std::make_tuple(edges[i], pbbslib::empty());
+  }
+  std::tuple<uintE, pbbslib::empty> next() {
+    return std::make_tuple(edges[++i], pbbslib::empty());
+  }
+};
+
+// Reads the whitespace-separated non-negative integers of a mmap'd text file
+// in chunks.
+struct token_stream {
+  char* s;
+  size_t size;
+  size_t pos;
+
+  token_stream(char* s, size_t size) : s(s), size(size), pos(0) {}
+
+  // Returns the next token as a string.
+  std::string next_string() {
+    while (pos < size && pbbs::is_space(s[pos])) pos++;
+    size_t start = pos;
+    while (pos < size && !pbbs::is_space(s[pos])) pos++;
+    return std::string(s + start, pos - start);
+  }
 
-        degrees[i] = deg;
-        byte_offsets[i] = total_bytes;
-      });
-      byte_offsets[n] = 0;
-      size_t total_space = pbbslib::scan_add_inplace(byte_offsets);
-      std::cout << "total in-space = " << total_space << std::endl;
-
-      // 2. Create compressed format in-memory
-      auto edges = sequence<uchar>(total_space);
-      par_for(0, n, [&] (size_t i) {
-        uintE deg = degrees[i];
-        if (deg > 0) {
-          auto it = GA.get_vertex(i).getOutIter(i);
-          size_t nbytes = byte::sequentialCompressEdgeSet<W>(edges.begin() + byte_offsets[i], 0, deg, (uintE)i, it);
-          if (nbytes != (byte_offsets[i+1] - byte_offsets[i])) {
-            std::cout << "nbytes = " << nbytes << ". Should be: " << (byte_offsets[i+1] - byte_offsets[i]) << " deg = " << deg << " i = " << i << std::endl;
-            exit(0);
-          }
-          assert(nbytes == (byte_offsets[i+1] - byte_offsets[i]));
-        }
-      });
-      std::cout << "Compressed" << std::endl;
-
-      long* sizes = pbbslib::new_array_no_init<long>(3);
-      sizes[0] = GA.n;
-      sizes[1] = GA.m;
-      sizes[2] = total_space;
-      out.write((char*)sizes,sizeof(long)*3); //write n, m and space used
-      out.write((char*)byte_offsets.begin(),sizeof(uintT)*(n+1)); //write offsets
-      out.write((char*)degrees.begin(),sizeof(uintE)*n);
-      out.write((char*)edges.begin(),total_space); //write edges
+  // Parses at most max_tokens integers from the next chunk_bytes bytes of the
+  // file (or from the next token, if it is longer).
+  template <class T>
+  sequence<T> next_chunk(size_t max_tokens, size_t chunk_bytes) {
+    while (pos < size && pbbs::is_space(s[pos])) pos++;
+    size_t end = std::min(size, pos + chunk_bytes);
+    while (end < size && !pbbs::is_space(s[end])) end++;
+    if (pos == end) {
+      return sequence<T>();
     }
+    auto tokens = pbbs::tokens(pbbs::range<char*>(s + pos, s + end),
+                               pbbs::is_space);
+    size_t k = std::min(max_tokens, tokens.size());
+    auto values = sequence<T>(k, [&] (size_t i) {
+      T v = 0;
+      for (char c : tokens[i]) {
+        v = 10 * v + (c - '0');
+      }
+      return v;
+    });
+    pos = (k < tokens.size()) ? (tokens[k].begin() - s) : end;
+    return values;
+  }
+};
+
+// Writes buffers to a file on a separate thread, so that writing a chunk
+// overlaps with compressing the next one.
+struct chunk_writer {
+  std::ofstream& out;
+  sequence<uchar> pending;
+  std::thread writer;
+
+  chunk_writer(std::ofstream& out) : out(out) {}
+
+  void write(sequence<uchar>&& buffer) {
+    finish();
+    pending = std::move(buffer);
+    writer = std::thread([&] () {
+      out.write((char*)pending.begin(), pending.size());
+    });
+  }
 
-    {
-      // in-edges
-      // 1. Calculate total size
-      auto degrees = sequence<uintE>(n);
-      auto byte_offsets = sequence<uintT>(n+1);
-      par_for(0, n, [&] (size_t i) {
-        size_t total_bytes = 0;
-        uintE last_ngh = 0;
-        size_t deg = 0;
-        uchar tmp[16];
-        auto f = [&] (uintE u, uintE v, W w) {
-          long bytes = 0;
-          if ((deg % PARALLEL_DEGREE) == 0) {
-            bytes = byte::compressFirstEdge(tmp, bytes, u, v);
-            bytes = byte::compressWeight<W>(tmp, bytes, w);
-          } else {
-            bytes = byte::compressEdge(tmp, bytes, v - last_ngh);
-            bytes = byte::compressWeight<W>(tmp, bytes, w);
-          }
-          last_ngh = v;
-          total_bytes += bytes;
-          deg++;
-          return false;
-        };
-        GA.get_vertex(i).mapInNgh(i, f, false);
-
-        if (deg > 0) {
-          size_t n_chunks = 1+(deg-1)/PARALLEL_DEGREE;
-          // To account for the byte offsets
-          total_bytes += (n_chunks-1)*sizeof(uintE);
-          // To account for the per-block counters
-          total_bytes += (n_chunks)*sizeof(uintE);
-          // To account for the virtual degree
-          total_bytes += sizeof(uintE);
-        }
+  void finish() {
+    if (writer.joinable()) writer.join();
+  }
+};
+
+// Writes the edges of one direction of a graph (out- or in-edges) starting at
+// the current position of out. The section is laid out as
+//   [header : header_bytes][byte offsets : (n+1) uintT][degrees : n uintE]
+//   [compressed edges]
+// Vertices are compressed in increasing order using compress(). The caller
+// fills in the header once finish() returns.
+template <class C>
+struct section_writer {
+  std::ofstream& out;
+  size_t n;
+  std::streampos header_pos, offsets_pos;
+  sequence<uintT> byte_offsets;
+  sequence<uintE> degrees;
+  size_t total_space;
+  chunk_writer writer;
+
+  section_writer(std::ofstream& out, size_t n, size_t header_bytes)
+      : out(out), n(n), byte_offsets(n + 1), degrees(n), total_space(0),
+        writer(out) {
+    header_pos = out.tellp();
+    offsets_pos = header_pos + (std::streamoff)header_bytes;
+    out.seekp(offsets_pos + (std::streamoff)((n + 1) * sizeof(uintT) +
+                                             n * sizeof(uintE)));
+  }
 
-        degrees[i] = deg;
-        byte_offsets[i] = total_bytes;
-      });
-      byte_offsets[n] = 0;
-      size_t total_space = pbbslib::scan_add_inplace(byte_offsets);
-      std::cout << "total in-space = " << total_space << std::endl;
-
-      // 2. Create compressed format in-memory
-      auto edges = sequence<uchar>(total_space);
-      par_for(0, n, [&] (size_t i) {
-        uintE deg = degrees[i];
-        if (deg > 0) {
-          auto it = GA.get_vertex(i).getInIter(i);
-          size_t nbytes = byte::sequentialCompressEdgeSet<W>(edges.begin() + byte_offsets[i], 0, deg, (uintE)i, it);
-          if (nbytes != (byte_offsets[i+1] - byte_offsets[i])) {
-            std::cout << "nbytes = " << nbytes << ". Should be: " << (byte_offsets[i+1] - byte_offsets[i]) << " deg = " << deg << " i = " << i << std::endl;
-            exit(0);
-          }
-          assert(nbytes == (byte_offsets[i+1] - byte_offsets[i]));
+  // Compresses vertices [start, end), where get_iter(i) returns an iterator
+  // over the edges of vertex i and degrees[start, end) is set.
+  template <class GetIter>
+  void compress(size_t start, size_t end, GetIter& get_iter) {
+    if (start == end) return;
+    // 1. Compute the compressed size of each vertex and scan for offsets.
+    auto sizes = sequence<uintT>(end - start + 1);
+    par_for(start, end, [&] (size_t i) {
+      sizes[i - start] = 0;
+      if (degrees[i] > 0) {
+        auto it = get_iter(i);
+        sizes[i - start] = C::template compressed_size<pbbslib::empty>(
+            degrees[i], (uintE)i, it);
+      }
+    });
+    sizes[end - start] = 0;
+    size_t chunk_space = pbbslib::scan_add_inplace(sizes);
+
+    // 2. Compress into a buffer, and hand it to the writer.
+    auto buffer = sequence<uchar>::no_init(chunk_space);
+    par_for(start, end, [&] (size_t i) {
+      byte_offsets[i] = total_space + sizes[i - start];
+      if (degrees[i] > 0) {
+        auto it = get_iter(i);
+        size_t nbytes = C::template sequentialCompressEdgeSet<pbbslib::empty>(
+            buffer.begin() + sizes[i - start], 0, degrees[i], (uintE)i, it);
+        if (nbytes != (sizes[i - start + 1] - sizes[i - start])) {
+          std::cout << "nbytes = " << nbytes << ". Should be: "
+                    << (sizes[i - start + 1] - sizes[i - start])
+                    << " deg = " << degrees[i] << " i = " << i << std::endl;
+          exit(-1);
         }
-      });
-      std::cout << "Compressed" << std::endl;
-      long inTotalSpace[1];
-      inTotalSpace[0] = total_space;
-      out.write((char*)inTotalSpace, sizeof(long)); // in-edges total space
-      out.write((char*)byte_offsets.begin(),sizeof(uintT)*(n+1)); //write offsets
-      out.write((char*)degrees.begin(),sizeof(uintE)*n);
-      out.write((char*)edges.begin(),total_space); //write edges
+      }
+    });
+    total_space += chunk_space;
+    writer.write(std::move(buffer));
+  }
+
+  // Writes the byte offsets and degrees, leaving out positioned at the end of
+  // the section.
+  void finish() {
+    writer.finish();
+    byte_offsets[n] = total_space;
+    std::streampos end_pos = out.tellp();
+    out.seekp(offsets_pos);
+    out.write((char*)byte_offsets.begin(), sizeof(uintT) * (n + 1));
+    out.write((char*)degrees.begin(), sizeof(uintE) * n);
+    out.seekp(end_pos);
+  }
+
+  void write_header(long* header, size_t header_longs) {
+    std::streampos end_pos = out.tellp();
+    out.seekp(header_pos);
+    out.write((char*)header, sizeof(long) * header_longs);
+    out.seekp(end_pos);
+  }
+};
+
+// Compresses a symmetric adjacency graph while streaming over the input file.
+template <class C>
+void compress_symmetric_stream(const char* iFile, std::ofstream& out,
+                               size_t chunk_bytes) {
+  auto [s, size] = gbbs_io::mmapStringFromFile(iFile);
+  auto S = token_stream(s, size);
+  if (S.next_string() != "AdjacencyGraph") {
+    std::cout << "Expected an unweighted AdjacencyGraph as input" << std::endl;
+    exit(-1);
+  }
+  size_t n = std::stoul(S.next_string());
+  size_t m = std::stoul(S.next_string());
+  std::cout << "n = " << n << " m = " << m << std::endl;
+
+  // 1. Read the offsets.
+  auto offsets = sequence<uintT>(n + 1);
+  for (size_t read = 0; read < n;) {
+    auto chunk = S.next_chunk<uintT>(n - read, chunk_bytes);
+    if (chunk.size() == 0) {
+      std::cout << "Unexpected end of input" << std::endl;
+      exit(-1);
     }
+    par_for(0, chunk.size(), [&] (size_t i) {
+      offsets[read + i] = chunk[i];
+    });
+    read += chunk.size();
   }
+  offsets[n] = m;
+
+  auto section = section_writer<C>(out, n, 3 * sizeof(long));
+  par_for(0, n, [&] (size_t i) {
+    section.degrees[i] = offsets[i + 1] - offsets[i];
+  });
+
+  // 2. Stream over the edges. pending holds the parsed edges [first, parsed)
+  // that belong to vertices that are not compressed yet.
+  sequence<uintE> pending;
+  size_t first = 0, parsed = 0, next_vertex = 0;
+  while (next_vertex < n) {
+    auto chunk = S.next_chunk<uintE>(m - parsed, chunk_bytes);
+    if (chunk.size() == 0 && parsed < m) {
+      std::cout << "Unexpected end of input" << std::endl;
+      exit(-1);
+    }
+    auto edges = sequence<uintE>::no_init(pending.size() + chunk.size());
+    par_for(0, pending.size(), [&] (size_t i) { edges[i] = pending[i]; });
+    par_for(0, chunk.size(), [&] (size_t i) {
+      edges[pending.size() + i] = chunk[i];
+    });
+    parsed += chunk.size();
+
+    // Vertices whose edges are all parsed.
+    size_t end_vertex = std::upper_bound(offsets.begin() + next_vertex + 1,
+                                         offsets.begin() + n + 1, parsed) -
+                        (offsets.begin() + 1);
+    auto get_iter = [&] (size_t i) {
+      return array_iter{edges.begin() + (offsets[i] - first), 0};
+    };
+    section.compress(next_vertex, end_vertex, get_iter);
+    next_vertex = end_vertex;
+
+    size_t new_first = offsets[next_vertex];
+    pending = sequence<uintE>(parsed - new_first, [&] (size_t i) {
+      return edges[new_first - first + i];
+    });
+    first = new_first;
+  }
+  section.finish();
+
+  long sizes[3] = {(long)n, (long)m, (long)section.total_space};
+  section.write_header(sizes, 3);
+  std::cout << "total space = " << section.total_space << std::endl;
+  munmap(s, size);
+}
 
-  template <class Graph>
-  void write_graph_bytepd_amortized_format(Graph& GA, std::ofstream& out, bool symmetric) {
-    using W = typename Graph::weight_type;
-    if (!symmetric) {
-      write_graph_bytepd_amortized_directed(GA, out);
-      return;
+// Compresses the out-edges or in-edges of every vertex of GA into out.
+template <class C, class Graph>
+size_t compress_graph_edges(Graph& GA, std::ofstream& out, bool in_edges,
+                            size_t header_bytes, size_t chunk_edges) {
+  size_t n = GA.n;
+  auto section = section_writer<C>(out, n, header_bytes);
+  par_for(0, n, [&] (size_t i) {
+    auto v = GA.get_vertex(i);
+    section.degrees[i] = in_edges ? v.getInDegree() : v.getOutDegree();
+  });
+  auto get_iter = [&] (size_t i) {
+    auto v = GA.get_vertex(i);
+    return in_edges ? v.getInIter(i) : v.getOutIter(i);
+  };
+  size_t start = 0;
+  while (start < n) {
+    size_t end = start, edges = 0;
+    while (end < n &&
+           (end == start || edges + section.degrees[end] <= chunk_edges)) {
+      edges += section.degrees[end++];
     }
-    size_t n = GA.n;
-
-//    auto xors = sequence<size_t>(n);
-//    parallel_for(size_t i=0; i<n; i++) {
-//      size_t xr = 0;
-//      auto map_f = wrap_f<W>([&] (uintE src, uintE ngh) {
-//        xr ^= (src ^ ngh);
-//      });
-//      GA.V[i].mapOutNgh(i, map_f, false);
-//      xors[i] = xr;
-//    }
-//    std::cout << "input graph: output red = " << pbbslib::reduce_xor(xors) << std::endl;
-//
-//  auto hash_or_lt = [&] (const uintE& src, const uintE& ngh) {
-//    uint32_t src_h = pbbslib::hash32(src);
-//    uint32_t ngh_h = pbbslib::hash32(ngh);
-//    return (src_h < ngh_h) || ((src_h == ngh_h) && src < ngh);
-//  };
-
-
-//    auto self_arr = sequence<size_t>(n);
-//    parallel_for(size_t i=0; i<n; i++) {
-//      uintE our_deg = pbbslib::log2_up(GA.V[i].getOutDegree());
-//      bool selfl = false;
-//      size_t pri = 0;
-//      auto map_f = wrap_f<W>([&] (uintE src, uintE ngh) {
-//        uintE ngh_deg = pbbslib::log2_up(GA.V[ngh].getOutDegree());
-//        if (src == ngh) {
-//          selfl = true;
-//        }
-//        if ((ngh_deg > our_deg) || ((ngh_deg == our_deg) && hash_or_lt(src, ngh))) {
-//          pri++;
-//        }
-//      });
-//      GA.V[i].mapOutNgh(i, map_f, false);
-//      self_arr[i] = selfl;
-//      xors[i] = pri;
-//    }
-//    std::cout << "input graph: priorities = " << pbbslib::reduce_add(xors) << std::endl;
-//    std::cout << "input graph: self-loops = " << pbbslib::reduce_add(self_arr) << std::endl;
-
-//    parallel_for(size_t i=0; i<n; i++) {
-//      uintE our_deg = pbbslib::log2_up(GA.V[i].getOutDegree());
-//      bool selfl = false;
-//      size_t pri = 0;
-//      auto it = GA.V[i].getOutIter(i);
-//      size_t d = 0;
-//      size_t degree = GA.V[i].getOutDegree();
-//      uintE src = i;
-//      if (degree > 0) {
-//        uintE ngh = get<0>(it.cur());
-//        if (src == ngh) { selfl = true; }
-//        uintE ngh_deg = pbbslib::log2_up(GA.V[ngh].getOutDegree());
-//        if ((ngh_deg > our_deg) || ((ngh_deg == our_deg) && hash_or_lt(src, ngh))) {
-//          pri++;
-//        }
-//        for (size_t i=1; i<degree; i++) {
-//          ngh = get<0>(it.next());
-//          ngh_deg = pbbslib::log2_up(GA.V[ngh].getOutDegree());
-//          if (src == ngh) { selfl = true; }
-//          if ((ngh_deg > our_deg) || ((ngh_deg == our_deg) && hash_or_lt(src, ngh))) {
-//            pri++;
-//          }
-//        }
-//      }
-//      self_arr[i] = selfl;
-//      xors[i] = pri;
-//    }
-//    std::cout << "input graph: priorities = " << pbbslib::reduce_add(xors) << std::endl;
-//    std::cout << "input graph: self-loops = " << pbbslib::reduce_add(self_arr) << std::endl;
-
-
-    // 1. Calculate total size
-    auto degrees = sequence<uintE>(n);
-    auto byte_offsets = sequence<uintT>(n+1);
-    par_for(0, n, [&] (size_t i) {
-      size_t total_bytes = 0;
-      uintE last_ngh = 0;
-      size_t deg = 0;
-      uchar tmp[16];
-      auto f = [&] (uintE u, uintE v, W w) {
-//        if (u == v) {
-//          return;
-//        }
-        long bytes = 0;
-        if ((deg % PARALLEL_DEGREE) == 0) {
-          bytes = byte::compressFirstEdge(tmp, bytes, u, v);
-          bytes = byte::compressWeight<W>(tmp, bytes, w);
-        } else {
-          bytes = byte::compressEdge(tmp, bytes, v - last_ngh);
-          bytes = byte::compressWeight<W>(tmp, bytes, w);
-        }
-        last_ngh = v;
-        total_bytes += bytes;
-        deg++;
-      };
-      GA.get_vertex(i).mapOutNgh(i, f, false);
-
-      if (deg > 0) {
-        size_t n_chunks = 1+(deg-1)/PARALLEL_DEGREE;
-        // To account for the byte offsets
-        total_bytes += (n_chunks-1)*sizeof(uintE);
-        // To account for the per-block counters
-        total_bytes += (n_chunks)*sizeof(uintE);
-        // To account for the virtual degree
-        total_bytes += sizeof(uintE);
-      }
+    section.compress(start, end, get_iter);
+    start = end;
+  }
+  section.finish();
+  return section.total_space;
+}
 
-      degrees[i] = deg;
-      byte_offsets[i] = total_bytes;
-    });
-    byte_offsets[n] = 0;
-    size_t total_space = pbbslib::scan_add_inplace(byte_offsets);
-    std::cout << "total space = " << total_space << std::endl;
-    auto deg_f = [&] (size_t i) { return degrees[i]; };
-    auto deg_im = pbbslib::make_sequence<size_t>(n, deg_f);
-    std::cout << "sum degs = " << pbbslib::reduce_add(deg_im) << std::endl;
-
-    // 2. Create compressed format in-memory
-    auto edges = sequence<uchar>(total_space);
-    par_for(0, n, [&] (size_t i) {
-      uintE deg = degrees[i];
-      if (deg > 0) {
-        auto it = GA.get_vertex(i).getOutIter(i);
-        size_t nbytes = byte::sequentialCompressEdgeSet<W>(edges.begin() + byte_offsets[i], 0, deg, (uintE)i, it);
-
-//        uchar* edgeArray = edges.begin() + byte_offsets[i];
-//        size_t degree = deg;
-//
-//        size_t current_offset = 0;
-//        size_t num_blocks = 1+(degree-1)/PARALLEL_DEGREE;
-//        uintE* vertex_ctr = (uintE*)edgeArray;
-//        *vertex_ctr = degree;
-//
-//        uintE* block_offsets = (uintE*)(edgeArray + sizeof(uintE));
-//        current_offset += sizeof(uintE) + (num_blocks-1)*sizeof(uintE); // virtual deg + block_offs
-//
-//        size_t proc = 0;
-//        size_t cur_block = 0;
-//        uintE* prev_block_deg = nullptr;
-//        uintE last_ngh;
-//        auto map_f = [&] (uintE u, uintE v, W w) {
-//          if ((proc % PARALLEL_DEGREE) == 0) {
-//            if (cur_block > 0) {
-//              assert(*prev_block_deg == 0);
-//              *prev_block_deg = PARALLEL_DEGREE; // full block; write prev block's degree
-//              block_offsets[cur_block-1] = current_offset; // write start of this block
-//            }
-//            prev_block_deg = (uintE*)(edgeArray + current_offset);
-//            *prev_block_deg = 0;
-//            current_offset += sizeof(uintE);
-//            current_offset = compressFirstEdge(edgeArray, current_offset, u, v);
-//            current_offset = compressWeight<W>(edgeArray, current_offset, w);
-//            cur_block++;
-//          } else {
-//            current_offset = compressEdge(edgeArray, current_offset, v - last_ngh);
-//            current_offset = compressWeight<W>(edgeArray, current_offset, w);
-//          }
-//          last_ngh = v;
-//          proc++;
-//        };
-//
-//        GA.V[i].mapOutNgh(i, map_f, false);
-//
-//        assert(prev_block_deg != nullptr);
-//        assert(*prev_block_deg == 0);
-//        *prev_block_deg = deg % PARALLEL_DEGREE;
-//
-//        assert(current_offset == (byte_offsets[i+1] - byte_offsets[i]));
+// Compresses a symmetric graph held in memory (e.g., a compressed graph being
+// re-encoded).
+template <class C, class Graph>
+void compress_symmetric(Graph& GA, std::ofstream& out, size_t chunk_bytes) {
+  size_t chunk_edges = std::max<size_t>(chunk_bytes / sizeof(uintE), 1);
+  std::streampos start = out.tellp();
+  size_t space = compress_graph_edges<C>(GA, out, false, 3 * sizeof(long),
+                                         chunk_edges);
+  std::streampos end = out.tellp();
+
+  long sizes[3] = {(long)GA.n, (long)GA.m, (long)space};
+  out.seekp(start);
+  out.write((char*)sizes, sizeof(long) * 3);
+  out.seekp(end);
+  std::cout << "total space = " << space << std::endl;
+}
 
-        if (nbytes != (byte_offsets[i+1] - byte_offsets[i])) {
-          std::cout << "nbytes = " << nbytes << ". Should be: " << (byte_offsets[i+1] - byte_offsets[i]) << " deg = " << deg << " i = " << i << std::endl;
-          exit(0);
-        }
-        assert(nbytes == (byte_offsets[i+1] - byte_offsets[i]));
-      }
-    });
-    std::cout << "Compressed" << std::endl;
-//    exit(0);
-
-//    parallel_for(size_t i=0; i<n; i++) {
-//      size_t xr = 0;
-//      auto map_f = [&] (uintE src, uintE ngh, const W& wgh, size_t off) {
-//        xr ^= (src ^ ngh);
-//        return true;
-//      };
-//      auto edge_start= edges.begin() + byte_offsets[i];
-//      size_t deg = degrees[i];
-//      if (deg > 0) {
-//        bytepd_amortized::decode<W>(map_f, edge_start, i, deg, false);
-//      }
-//      xors[i] = xr;
-//    }
-//    std::cout << "output graph: output red = " << pbbslib::reduce_xor(xors) << std::endl;
-
-//    parallel_for(size_t i=0; i<n; i++) {
-//      assert(degrees[i] == GA.V[i].getOutDegree());
-//      uintE our_deg = pbbslib::log2_up(degrees[i]);
-//      bool selfl = false;
-//      size_t pri = 0;
-//      auto map_f = [&] (uintE src, uintE ngh, const W& wgh, size_t off) {
-//        uintE ngh_deg = pbbslib::log2_up(degrees[ngh]);
-//        if (src == ngh) {
-//          selfl = true;
-//        }
-//        if ((ngh_deg > our_deg) || ((ngh_deg == our_deg) && hash_or_lt(src, ngh))) {
-//          pri++;
-//        }
-//        return true;
-//      };
-//      auto edge_start= edges.begin() + byte_offsets[i];
-//      size_t deg = degrees[i];
-//      if (deg > 0) {
-//        bytepd_amortized::decode<W>(map_f, edge_start, i, deg, false);
-//      }
-//      self_arr[i] = selfl;
-//      xors[i] = pri;
-//    }
-//    std::cout << "output graph: priorities = " << pbbslib::reduce_add(xors) << std::endl;
-//    std::cout << "output graph: self-loops = " << pbbslib::reduce_add(self_arr) << std::endl;
-
-
-//    exit(0);
-
-    long* sizes = pbbslib::new_array_no_init<long>(3);
-    sizes[0] = GA.n;
-    sizes[1] = GA.m;
-    sizes[2] = total_space;
-    out.write((char*)sizes,sizeof(long)*3); //write n, m and space used
-    out.write((char*)byte_offsets.begin(),sizeof(uintT)*(n+1)); //write offsets
-    out.write((char*)degrees.begin(),sizeof(uintE)*n);
-    out.write((char*)edges.begin(),total_space); //write edges
-    out.close();
+// Compresses an asymmetric graph held in memory, which is needed to build its
+// in-edges.
+template <class C, class Graph>
+void compress_asymmetric(Graph& GA, std::ofstream& out, size_t chunk_bytes) {
+  size_t chunk_edges = std::max<size_t>(chunk_bytes / sizeof(uintE), 1);
+  std::streampos start = out.tellp();
+  size_t out_space = compress_graph_edges<C>(GA, out, false, 3 * sizeof(long),
+                                             chunk_edges);
+  std::streampos in_start = out.tellp();
+  size_t in_space = compress_graph_edges<C>(GA, out, true, sizeof(long),
+                                            chunk_edges);
+  std::streampos end = out.tellp();
+
+  long sizes[3] = {(long)GA.n, (long)GA.m, (long)out_space};
+  out.seekp(start);
+  out.write((char*)sizes, sizeof(long) * 3);
+  long in_total_space = in_space;
+  out.seekp(in_start);
+  out.write((char*)&in_total_space, sizeof(long));
+  out.seekp(end);
+  std::cout << "total space = " << out_space << " in-space = " << in_space
+            << std::endl;
+}
+
+// Reads the input the way generate_main does: a compressed graph (in the
+// encoding the binary is compiled to read, see compressed_encoding) with -c,
+// and an adjacency graph otherwise, mmap'd with -m. Uncompressed symmetric
+// inputs are always streamed from an mmap'd file.
+template <class C>
+void compress(const char* iFile, std::ofstream& out, bool symmetric,
+              bool compressed, bool mmap, size_t chunk_bytes) {
+  if (compressed) {
+    if (symmetric) {
+      auto GA = gbbs_io::read_compressed_symmetric_graph<pbbslib::empty>(
+          iFile, mmap, false);
+      compress_symmetric<C>(GA, out, chunk_bytes);
+      GA.del();
+    } else {
+      auto GA = gbbs_io::read_compressed_asymmetric_graph<pbbslib::empty>(
+          iFile, mmap, false);
+      compress_asymmetric<C>(GA, out, chunk_bytes);
+      GA.del();
+    }
+  } else if (symmetric) {
+    compress_symmetric_stream<C>(iFile, out, chunk_bytes);
+  } else {
+    auto GA = gbbs_io::read_unweighted_asymmetric_graph(iFile, mmap);
+    compress_asymmetric<C>(GA, out, chunk_bytes);
+    GA.del();
   }
-}; // namespace bytepd_amortized
-}; // namespace encodings
+}
 
-template <class Graph>
-double converter(Graph& GA, commandLine P) {
-  auto outfile = P.getOptionValue("-o", "");
+}  // namespace compressor
+}  // namespace gbbs
+
+int main(int argc, char* argv[]) {
+  gbbs::commandLine P(argc, argv,
+                      " [-s] [-c] [-m] [-enc encoding] [-chunk bytes] "
+                      "-o <outFile> <inFile>");
+  char* iFile = P.getArgument(0);
   bool symmetric = P.getOptionValue("-s");
+  bool compressed = P.getOptionValue("-c");
+  bool mmap = P.getOptionValue("-m");
+  auto outfile = P.getOptionValue("-o", "");
+  auto encoding = P.getOptionValue("-enc", "bytepd-amortized");
+  size_t chunk_bytes = P.getOptionLongValue("-chunk", 1L << 28);
   std::cout << "Outfile: " << outfile << std::endl;
   if (outfile == "") {
     std::cout << "Please specify an output file" << std::endl;
     exit(0);
   }
   std::ofstream out(outfile.c_str(), std::ofstream::out | std::ios::binary);
-  auto encoding = P.getOptionValue("-enc", "bytepd-amortized");
 
+  gbbs::timer t; t.start();
   if (encoding == "bytepd-amortized") {
-    encodings::bytepd_amortized::write_graph_bytepd_amortized_format(GA, out, symmetric);
+    gbbs::compressor::compress<gbbs::bytepd_amortized_decode>(
+        iFile, out, symmetric, compressed, mmap, chunk_bytes);
+  } else if (encoding == "streamvbyte") {
+    gbbs::compressor::compress<gbbs::streamvbyte_decode>(
+        iFile, out, symmetric, compressed, mmap, chunk_bytes);
+  } else if (encoding == "bitpacked") {
+    gbbs::compressor::compress<gbbs::bitpacked_decode>(
+        iFile, out, symmetric, compressed, mmap, chunk_bytes);
   } else {
     std::cout << "Unknown encoding: " << encoding << std::endl;
     exit(0);
   }
-  std::cout << "Finished converting." << std::endl;
-  exit(0);
+  out.close();
+  std::cout << "Finished converting in " << t.stop() << " seconds."
+            << std::endl;
   return 0;
 }
-}  // namespace gbbs
-
-
-generate_main(gbbs::converter, false);
@@ -0,0 +1,166 @@
+// Usage:
+// numactl -i all ./decoder_benchmark -s -rounds 5 twitter_SJ
+// flags:
+//   optional:
+//     -rounds : the number of times to decode the graph with each encoding
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -s : indicate that the graph is symmetric
+//
+// Encodes the out-edges of the input graph in memory using each of the
+// parallel-block encodings in gbbs/encodings, and reports the space used and
+// the throughput of decoding every edge of the graph in parallel.
+
+#include "gbbs/gbbs.h"
+
+#include <iostream>
+#include <string>
+
+namespace gbbs {
+
+// An in-memory encoding of the out-edges of a graph.
+struct encoded_edges {
+  sequence<uintE> degrees;
+  sequence<uintT> byte_offsets;
+  sequence<uchar> edges;
+};
+
+template <class C, class Graph>
+encoded_edges encode_graph(Graph& G) {
+  using W = typename Graph::weight_type;
+  size_t n = G.n;
+  // Encode each vertex into a scratch region large enough for any of the
+  // encodings, and then compact the encoded lists.
+  auto degrees = sequence<uintE>(n, [&] (size_t i) {
+    return G.get_vertex(i).getOutDegree(); });
+  auto scratch_offsets = sequence<uintT>(n + 1, [&] (size_t i) {
+    if (i == n) return (uintT)0;
+    size_t num_blocks = 1 + degrees[i] / PARALLEL_DEGREE;
+    return (uintT)(16 * degrees[i] + 3 * sizeof(uintE) * (num_blocks + 1));
+  });
+  size_t scratch_space = pbbslib::scan_add_inplace(scratch_offsets);
+  auto scratch = sequence<uchar>(scratch_space);
+  auto byte_offsets = sequence<uintT>(n + 1);
+  par_for(0, n, [&] (size_t i) {
+    byte_offsets[i] = 0;
+    if (degrees[i] > 0) {
+      auto it = G.get_vertex(i).getOutIter(i);
+      byte_offsets[i] = C::template sequentialCompressEdgeSet<W>(
+          scratch.begin() + scratch_offsets[i], 0, degrees[i], i, it);
+    }
+  }, 1);
+  byte_offsets[n] = 0;
+  size_t total_space = pbbslib::scan_add_inplace(byte_offsets);
+  auto edges = sequence<uchar>(total_space);
+  par_for(0, n, [&] (size_t i) {
+    size_t bytes = byte_offsets[i + 1] - byte_offsets[i];
+    memcpy(edges.begin() + byte_offsets[i],
+           scratch.begin() + scratch_offsets[i], bytes);
+  }, 1);
+  return encoded_edges{std::move(degrees), std::move(byte_offsets),
+                       std::move(edges)};
+}
+
+// Decodes every edge of the encoded graph, returning a checksum of the
+// neighbor ids.
+template <class C, class W>
+size_t decode_graph(encoded_edges& E) {
+  size_t n = E.degrees.size();
+  auto sums = sequence<size_t>(n);
+  par_for(0, n, [&] (size_t i) {
+    size_t sum = 0;
+    auto f = [&] (const uintE& src, const uintE& ngh, const W& wgh,
+                  const uintT& edge_id) {
+      sum += ngh;
+      return true;
+    };
+    C::template decode<W>(f, E.edges.begin() + E.byte_offsets[i], i,
+                          E.degrees[i], false);
+    sums[i] = sum;
+  }, 1);
+  return pbbslib::reduce_add(sums);
+}
+
+template <class C, class Graph>
+void benchmark_encoding(Graph& G, const std::string& name, size_t rounds) {
+  using W = typename Graph::weight_type;
+  timer enc_t; enc_t.start();
+  auto E = encode_graph<C>(G);
+  double enc_time = enc_t.stop();
+
+  size_t checksum = 0;
+  double total_time = 0.0;
+  for (size_t r = 0; r < rounds; r++) {
+    timer t; t.start();
+    checksum = decode_graph<C, W>(E);
+    total_time += t.stop();
+  }
+  double time_per_round = total_time / rounds;
+  std::cout << "### Encoding: " << name << std::endl;
+  std::cout << "# encode time: " << enc_time << std::endl;
+  std::cout << "# bytes: " << E.edges.size() << " bits/edge: "
+            << (8.0 * E.edges.size()) / G.m << std::endl;
+  std::cout << "# decode time: " << time_per_round << " edges/s: "
+            << G.m / time_per_round << " checksum: " << checksum << std::endl;
+}
+
+template <class Graph>
+double DecoderBenchmark_runner(Graph& G, commandLine P) {
+  size_t rounds = P.getOptionLongValue("-rounds", 3);
+  std::cout << "### Application: DecoderBenchmark" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << G.n << std::endl;
+  std::cout << "### m: " << G.m << std::endl;
+  std::cout << "### ------------------------------------" << std::endl;
+
+  timer t; t.start();
+  benchmark_encoding<bytepd_amortized_decode>(G, "bytepd-amortized", rounds);
+  benchmark_encoding<streamvbyte_decode>(G, "streamvbyte", rounds);
+  benchmark_encoding<bitpacked_decode>(G, "bitpacked", rounds);
+  double tt = t.stop();
+
+  std::cout << "### Running Time: " << tt << std::endl;
+  return tt;
+}
+
+}  // namespace gbbs
+
+// -rounds is consumed by the runner itself, so the graph is read and the
+// runner invoked once instead of going through generate_main.
+int main(int argc, char* argv[]) {
+  gbbs::commandLine P(argc, argv, " [-s] [-c] [-m] [-rounds r] <inFile>");
+  char* iFile = P.getArgument(0);
+  bool symmetric = P.getOptionValue("-s");
+  bool compressed = P.getOptionValue("-c");
+  bool mmap = P.getOptionValue("-m");
+  if (compressed) {
+    if (symmetric) {
+      auto G = gbbs::gbbs_io::read_compressed_symmetric_graph<pbbslib::empty>(
+          iFile, mmap, false);
+      gbbs::alloc_init(G);
+      gbbs::DecoderBenchmark_runner(G, P);
+      G.del();
+    } else {
+      auto G = gbbs::gbbs_io::read_compressed_asymmetric_graph<pbbslib::empty>(
+          iFile, mmap, false);
+      gbbs::alloc_init(G);
+      gbbs::DecoderBenchmark_runner(G, P);
+      G.del();
+    }
+  } else {
+    if (symmetric) {
+      auto G = gbbs::gbbs_io::read_unweighted_symmetric_graph(iFile, mmap);
+      gbbs::alloc_init(G);
+      gbbs::DecoderBenchmark_runner(G, P);
+      G.del();
+    } else {
+      auto G = gbbs::gbbs_io::read_unweighted_asymmetric_graph(iFile, mmap);
+      gbbs::alloc_init(G);
+      gbbs::DecoderBenchmark_runner(G, P);
+      G.del();
+    }
+  }
+  gbbs::alloc_finish();
+  return 0;
+}
@@ -0,0 +1,634 @@
+// Usage:
+// numactl -i all ./gbbs_server -s -socket /tmp/gbbs.sock -shm /twitter twitter_SJ
+// flags:
+//   required:
+//     -s : indicate that the graph is symmetric
+//   optional:
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -w : indicate that the graph is weighted
+//     -socket : path of the Unix-domain socket to listen on
+//               (default: /tmp/gbbs_server.sock)
+//     -shm : name of a POSIX shared-memory segment (e.g. /twitter) holding the
+//            graph. If a segment built from the same input file exists, the
+//            server attaches to it instead of reading the input; otherwise
+//            the graph is read once and copied into the segment.
+//     -max_requests : the maximum number of admitted requests that are
+//                     waiting or running (default: 16). Further requests
+//                     are rejected with "error busy".
+//
+// Loads a graph once and serves algorithm requests over a Unix-domain socket.
+// A request is a single line of the form
+//
+//   <ALG> [key=value ...]
+//
+// where ALG is one of
+//
+//   BFS src=<v>                    : parents of a BFS tree rooted at v
+//   CC                             : connectivity labels
+//   KCore                          : coreness of every vertex
+//   PageRank eps=<e> iters=<k>     : PageRank values
+//   SSSP src=<v>                   : Bellman-Ford distances from v
+//   STATS                          : graph and server statistics
+//   SHUTDOWN                       : stops the server
+//
+// Every algorithm also accepts priority=<p> (default: 0), and out=<path>,
+// which writes the full result (one value per line) to path. The reply is a
+// single line,
+//
+//   ok <ALG> queue_ms=<t> run_ms=<t> total_ms=<t> <summary>
+//
+// or "error <reason>". A connection may issue any number of requests, and
+// is closed by the client or by sending QUIT.
+//
+// Connections are served by their own threads, and each request runs as its
+// own root computation on the shared scheduler (see pbbs::run_root):
+// concurrent requests share the workers, and a request with a higher
+// priority preempts lower-priority requests at their next fork, so small
+// queries sent with e.g. priority=1 are not stuck behind a long PageRank.
+
+#include "gbbs/gbbs.h"
+
+#include "benchmarks/BFS/NonDeterministicBFS/BFS.h"
+#include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
+#include "benchmarks/GeneralWeightSSSP/BellmanFord/BellmanFord.h"
+#include "benchmarks/KCore/JulienneDBS17/KCore.h"
+#include "benchmarks/PageRank/PageRank.h"
+#include "pbbslib/strings/string_basics.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace gbbs {
+namespace server {
+
+using clock_type = std::chrono::steady_clock;
+
+inline double ms_since(clock_type::time_point start,
+                       clock_type::time_point end = clock_type::now()) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/* ======================= Shared-memory graphs ======================= */
+
+constexpr uint64_t kShmMagic = 0x67626273'73686d31ULL;  // "gbbsshm1"
+constexpr size_t kShmAlign = 64;
+
+// The encoding of the edges stored in a segment; a server built for one
+// encoding must not attach to a segment written by another.
+constexpr uint64_t kShmEncoding =
+    std::is_same<compressed_encoding, streamvbyte_decode>::value ? 2
+    : std::is_same<compressed_encoding, bitpacked_decode>::value ? 3
+    : 1;
+
+// A segment holds the header, followed by the vertex_data array and the
+// edge array of the graph, each aligned to kShmAlign bytes. The header
+// records the size and modification time of the input file so that a
+// segment built from a stale input is rebuilt rather than reused.
+struct shm_header {
+  uint64_t magic;
+  uint64_t encoding;  // 0 if uncompressed, kShmEncoding otherwise
+  uint64_t weight_bytes;
+  uint64_t n, m;
+  uint64_t edge_bytes;
+  uint64_t input_size;
+  int64_t input_mtime;
+  uint64_t ready;  // written last, once the contents are complete
+};
+
+inline size_t align_up(size_t x) {
+  return (x + kShmAlign - 1) & ~(kShmAlign - 1);
+}
+
+struct shm_layout {
+  size_t vertex_offset, edge_offset, total_bytes;
+  shm_layout(size_t n, size_t edge_bytes) {
+    vertex_offset = align_up(sizeof(shm_header));
+    edge_offset = align_up(vertex_offset + n * sizeof(vertex_data));
+    total_bytes = edge_offset + edge_bytes;
+  }
+};
+
+inline void parallel_memcpy(char* dst, const char* src, size_t bytes) {
+  constexpr size_t kChunk = 1 << 20;
+  size_t chunks = (bytes + kChunk - 1) / kChunk;
+  par_for(0, chunks, 1, [&] (size_t i) {
+    size_t start = i * kChunk;
+    size_t end = std::min(bytes, start + kChunk);
+    memcpy(dst + start, src + start, end - start);
+  });
+}
+
+// Returns the number of bytes of encoded edges in a compressed graph file.
+inline size_t compressed_edge_bytes(const char* fname) {
+  std::ifstream in(fname, std::ios::in | std::ios::binary);
+  long sizes[3];
+  in.read((char*)sizes, sizeof(sizes));
+  if (!in) {
+    std::cout << "# Unable to read the header of " << fname << std::endl;
+    exit(-1);
+  }
+  return sizes[2];
+}
+
+// Maps a segment copy-on-write, so that algorithms which modify the graph
+// (e.g. by packing out edges) never change the shared copy. Returns nullptr
+// if the segment does not exist or does not hold a complete graph matching
+// the expected parameters.
+template <class Graph>
+Graph* attach_shm_graph(const std::string& name, uint64_t encoding,
+                        const struct stat& input) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1) return nullptr;
+  struct stat sb;
+  if (fstat(fd, &sb) == -1 || (size_t)sb.st_size < sizeof(shm_header)) {
+    close(fd);
+    return nullptr;
+  }
+  size_t size = sb.st_size;
+  char* base = (char*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                           fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) return nullptr;
+
+  auto* H = (shm_header*)base;
+  bool valid = H->magic == kShmMagic && H->ready == 1 &&
+               H->encoding == encoding &&
+               H->weight_bytes == sizeof(typename Graph::weight_type) &&
+               H->input_size == (uint64_t)input.st_size &&
+               H->input_mtime == (int64_t)input.st_mtime &&
+               shm_layout(H->n, H->edge_bytes).total_bytes <= size;
+  if (!valid) {
+    munmap(base, size);
+    return nullptr;
+  }
+  auto layout = shm_layout(H->n, H->edge_bytes);
+  auto* v_data = (vertex_data*)(base + layout.vertex_offset);
+  auto* edges = (typename Graph::edge_type*)(base + layout.edge_offset);
+  return new Graph(v_data, H->n, H->m,
+                   [base, size] () { munmap(base, size); }, edges);
+}
+
+// Copies G into a newly created segment, replacing any existing segment with
+// the same name.
+template <class Graph>
+void create_shm_graph(const std::string& name, Graph& G, size_t edge_bytes,
+                      uint64_t encoding, const struct stat& input) {
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    std::cout << "# Unable to create shared-memory segment " << name << ": "
+              << strerror(errno) << std::endl;
+    exit(-1);
+  }
+  auto layout = shm_layout(G.n, edge_bytes);
+  if (ftruncate(fd, layout.total_bytes) == -1) {
+    std::cout << "# Unable to size shared-memory segment " << name << ": "
+              << strerror(errno) << std::endl;
+    exit(-1);
+  }
+  char* base = (char*)mmap(nullptr, layout.total_bytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    std::cout << "# Unable to map shared-memory segment " << name << ": "
+              << strerror(errno) << std::endl;
+    exit(-1);
+  }
+  parallel_memcpy(base + layout.vertex_offset, (char*)G.v_data,
+                  G.n * sizeof(vertex_data));
+  parallel_memcpy(base + layout.edge_offset, (char*)G.e0, edge_bytes);
+  auto* H = (shm_header*)base;
+  H->magic = kShmMagic;
+  H->encoding = encoding;
+  H->weight_bytes = sizeof(typename Graph::weight_type);
+  H->n = G.n;
+  H->m = G.m;
+  H->edge_bytes = edge_bytes;
+  H->input_size = input.st_size;
+  H->input_mtime = input.st_mtime;
+  std::atomic_thread_fence(std::memory_order_release);
+  H->ready = 1;
+  munmap(base, layout.total_bytes);
+}
+
+/* ========================= Request handling ========================= */
+
+struct server_state {
+  size_t max_requests;
+  int listen_fd;
+  clock_type::time_point start_time;
+  std::atomic<size_t> in_flight{0};
+  std::atomic<size_t> served{0};
+  std::atomic<size_t> rejected{0};
+  std::atomic<size_t> failed{0};
+  std::atomic<bool> shutting_down{false};
+  std::mutex log_mutex;
+};
+
+// Parses "<ALG> key=value ..." into the algorithm name and its parameters.
+inline bool parse_request(const std::string& line, std::string& alg,
+                          std::map<std::string, std::string>& params,
+                          std::string& err) {
+  std::istringstream in(line);
+  if (!(in >> alg)) {
+    err = "empty request";
+    return false;
+  }
+  std::string tok;
+  while (in >> tok) {
+    size_t eq = tok.find('=');
+    if (eq == std::string::npos || eq == 0) {
+      err = "malformed parameter " + tok;
+      return false;
+    }
+    params[tok.substr(0, eq)] = tok.substr(eq + 1);
+  }
+  return true;
+}
+
+struct param_reader {
+  const std::map<std::string, std::string>& params;
+  std::string err;
+
+  long get_long(const std::string& key, long def) {
+    auto it = params.find(key);
+    if (it == params.end()) return def;
+    char* end;
+    long v = strtol(it->second.c_str(), &end, 10);
+    if (*end != '\0' || it->second.empty()) err = "bad value for " + key;
+    return v;
+  }
+
+  double get_double(const std::string& key, double def) {
+    auto it = params.find(key);
+    if (it == params.end()) return def;
+    char* end;
+    double v = strtod(it->second.c_str(), &end);
+    if (*end != '\0' || it->second.empty()) err = "bad value for " + key;
+    return v;
+  }
+};
+
+template <class Seq>
+void write_result(Seq& S, const std::map<std::string, std::string>& params) {
+  auto it = params.find("out");
+  if (it == params.end()) return;
+  auto C = pbbslib::sequence_to_string(S);
+  pbbs::char_seq_to_file(C, it->second.c_str());
+}
+
+// Runs a single request on G, returning the summary of its result, or
+// setting err.
+template <class Graph>
+std::string run_algorithm(Graph& G, const std::string& alg,
+                          const std::map<std::string, std::string>& params,
+                          std::string& err) {
+  param_reader P{params, ""};
+  std::ostringstream out;
+  auto check_src = [&] (long src) {
+    if (P.err.empty() && (src < 0 || (size_t)src >= G.n)) {
+      P.err = "src out of range";
+    }
+    return P.err.empty();
+  };
+  if (alg == "BFS") {
+    long src = P.get_long("src", 0);
+    if (check_src(src)) {
+      auto parents = BFS(G, (uintE)src);
+      size_t reachable = pbbslib::reduce_add(pbbslib::make_sequence<size_t>(
+          G.n, [&] (size_t i) { return parents[i] != UINT_E_MAX; }));
+      write_result(parents, params);
+      out << "reachable=" << reachable;
+    }
+  } else if (alg == "CC") {
+    auto labels = workefficient_cc::CC(G);
+    size_t num_cc = workefficient_cc::num_cc(labels);
+    write_result(labels, params);
+    out << "components=" << num_cc;
+  } else if (alg == "KCore") {
+    auto cores = KCore(G);
+    write_result(cores, params);
+    out << "kmax=" << pbbslib::reduce_max(cores);
+  } else if (alg == "PageRank") {
+    double eps = P.get_double("eps", 0.000001);
+    long iters = P.get_long("iters", 100);
+    if (P.err.empty() && (eps <= 0 || iters <= 0)) P.err = "bad eps or iters";
+    if (P.err.empty()) {
+      auto ranks = PageRank(G, eps, iters);
+      size_t best = pbbs::max_element(ranks, std::less<double>());
+      write_result(ranks, params);
+      out << "max_rank=" << ranks[best] << " argmax=" << best;
+    }
+  } else if (alg == "SSSP") {
+    long src = P.get_long("src", 0);
+    if (check_src(src)) {
+      auto dists = BellmanFord(G, (uintE)src);
+      auto reached = pbbslib::make_sequence<intE>(G.n, [&] (size_t i) {
+        return (dists[i] == INT_MAX / 2) ? 0 : dists[i]; });
+      size_t reachable = pbbslib::reduce_add(pbbslib::make_sequence<size_t>(
+          G.n, [&] (size_t i) { return dists[i] != INT_MAX / 2; }));
+      write_result(dists, params);
+      out << "reachable=" << reachable
+          << " max_dist=" << pbbslib::reduce_max(reached);
+    }
+  } else {
+    P.err = "unknown algorithm " + alg;
+  }
+  err = P.err;
+  return out.str();
+}
+
+// Handles a single request line, returning the reply. Algorithms run as
+// root computations on the shared scheduler, so requests from different
+// connections run concurrently.
+template <class Graph>
+std::string handle_request(Graph& G, const std::string& line,
+                           server_state& S) {
+  auto arrival = clock_type::now();
+  std::string alg, err, summary;
+  std::map<std::string, std::string> params;
+  if (!parse_request(line, alg, params, err)) {
+    S.failed++;
+    return "error " + err;
+  }
+  if (alg == "STATS") {
+    std::ostringstream out;
+    out << "ok STATS n=" << G.n << " m=" << G.m
+        << " workers=" << num_workers() << " in_flight=" << S.in_flight
+        << " served=" << S.served << " rejected=" << S.rejected
+        << " failed=" << S.failed
+        << " uptime_s=" << ms_since(S.start_time) / 1000;
+    return out.str();
+  }
+  // in_flight is raised before shutting_down is read, so that run_server
+  // either sees this request in its drain loop or this request sees the
+  // shutdown and backs out.
+  if (S.in_flight++ >= S.max_requests) {
+    S.in_flight--;
+    S.rejected++;
+    return "error busy";
+  }
+  if (S.shutting_down) {
+    S.in_flight--;
+    return "error shutting down";
+  }
+  param_reader P{params, ""};
+  int priority = P.get_long("priority", 0);
+  clock_type::time_point run_start;
+  if (P.err.empty()) {
+    run_root([&] () {
+      run_start = clock_type::now();
+      summary = run_algorithm(G, alg, params, err);
+    }, priority);
+  } else {
+    err = P.err;
+  }
+  auto run_end = clock_type::now();
+  S.in_flight--;
+
+  std::ostringstream resp;
+  if (err.empty()) {
+    S.served++;
+    resp << "ok " << alg << " queue_ms=" << ms_since(arrival, run_start)
+         << " run_ms=" << ms_since(run_start, run_end)
+         << " total_ms=" << ms_since(arrival, run_end) << " " << summary;
+  } else {
+    S.failed++;
+    resp << "error " << err;
+  }
+  return resp.str();
+}
+
+// Serves the requests of one connection until the client closes it, sends
+// QUIT, or run_server shuts the socket down. Runs on its own thread; the
+// socket is closed by run_server once the thread is joined.
+template <class Graph>
+void serve_connection(Graph& G, int fd, server_state& S) {
+  std::string buffer;
+  char chunk[4096];
+  auto reply = [&] (const std::string& s) {
+    std::string msg = s + "\n";
+    size_t sent = 0;
+    while (sent < msg.size()) {
+      ssize_t r = send(fd, msg.data() + sent, msg.size() - sent, MSG_NOSIGNAL);
+      if (r <= 0) return false;
+      sent += r;
+    }
+    return true;
+  };
+  while (true) {
+    size_t nl;
+    while ((nl = buffer.find('\n')) == std::string::npos) {
+      ssize_t r = recv(fd, chunk, sizeof(chunk), 0);
+      if (r <= 0) return;
+      buffer.append(chunk, r);
+    }
+    std::string line = buffer.substr(0, nl);
+    buffer.erase(0, nl + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.find_first_not_of(" \t") == std::string::npos) continue;
+    if (line == "QUIT") break;
+
+    if (line == "SHUTDOWN") {
+      reply("ok SHUTDOWN bye");
+      // Stops the accept loop; run_server waits for in-flight requests.
+      S.shutting_down = true;
+      shutdown(S.listen_fd, SHUT_RDWR);
+      break;
+    }
+    std::string resp = handle_request(G, line, S);
+    {
+      std::lock_guard<std::mutex> lock(S.log_mutex);
+      std::cout << "### Request: " << line << " -> " << resp << std::endl;
+    }
+    if (!reply(resp)) break;
+  }
+}
+
+// A client connection and the thread serving it.
+struct connection {
+  int fd;
+  std::atomic<bool> done{false};
+  std::thread thread;
+};
+
+template <class Graph>
+int run_server(Graph& G, commandLine& P) {
+  std::string socket_path = P.getOptionValue("-socket", "/tmp/gbbs_server.sock");
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (listen_fd == -1 || socket_path.size() >= sizeof(addr.sun_path)) {
+    std::cout << "# Unable to create socket " << socket_path << std::endl;
+    return -1;
+  }
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) == -1 ||
+      listen(listen_fd, 64) == -1) {
+    std::cout << "# Unable to listen on " << socket_path << ": "
+              << strerror(errno) << std::endl;
+    return -1;
+  }
+
+  server_state S;
+  S.max_requests = P.getOptionLongValue("-max_requests", 16);
+  S.listen_fd = listen_fd;
+  S.start_time = clock_type::now();
+
+  std::cout << "### Application: gbbs_server" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << G.n << std::endl;
+  std::cout << "### m: " << G.m << std::endl;
+  std::cout << "### Listening on: " << socket_path << std::endl;
+
+  // The connection threads refer to G and S, so they are all joined before
+  // returning; finished ones are reaped as new connections arrive.
+  std::list<std::unique_ptr<connection>> connections;
+  auto reap = [&] (bool all) {
+    for (auto it = connections.begin(); it != connections.end();) {
+      auto& c = *it;
+      if (!all && !c->done) {
+        ++it;
+        continue;
+      }
+      c->thread.join();
+      close(c->fd);
+      it = connections.erase(it);
+    }
+  };
+  while (true) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd == -1) {
+      if (errno == EINTR && !S.shutting_down) continue;
+      break;  // the listening socket was shut down
+    }
+    reap(false);
+    auto c = std::make_unique<connection>();
+    c->fd = fd;
+    connection* cp = c.get();
+    c->thread = std::thread([&G, &S, cp] () {
+      serve_connection<Graph>(G, cp->fd, S);
+      cp->done = true;
+    });
+    connections.push_back(std::move(c));
+  }
+  close(listen_fd);
+  // Let the admitted requests finish and reply, then wake up the idle
+  // connections blocked in recv.
+  while (S.in_flight > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (auto& c : connections) {
+    shutdown(c->fd, SHUT_RDWR);
+  }
+  reap(true);
+  unlink(socket_path.c_str());
+  return 0;
+}
+
+/* ============================ Loading ============================= */
+
+template <class Graph, class Read>
+void load_and_serve(commandLine& P, uint64_t encoding, Read read_graph,
+                    std::function<size_t(Graph&)> edge_bytes) {
+  char* iFile = P.getArgument(0);
+  std::string shm_name = P.getOptionValue("-shm", "");
+  timer load_t; load_t.start();
+  Graph* G = nullptr;
+  if (!shm_name.empty()) {
+    struct stat input;
+    if (stat(iFile, &input) == -1) {
+      std::cout << "# Unable to stat " << iFile << std::endl;
+      exit(-1);
+    }
+    G = attach_shm_graph<Graph>(shm_name, encoding, input);
+    if (G != nullptr) {
+      std::cout << "### Attached to shared memory: " << shm_name << std::endl;
+    } else {
+      auto F = read_graph();
+      create_shm_graph(shm_name, F, edge_bytes(F), encoding, input);
+      F.del();
+      G = attach_shm_graph<Graph>(shm_name, encoding, input);
+      if (G == nullptr) {
+        std::cout << "# Unable to attach to " << shm_name << std::endl;
+        exit(-1);
+      }
+      std::cout << "### Created shared memory: " << shm_name << std::endl;
+    }
+  } else {
+    G = new Graph(read_graph());
+  }
+  alloc_init(*G);
+  std::cout << "### Load time: " << load_t.stop() << std::endl;
+  run_server(*G, P);
+  G->del();
+  delete G;
+}
+
+template <class W, class ReadUncompressed>
+void serve(commandLine& P, ReadUncompressed read_uncompressed) {
+  char* iFile = P.getArgument(0);
+  bool mmap = P.getOptionValue("-m");
+  if (P.getOptionValue("-c")) {
+    auto read = [&] () {
+      return gbbs_io::read_compressed_symmetric_graph<W>(iFile, mmap, false);
+    };
+    using Graph = decltype(read());
+    load_and_serve<Graph>(
+        P, kShmEncoding, read,
+        [&] (Graph&) { return compressed_edge_bytes(iFile); });
+  } else {
+    using Graph = symmetric_graph<symmetric_vertex, W>;
+    load_and_serve<Graph>(
+        P, 0, [&] () { return read_uncompressed(iFile, mmap); },
+        [] (Graph& G) { return G.m * sizeof(typename Graph::edge_type); });
+  }
+}
+
+}  // namespace server
+}  // namespace gbbs
+
+int main(int argc, char* argv[]) {
+  gbbs::commandLine P(argc, argv,
+                      " -s [-c] [-m] [-w] [-socket <path>] [-shm <name>]"
+                      " [-max_requests <k>] <inFile>");
+  if (!P.getOptionValue("-s")) {
+    std::cout << "gbbs_server only accepts symmetric graphs (-s)" << std::endl;
+    exit(-1);
+  }
+  signal(SIGPIPE, SIG_IGN);
+  gbbs::pcm_init();
+  if (P.getOptionValue("-w")) {
+    gbbs::server::serve<gbbs::intE>(P, [] (const char* f, bool m) {
+      return gbbs::gbbs_io::read_weighted_symmetric_graph(f, m);
+    });
+  } else {
+    gbbs::server::serve<pbbslib::empty>(P, [] (const char* f, bool m) {
+      return gbbs::gbbs_io::read_unweighted_symmetric_graph(f, m);
+    });
+  }
+  gbbs::alloc_finish();
+  return 0;
+}
@@ -0,0 +1,194 @@
+// Usage:
+// numactl -i all ./mixed_workload_benchmark -s -clients 4 -queries 100 twitter_SJ
+// flags:
+//   required:
+//     -s : indicate that the graph is symmetric
+//   optional:
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -clients : the number of client threads issuing small queries
+//                (default: 4)
+//     -queries : the number of queries issued by each client (default: 50)
+//     -interval_ms : the mean time a client waits between queries
+//                    (default: 10)
+//     -hops : the number of hops explored by each query (default: 2)
+//     -iters : the number of PageRank iterations run by each background job
+//              (default: 10)
+//
+// Measures the latency of small queries (a BFS limited to -hops hops from a
+// random vertex) issued concurrently by -clients threads, each as its own
+// root computation on the shared scheduler:
+//   1. with no other work,
+//   2. while a background thread repeatedly runs PageRank at the same
+//      priority as the queries, and
+//   3. while the same PageRank runs at a lower priority than the queries.
+// For each phase it reports latency percentiles of the queries, and the
+// throughput of the background job.
+
+#include "gbbs/gbbs.h"
+
+#include "benchmarks/BFS/NonDeterministicBFS/BFS.h"
+#include "benchmarks/PageRank/PageRank.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gbbs {
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Discards the output of the algorithms run by the benchmark.
+struct null_buffer : std::streambuf {
+  int overflow(int c) override { return c; }
+};
+
+// Returns the number of vertices within hops hops of src.
+template <class Graph>
+size_t local_bfs(Graph& G, uintE src, size_t hops) {
+  using W = typename Graph::weight_type;
+  auto Parents = sequence<uintE>(G.n, [&] (size_t i) { return UINT_E_MAX; });
+  Parents[src] = src;
+  vertexSubset Frontier(G.n, src);
+  size_t visited = 0;
+  for (size_t h = 0; h <= hops && !Frontier.isEmpty(); h++) {
+    visited += Frontier.size();
+    if (h == hops) break;
+    vertexSubset output = nghMap(G, Frontier, BFS_F<W>(Parents.begin()), -1,
+                                 sparse_blocked | dense_parallel);
+    Frontier.del();
+    Frontier = output;
+  }
+  Frontier.del();
+  return visited;
+}
+
+struct phase_result {
+  std::vector<double> latencies_ms;
+  size_t background_runs;
+  double elapsed_s;
+};
+
+template <class Graph>
+phase_result run_phase(Graph& G, commandLine& P, bool background,
+                       int background_priority, int query_priority) {
+  size_t clients = P.getOptionLongValue("-clients", 4);
+  size_t queries = P.getOptionLongValue("-queries", 50);
+  double interval_ms = P.getOptionDoubleValue("-interval_ms", 10);
+  size_t hops = P.getOptionLongValue("-hops", 2);
+  size_t iters = P.getOptionLongValue("-iters", 10);
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> background_runs{0};
+  std::thread background_thread;
+  if (background) {
+    background_thread = std::thread([&] () {
+      while (!stop) {
+        run_root([&] () { PageRank(G, 0.0, iters); }, background_priority);
+        background_runs++;
+      }
+    });
+    // Let the background job get going before issuing queries.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  auto start = clock_type::now();
+  std::vector<std::vector<double>> latencies(clients);
+  std::vector<std::thread> client_threads;
+  for (size_t c = 0; c < clients; c++) {
+    client_threads.emplace_back([&, c] () {
+      std::mt19937_64 rng(c + 1);
+      std::exponential_distribution<double> wait(1.0 / interval_ms);
+      std::uniform_int_distribution<size_t> vertex(0, G.n - 1);
+      for (size_t q = 0; q < queries; q++) {
+        std::this_thread::sleep_for(
+            std::chrono::duration<double, std::milli>(wait(rng)));
+        uintE src = vertex(rng);
+        auto t = clock_type::now();
+        run_root([&] () { local_bfs(G, src, hops); }, query_priority);
+        latencies[c].push_back(
+            std::chrono::duration<double, std::milli>(clock_type::now() - t)
+                .count());
+      }
+    });
+  }
+  for (auto& t : client_threads) t.join();
+  double elapsed = std::chrono::duration<double>(clock_type::now() - start)
+                       .count();
+  stop = true;
+  if (background) background_thread.join();
+
+  phase_result result;
+  for (auto& l : latencies) {
+    result.latencies_ms.insert(result.latencies_ms.end(), l.begin(), l.end());
+  }
+  result.background_runs = background_runs;
+  result.elapsed_s = elapsed;
+  return result;
+}
+
+void report_phase(const std::string& name, phase_result& R, bool background) {
+  auto& L = R.latencies_ms;
+  std::sort(L.begin(), L.end());
+  auto percentile = [&] (double p) {
+    return L[std::min(L.size() - 1, (size_t)(p * L.size()))];
+  };
+  double mean = 0;
+  for (double l : L) mean += l;
+  mean /= L.size();
+  std::cout << "### Phase: " << name << std::endl;
+  std::cout << "# queries: " << L.size() << " mean_ms: " << mean
+            << " p50_ms: " << percentile(0.5) << " p95_ms: "
+            << percentile(0.95) << " p99_ms: " << percentile(0.99)
+            << " max_ms: " << L.back() << std::endl;
+  if (background) {
+    std::cout << "# background PageRank runs: " << R.background_runs
+              << " runs/s: " << R.background_runs / R.elapsed_s << std::endl;
+  }
+}
+
+}  // namespace
+
+template <class Graph>
+double MixedWorkload_runner(Graph& G, commandLine P) {
+  std::cout << "### Application: MixedWorkloadBenchmark" << std::endl;
+  std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+  std::cout << "### Threads: " << num_workers() << std::endl;
+  std::cout << "### n: " << G.n << std::endl;
+  std::cout << "### m: " << G.m << std::endl;
+  std::cout << "### Params: -clients = "
+            << P.getOptionLongValue("-clients", 4)
+            << " -queries = " << P.getOptionLongValue("-queries", 50)
+            << " -interval_ms = " << P.getOptionDoubleValue("-interval_ms", 10)
+            << " -hops = " << P.getOptionLongValue("-hops", 2)
+            << " -iters = " << P.getOptionLongValue("-iters", 10) << std::endl;
+  std::cout << "### ------------------------------------" << std::endl;
+
+  timer t; t.start();
+  null_buffer sink;
+  auto* cout_buffer = std::cout.rdbuf(&sink);
+  auto alone = run_phase(G, P, false, 0, 0);
+  auto same_priority = run_phase(G, P, true, 0, 0);
+  auto high_priority = run_phase(G, P, true, 0, 1);
+  std::cout.rdbuf(cout_buffer);
+  double tt = t.stop();
+
+  report_phase("queries alone", alone, false);
+  report_phase("queries with background, same priority", same_priority, true);
+  report_phase("queries with background, higher priority", high_priority,
+               true);
+  std::cout << "### Running Time: " << tt << std::endl;
+  exit(0);
+  return tt;
+}
+
+}  // namespace gbbs
+
+generate_symmetric_main(gbbs::MixedWorkload_runner, false);